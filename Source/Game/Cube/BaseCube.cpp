@@ -87,12 +87,12 @@ const library::SimpleVertex* BaseCube::getVertices() const {
 
   Summary:  Returns the pointer to the indices data
   
-  Returns:  const WORD*
-              Pointer to the indices data
+  Returns:  const void*
+              Pointer to the 16-bit indices data
 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 /*--------------------------------------------------------------------
   TODO: BaseCube::getIndices definition (remove the comment)
 --------------------------------------------------------------------*/
-const WORD* BaseCube::getIndices() const {
+const void* BaseCube::getIndices() const {
     return INDICES;
 }
@@ -44,7 +44,7 @@ public:
     UINT GetNumIndices() const override;
 protected:
     const library::SimpleVertex* getVertices() const override;
-    const WORD* getIndices() const override;
+    const void* getIndices() const override;
 
     static constexpr const library::SimpleVertex VERTICES[] =
     {
@@ -12,7 +12,6 @@
 #include "Common.h"
 
 #include <cstdio>
-#include <fstream>
 #include <memory>
 
 #include "Cube/Cube.h"
@@ -21,6 +20,7 @@
 #include "Light/RotatingPointLight.h"
 #include "Model/Model.h"
 #include "Renderer/Skybox.h"
+#include "Scene/HeightMap.h"
 #include "Scene/Scene.h"
 #include "Scene/Voxel.h"
 #include "Shader/SkyMapVertexShader.h"
@@ -53,8 +53,6 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 
     std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Assignment 3: Cube Mapping");
 
-    std::ofstream sceneFile;
-    sceneFile.open("HeightMap.txt");
     constexpr const UINT MAP_WIDTH = 0;
     constexpr const UINT MAP_HEIGHT = 0;
     constexpr const UINT MAP_DEPTH = 0;
@@ -77,15 +75,15 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         XMFLOAT4(0.15f,     0.372f, 0.15f,  1.0f),  // TROPICAL_RAIN_FOREST
     };
 
-    sceneFile << MAP_WIDTH << " " << MAP_HEIGHT << " " << MAP_DEPTH << ' ' << ARRAYSIZE(aColors) << '\n';
-
+    std::vector<XMFLOAT3> aPalette;
     for (UINT colorIdx = 0; colorIdx < ARRAYSIZE(aColors); ++colorIdx)
     {
-        sceneFile << aColors[colorIdx].x << ' ' <<
-            aColors[colorIdx].y << ' ' <<
-            aColors[colorIdx].z << '\n';
+        aPalette.push_back(XMFLOAT3(aColors[colorIdx].x, aColors[colorIdx].y, aColors[colorIdx].z));
     }
 
+    std::vector<library::HeightMapColumn> aColumns;
+    aColumns.reserve(static_cast<size_t>(MAP_WIDTH) * static_cast<size_t>(MAP_DEPTH));
+
     for (UINT z = 0u; z < MAP_DEPTH; ++z)
     {
         for (UINT x = 0u; x < MAP_WIDTH; ++x)
@@ -200,16 +198,23 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
                 }
             }
 
-            sceneFile << static_cast<CHAR>(blockType);
-
-            sceneFile << height << ' ';
+            aColumns.push_back(
+                library::HeightMapColumn
+                {
+                    .uType = static_cast<BYTE>(static_cast<CHAR>(blockType) - static_cast<CHAR>(library::eBlockType::GRASSLAND)),
+                    .uPadding = 0u,
+                    .uHeight = static_cast<WORD>(static_cast<FLOAT>(MAP_HEIGHT) * height)
+                }
+            );
         }
-        sceneFile << '\n';
     }
-    sceneFile << std::endl;
-    sceneFile.close();
 
-    std::shared_ptr<library::Scene> mainScene = std::make_shared<library::Scene>(L"HeightMap.txt");
+    if (FAILED(library::HeightMap::Save(L"HeightMap.hmap", MAP_WIDTH, MAP_HEIGHT, MAP_DEPTH, aPalette, aColumns, TRUE)))
+    {
+        return 0;
+    }
+
+    std::shared_ptr<library::Scene> mainScene = std::make_shared<library::Scene>(L"HeightMap.hmap");
 
     // Phong
     std::shared_ptr<library::VertexShader> phongVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
@@ -328,6 +333,39 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
     */
+    /*
+    // Instancing stress scene: 10,000 copies of one static model. Drawing
+    // them as separate models instead (AddModel with a Translate each) gives
+    // the per object path to compare against; Renderer::GetDrawStatistics
+    // reports the draw calls and submit time of both paths every frame.
+    std::shared_ptr<library::VertexShader> phongInstancedVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhongInstanced", "vs_5_0");
+    if (FAILED(mainScene->AddVertexShader(L"PhongInstancedShader", phongInstancedVertexShader)))
+    {
+        return 0;
+    }
+
+    constexpr const UINT STRESS_GRID_SIZE = 100u;
+    std::shared_ptr<library::InstancedModel> nanosuits = std::make_shared<library::InstancedModel>(std::make_shared<library::Model>(L"Content/Nanosuit/nanosuit.obj"));
+    for (UINT z = 0u; z < STRESS_GRID_SIZE; ++z)
+    {
+        for (UINT x = 0u; x < STRESS_GRID_SIZE; ++x)
+        {
+            nanosuits->AddInstance(XMMatrixTranslation(static_cast<FLOAT>(x) * 10.0f, 0.0f, static_cast<FLOAT>(z) * 10.0f));
+        }
+    }
+    if (FAILED(mainScene->AddInstancedModel(L"Nanosuits", nanosuits)))
+    {
+        return 0;
+    }
+    if (FAILED(mainScene->SetVertexShaderOfInstancedModel(L"Nanosuits", L"PhongInstancedShader")))
+    {
+        return 0;
+    }
+    if (FAILED(mainScene->SetPixelShaderOfInstancedModel(L"Nanosuits", L"PhongShader")))
+    {
+        return 0;
+    }
+    */
     XMFLOAT4 color;
     XMStoreFloat4(&color, Colors::WhiteSmoke);
 
@@ -30,11 +30,14 @@
 #include <d3d11_4.h>
 #include <d3dcompiler.h>
 #include <directxcolors.h>
+#include <DirectXCollision.h>
+#include <DirectXPackedVector.h>
 
 #define _CRTDBG_MAP_ALLOC
 #include <stdlib.h>
 #include <crtdbg.h>
 
+#include <algorithm>
 #include <cassert>
 #include <filesystem>
 #include <memory>
@@ -49,6 +52,7 @@ constexpr LPCWSTR PSZ_COURSE_TITLE = L"Game Graphics Programming";
 
 using namespace Microsoft::WRL;
 using namespace DirectX;
+using namespace DirectX::PackedVector;
 
 #define ASSIMP_LOAD_FLAGS (aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_ConvertToLeftHanded | aiProcess_CalcTangentSpace)
 
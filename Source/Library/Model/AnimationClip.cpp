@@ -0,0 +1,709 @@
+#include "Model/AnimationClip.h"
+#include "Model/ImportProfiler.h"
+
+#include "assimp/scene.h"
+
+namespace library
+{
+    constexpr const FLOAT SQRT2 = 1.414213562f;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::FindKeyIndex
+
+      Summary:  Find the index of the key right before the given
+                animation time. The cursor remembers the key found on
+                the previous call, so playing forward only checks the
+                current and the next key. When the time jumps or the
+                animation loops, falls back to a binary search.
+
+      Args:     FLOAT animationTimeTicks
+                  Animation time
+                const FLOAT* aTimes
+                  Array of key times in ascending order
+                UINT uNumKeys
+                  Number of keys, must be at least 2
+                UINT& uCursor
+                  Key index found on the previous call
+
+      Returns:  UINT
+                  Index of the key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT AnimationClip::FindKeyIndex(_In_ FLOAT animationTimeTicks, _In_reads_(uNumKeys) const FLOAT* aTimes, _In_ UINT uNumKeys, _Inout_ UINT& uCursor)
+    {
+        assert(uNumKeys > 1u);
+
+        const UINT uLastIndex = uNumKeys - 2u;
+
+        if (uCursor <= uLastIndex && aTimes[uCursor] <= animationTimeTicks)
+        {
+            if (uCursor == uLastIndex || animationTimeTicks < aTimes[uCursor + 1u])
+            {
+                return uCursor;
+            }
+
+            if (uCursor + 1u == uLastIndex || animationTimeTicks < aTimes[uCursor + 2u])
+            {
+                return ++uCursor;
+            }
+        }
+
+        UINT uLow = 0u;
+        UINT uHigh = uLastIndex;
+        while (uLow < uHigh)
+        {
+            UINT uMid = (uLow + uHigh + 1u) / 2u;
+
+            if (aTimes[uMid] <= animationTimeTicks)
+            {
+                uLow = uMid;
+            }
+            else
+            {
+                uHigh = uMid - 1u;
+            }
+        }
+
+        uCursor = uLow;
+
+        return uCursor;
+    }
+
+    namespace
+    {
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: InterpolationFactor
+
+          Summary:  Returns where the given time lies between two keys,
+                    clamped to [0, 1]
+
+          Args:     FLOAT animationTimeTicks
+                      Animation time
+                    FLOAT startTime
+                      Time of the first key
+                    FLOAT endTime
+                      Time of the second key
+
+          Returns:  FLOAT
+        -----------------------------------------------------------------F-F*/
+        FLOAT InterpolationFactor(_In_ FLOAT animationTimeTicks, _In_ FLOAT startTime, _In_ FLOAT endTime)
+        {
+            FLOAT factor = (animationTimeTicks - startTime) / (endTime - startTime);
+
+            return std::clamp(factor, 0.0f, 1.0f);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: QuantizeRotation
+
+          Summary:  Pack a unit quaternion into 64 bits. The largest
+                    component is dropped and rebuilt from the other three,
+                    which are stored with 20 bits each.
+
+          Args:     const XMFLOAT4& rotation
+                      Unit quaternion
+
+          Returns:  UINT64
+                      Bits 60-61 hold the index of the dropped component
+        -----------------------------------------------------------------F-F*/
+        UINT64 QuantizeRotation(_In_ const XMFLOAT4& rotation)
+        {
+            constexpr const FLOAT QUANTIZATION_SCALE = static_cast<FLOAT>((1u << 20u) - 1u);
+
+            FLOAT aComponents[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+            UINT uLargestIndex = 0u;
+            for (UINT i = 1u; i < 4u; ++i)
+            {
+                if (fabsf(aComponents[i]) > fabsf(aComponents[uLargestIndex]))
+                {
+                    uLargestIndex = i;
+                }
+            }
+
+            // q and -q are the same rotation, so the dropped component can always be positive
+            FLOAT sign = (aComponents[uLargestIndex] < 0.0f) ? -1.0f : 1.0f;
+
+            UINT64 uPacked = static_cast<UINT64>(uLargestIndex) << 60u;
+            UINT uShift = 40u;
+            for (UINT i = 0u; i < 4u; ++i)
+            {
+                if (i == uLargestIndex)
+                {
+                    continue;
+                }
+
+                // The other components lie in [-1/sqrt(2), 1/sqrt(2)]
+                FLOAT normalized = std::clamp(aComponents[i] * sign * SQRT2 * 0.5f + 0.5f, 0.0f, 1.0f);
+                uPacked |= static_cast<UINT64>(normalized * QUANTIZATION_SCALE + 0.5f) << uShift;
+                uShift -= 20u;
+            }
+
+            return uPacked;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: DequantizeRotation
+
+          Summary:  Unpack a quaternion packed by QuantizeRotation
+
+          Args:     UINT64 uPacked
+                      Packed quaternion
+
+          Returns:  XMVECTOR
+        -----------------------------------------------------------------F-F*/
+        XMVECTOR DequantizeRotation(_In_ UINT64 uPacked)
+        {
+            constexpr const FLOAT QUANTIZATION_SCALE = static_cast<FLOAT>((1u << 20u) - 1u);
+            constexpr const UINT64 COMPONENT_MASK = (1u << 20u) - 1u;
+
+            UINT uLargestIndex = static_cast<UINT>(uPacked >> 60u) & 3u;
+
+            FLOAT aComponents[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            FLOAT sumOfSquares = 0.0f;
+            UINT uShift = 40u;
+            for (UINT i = 0u; i < 4u; ++i)
+            {
+                if (i == uLargestIndex)
+                {
+                    continue;
+                }
+
+                FLOAT normalized = static_cast<FLOAT>((uPacked >> uShift) & COMPONENT_MASK) / QUANTIZATION_SCALE;
+                aComponents[i] = (normalized - 0.5f) * SQRT2;
+                sumOfSquares += aComponents[i] * aComponents[i];
+                uShift -= 20u;
+            }
+
+            aComponents[uLargestIndex] = sqrtf(std::max(0.0f, 1.0f - sumOfSquares));
+
+            return XMVectorSet(aComponents[0], aComponents[1], aComponents[2], aComponents[3]);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: ReduceKeys
+
+          Summary:  Remove the keys that interpolating their neighbors
+                    rebuilds within the tolerance. A track whose keys all
+                    match the first one is reduced to that key.
+
+          Args:     std::vector<FLOAT>& aTimes
+                      Key times
+                    std::vector<T>& aValues
+                      Key values
+                    FLOAT tolerance
+                      Largest error allowed
+                    Interpolate interpolate
+                      Interpolates two values
+                    Distance distance
+                      Measures the error between two values
+
+          Modifies: [aTimes, aValues].
+        -----------------------------------------------------------------F-F*/
+        template <class T, class Interpolate, class Distance>
+        void ReduceKeys(_Inout_ std::vector<FLOAT>& aTimes, _Inout_ std::vector<T>& aValues, _In_ FLOAT tolerance, _In_ Interpolate interpolate, _In_ Distance distance)
+        {
+            const size_t uNumKeys = aValues.size();
+            if (uNumKeys < 2u)
+            {
+                return;
+            }
+
+            BOOL bConstant = TRUE;
+            for (size_t i = 1u; i < uNumKeys && bConstant; ++i)
+            {
+                bConstant = distance(aValues[i], aValues[0]) <= tolerance;
+            }
+
+            if (bConstant)
+            {
+                aTimes.resize(1u);
+                aValues.resize(1u);
+                return;
+            }
+
+            std::vector<size_t> aKeptIndices;
+            aKeptIndices.push_back(0u);
+
+            size_t uAnchor = 0u;
+            for (size_t k = 1u; k + 1u < uNumKeys; ++k)
+            {
+                // Try to drop key k by interpolating from the last kept key to key k + 1
+                BOOL bDroppable = TRUE;
+                for (size_t j = uAnchor + 1u; j <= k && bDroppable; ++j)
+                {
+                    FLOAT factor = InterpolationFactor(aTimes[j], aTimes[uAnchor], aTimes[k + 1u]);
+                    bDroppable = distance(interpolate(aValues[uAnchor], aValues[k + 1u], factor), aValues[j]) <= tolerance;
+                }
+
+                if (!bDroppable)
+                {
+                    aKeptIndices.push_back(k);
+                    uAnchor = k;
+                }
+            }
+
+            aKeptIndices.push_back(uNumKeys - 1u);
+
+            for (size_t i = 0u; i < aKeptIndices.size(); ++i)
+            {
+                aTimes[i] = aTimes[aKeptIndices[i]];
+                aValues[i] = aValues[aKeptIndices[i]];
+            }
+
+            aTimes.resize(aKeptIndices.size());
+            aValues.resize(aKeptIndices.size());
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: LoadVectorKeys
+
+          Summary:  Convert assimp vector keys and reduce them
+
+          Args:     const aiVectorKey* aKeys
+                      Assimp keys
+                    UINT uNumKeys
+                      Number of keys
+                    FLOAT tolerance
+                      Largest error allowed
+                    std::vector<FLOAT>& aOutTimes
+                      Key times
+                    std::vector<XMFLOAT3>& aOutValues
+                      Key values
+
+          Modifies: [aOutTimes, aOutValues].
+        -----------------------------------------------------------------F-F*/
+        void LoadVectorKeys(_In_reads_(uNumKeys) const aiVectorKey* aKeys, _In_ UINT uNumKeys, _In_ FLOAT tolerance, _Out_ std::vector<FLOAT>& aOutTimes, _Out_ std::vector<XMFLOAT3>& aOutValues)
+        {
+            aOutTimes.resize(uNumKeys);
+            aOutValues.resize(uNumKeys);
+
+            for (UINT i = 0u; i < uNumKeys; ++i)
+            {
+                aOutTimes[i] = static_cast<FLOAT>(aKeys[i].mTime);
+                aOutValues[i] = XMFLOAT3(aKeys[i].mValue.x, aKeys[i].mValue.y, aKeys[i].mValue.z);
+            }
+
+            ReduceKeys(aOutTimes, aOutValues, tolerance,
+                [](const XMFLOAT3& start, const XMFLOAT3& end, FLOAT factor)
+                {
+                    XMFLOAT3 value;
+                    XMStoreFloat3(&value, XMVectorLerp(XMLoadFloat3(&start), XMLoadFloat3(&end), factor));
+                    return value;
+                },
+                [](const XMFLOAT3& a, const XMFLOAT3& b)
+                {
+                    return XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&a), XMLoadFloat3(&b))));
+                }
+            );
+
+            aOutTimes.shrink_to_fit();
+            aOutValues.shrink_to_fit();
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: LoadRotationKeys
+
+          Summary:  Convert assimp rotation keys, reduce and quantize them
+
+          Args:     const aiQuatKey* aKeys
+                      Assimp keys
+                    UINT uNumKeys
+                      Number of keys
+                    FLOAT tolerance
+                      Largest error allowed, in 1 - |dot|
+                    std::vector<FLOAT>& aOutTimes
+                      Key times
+                    std::vector<UINT64>& aOutValues
+                      Quantized key values
+
+          Modifies: [aOutTimes, aOutValues].
+        -----------------------------------------------------------------F-F*/
+        void LoadRotationKeys(_In_reads_(uNumKeys) const aiQuatKey* aKeys, _In_ UINT uNumKeys, _In_ FLOAT tolerance, _Out_ std::vector<FLOAT>& aOutTimes, _Out_ std::vector<UINT64>& aOutValues)
+        {
+            std::vector<XMFLOAT4> aRotations(uNumKeys);
+            aOutTimes.resize(uNumKeys);
+
+            for (UINT i = 0u; i < uNumKeys; ++i)
+            {
+                aOutTimes[i] = static_cast<FLOAT>(aKeys[i].mTime);
+                XMVECTOR rotation = XMVectorSet(aKeys[i].mValue.x, aKeys[i].mValue.y, aKeys[i].mValue.z, aKeys[i].mValue.w);
+                XMStoreFloat4(&aRotations[i], XMQuaternionNormalize(rotation));
+            }
+
+            ReduceKeys(aOutTimes, aRotations, tolerance,
+                [](const XMFLOAT4& start, const XMFLOAT4& end, FLOAT factor)
+                {
+                    XMFLOAT4 value;
+                    XMStoreFloat4(&value, XMQuaternionNormalize(XMQuaternionSlerp(XMLoadFloat4(&start), XMLoadFloat4(&end), factor)));
+                    return value;
+                },
+                [](const XMFLOAT4& a, const XMFLOAT4& b)
+                {
+                    return 1.0f - fabsf(XMVectorGetX(XMVector4Dot(XMLoadFloat4(&a), XMLoadFloat4(&b))));
+                }
+            );
+
+            aOutValues.resize(aRotations.size());
+            for (size_t i = 0u; i < aRotations.size(); ++i)
+            {
+                aOutValues[i] = QuantizeRotation(aRotations[i]);
+            }
+
+            aOutTimes.shrink_to_fit();
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: SampleVectorKeys
+
+          Summary:  Interpolate the vector keys at the given time
+
+          Args:     FLOAT animationTimeTicks
+                      Animation time
+                    const std::vector<FLOAT>& aTimes
+                      Key times
+                    const std::vector<XMFLOAT3>& aValues
+                      Key values
+                    UINT& uCursor
+                      Key index found on the previous call
+
+          Returns:  XMVECTOR
+        -----------------------------------------------------------------F-F*/
+        XMVECTOR SampleVectorKeys(_In_ FLOAT animationTimeTicks, _In_ const std::vector<FLOAT>& aTimes, _In_ const std::vector<XMFLOAT3>& aValues, _Inout_ UINT& uCursor)
+        {
+            if (aValues.size() == 1u)
+            {
+                return XMLoadFloat3(&aValues[0]);
+            }
+
+            UINT uIndex = AnimationClip::FindKeyIndex(animationTimeTicks, aTimes.data(), static_cast<UINT>(aTimes.size()), uCursor);
+            FLOAT factor = InterpolationFactor(animationTimeTicks, aTimes[uIndex], aTimes[uIndex + 1u]);
+
+            return XMVectorLerp(XMLoadFloat3(&aValues[uIndex]), XMLoadFloat3(&aValues[uIndex + 1u]), factor);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: SampleRotationKeys
+
+          Summary:  Interpolate the quantized rotation keys at the given time
+
+          Args:     FLOAT animationTimeTicks
+                      Animation time
+                    const std::vector<FLOAT>& aTimes
+                      Key times
+                    const std::vector<UINT64>& aValues
+                      Quantized key values
+                    UINT& uCursor
+                      Key index found on the previous call
+
+          Returns:  XMVECTOR
+        -----------------------------------------------------------------F-F*/
+        XMVECTOR SampleRotationKeys(_In_ FLOAT animationTimeTicks, _In_ const std::vector<FLOAT>& aTimes, _In_ const std::vector<UINT64>& aValues, _Inout_ UINT& uCursor)
+        {
+            if (aValues.size() == 1u)
+            {
+                return DequantizeRotation(aValues[0]);
+            }
+
+            UINT uIndex = AnimationClip::FindKeyIndex(animationTimeTicks, aTimes.data(), static_cast<UINT>(aTimes.size()), uCursor);
+            FLOAT factor = InterpolationFactor(animationTimeTicks, aTimes[uIndex], aTimes[uIndex + 1u]);
+
+            XMVECTOR start = DequantizeRotation(aValues[uIndex]);
+            XMVECTOR end = DequantizeRotation(aValues[uIndex + 1u]);
+
+            return XMQuaternionNormalize(XMQuaternionSlerp(start, end, factor));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::AnimationClip
+
+      Summary:  Constructor
+
+      Modifies: [m_aTracks, m_ticksPerSecond, m_durationTicks,
+                 m_uNumAnimatedJoints, m_uSourceSize, m_uCompressedSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AnimationClip::AnimationClip()
+        : m_aTracks()
+        , m_ticksPerSecond(25.0f)
+        , m_durationTicks(0.0f)
+        , m_uNumAnimatedJoints(0u)
+        , m_uSourceSize(0u)
+        , m_uCompressedSize(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::Initialize
+
+      Summary:  Convert the channels of the given animation into one
+                track per joint. Joints without a channel get an empty
+                track.
+
+      Args:     const aiAnimation* pAnimation
+                  Pointer to an assimp animation object
+                const std::vector<std::string>& aJointNames
+                  Node name of every joint of the skeleton
+
+      Modifies: [m_aTracks, m_ticksPerSecond, m_durationTicks,
+                 m_uNumAnimatedJoints, m_uSourceSize, m_uCompressedSize].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT AnimationClip::Initialize(_In_ const aiAnimation* pAnimation, _In_ const std::vector<std::string>& aJointNames)
+    {
+        if (!pAnimation)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_ticksPerSecond = static_cast<FLOAT>(pAnimation->mTicksPerSecond != 0.0 ? pAnimation->mTicksPerSecond : 25.0f);
+        m_durationTicks = static_cast<FLOAT>(pAnimation->mDuration);
+        m_aTracks.clear();
+        m_aTracks.resize(aJointNames.size());
+        m_uNumAnimatedJoints = 0u;
+        m_uSourceSize = 0u;
+        m_uCompressedSize = 0u;
+
+        std::unordered_map<std::string, UINT> jointNameToIndexMap;
+        for (UINT i = 0u; i < aJointNames.size(); ++i)
+        {
+            jointNameToIndexMap.emplace(aJointNames[i], i);
+        }
+
+        for (UINT i = 0u; i < pAnimation->mNumChannels; ++i)
+        {
+            const aiNodeAnim* pNodeAnim = pAnimation->mChannels[i];
+
+            m_uSourceSize += sizeof(aiVectorKey) * pNodeAnim->mNumPositionKeys
+                + sizeof(aiQuatKey) * pNodeAnim->mNumRotationKeys
+                + sizeof(aiVectorKey) * pNodeAnim->mNumScalingKeys;
+
+            auto iJointIndex = jointNameToIndexMap.find(pNodeAnim->mNodeName.C_Str());
+            if (iJointIndex == jointNameToIndexMap.end())
+            {
+                continue;
+            }
+
+            Track& track = m_aTracks[iJointIndex->second];
+            LoadVectorKeys(pNodeAnim->mPositionKeys, pNodeAnim->mNumPositionKeys, POSITION_TOLERANCE, track.aPositionTimes, track.aPositions);
+            LoadRotationKeys(pNodeAnim->mRotationKeys, pNodeAnim->mNumRotationKeys, ROTATION_TOLERANCE, track.aRotationTimes, track.aRotations);
+            LoadVectorKeys(pNodeAnim->mScalingKeys, pNodeAnim->mNumScalingKeys, SCALING_TOLERANCE, track.aScalingTimes, track.aScales);
+
+            m_uCompressedSize += sizeof(FLOAT) * (track.aPositionTimes.size() + track.aRotationTimes.size() + track.aScalingTimes.size())
+                + sizeof(XMFLOAT3) * (track.aPositions.size() + track.aScales.size())
+                + sizeof(UINT64) * track.aRotations.size();
+
+            ++m_uNumAnimatedJoints;
+        }
+
+        if (ImportProfiler::GetVerbosity() == eImportVerbosity::SILENT)
+        {
+            return S_OK;
+        }
+
+        CHAR szDebugMessage[256];
+        sprintf_s(szDebugMessage, "Animation clip %s: %zu bytes of keys compressed to %zu bytes\n", pAnimation->mName.C_Str(), m_uSourceSize, m_uCompressedSize);
+        OutputDebugStringA(szDebugMessage);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::Initialize
+
+      Summary:  Take tracks that were already converted, as stored in a
+                cooked model. Each track must hold as many times as
+                values for every key type.
+
+      Args:     std::vector<Track>&& aTracks
+                  Track of every joint of the skeleton
+                FLOAT ticksPerSecond
+                  Number of ticks per second
+                FLOAT durationTicks
+                  Duration in ticks
+                size_t uSourceSize
+                  Size of the assimp keys the tracks were converted from
+
+      Modifies: [m_aTracks, m_ticksPerSecond, m_durationTicks,
+                 m_uNumAnimatedJoints, m_uSourceSize, m_uCompressedSize].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT AnimationClip::Initialize(_In_ std::vector<Track>&& aTracks, _In_ FLOAT ticksPerSecond, _In_ FLOAT durationTicks, _In_ size_t uSourceSize)
+    {
+        for (const Track& track : aTracks)
+        {
+            if (track.aPositionTimes.size() != track.aPositions.size()
+                || track.aRotationTimes.size() != track.aRotations.size()
+                || track.aScalingTimes.size() != track.aScales.size())
+            {
+                return E_INVALIDARG;
+            }
+        }
+
+        m_aTracks = std::move(aTracks);
+        m_ticksPerSecond = ticksPerSecond != 0.0f ? ticksPerSecond : 25.0f;
+        m_durationTicks = durationTicks;
+        m_uNumAnimatedJoints = 0u;
+        m_uSourceSize = uSourceSize;
+        m_uCompressedSize = 0u;
+
+        for (UINT i = 0u; i < m_aTracks.size(); ++i)
+        {
+            const Track& track = m_aTracks[i];
+
+            m_uCompressedSize += sizeof(FLOAT) * (track.aPositionTimes.size() + track.aRotationTimes.size() + track.aScalingTimes.size())
+                + sizeof(XMFLOAT3) * (track.aPositions.size() + track.aScales.size())
+                + sizeof(UINT64) * track.aRotations.size();
+
+            if (HasTrack(i))
+            {
+                ++m_uNumAnimatedJoints;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::Sample
+
+      Summary:  Sample the track of a joint at the given time. Parts of
+                the transform without keys keep the given values.
+
+      Args:     FLOAT animationTimeTicks
+                  Animation time
+                UINT uJointIndex
+                  Index of the joint
+                KeyCursor& cursor
+                  Key indices found on the previous call for this joint
+                XMVECTOR& scale
+                  Scale of the joint
+                XMVECTOR& rotation
+                  Rotation quaternion of the joint
+                XMVECTOR& translation
+                  Translation of the joint
+
+      Modifies: [cursor, scale, rotation, translation].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AnimationClip::Sample(
+        _In_ FLOAT animationTimeTicks,
+        _In_ UINT uJointIndex,
+        _Inout_ KeyCursor& cursor,
+        _Inout_ XMVECTOR& scale,
+        _Inout_ XMVECTOR& rotation,
+        _Inout_ XMVECTOR& translation
+    ) const
+    {
+        const Track& track = m_aTracks[uJointIndex];
+
+        if (!track.aScales.empty())
+        {
+            scale = SampleVectorKeys(animationTimeTicks, track.aScalingTimes, track.aScales, cursor.uScaling);
+        }
+
+        if (!track.aRotations.empty())
+        {
+            rotation = SampleRotationKeys(animationTimeTicks, track.aRotationTimes, track.aRotations, cursor.uRotation);
+        }
+
+        if (!track.aPositions.empty())
+        {
+            translation = SampleVectorKeys(animationTimeTicks, track.aPositionTimes, track.aPositions, cursor.uPosition);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::HasTrack
+
+      Summary:  Returns whether the joint has any key in this clip
+
+      Args:     UINT uJointIndex
+                  Index of the joint
+
+      Returns:  BOOL
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL AnimationClip::HasTrack(_In_ UINT uJointIndex) const
+    {
+        const Track& track = m_aTracks[uJointIndex];
+
+        return !track.aPositions.empty() || !track.aRotations.empty() || !track.aScales.empty();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetTicksPerSecond
+
+      Summary:  Returns the number of ticks per second
+
+      Returns:  FLOAT
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT AnimationClip::GetTicksPerSecond() const
+    {
+        return m_ticksPerSecond;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetDurationTicks
+
+      Summary:  Returns the duration in ticks
+
+      Returns:  FLOAT
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT AnimationClip::GetDurationTicks() const
+    {
+        return m_durationTicks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetNumAnimatedJoints
+
+      Summary:  Returns the number of joints with a track
+
+      Returns:  UINT
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT AnimationClip::GetNumAnimatedJoints() const
+    {
+        return m_uNumAnimatedJoints;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetSourceSize
+
+      Summary:  Returns the size of the assimp keys the clip was
+                converted from
+
+      Returns:  size_t
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t AnimationClip::GetSourceSize() const
+    {
+        return m_uSourceSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetCompressedSize
+
+      Summary:  Returns the size of the keys held by the clip
+
+      Returns:  size_t
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t AnimationClip::GetCompressedSize() const
+    {
+        return m_uCompressedSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetTracks
+
+      Summary:  Returns the track of every joint, used to cook the clip
+
+      Returns:  const std::vector<Track>&
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<AnimationClip::Track>& AnimationClip::GetTracks() const
+    {
+        return m_aTracks;
+    }
+}
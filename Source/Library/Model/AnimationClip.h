@@ -0,0 +1,126 @@
+/*+===================================================================
+  File:      ANIMATIONCLIP.H
+
+  Summary:   AnimationClip header file contains declaration of class
+             AnimationClip used to store the keyframes of an animation
+             in a compact format owned by the engine.
+
+  Classes:  AnimationClip
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+struct aiAnimation;
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    AnimationClip
+
+      Summary:  Keyframes of an animation converted from assimp, one
+                track per joint of the skeleton. Tracks whose keys do
+                not change are reduced to a single key, keys that can be
+                rebuilt by interpolating their neighbors within a
+                tolerance are removed, and rotations are stored as
+                quantized quaternions.
+
+      Methods:  Initialize
+                  Converts the given assimp animation, or takes tracks
+                  already converted and loaded from a cooked model
+                Sample
+                  Samples the track of a joint at the given time
+                HasTrack
+                  Returns whether the joint is animated
+                GetTicksPerSecond
+                  Returns the number of ticks per second
+                GetDurationTicks
+                  Returns the duration in ticks
+                GetNumAnimatedJoints
+                  Returns the number of animated joints
+                GetSourceSize
+                  Returns the size of the assimp keys in bytes
+                GetCompressedSize
+                  Returns the size of the converted keys in bytes
+                GetTracks
+                  Returns the track of every joint
+                FindKeyIndex
+                  Finds the key right before an animation time,
+                  starting from the key found on the previous call
+                AnimationClip
+                  Constructor.
+                ~AnimationClip
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class AnimationClip
+    {
+    public:
+        static constexpr const FLOAT POSITION_TOLERANCE = 1.0e-4f;
+        static constexpr const FLOAT SCALING_TOLERANCE = 1.0e-4f;
+        static constexpr const FLOAT ROTATION_TOLERANCE = 1.0e-6f;
+
+        struct KeyCursor
+        {
+            KeyCursor()
+                : uPosition(0u)
+                , uRotation(0u)
+                , uScaling(0u)
+            {
+            }
+
+            UINT uPosition;
+            UINT uRotation;
+            UINT uScaling;
+        };
+
+        struct Track
+        {
+            std::vector<FLOAT> aPositionTimes;
+            std::vector<XMFLOAT3> aPositions;
+            std::vector<FLOAT> aRotationTimes;
+            std::vector<UINT64> aRotations;
+            std::vector<FLOAT> aScalingTimes;
+            std::vector<XMFLOAT3> aScales;
+        };
+
+    public:
+        AnimationClip();
+        AnimationClip(const AnimationClip& other) = delete;
+        AnimationClip(AnimationClip&& other) = delete;
+        AnimationClip& operator=(const AnimationClip& other) = delete;
+        AnimationClip& operator=(AnimationClip&& other) = delete;
+        virtual ~AnimationClip() = default;
+
+        HRESULT Initialize(_In_ const aiAnimation* pAnimation, _In_ const std::vector<std::string>& aJointNames);
+        HRESULT Initialize(_In_ std::vector<Track>&& aTracks, _In_ FLOAT ticksPerSecond, _In_ FLOAT durationTicks, _In_ size_t uSourceSize);
+
+        void Sample(
+            _In_ FLOAT animationTimeTicks,
+            _In_ UINT uJointIndex,
+            _Inout_ KeyCursor& cursor,
+            _Inout_ XMVECTOR& scale,
+            _Inout_ XMVECTOR& rotation,
+            _Inout_ XMVECTOR& translation
+        ) const;
+
+        BOOL HasTrack(_In_ UINT uJointIndex) const;
+        FLOAT GetTicksPerSecond() const;
+        FLOAT GetDurationTicks() const;
+        UINT GetNumAnimatedJoints() const;
+        size_t GetSourceSize() const;
+        size_t GetCompressedSize() const;
+        const std::vector<Track>& GetTracks() const;
+
+        static UINT FindKeyIndex(_In_ FLOAT animationTimeTicks, _In_reads_(uNumKeys) const FLOAT* aTimes, _In_ UINT uNumKeys, _Inout_ UINT& uCursor);
+
+    private:
+        std::vector<Track> m_aTracks;
+        FLOAT m_ticksPerSecond;
+        FLOAT m_durationTicks;
+        UINT m_uNumAnimatedJoints;
+        size_t m_uSourceSize;
+        size_t m_uCompressedSize;
+    };
+}
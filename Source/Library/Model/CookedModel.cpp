@@ -0,0 +1,433 @@
+#include "Model/CookedModel.h"
+
+#include <fstream>
+
+namespace library
+{
+    namespace
+    {
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: AlignSectionOffset
+
+          Summary:  Rounds an offset up to CookedModel::SECTION_ALIGNMENT
+
+          Args:     UINT64 uOffset
+                      Offset in bytes
+
+          Returns:  UINT64
+                      Aligned offset
+        -----------------------------------------------------------------F-F*/
+        UINT64 AlignSectionOffset(_In_ UINT64 uOffset)
+        {
+            return (uOffset + CookedModel::SECTION_ALIGNMENT - 1u) & ~(CookedModel::SECTION_ALIGNMENT - 1u);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModel::CookedModel
+
+      Summary:  Constructor
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    CookedModel::CookedModel()
+        : m_hFile(INVALID_HANDLE_VALUE)
+        , m_hMapping(nullptr)
+        , m_pView(nullptr)
+        , m_uSize(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModel::~CookedModel
+
+      Summary:  Destructor
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    CookedModel::~CookedModel()
+    {
+        Close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModel::Open
+
+      Summary:  Maps the cooked file and checks that it was cooked by
+                this version from the current source file with the
+                same import and mesh optimization flags, and that every
+                section lies inside the file
+
+      Args:     const std::filesystem::path& cookedFilePath
+                  Path to the cooked file
+                const std::filesystem::path& sourceFilePath
+                  Path to the model file it was cooked from
+                UINT uLoadFlags
+                  Assimp flags the model is imported with
+                UINT uMeshOptimizationFlags
+                  MeshOptimizer flags the meshes are reordered with
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_uSize].
+
+      Returns:  HRESULT
+                  Status code, E_FAIL if the file is stale
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT CookedModel::Open(
+        _In_ const std::filesystem::path& cookedFilePath,
+        _In_ const std::filesystem::path& sourceFilePath,
+        _In_ UINT uLoadFlags,
+        _In_ UINT uMeshOptimizationFlags
+    )
+    {
+        Close();
+
+        UINT64 uSourceSize = 0u;
+        INT64 sourceWriteTime = 0;
+        HRESULT hr = GetSourceWriteTime(sourceFilePath, uSourceSize, sourceWriteTime);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_hFile = CreateFile(cookedFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(m_hFile, &fileSize) || static_cast<UINT64>(fileSize.QuadPart) < sizeof(CookedModelHeader))
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        m_hMapping = CreateFileMapping(m_hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_hMapping)
+        {
+            hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_pView = static_cast<const BYTE*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0u, 0u, 0u));
+        if (!m_pView)
+        {
+            hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_uSize = static_cast<UINT64>(fileSize.QuadPart);
+
+        const CookedModelHeader& header = GetHeader();
+        if (header.uMagic != MAGIC || header.uVersion != VERSION || header.uLoadFlags != uLoadFlags
+            || header.uMeshOptimizationFlags != uMeshOptimizationFlags
+            || header.uNumSections != static_cast<UINT>(eCookedSection::COUNT))
+        {
+            OutputDebugString(L"Cooked model \"");
+            OutputDebugString(cookedFilePath.c_str());
+            OutputDebugString(L"\" was cooked by another version\n");
+
+            Close();
+            return E_FAIL;
+        }
+
+        if (header.uSourceSize != uSourceSize || header.sourceWriteTime != sourceWriteTime)
+        {
+            OutputDebugString(L"Cooked model \"");
+            OutputDebugString(cookedFilePath.c_str());
+            OutputDebugString(L"\" is older than its source\n");
+
+            Close();
+            return E_FAIL;
+        }
+
+        for (const CookedSection& section : header.aSections)
+        {
+            if (section.uOffset % SECTION_ALIGNMENT != 0u || section.uOffset > m_uSize || section.uSize > m_uSize - section.uOffset)
+            {
+                OutputDebugString(L"Cooked model \"");
+                OutputDebugString(cookedFilePath.c_str());
+                OutputDebugString(L"\" is truncated\n");
+
+                Close();
+                return E_FAIL;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModel::Close
+
+      Summary:  Unmaps and closes the file. Sections returned before are
+                no longer valid.
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CookedModel::Close()
+    {
+        if (m_pView)
+        {
+            UnmapViewOfFile(m_pView);
+            m_pView = nullptr;
+        }
+
+        if (m_hMapping)
+        {
+            CloseHandle(m_hMapping);
+            m_hMapping = nullptr;
+        }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+
+        m_uSize = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModel::GetHeader
+
+      Summary:  Returns the header of the open file
+
+      Returns:  const CookedModelHeader&
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const CookedModelHeader& CookedModel::GetHeader() const
+    {
+        assert(m_pView);
+
+        return *reinterpret_cast<const CookedModelHeader*>(m_pView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModel::GetString
+
+      Summary:  Returns a string of the STRINGS section
+
+      Args:     const CookedString& string
+                  Range of the string
+
+      Returns:  std::string_view
+                  Characters of the string, empty if the range is not
+                  inside the section
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::string_view CookedModel::GetString(_In_ const CookedString& string) const
+    {
+        std::span<const CHAR> aCharacters = GetSection<CHAR>(eCookedSection::STRINGS);
+
+        if (static_cast<size_t>(string.uOffset) + string.uLength > aCharacters.size())
+        {
+            return std::string_view();
+        }
+
+        return std::string_view(aCharacters.data() + string.uOffset, string.uLength);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModel::GetCookedFilePath
+
+      Summary:  Returns the path of the cooked file of a model, next to
+                the model file
+
+      Args:     const std::filesystem::path& sourceFilePath
+                  Path to the model file
+
+      Returns:  std::filesystem::path
+                  Path to the cooked file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::path CookedModel::GetCookedFilePath(_In_ const std::filesystem::path& sourceFilePath)
+    {
+        std::filesystem::path cookedFilePath = sourceFilePath;
+        cookedFilePath += L".cooked";
+
+        return cookedFilePath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModel::GetSourceWriteTime
+
+      Summary:  Returns the size and the last write time of a model
+                file, which a cooked file must match to be up to date
+
+      Args:     const std::filesystem::path& sourceFilePath
+                  Path to the model file
+                UINT64& uOutSize
+                  Size of the file in bytes
+                INT64& outWriteTime
+                  Last write time of the file
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT CookedModel::GetSourceWriteTime(_In_ const std::filesystem::path& sourceFilePath, _Out_ UINT64& uOutSize, _Out_ INT64& outWriteTime)
+    {
+        uOutSize = 0u;
+        outWriteTime = 0;
+
+        std::error_code errorCode;
+        uOutSize = static_cast<UINT64>(std::filesystem::file_size(sourceFilePath, errorCode));
+        if (errorCode)
+        {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+
+        std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(sourceFilePath, errorCode);
+        if (errorCode)
+        {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+
+        outWriteTime = static_cast<INT64>(writeTime.time_since_epoch().count());
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModelWriter::CookedModelWriter
+
+      Summary:  Constructor
+
+      Modifies: [m_aSections].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    CookedModelWriter::CookedModelWriter()
+        : m_aSections()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModelWriter::AddString
+
+      Summary:  Appends a string to the STRINGS section
+
+      Args:     std::string_view string
+                  String to append
+
+      Modifies: [m_aSections].
+
+      Returns:  CookedString
+                  Range of the string in the section
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    CookedString CookedModelWriter::AddString(_In_ std::string_view string)
+    {
+        std::vector<BYTE>& aCharacters = m_aSections[static_cast<size_t>(eCookedSection::STRINGS)];
+
+        CookedString cookedString =
+        {
+            .uOffset = static_cast<UINT>(aCharacters.size()),
+            .uLength = static_cast<UINT>(string.size())
+        };
+
+        aCharacters.insert(aCharacters.end(), string.begin(), string.end());
+
+        return cookedString;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModelWriter::Save
+
+      Summary:  Writes the header and the sections. The file is written
+                under a temporary name and renamed once complete, so a
+                failed write never leaves a truncated cooked file.
+
+      Args:     const std::filesystem::path& cookedFilePath
+                  Path to the cooked file
+                const std::filesystem::path& sourceFilePath
+                  Path to the model file it is cooked from
+                UINT uLoadFlags
+                  Assimp flags the model was imported with
+                UINT uMeshOptimizationFlags
+                  MeshOptimizer flags the meshes were reordered with
+                const XMMATRIX& globalInverseTransform
+                  Inverse transform of the root node
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT CookedModelWriter::Save(
+        _In_ const std::filesystem::path& cookedFilePath,
+        _In_ const std::filesystem::path& sourceFilePath,
+        _In_ UINT uLoadFlags,
+        _In_ UINT uMeshOptimizationFlags,
+        _In_ const XMMATRIX& globalInverseTransform
+    )
+    {
+        CookedModelHeader header =
+        {
+            .uMagic = CookedModel::MAGIC,
+            .uVersion = CookedModel::VERSION,
+            .uLoadFlags = uLoadFlags,
+            .uMeshOptimizationFlags = uMeshOptimizationFlags,
+            .uNumSections = static_cast<UINT>(eCookedSection::COUNT),
+            .uPadding = 0u,
+            .uSourceSize = 0u,
+            .sourceWriteTime = 0,
+            .globalInverseTransform = XMFLOAT4X4(),
+            .aSections = {}
+        };
+
+        HRESULT hr = CookedModel::GetSourceWriteTime(sourceFilePath, header.uSourceSize, header.sourceWriteTime);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        XMStoreFloat4x4(&header.globalInverseTransform, globalInverseTransform);
+
+        UINT64 uOffset = AlignSectionOffset(sizeof(CookedModelHeader));
+        for (size_t i = 0u; i < static_cast<size_t>(eCookedSection::COUNT); ++i)
+        {
+            header.aSections[i] =
+            {
+                .uOffset = uOffset,
+                .uSize = m_aSections[i].size()
+            };
+
+            uOffset = AlignSectionOffset(uOffset + m_aSections[i].size());
+        }
+
+        std::filesystem::path temporaryFilePath = cookedFilePath;
+        temporaryFilePath += L".tmp";
+
+        BOOL bIsWritten = FALSE;
+        {
+            std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                return E_ACCESSDENIED;
+            }
+
+            const CHAR aPadding[CookedModel::SECTION_ALIGNMENT] = {};
+
+            file.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+            UINT64 uWritten = sizeof(header);
+            for (size_t i = 0u; i < static_cast<size_t>(eCookedSection::COUNT); ++i)
+            {
+                file.write(aPadding, static_cast<std::streamsize>(header.aSections[i].uOffset - uWritten));
+                file.write(reinterpret_cast<const CHAR*>(m_aSections[i].data()), static_cast<std::streamsize>(m_aSections[i].size()));
+                uWritten = header.aSections[i].uOffset + m_aSections[i].size();
+            }
+
+            file.flush();
+            bIsWritten = file.good();
+        }
+
+        std::error_code errorCode;
+        if (bIsWritten)
+        {
+            std::filesystem::rename(temporaryFilePath, cookedFilePath, errorCode);
+        }
+
+        if (!bIsWritten || errorCode)
+        {
+            std::filesystem::remove(temporaryFilePath, errorCode);
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+}
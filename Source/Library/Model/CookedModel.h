@@ -0,0 +1,301 @@
+/*+===================================================================
+  File:      COOKEDMODEL.H
+
+  Summary:   CookedModel header file contains declarations of the
+             cooked model file format and of the classes CookedModel
+             and CookedModelWriter used to read and write it. A cooked
+             file holds the data Model builds from an assimp import, so
+             it can be loaded without importing the model again.
+
+  Classes:  CookedModel
+            CookedModelWriter
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <span>
+#include <string_view>
+
+namespace library
+{
+    enum class eCookedSection : UINT
+    {
+        VERTICES = 0,
+        NORMAL_DATA,
+        ANIMATION_DATA,
+        BONE_WEIGHT_ERRORS,
+        INDICES,
+        WIDE_INDICES,
+        MESHES,
+        MESHLETS,
+        MESHLET_BOUNDS,
+        MATERIALS,
+        BONE_OFFSETS,
+        BONE_NAMES,
+        JOINT_NAMES,
+        JOINT_PARENTS,
+        JOINT_BONES,
+        JOINT_BIND_SCALES,
+        JOINT_BIND_ROTATIONS,
+        JOINT_BIND_TRANSLATIONS,
+        JOINT_BIND_TRANSFORMS,
+        CLIPS,
+        TRACKS,
+        POSITION_TIMES,
+        POSITION_KEYS,
+        ROTATION_TIMES,
+        ROTATION_KEYS,
+        SCALING_TIMES,
+        SCALING_KEYS,
+        STRINGS,
+        COUNT,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   CookedString
+
+      Summary:  Characters of a string in the STRINGS section
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct CookedString
+    {
+        UINT uOffset;
+        UINT uLength;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   CookedMaterial
+
+      Summary:  Texture paths of a material relative to the model
+                directory, empty when the material has no such texture
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct CookedMaterial
+    {
+        CookedString diffuse;
+        CookedString specular;
+        CookedString normal;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   CookedClip
+
+      Summary:  Animation clip whose tracks are uNumTracks entries of the
+                TRACKS section starting at uFirstTrack
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct CookedClip
+    {
+        UINT64 uSourceSize;
+        FLOAT ticksPerSecond;
+        FLOAT durationTicks;
+        UINT uFirstTrack;
+        UINT uNumTracks;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   CookedTrack
+
+      Summary:  Ranges of the key sections holding the keys of a track.
+                Times and values of a key type share the same range.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct CookedTrack
+    {
+        UINT uFirstPositionKey;
+        UINT uNumPositionKeys;
+        UINT uFirstRotationKey;
+        UINT uNumRotationKeys;
+        UINT uFirstScalingKey;
+        UINT uNumScalingKeys;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   CookedSection
+
+      Summary:  Byte range of a section in the file
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct CookedSection
+    {
+        UINT64 uOffset;
+        UINT64 uSize;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   CookedModelHeader
+
+      Summary:  Start of a cooked file. The size and write time of the
+                source file, the import flags and the mesh optimization
+                flags tell whether the file is still up to date.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct CookedModelHeader
+    {
+        UINT uMagic;
+        UINT uVersion;
+        UINT uLoadFlags;
+        UINT uMeshOptimizationFlags;
+        UINT uNumSections;
+        UINT uPadding;
+        UINT64 uSourceSize;
+        INT64 sourceWriteTime;
+        XMFLOAT4X4 globalInverseTransform;
+        CookedSection aSections[static_cast<size_t>(eCookedSection::COUNT)];
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    CookedModel
+
+      Summary:  Read only view of a cooked file mapped in memory. The
+                sections are arrays of the engine types, so loading
+                copies them into the asset with no parsing beyond
+                checking the header.
+
+      Methods:  Open
+                  Maps the cooked file if it is up to date
+                Close
+                  Unmaps the file
+                GetHeader
+                  Returns the header
+                GetSection
+                  Returns a section as an array of elements
+                GetString
+                  Returns a string of the STRINGS section
+                GetCookedFilePath
+                  Returns the path of the cooked file of a model
+                GetSourceWriteTime
+                  Returns the last write time of a model file
+                CookedModel
+                  Constructor.
+                ~CookedModel
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class CookedModel
+    {
+    public:
+        static constexpr const UINT MAGIC = 0x4C444D43u; // "CMDL"
+        // Increase when the layout of a section or of an engine type stored in it changes
+        static constexpr const UINT VERSION = 6u;
+        static constexpr const UINT64 SECTION_ALIGNMENT = 16u;
+
+    public:
+        CookedModel();
+        CookedModel(const CookedModel& other) = delete;
+        CookedModel(CookedModel&& other) = delete;
+        CookedModel& operator=(const CookedModel& other) = delete;
+        CookedModel& operator=(CookedModel&& other) = delete;
+        virtual ~CookedModel();
+
+        HRESULT Open(
+            _In_ const std::filesystem::path& cookedFilePath,
+            _In_ const std::filesystem::path& sourceFilePath,
+            _In_ UINT uLoadFlags,
+            _In_ UINT uMeshOptimizationFlags
+        );
+        void Close();
+
+        const CookedModelHeader& GetHeader() const;
+        std::string_view GetString(_In_ const CookedString& string) const;
+
+        template <class T>
+        std::span<const T> GetSection(_In_ eCookedSection section) const;
+
+        static std::filesystem::path GetCookedFilePath(_In_ const std::filesystem::path& sourceFilePath);
+        static HRESULT GetSourceWriteTime(_In_ const std::filesystem::path& sourceFilePath, _Out_ UINT64& uOutSize, _Out_ INT64& outWriteTime);
+
+    private:
+        HANDLE m_hFile;
+        HANDLE m_hMapping;
+        const BYTE* m_pView;
+        UINT64 m_uSize;
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModel::GetSection
+
+      Summary:  Returns a section as an array of elements pointing into
+                the mapped file
+
+      Args:     eCookedSection section
+                  Section to return
+
+      Returns:  std::span<const T>
+                  Elements of the section, empty if the file is not open
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class T>
+    std::span<const T> CookedModel::GetSection(_In_ eCookedSection section) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Cooked sections only hold trivially copyable types");
+
+        if (!m_pView)
+        {
+            return std::span<const T>();
+        }
+
+        const CookedSection& range = GetHeader().aSections[static_cast<size_t>(section)];
+
+        return std::span<const T>(reinterpret_cast<const T*>(m_pView + range.uOffset), static_cast<size_t>(range.uSize / sizeof(T)));
+    }
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    CookedModelWriter
+
+      Summary:  Collects the sections of a cooked file and writes them
+                after the header, each aligned to SECTION_ALIGNMENT
+
+      Methods:  AddSection
+                  Sets the content of a section
+                AddString
+                  Appends a string to the STRINGS section
+                Save
+                  Writes the cooked file
+                CookedModelWriter
+                  Constructor.
+                ~CookedModelWriter
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class CookedModelWriter
+    {
+    public:
+        CookedModelWriter();
+        CookedModelWriter(const CookedModelWriter& other) = delete;
+        CookedModelWriter(CookedModelWriter&& other) = delete;
+        CookedModelWriter& operator=(const CookedModelWriter& other) = delete;
+        CookedModelWriter& operator=(CookedModelWriter&& other) = delete;
+        virtual ~CookedModelWriter() = default;
+
+        template <class T>
+        void AddSection(_In_ eCookedSection section, _In_ const std::vector<T>& aElements);
+        CookedString AddString(_In_ std::string_view string);
+
+        HRESULT Save(
+            _In_ const std::filesystem::path& cookedFilePath,
+            _In_ const std::filesystem::path& sourceFilePath,
+            _In_ UINT uLoadFlags,
+            _In_ UINT uMeshOptimizationFlags,
+            _In_ const XMMATRIX& globalInverseTransform
+        );
+
+    private:
+        std::vector<BYTE> m_aSections[static_cast<size_t>(eCookedSection::COUNT)];
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CookedModelWriter::AddSection
+
+      Summary:  Sets the content of a section to the given elements
+
+      Args:     eCookedSection section
+                  Section to set
+                const std::vector<T>& aElements
+                  Elements to store
+
+      Modifies: [m_aSections].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class T>
+    void CookedModelWriter::AddSection(_In_ eCookedSection section, _In_ const std::vector<T>& aElements)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Cooked sections only hold trivially copyable types");
+
+        const BYTE* pBytes = reinterpret_cast<const BYTE*>(aElements.data());
+        m_aSections[static_cast<size_t>(section)].assign(pBytes, pBytes + sizeof(T) * aElements.size());
+    }
+}
@@ -0,0 +1,357 @@
+#include "Model/ImportProfiler.h"
+
+#include <mutex>
+
+namespace library
+{
+    thread_local UINT64 ImportProfiler::sm_uNumAllocations = 0u;
+    thread_local UINT64 ImportProfiler::sm_uNumAllocatedBytes = 0u;
+    std::atomic<eImportVerbosity> ImportProfiler::sm_verbosity(eImportVerbosity::SUMMARY);
+
+#ifdef _DEBUG
+    static _CRT_ALLOC_HOOK s_pfnPreviousAllocHook = nullptr;
+#endif
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::ImportProfiler
+
+      Summary:  Constructor
+
+      Modifies: [m_frequency, m_aStartingTimes, m_aStartingAllocations,
+                 m_aStartingAllocatedBytes, m_aStages].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ImportProfiler::ImportProfiler() :
+        m_frequency(),
+        m_aStartingTimes(),
+        m_aStartingAllocations(),
+        m_aStartingAllocatedBytes(),
+        m_aStages()
+    {
+        QueryPerformanceFrequency(&m_frequency);
+        installAllocationHook();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::BeginStage
+
+      Summary:  Starts timing a stage
+
+      Args:     eImportStage stage
+                  Stage to time
+
+      Modifies: [m_aStartingTimes, m_aStartingAllocations,
+                 m_aStartingAllocatedBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ImportProfiler::BeginStage(_In_ eImportStage stage)
+    {
+        const size_t uStage = static_cast<size_t>(stage);
+
+        m_aStartingAllocations[uStage] = sm_uNumAllocations;
+        m_aStartingAllocatedBytes[uStage] = sm_uNumAllocatedBytes;
+        QueryPerformanceCounter(&m_aStartingTimes[uStage]);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::EndStage
+
+      Summary:  Stops timing a stage and adds the time and allocations
+                since BeginStage to its statistics
+
+      Args:     eImportStage stage
+                  Stage to stop
+
+      Modifies: [m_aStages].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ImportProfiler::EndStage(_In_ eImportStage stage)
+    {
+        LARGE_INTEGER endingTime;
+        QueryPerformanceCounter(&endingTime);
+
+        const size_t uStage = static_cast<size_t>(stage);
+        ImportStageStatistics& statistics = m_aStages[uStage];
+
+        statistics.time += static_cast<DOUBLE>(endingTime.QuadPart - m_aStartingTimes[uStage].QuadPart) * 1000.0 / static_cast<DOUBLE>(m_frequency.QuadPart);
+        statistics.uNumAllocations += sm_uNumAllocations - m_aStartingAllocations[uStage];
+        statistics.uNumAllocatedBytes += sm_uNumAllocatedBytes - m_aStartingAllocatedBytes[uStage];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::Reset
+
+      Summary:  Clears the statistics of every stage
+
+      Modifies: [m_aStages].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ImportProfiler::Reset()
+    {
+        for (ImportStageStatistics& statistics : m_aStages)
+        {
+            statistics = ImportStageStatistics{ .time = 0.0, .uNumAllocations = 0u, .uNumAllocatedBytes = 0u };
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::GetStageStatistics
+
+      Summary:  Returns the statistics of a stage
+
+      Args:     eImportStage stage
+                  Stage to return
+
+      Returns:  const ImportStageStatistics&
+                  Time and allocations of the stage
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const ImportStageStatistics& ImportProfiler::GetStageStatistics(_In_ eImportStage stage) const
+    {
+        return m_aStages[static_cast<size_t>(stage)];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::Report
+
+      Summary:  Writes the import report to the debug output. SUMMARY
+                writes the totals on one line, STAGES adds one line per
+                stage that ran.
+
+      Args:     PCSTR pszAssetName
+                  Name of the imported file
+                BOOL bIsCooked
+                  TRUE if the asset was loaded from its cooked file
+                DOUBLE totalTime
+                  Time in milliseconds of the whole load, including the
+                  work outside the stages
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ImportProfiler::Report(_In_ PCSTR pszAssetName, _In_ BOOL bIsCooked, _In_ DOUBLE totalTime) const
+    {
+        const eImportVerbosity verbosity = GetVerbosity();
+        if (verbosity == eImportVerbosity::SILENT)
+        {
+            return;
+        }
+
+        ImportStageStatistics total = { .time = totalTime, .uNumAllocations = 0u, .uNumAllocatedBytes = 0u };
+        for (const ImportStageStatistics& statistics : m_aStages)
+        {
+            total.uNumAllocations += statistics.uNumAllocations;
+            total.uNumAllocatedBytes += statistics.uNumAllocatedBytes;
+        }
+
+        CHAR szDebugMessage[256];
+        if (CountsAllocations())
+        {
+            sprintf_s(szDebugMessage, "import-report %s (%s): %.3f ms, %llu allocations, %llu bytes\n",
+                pszAssetName,
+                bIsCooked ? "cooked" : "imported",
+                total.time,
+                total.uNumAllocations,
+                total.uNumAllocatedBytes);
+        }
+        else
+        {
+            sprintf_s(szDebugMessage, "import-report %s (%s): %.3f ms\n",
+                pszAssetName,
+                bIsCooked ? "cooked" : "imported",
+                total.time);
+        }
+        OutputDebugStringA(szDebugMessage);
+
+        if (verbosity < eImportVerbosity::STAGES)
+        {
+            return;
+        }
+
+        for (UINT i = 0u; i < static_cast<UINT>(eImportStage::COUNT); ++i)
+        {
+            const ImportStageStatistics& statistics = m_aStages[i];
+            if (statistics.time == 0.0 && statistics.uNumAllocations == 0u)
+            {
+                continue;
+            }
+
+            if (CountsAllocations())
+            {
+                sprintf_s(szDebugMessage, "    %-16s %10.3f ms %10llu allocations %12llu bytes\n",
+                    GetStageName(static_cast<eImportStage>(i)),
+                    statistics.time,
+                    statistics.uNumAllocations,
+                    statistics.uNumAllocatedBytes);
+            }
+            else
+            {
+                sprintf_s(szDebugMessage, "    %-16s %10.3f ms\n",
+                    GetStageName(static_cast<eImportStage>(i)),
+                    statistics.time);
+            }
+            OutputDebugStringA(szDebugMessage);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::GetStageName
+
+      Summary:  Returns the name of a stage used in the report
+
+      Args:     eImportStage stage
+                  Stage to name
+
+      Returns:  PCSTR
+                  Name of the stage
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PCSTR ImportProfiler::GetStageName(_In_ eImportStage stage)
+    {
+        switch (stage)
+        {
+        case eImportStage::READ:
+            return "read";
+        case eImportStage::COUNT_ELEMENTS:
+            return "count";
+        case eImportStage::MESH_FILL:
+            return "mesh fill";
+        case eImportStage::BONE_BINNING:
+            return "bone binning";
+        case eImportStage::MESH_PROCESSING:
+            return "mesh processing";
+        case eImportStage::MATERIALS:
+            return "materials";
+        case eImportStage::TANGENTS:
+            return "tangents";
+        case eImportStage::GPU_UPLOAD:
+            return "gpu upload";
+        default:
+            return "unknown";
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::CountsAllocations
+
+      Summary:  Returns whether heap allocations are counted
+
+      Returns:  BOOL
+                  TRUE in debug builds, where the allocation hook exists
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL ImportProfiler::CountsAllocations()
+    {
+#ifdef _DEBUG
+        return TRUE;
+#else
+        return FALSE;
+#endif
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::SetVerbosity
+
+      Summary:  Sets how much of the report is written for every import
+                that follows
+
+      Args:     eImportVerbosity verbosity
+                  SILENT, SUMMARY or STAGES
+
+      Modifies: [sm_verbosity].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ImportProfiler::SetVerbosity(_In_ eImportVerbosity verbosity)
+    {
+        sm_verbosity.store(verbosity);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::GetVerbosity
+
+      Summary:  Returns how much of the report is written
+
+      Returns:  eImportVerbosity
+                  Current verbosity
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eImportVerbosity ImportProfiler::GetVerbosity()
+    {
+        return sm_verbosity.load();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::installAllocationHook
+
+      Summary:  Installs countAllocation as the debug CRT allocation hook
+                the first time a profiler is created, keeping the hook
+                that was installed before it
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ImportProfiler::installAllocationHook()
+    {
+#ifdef _DEBUG
+        static std::once_flag s_installFlag;
+        std::call_once(s_installFlag,
+            []()
+            {
+                s_pfnPreviousAllocHook = _CrtSetAllocHook(countAllocation);
+            }
+        );
+#endif
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImportProfiler::countAllocation
+
+      Summary:  Debug CRT allocation hook counting the allocations and
+                reallocations of client blocks made by the calling
+                thread
+
+      Args:     int allocType
+                  _HOOK_ALLOC, _HOOK_REALLOC or _HOOK_FREE
+                void* pUserData
+                  Block being freed
+                size_t uSize
+                  Size of the allocation in bytes
+                int blockType
+                  Type of the block
+                long requestNumber
+                  Order of the allocation
+                const unsigned char* pszFileName
+                  File of the allocation, if known
+                int lineNumber
+                  Line of the allocation, if known
+
+      Modifies: [sm_uNumAllocations, sm_uNumAllocatedBytes].
+
+      Returns:  int
+                  TRUE to let the allocation proceed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    int __cdecl ImportProfiler::countAllocation(
+        _In_ int allocType,
+        _In_opt_ void* pUserData,
+        _In_ size_t uSize,
+        _In_ int blockType,
+        _In_ long requestNumber,
+        _In_opt_ const unsigned char* pszFileName,
+        _In_ int lineNumber
+    )
+    {
+#ifdef _DEBUG
+        // Blocks of the CRT itself must not be touched by a hook
+        if (blockType == _CRT_BLOCK)
+        {
+            return TRUE;
+        }
+
+        if (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC)
+        {
+            ++sm_uNumAllocations;
+            sm_uNumAllocatedBytes += uSize;
+        }
+
+        if (s_pfnPreviousAllocHook)
+        {
+            return s_pfnPreviousAllocHook(allocType, pUserData, uSize, blockType, requestNumber, pszFileName, lineNumber);
+        }
+#else
+        UNREFERENCED_PARAMETER(allocType);
+        UNREFERENCED_PARAMETER(pUserData);
+        UNREFERENCED_PARAMETER(uSize);
+        UNREFERENCED_PARAMETER(blockType);
+        UNREFERENCED_PARAMETER(requestNumber);
+        UNREFERENCED_PARAMETER(pszFileName);
+        UNREFERENCED_PARAMETER(lineNumber);
+#endif
+
+        return TRUE;
+    }
+}
@@ -0,0 +1,133 @@
+/*+===================================================================
+  File:      IMPORTPROFILER.H
+
+  Summary:   ImportProfiler header file contains declaration of class
+             ImportProfiler used to time the stages of a model import
+             and count the heap allocations made during each of them.
+
+  Classes:  ImportProfiler
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+
+namespace library
+{
+    enum class eImportStage : UINT
+    {
+        READ = 0,
+        COUNT_ELEMENTS,
+        MESH_FILL,
+        BONE_BINNING,
+        MESH_PROCESSING,
+        MATERIALS,
+        TANGENTS,
+        GPU_UPLOAD,
+        COUNT,
+    };
+
+    enum class eImportVerbosity : UINT
+    {
+        SILENT = 0,
+        SUMMARY,
+        STAGES,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ImportStageStatistics
+
+      Summary:  CPU time in milliseconds, heap allocations and bytes
+                allocated during a stage, summed over every time the
+                stage ran
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ImportStageStatistics
+    {
+        DOUBLE time;
+        UINT64 uNumAllocations;
+        UINT64 uNumAllocatedBytes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ImportProfiler
+
+      Summary:  Times the stages of the import of one model. Heap
+                allocations are counted through the debug CRT allocation
+                hook, so they are only available in debug builds. They
+                are counted per thread and only include the allocations
+                of the thread running the import, not those of other
+                imports running at the same time, nor those made by the
+                parallel algorithms a stage hands its work to.
+
+      Methods:  BeginStage
+                  Starts timing a stage
+                EndStage
+                  Stops timing a stage and adds its statistics
+                Reset
+                  Clears the statistics of every stage
+                GetStageStatistics
+                  Returns the statistics of a stage
+                Report
+                  Writes the import report to the debug output
+                GetStageName
+                  Returns the name of a stage
+                CountsAllocations
+                  Returns whether heap allocations are counted
+                SetVerbosity
+                  Sets how much of the report is written
+                GetVerbosity
+                  Returns how much of the report is written
+                ImportProfiler
+                  Constructor.
+                ~ImportProfiler
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ImportProfiler
+    {
+    public:
+        ImportProfiler();
+        ImportProfiler(const ImportProfiler& other) = delete;
+        ImportProfiler(ImportProfiler&& other) = delete;
+        ImportProfiler& operator=(const ImportProfiler& other) = delete;
+        ImportProfiler& operator=(ImportProfiler&& other) = delete;
+        virtual ~ImportProfiler() = default;
+
+        void BeginStage(_In_ eImportStage stage);
+        void EndStage(_In_ eImportStage stage);
+        void Reset();
+        const ImportStageStatistics& GetStageStatistics(_In_ eImportStage stage) const;
+        void Report(_In_ PCSTR pszAssetName, _In_ BOOL bIsCooked, _In_ DOUBLE totalTime) const;
+
+        static PCSTR GetStageName(_In_ eImportStage stage);
+        static BOOL CountsAllocations();
+        static void SetVerbosity(_In_ eImportVerbosity verbosity);
+        static eImportVerbosity GetVerbosity();
+
+    private:
+        static void installAllocationHook();
+        static int __cdecl countAllocation(
+            _In_ int allocType,
+            _In_opt_ void* pUserData,
+            _In_ size_t uSize,
+            _In_ int blockType,
+            _In_ long requestNumber,
+            _In_opt_ const unsigned char* pszFileName,
+            _In_ int lineNumber
+        );
+
+    private:
+        static thread_local UINT64 sm_uNumAllocations;
+        static thread_local UINT64 sm_uNumAllocatedBytes;
+        static std::atomic<eImportVerbosity> sm_verbosity;
+
+    private:
+        LARGE_INTEGER m_frequency;
+        LARGE_INTEGER m_aStartingTimes[static_cast<size_t>(eImportStage::COUNT)];
+        UINT64 m_aStartingAllocations[static_cast<size_t>(eImportStage::COUNT)];
+        UINT64 m_aStartingAllocatedBytes[static_cast<size_t>(eImportStage::COUNT)];
+        ImportStageStatistics m_aStages[static_cast<size_t>(eImportStage::COUNT)];
+    };
+}
@@ -0,0 +1,533 @@
+#include "Model/MeshOptimizer.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::OptimizeVertexCache
+
+      Summary:  Reorders the triangles with Forsyth's linear speed
+                vertex cache optimization. Each step emits the triangle
+                whose vertices score highest, where vertices score for
+                being recently used in a modeled LRU cache and for
+                having few triangles left, so that no vertex is left
+                behind to be transformed again later.
+
+      Args:     UINT* aIndices
+                  Triangle list indices of the mesh
+                UINT uNumIndices
+                  Number of indices
+                UINT uNumVertices
+                  Number of vertices of the mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::OptimizeVertexCache(_Inout_updates_(uNumIndices) UINT* aIndices, _In_ UINT uNumIndices, _In_ UINT uNumVertices)
+    {
+        const UINT uNumTriangles = uNumIndices / 3u;
+        if (uNumTriangles == 0u)
+        {
+            return;
+        }
+
+        // Triangles adjacent to each vertex, the first aNumRemainingTriangles
+        // entries of a vertex are the triangles not emitted yet
+        std::vector<UINT> aNumRemainingTriangles(uNumVertices, 0u);
+        for (UINT i = 0u; i < uNumTriangles * 3u; ++i)
+        {
+            assert(aIndices[i] < uNumVertices);
+            ++aNumRemainingTriangles[aIndices[i]];
+        }
+
+        std::vector<UINT> aAdjacencyOffsets(uNumVertices + 1u, 0u);
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            aAdjacencyOffsets[i + 1u] = aAdjacencyOffsets[i] + aNumRemainingTriangles[i];
+        }
+
+        std::vector<UINT> aAdjacency(uNumTriangles * 3u);
+        std::vector<UINT> aFillOffsets(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end() - 1);
+        for (UINT i = 0u; i < uNumTriangles * 3u; ++i)
+        {
+            aAdjacency[aFillOffsets[aIndices[i]]++] = i / 3u;
+        }
+
+        std::vector<FLOAT> aVertexScores(uNumVertices);
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            aVertexScores[i] = computeVertexScore(-1, aNumRemainingTriangles[i]);
+        }
+
+        std::vector<BYTE> aIsEmitted(uNumTriangles, 0u);
+        UINT uBestTriangle = 0u;
+        FLOAT bestScore = -FLT_MAX;
+        for (UINT i = 0u; i < uNumTriangles; ++i)
+        {
+            const FLOAT score = aVertexScores[aIndices[i * 3u]] + aVertexScores[aIndices[i * 3u + 1u]] + aVertexScores[aIndices[i * 3u + 2u]];
+            if (score > bestScore)
+            {
+                bestScore = score;
+                uBestTriangle = i;
+            }
+        }
+
+        std::vector<UINT> aOptimizedIndices;
+        aOptimizedIndices.reserve(uNumTriangles * 3u);
+
+        UINT aCache[VERTEX_CACHE_SIZE + 3u] = { 0u, };
+        UINT aNewCache[VERTEX_CACHE_SIZE + 3u] = { 0u, };
+        UINT uCacheSize = 0u;
+        UINT uScanCursor = 0u;
+
+        for (UINT uNumEmitted = 0u; uNumEmitted < uNumTriangles; ++uNumEmitted)
+        {
+            // No triangle touches the cache, restart from the next triangle left
+            if (uBestTriangle == UINT_MAX)
+            {
+                while (aIsEmitted[uScanCursor])
+                {
+                    ++uScanCursor;
+                }
+                uBestTriangle = uScanCursor;
+            }
+
+            const UINT aTriangle[3] =
+            {
+                aIndices[uBestTriangle * 3u],
+                aIndices[uBestTriangle * 3u + 1u],
+                aIndices[uBestTriangle * 3u + 2u],
+            };
+
+            aOptimizedIndices.insert(aOptimizedIndices.end(), aTriangle, aTriangle + 3);
+            aIsEmitted[uBestTriangle] = 1u;
+
+            // The vertices of the emitted triangle move to the front of the cache
+            UINT uNewCacheSize = 0u;
+            for (UINT k = 0u; k < 3u; ++k)
+            {
+                const UINT uVertex = aTriangle[k];
+
+                UINT* pAdjacencyBegin = aAdjacency.data() + aAdjacencyOffsets[uVertex];
+                UINT* pAdjacencyEnd = pAdjacencyBegin + aNumRemainingTriangles[uVertex];
+                UINT* pTriangle = std::find(pAdjacencyBegin, pAdjacencyEnd, uBestTriangle);
+                assert(pTriangle != pAdjacencyEnd);
+                *pTriangle = *(pAdjacencyEnd - 1);
+                --aNumRemainingTriangles[uVertex];
+
+                if (std::find(aNewCache, aNewCache + uNewCacheSize, uVertex) == aNewCache + uNewCacheSize)
+                {
+                    aNewCache[uNewCacheSize++] = uVertex;
+                }
+            }
+
+            for (UINT i = 0u; i < uCacheSize; ++i)
+            {
+                const UINT uVertex = aCache[i];
+                if (uVertex != aTriangle[0] && uVertex != aTriangle[1] && uVertex != aTriangle[2])
+                {
+                    aNewCache[uNewCacheSize++] = uVertex;
+                }
+            }
+
+            // Vertices pushed past the end of the cache are rescored as evicted
+            for (UINT i = 0u; i < uNewCacheSize; ++i)
+            {
+                const INT iCachePosition = i < VERTEX_CACHE_SIZE ? static_cast<INT>(i) : -1;
+                aVertexScores[aNewCache[i]] = computeVertexScore(iCachePosition, aNumRemainingTriangles[aNewCache[i]]);
+            }
+
+            uCacheSize = std::min(uNewCacheSize, VERTEX_CACHE_SIZE);
+            std::copy(aNewCache, aNewCache + uCacheSize, aCache);
+
+            // Only triangles sharing a vertex with the cache change their score
+            uBestTriangle = UINT_MAX;
+            bestScore = -FLT_MAX;
+            for (UINT i = 0u; i < uNewCacheSize; ++i)
+            {
+                const UINT uVertex = aNewCache[i];
+                const UINT* pAdjacency = aAdjacency.data() + aAdjacencyOffsets[uVertex];
+
+                for (UINT j = 0u; j < aNumRemainingTriangles[uVertex]; ++j)
+                {
+                    const UINT uTriangle = pAdjacency[j];
+                    const FLOAT score = aVertexScores[aIndices[uTriangle * 3u]]
+                        + aVertexScores[aIndices[uTriangle * 3u + 1u]]
+                        + aVertexScores[aIndices[uTriangle * 3u + 2u]];
+
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        uBestTriangle = uTriangle;
+                    }
+                }
+            }
+        }
+
+        std::copy(aOptimizedIndices.begin(), aOptimizedIndices.end(), aIndices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::OptimizeOverdraw
+
+      Summary:  Splits the cache optimized triangles into clusters and
+                draws the clusters facing away from the center of the
+                mesh first, so they tend to occlude the ones behind
+                them. Clusters start where the FIFO cache flushes, and
+                are split further wherever the ACMR so far is within
+                threshold of the whole cluster, which bounds the cache
+                efficiency lost by reordering them.
+
+      Args:     UINT* aIndices
+                  Cache optimized triangle list indices of the mesh
+                UINT uNumIndices
+                  Number of indices
+                const SimpleVertex* aVertices
+                  Vertices of the mesh
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                FLOAT threshold
+                  Allowed ACMR ratio, OVERDRAW_THRESHOLD by default
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::OptimizeOverdraw(
+        _Inout_updates_(uNumIndices) UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_ UINT uNumVertices,
+        _In_ FLOAT threshold
+    )
+    {
+        const UINT uNumTriangles = uNumIndices / 3u;
+        if (uNumTriangles < 2u)
+        {
+            return;
+        }
+
+        std::vector<UINT> aTimestamps(uNumVertices, 0u);
+        UINT uTimestamp = FIFO_CACHE_SIZE + 1u;
+
+        // Hard boundaries where all three vertices miss the cache
+        std::vector<UINT> aHardBoundaries;
+        for (UINT i = 0u; i < uNumTriangles; ++i)
+        {
+            if (updateFifoCache(aIndices + i * 3u, aTimestamps, uTimestamp) == 3u || i == 0u)
+            {
+                aHardBoundaries.push_back(i);
+            }
+        }
+        aHardBoundaries.push_back(uNumTriangles);
+
+        std::vector<UINT> aBoundaries;
+        for (size_t c = 0; c + 1 < aHardBoundaries.size(); ++c)
+        {
+            const UINT uStart = aHardBoundaries[c];
+            const UINT uEnd = aHardBoundaries[c + 1];
+
+            // Moving the time past every entry empties the cache without clearing the timestamps
+            uTimestamp += FIFO_CACHE_SIZE + 1u;
+
+            UINT uNumClusterMisses = 0u;
+            for (UINT i = uStart; i < uEnd; ++i)
+            {
+                uNumClusterMisses += updateFifoCache(aIndices + i * 3u, aTimestamps, uTimestamp);
+            }
+            const FLOAT clusterThreshold = threshold * static_cast<FLOAT>(uNumClusterMisses) / static_cast<FLOAT>(uEnd - uStart);
+
+            uTimestamp += FIFO_CACHE_SIZE + 1u;
+
+            aBoundaries.push_back(uStart);
+
+            UINT uNumRunningMisses = 0u;
+            UINT uNumRunningTriangles = 0u;
+            for (UINT i = uStart; i < uEnd; ++i)
+            {
+                uNumRunningMisses += updateFifoCache(aIndices + i * 3u, aTimestamps, uTimestamp);
+                ++uNumRunningTriangles;
+
+                if (i + 1u < uEnd && static_cast<FLOAT>(uNumRunningMisses) / static_cast<FLOAT>(uNumRunningTriangles) <= clusterThreshold)
+                {
+                    aBoundaries.push_back(i + 1u);
+
+                    uTimestamp += FIFO_CACHE_SIZE + 1u;
+                    uNumRunningMisses = 0u;
+                    uNumRunningTriangles = 0u;
+                }
+            }
+        }
+        aBoundaries.push_back(uNumTriangles);
+
+        // Area weighted centroid of the mesh and of each cluster
+        const size_t uNumClusters = aBoundaries.size() - 1;
+        std::vector<XMFLOAT3> aClusterCentroids(uNumClusters, XMFLOAT3(0.0f, 0.0f, 0.0f));
+        std::vector<XMFLOAT3> aClusterNormals(uNumClusters, XMFLOAT3(0.0f, 0.0f, 0.0f));
+        XMVECTOR meshCentroid = XMVectorZero();
+        FLOAT meshArea = 0.0f;
+
+        for (size_t c = 0; c < uNumClusters; ++c)
+        {
+            XMVECTOR clusterCentroid = XMVectorZero();
+            XMVECTOR clusterNormal = XMVectorZero();
+            FLOAT clusterArea = 0.0f;
+
+            for (UINT i = aBoundaries[c]; i < aBoundaries[c + 1]; ++i)
+            {
+                const XMVECTOR p0 = XMLoadFloat3(&aVertices[aIndices[i * 3u]].Position);
+                const XMVECTOR p1 = XMLoadFloat3(&aVertices[aIndices[i * 3u + 1u]].Position);
+                const XMVECTOR p2 = XMLoadFloat3(&aVertices[aIndices[i * 3u + 2u]].Position);
+
+                // Twice the area weighted normal of the triangle
+                const XMVECTOR normal = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+                const FLOAT area = XMVectorGetX(XMVector3Length(normal));
+                const XMVECTOR centroid = XMVectorScale(XMVectorAdd(XMVectorAdd(p0, p1), p2), 1.0f / 3.0f);
+
+                clusterCentroid = XMVectorAdd(clusterCentroid, XMVectorScale(centroid, area));
+                clusterNormal = XMVectorAdd(clusterNormal, normal);
+                clusterArea += area;
+            }
+
+            meshCentroid = XMVectorAdd(meshCentroid, clusterCentroid);
+            meshArea += clusterArea;
+
+            XMStoreFloat3(&aClusterCentroids[c], clusterArea > 0.0f ? XMVectorScale(clusterCentroid, 1.0f / clusterArea) : clusterCentroid);
+            XMStoreFloat3(&aClusterNormals[c], XMVector3Normalize(clusterNormal));
+        }
+
+        if (meshArea > 0.0f)
+        {
+            meshCentroid = XMVectorScale(meshCentroid, 1.0f / meshArea);
+        }
+
+        std::vector<FLOAT> aSortKeys(uNumClusters);
+        for (size_t c = 0; c < uNumClusters; ++c)
+        {
+            const XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&aClusterCentroids[c]), meshCentroid);
+            aSortKeys[c] = XMVectorGetX(XMVector3Dot(offset, XMLoadFloat3(&aClusterNormals[c])));
+        }
+
+        std::vector<UINT> aClusterOrder(uNumClusters);
+        for (size_t c = 0; c < uNumClusters; ++c)
+        {
+            aClusterOrder[c] = static_cast<UINT>(c);
+        }
+        std::stable_sort(aClusterOrder.begin(), aClusterOrder.end(),
+            [&aSortKeys](UINT uLeft, UINT uRight) { return aSortKeys[uLeft] > aSortKeys[uRight]; });
+
+        std::vector<UINT> aSortedIndices;
+        aSortedIndices.reserve(uNumTriangles * 3u);
+        for (UINT uCluster : aClusterOrder)
+        {
+            aSortedIndices.insert(aSortedIndices.end(), aIndices + aBoundaries[uCluster] * 3u, aIndices + aBoundaries[uCluster + 1] * 3u);
+        }
+
+        std::copy(aSortedIndices.begin(), aSortedIndices.end(), aIndices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::OptimizeVertexFetch
+
+      Summary:  Numbers the vertices in the order the indices first use
+                them, so the vertex fetches of consecutive triangles
+                read neighboring memory. Unused vertices are numbered
+                last so the vertex count does not change.
+
+      Args:     const UINT* aIndices
+                  Triangle list indices of the mesh
+                UINT uNumIndices
+                  Number of indices
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                std::vector<UINT>& aOutRemap
+                  New index of each vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::OptimizeVertexFetch(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _Out_ std::vector<UINT>& aOutRemap
+    )
+    {
+        aOutRemap.assign(uNumVertices, UINT_MAX);
+
+        UINT uNextVertex = 0u;
+        for (UINT i = 0u; i < uNumIndices; ++i)
+        {
+            if (aOutRemap[aIndices[i]] == UINT_MAX)
+            {
+                aOutRemap[aIndices[i]] = uNextVertex++;
+            }
+        }
+
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            if (aOutRemap[i] == UINT_MAX)
+            {
+                aOutRemap[i] = uNextVertex++;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::RemapIndices
+
+      Summary:  Replaces each index with the new index of its vertex
+
+      Args:     UINT* aIndices
+                  Triangle list indices of the mesh
+                UINT uNumIndices
+                  Number of indices
+                const std::vector<UINT>& aRemap
+                  New index of each vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::RemapIndices(_Inout_updates_(uNumIndices) UINT* aIndices, _In_ UINT uNumIndices, _In_ const std::vector<UINT>& aRemap)
+    {
+        for (UINT i = 0u; i < uNumIndices; ++i)
+        {
+            aIndices[i] = aRemap[aIndices[i]];
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::AnalyzeVertexCache
+
+      Summary:  Simulates a FIFO post-transform cache of the given size
+                over the indices
+
+      Args:     const UINT* aIndices
+                  Triangle list indices of the mesh
+                UINT uNumIndices
+                  Number of indices
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                UINT uCacheSize
+                  Number of vertices the cache holds
+
+      Returns:  VertexCacheStatistics
+                  Transformed vertices, ACMR and ATVR
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uNumVertices,
+        _In_ UINT uCacheSize
+    )
+    {
+        VertexCacheStatistics statistics =
+        {
+            .uNumTransformedVertices = 0u,
+            .uNumReferencedVertices = 0u,
+            .uNumTriangles = uNumIndices / 3u,
+            .acmr = 0.0f,
+            .atvr = 0.0f
+        };
+
+        std::vector<UINT> aTimestamps(uNumVertices, 0u);
+        UINT uTimestamp = uCacheSize + 1u;
+
+        for (UINT i = 0u; i < statistics.uNumTriangles * 3u; ++i)
+        {
+            const UINT uVertex = aIndices[i];
+
+            if (aTimestamps[uVertex] == 0u)
+            {
+                ++statistics.uNumReferencedVertices;
+            }
+
+            if (uTimestamp - aTimestamps[uVertex] > uCacheSize)
+            {
+                aTimestamps[uVertex] = uTimestamp++;
+                ++statistics.uNumTransformedVertices;
+            }
+        }
+
+        if (statistics.uNumTriangles > 0u)
+        {
+            statistics.acmr = static_cast<FLOAT>(statistics.uNumTransformedVertices) / static_cast<FLOAT>(statistics.uNumTriangles);
+        }
+
+        if (statistics.uNumReferencedVertices > 0u)
+        {
+            statistics.atvr = static_cast<FLOAT>(statistics.uNumTransformedVertices) / static_cast<FLOAT>(statistics.uNumReferencedVertices);
+        }
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::computeVertexScore
+
+      Summary:  Scores a vertex for Forsyth's algorithm. The vertices of
+                the last triangle get a fixed score so the next triangle
+                does not simply reuse an edge, older cache entries decay,
+                and vertices with few triangles left are boosted.
+
+      Args:     INT iCachePosition
+                  Position in the modeled LRU cache, -1 if not cached
+                UINT uNumRemainingTriangles
+                  Number of triangles of the vertex not emitted yet
+
+      Returns:  FLOAT
+                  Score of the vertex, -1 if it has no triangle left
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT MeshOptimizer::computeVertexScore(_In_ INT iCachePosition, _In_ UINT uNumRemainingTriangles)
+    {
+        constexpr FLOAT CACHE_DECAY_POWER = 1.5f;
+        constexpr FLOAT LAST_TRIANGLE_SCORE = 0.75f;
+        constexpr FLOAT VALENCE_BOOST_SCALE = 2.0f;
+        constexpr FLOAT VALENCE_BOOST_POWER = 0.5f;
+
+        if (uNumRemainingTriangles == 0u)
+        {
+            return -1.0f;
+        }
+
+        FLOAT score = 0.0f;
+        if (iCachePosition >= 0)
+        {
+            if (iCachePosition < 3)
+            {
+                score = LAST_TRIANGLE_SCORE;
+            }
+            else
+            {
+                const FLOAT scaler = 1.0f / static_cast<FLOAT>(VERTEX_CACHE_SIZE - 3u);
+                score = powf(1.0f - static_cast<FLOAT>(iCachePosition - 3) * scaler, CACHE_DECAY_POWER);
+            }
+        }
+
+        score += VALENCE_BOOST_SCALE * powf(static_cast<FLOAT>(uNumRemainingTriangles), -VALENCE_BOOST_POWER);
+
+        return score;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::updateFifoCache
+
+      Summary:  Adds a triangle to a FIFO cache of FIFO_CACHE_SIZE
+                vertices kept as the time each vertex entered it
+
+      Args:     const UINT* aTriangle
+                  Indices of the triangle
+                std::vector<UINT>& aTimestamps
+                  Time each vertex entered the cache, 0 if never
+                UINT& uTimestamp
+                  Time of the next vertex to enter the cache
+
+      Returns:  UINT
+                  Number of vertices of the triangle missing the cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT MeshOptimizer::updateFifoCache(
+        _In_reads_(3) const UINT* aTriangle,
+        _Inout_ std::vector<UINT>& aTimestamps,
+        _Inout_ UINT& uTimestamp
+    )
+    {
+        UINT uNumMisses = 0u;
+
+        for (UINT k = 0u; k < 3u; ++k)
+        {
+            if (uTimestamp - aTimestamps[aTriangle[k]] > FIFO_CACHE_SIZE)
+            {
+                aTimestamps[aTriangle[k]] = uTimestamp++;
+                ++uNumMisses;
+            }
+        }
+
+        return uNumMisses;
+    }
+}
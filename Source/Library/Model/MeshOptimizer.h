@@ -0,0 +1,139 @@
+/*+===================================================================
+  File:      MESHOPTIMIZER.H
+
+  Summary:   MeshOptimizer header file contains declaration of class
+             MeshOptimizer used to reorder the triangles and vertices
+             of imported meshes, so the GPU transforms and fetches
+             fewer vertices and shades fewer hidden pixels.
+
+  Classes:  MeshOptimizer
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VertexCacheStatistics
+
+      Summary:  Result of simulating a FIFO post-transform vertex cache
+                over an index buffer. ACMR is the number of transformed
+                vertices per triangle, ATVR the number of transformed
+                vertices per referenced vertex; 1.0 is the ideal ATVR.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VertexCacheStatistics
+    {
+        UINT uNumTransformedVertices;
+        UINT uNumReferencedVertices;
+        UINT uNumTriangles;
+        FLOAT acmr;
+        FLOAT atvr;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshOptimizer
+
+      Summary:  Reorders the triangle list of a mesh for vertex cache
+                locality with Forsyth's linear speed algorithm, then
+                optionally sorts clusters of triangles from the outside
+                in to reduce overdraw, then numbers the vertices in the
+                order they are first used for vertex fetch locality.
+                Indices are relative to the first vertex of the mesh.
+
+      Methods:  OptimizeVertexCache
+                  Reorders triangles for the post-transform cache
+                OptimizeOverdraw
+                  Reorders clusters of triangles to reduce overdraw
+                OptimizeVertexFetch
+                  Computes a vertex order for fetch locality
+                RemapIndices
+                  Replaces each index with its new vertex index
+                RemapVertices
+                  Moves each vertex to its new index
+                AnalyzeVertexCache
+                  Returns the ACMR and ATVR of an index buffer
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshOptimizer
+    {
+    public:
+        static constexpr const UINT OPTIMIZE_VERTEX_CACHE = 0x1u;
+        static constexpr const UINT OPTIMIZE_OVERDRAW = 0x2u;
+        static constexpr const UINT OPTIMIZE_VERTEX_FETCH = 0x4u;
+        static constexpr const UINT DEFAULT_FLAGS = OPTIMIZE_VERTEX_CACHE | OPTIMIZE_VERTEX_FETCH;
+
+        // Size of the LRU cache modeled while ordering triangles
+        static constexpr const UINT VERTEX_CACHE_SIZE = 32u;
+        // Size of the FIFO cache simulated to measure and cluster
+        static constexpr const UINT FIFO_CACHE_SIZE = 16u;
+        // ACMR a cluster may lose to the overdraw reordering
+        static constexpr const FLOAT OVERDRAW_THRESHOLD = 1.05f;
+
+    public:
+        MeshOptimizer() = delete;
+        MeshOptimizer(const MeshOptimizer& other) = delete;
+        MeshOptimizer(MeshOptimizer&& other) = delete;
+        MeshOptimizer& operator=(const MeshOptimizer& other) = delete;
+        MeshOptimizer& operator=(MeshOptimizer&& other) = delete;
+        ~MeshOptimizer() = delete;
+
+        static void OptimizeVertexCache(_Inout_updates_(uNumIndices) UINT* aIndices, _In_ UINT uNumIndices, _In_ UINT uNumVertices);
+        static void OptimizeOverdraw(
+            _Inout_updates_(uNumIndices) UINT* aIndices,
+            _In_ UINT uNumIndices,
+            _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+            _In_ UINT uNumVertices,
+            _In_ FLOAT threshold
+        );
+        static void OptimizeVertexFetch(
+            _In_reads_(uNumIndices) const UINT* aIndices,
+            _In_ UINT uNumIndices,
+            _In_ UINT uNumVertices,
+            _Out_ std::vector<UINT>& aOutRemap
+        );
+        static void RemapIndices(_Inout_updates_(uNumIndices) UINT* aIndices, _In_ UINT uNumIndices, _In_ const std::vector<UINT>& aRemap);
+
+        template <class T>
+        static void RemapVertices(_Inout_updates_(aRemap.size()) T* aVertices, _In_ const std::vector<UINT>& aRemap);
+
+        static VertexCacheStatistics AnalyzeVertexCache(
+            _In_reads_(uNumIndices) const UINT* aIndices,
+            _In_ UINT uNumIndices,
+            _In_ UINT uNumVertices,
+            _In_ UINT uCacheSize
+        );
+
+    private:
+        static FLOAT computeVertexScore(_In_ INT iCachePosition, _In_ UINT uNumRemainingTriangles);
+        static UINT updateFifoCache(
+            _In_reads_(3) const UINT* aTriangle,
+            _Inout_ std::vector<UINT>& aTimestamps,
+            _Inout_ UINT& uTimestamp
+        );
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::RemapVertices
+
+      Summary:  Moves each vertex to the index given by the remap table
+                of OptimizeVertexFetch
+
+      Args:     T* aVertices
+                  Vertices of the mesh, one per remap entry
+                const std::vector<UINT>& aRemap
+                  New index of each vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class T>
+    void MeshOptimizer::RemapVertices(_Inout_updates_(aRemap.size()) T* aVertices, _In_ const std::vector<UINT>& aRemap)
+    {
+        const std::vector<T> aOriginalVertices(aVertices, aVertices + aRemap.size());
+
+        for (size_t i = 0; i < aRemap.size(); ++i)
+        {
+            aVertices[aRemap[i]] = aOriginalVertices[i];
+        }
+    }
+}
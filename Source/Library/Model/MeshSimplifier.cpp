@@ -0,0 +1,464 @@
+#include "Model/MeshSimplifier.h"
+
+#include <numeric>
+#include <tuple>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::Simplify
+
+      Summary:  Collapses edges in passes. Each pass sorts the edges by
+                the quadric error of collapsing them, then collapses the
+                cheapest ones whose neighborhoods do not overlap and that
+                do not flip a triangle, until the target index count is
+                reached or no collapse stays under the error limit.
+
+      Args:     const UINT* aIndices
+                  Triangle list indices of the mesh
+                UINT uNumIndices
+                  Number of indices
+                const SimpleVertex* aVertices
+                  Vertices of the mesh
+                const AnimationData* aAnimationData
+                  Bone indices and weights of the vertices, or nullptr
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                UINT uTargetNumIndices
+                  Number of indices to simplify to
+                FLOAT maxError
+                  Largest error of a collapse in model units
+                std::vector<UINT>& aOutIndices
+                  Simplified triangle list indices
+
+      Returns:  FLOAT
+                  Largest error of the collapses in model units
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT MeshSimplifier::Simplify(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_reads_opt_(uNumVertices) const AnimationData* aAnimationData,
+        _In_ UINT uNumVertices,
+        _In_ UINT uTargetNumIndices,
+        _In_ FLOAT maxError,
+        _Out_ std::vector<UINT>& aOutIndices
+    )
+    {
+        aOutIndices.assign(aIndices, aIndices + (uNumIndices / 3u) * 3u);
+        if (aOutIndices.size() <= uTargetNumIndices || uNumVertices == 0u)
+        {
+            return 0.0f;
+        }
+
+        // Vertices sharing a position get the same position id
+        std::vector<UINT> aSortedVertices(uNumVertices);
+        std::iota(aSortedVertices.begin(), aSortedVertices.end(), 0u);
+        std::sort(aSortedVertices.begin(), aSortedVertices.end(),
+            [aVertices](UINT uLeft, UINT uRight)
+            {
+                const XMFLOAT3& left = aVertices[uLeft].Position;
+                const XMFLOAT3& right = aVertices[uRight].Position;
+                return std::tie(left.x, left.y, left.z) < std::tie(right.x, right.y, right.z);
+            });
+
+        std::vector<UINT> aPositionIds(uNumVertices);
+        std::vector<UINT> aNumPositionVertices;
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            const XMFLOAT3& position = aVertices[aSortedVertices[i]].Position;
+            if (i == 0u || std::tie(position.x, position.y, position.z) != std::tie(
+                aVertices[aSortedVertices[i - 1u]].Position.x,
+                aVertices[aSortedVertices[i - 1u]].Position.y,
+                aVertices[aSortedVertices[i - 1u]].Position.z))
+            {
+                aNumPositionVertices.push_back(0u);
+            }
+            aPositionIds[aSortedVertices[i]] = static_cast<UINT>(aNumPositionVertices.size()) - 1u;
+            ++aNumPositionVertices.back();
+        }
+
+        // Seams split a position into several vertices, borders and non
+        // manifold edges are used by other than two triangles. Collapsing
+        // either would open cracks, so their positions are locked.
+        std::vector<BYTE> aIsPositionLocked(aNumPositionVertices.size(), 0u);
+        for (size_t i = 0; i < aNumPositionVertices.size(); ++i)
+        {
+            aIsPositionLocked[i] = aNumPositionVertices[i] > 1u;
+        }
+
+        std::unordered_map<UINT64, UINT> edgeUses;
+        edgeUses.reserve(aOutIndices.size());
+        for (size_t i = 0; i < aOutIndices.size(); ++i)
+        {
+            const UINT uFirst = aPositionIds[aOutIndices[i]];
+            const UINT uSecond = aPositionIds[aOutIndices[i - i % 3u + (i + 1u) % 3u]];
+            if (uFirst != uSecond)
+            {
+                ++edgeUses[(static_cast<UINT64>(std::min(uFirst, uSecond)) << 32u) | std::max(uFirst, uSecond)];
+            }
+        }
+        for (const auto& edgeUse : edgeUses)
+        {
+            if (edgeUse.second != 2u)
+            {
+                aIsPositionLocked[static_cast<size_t>(edgeUse.first >> 32u)] = 1u;
+                aIsPositionLocked[static_cast<size_t>(edgeUse.first & 0xFFFFFFFFu)] = 1u;
+            }
+        }
+
+        std::vector<Quadric> aQuadrics(uNumVertices, Quadric());
+        for (size_t i = 0; i < aOutIndices.size(); i += 3u)
+        {
+            const XMVECTOR position0 = XMLoadFloat3(&aVertices[aOutIndices[i]].Position);
+            const XMVECTOR normal = XMVector3Cross(
+                XMVectorSubtract(XMLoadFloat3(&aVertices[aOutIndices[i + 1u]].Position), position0),
+                XMVectorSubtract(XMLoadFloat3(&aVertices[aOutIndices[i + 2u]].Position), position0)
+            );
+            const FLOAT doubleArea = XMVectorGetX(XMVector3Length(normal));
+            if (doubleArea <= 0.0f)
+            {
+                continue;
+            }
+
+            XMFLOAT3 planeNormal;
+            XMStoreFloat3(&planeNormal, XMVectorScale(normal, 1.0f / doubleArea));
+            const FLOAT distance = -XMVectorGetX(XMVector3Dot(XMLoadFloat3(&planeNormal), position0));
+
+            for (UINT k = 0u; k < 3u; ++k)
+            {
+                addPlane(aQuadrics[aOutIndices[i + k]], planeNormal, distance, doubleArea * 0.5f);
+            }
+        }
+
+        std::vector<UINT> aDominantBones;
+        if (aAnimationData)
+        {
+            aDominantBones.resize(uNumVertices);
+            for (UINT i = 0u; i < uNumVertices; ++i)
+            {
+                aDominantBones[i] = getDominantBone(aAnimationData[i]);
+            }
+        }
+
+        const DOUBLE maxCost = static_cast<DOUBLE>(maxError) * static_cast<DOUBLE>(maxError);
+        DOUBLE resultCost = 0.0;
+
+        std::vector<UINT> aAdjacencyOffsets(uNumVertices + 1u);
+        std::vector<UINT> aAdjacency;
+        std::vector<UINT> aFillOffsets;
+        std::vector<Collapse> aCollapses;
+        std::vector<UINT> aRemap(uNumVertices);
+        std::vector<BYTE> aIsTouched(uNumVertices);
+
+        while (aOutIndices.size() > uTargetNumIndices)
+        {
+            const UINT uNumTriangles = static_cast<UINT>(aOutIndices.size() / 3u);
+
+            // Triangles adjacent to each vertex
+            std::fill(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end(), 0u);
+            for (UINT uIndex : aOutIndices)
+            {
+                ++aAdjacencyOffsets[uIndex + 1u];
+            }
+            for (UINT i = 0u; i < uNumVertices; ++i)
+            {
+                aAdjacencyOffsets[i + 1u] += aAdjacencyOffsets[i];
+            }
+            aAdjacency.resize(aOutIndices.size());
+            aFillOffsets.assign(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < aOutIndices.size(); ++i)
+            {
+                aAdjacency[aFillOffsets[aOutIndices[i]]++] = static_cast<UINT>(i / 3u);
+            }
+
+            // Cheapest direction of every edge
+            aCollapses.clear();
+            for (size_t i = 0; i < aOutIndices.size(); ++i)
+            {
+                const UINT uFirst = aOutIndices[i];
+                const UINT uSecond = aOutIndices[i - i % 3u + (i + 1u) % 3u];
+                if (uFirst >= uSecond)
+                {
+                    continue;
+                }
+                if (!aDominantBones.empty() && aDominantBones[uFirst] != aDominantBones[uSecond])
+                {
+                    continue;
+                }
+
+                Quadric quadric = aQuadrics[uFirst];
+                addQuadric(quadric, aQuadrics[uSecond]);
+                const DOUBLE weight = std::max(quadric.weight, DBL_EPSILON);
+
+                Collapse collapse = { .uSource = 0u, .uTarget = 0u, .cost = DBL_MAX };
+                if (!aIsPositionLocked[aPositionIds[uFirst]])
+                {
+                    collapse = { .uSource = uFirst, .uTarget = uSecond, .cost = std::max(evaluateQuadric(quadric, aVertices[uSecond].Position) / weight, 0.0) };
+                }
+                if (!aIsPositionLocked[aPositionIds[uSecond]])
+                {
+                    const DOUBLE cost = std::max(evaluateQuadric(quadric, aVertices[uFirst].Position) / weight, 0.0);
+                    if (cost < collapse.cost)
+                    {
+                        collapse = { .uSource = uSecond, .uTarget = uFirst, .cost = cost };
+                    }
+                }
+                if (collapse.cost <= maxCost)
+                {
+                    aCollapses.push_back(collapse);
+                }
+            }
+
+            std::sort(aCollapses.begin(), aCollapses.end(),
+                [](const Collapse& left, const Collapse& right)
+                {
+                    return left.cost < right.cost;
+                });
+
+            std::iota(aRemap.begin(), aRemap.end(), 0u);
+            std::fill(aIsTouched.begin(), aIsTouched.end(), 0u);
+
+            const UINT uNumTrianglesToRemove = uNumTriangles - uTargetNumIndices / 3u;
+            UINT uNumRemovedTriangles = 0u;
+            for (const Collapse& collapse : aCollapses)
+            {
+                if (aIsTouched[collapse.uSource] || aIsTouched[collapse.uTarget])
+                {
+                    continue;
+                }
+
+                BOOL bFlips = FALSE;
+                UINT uNumCollapsedTriangles = 0u;
+                for (UINT k = aAdjacencyOffsets[collapse.uSource]; k < aAdjacencyOffsets[collapse.uSource + 1u] && !bFlips; ++k)
+                {
+                    const UINT* aTriangle = &aOutIndices[aAdjacency[k] * 3u];
+                    if (aTriangle[0] == collapse.uTarget || aTriangle[1] == collapse.uTarget || aTriangle[2] == collapse.uTarget)
+                    {
+                        ++uNumCollapsedTriangles;
+                    }
+                    else
+                    {
+                        bFlips = flipsTriangle(aTriangle, collapse.uSource, collapse.uTarget, aVertices);
+                    }
+                }
+                if (bFlips)
+                {
+                    continue;
+                }
+
+                aRemap[collapse.uSource] = collapse.uTarget;
+                addQuadric(aQuadrics[collapse.uTarget], aQuadrics[collapse.uSource]);
+                resultCost = std::max(resultCost, collapse.cost);
+
+                // Later collapses of this pass must not move a vertex of the changed triangles
+                for (UINT k = aAdjacencyOffsets[collapse.uSource]; k < aAdjacencyOffsets[collapse.uSource + 1u]; ++k)
+                {
+                    const UINT* aTriangle = &aOutIndices[aAdjacency[k] * 3u];
+                    aIsTouched[aTriangle[0]] = aIsTouched[aTriangle[1]] = aIsTouched[aTriangle[2]] = 1u;
+                }
+
+                uNumRemovedTriangles += uNumCollapsedTriangles;
+                if (uNumRemovedTriangles >= uNumTrianglesToRemove)
+                {
+                    break;
+                }
+            }
+
+            if (uNumRemovedTriangles == 0u)
+            {
+                break;
+            }
+
+            size_t uNumKeptIndices = 0u;
+            for (size_t i = 0; i < aOutIndices.size(); i += 3u)
+            {
+                const UINT uIndex0 = aRemap[aOutIndices[i]];
+                const UINT uIndex1 = aRemap[aOutIndices[i + 1u]];
+                const UINT uIndex2 = aRemap[aOutIndices[i + 2u]];
+                if (uIndex0 != uIndex1 && uIndex1 != uIndex2 && uIndex2 != uIndex0)
+                {
+                    aOutIndices[uNumKeptIndices++] = uIndex0;
+                    aOutIndices[uNumKeptIndices++] = uIndex1;
+                    aOutIndices[uNumKeptIndices++] = uIndex2;
+                }
+            }
+            aOutIndices.resize(uNumKeptIndices);
+        }
+
+        return static_cast<FLOAT>(sqrt(resultCost));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::addPlane
+
+      Summary:  Adds the squared distance to a plane, weighted by the
+                area of the triangle that lies in it
+
+      Args:     Quadric& quadric
+                  Quadric to add to
+                const XMFLOAT3& normal
+                  Unit normal of the plane
+                FLOAT distance
+                  Signed distance of the plane from the origin
+                FLOAT weight
+                  Area of the triangle
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshSimplifier::addPlane(_Inout_ Quadric& quadric, _In_ const XMFLOAT3& normal, _In_ FLOAT distance, _In_ FLOAT weight)
+    {
+        const DOUBLE a = normal.x;
+        const DOUBLE b = normal.y;
+        const DOUBLE c = normal.z;
+        const DOUBLE d = distance;
+        const DOUBLE w = weight;
+
+        quadric.a00 += w * a * a;
+        quadric.a11 += w * b * b;
+        quadric.a22 += w * c * c;
+        quadric.a01 += w * a * b;
+        quadric.a02 += w * a * c;
+        quadric.a12 += w * b * c;
+        quadric.b0 += w * a * d;
+        quadric.b1 += w * b * d;
+        quadric.b2 += w * c * d;
+        quadric.c += w * d * d;
+        quadric.weight += w;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::addQuadric
+
+      Summary:  Adds the planes of another quadric
+
+      Args:     Quadric& quadric
+                  Quadric to add to
+                const Quadric& other
+                  Quadric to add
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshSimplifier::addQuadric(_Inout_ Quadric& quadric, _In_ const Quadric& other)
+    {
+        quadric.a00 += other.a00;
+        quadric.a11 += other.a11;
+        quadric.a22 += other.a22;
+        quadric.a01 += other.a01;
+        quadric.a02 += other.a02;
+        quadric.a12 += other.a12;
+        quadric.b0 += other.b0;
+        quadric.b1 += other.b1;
+        quadric.b2 += other.b2;
+        quadric.c += other.c;
+        quadric.weight += other.weight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::evaluateQuadric
+
+      Summary:  Returns the weighted sum of squared distances from a
+                position to the planes of a quadric
+
+      Args:     const Quadric& quadric
+                  Quadric to evaluate
+                const XMFLOAT3& position
+                  Position to evaluate the quadric at
+
+      Returns:  DOUBLE
+                  Weighted squared distance
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DOUBLE MeshSimplifier::evaluateQuadric(_In_ const Quadric& quadric, _In_ const XMFLOAT3& position)
+    {
+        const DOUBLE x = position.x;
+        const DOUBLE y = position.y;
+        const DOUBLE z = position.z;
+
+        return quadric.a00 * x * x + quadric.a11 * y * y + quadric.a22 * z * z
+            + 2.0 * (quadric.a01 * x * y + quadric.a02 * x * z + quadric.a12 * y * z)
+            + 2.0 * (quadric.b0 * x + quadric.b1 * y + quadric.b2 * z)
+            + quadric.c;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::getDominantBone
+
+      Summary:  Returns the bone with the largest weight on a vertex
+
+      Args:     const AnimationData& animationData
+                  Bone indices and weights of the vertex
+
+      Returns:  UINT
+                  Bone index, the first one if every weight is zero
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT MeshSimplifier::getDominantBone(_In_ const AnimationData& animationData)
+    {
+        const FLOAT aWeights[4] =
+        {
+            animationData.aBoneWeights.x,
+            animationData.aBoneWeights.y,
+            animationData.aBoneWeights.z,
+            animationData.aBoneWeights.w,
+        };
+        const UINT aBoneIndices[4] =
+        {
+            animationData.aBoneIndices.x,
+            animationData.aBoneIndices.y,
+            animationData.aBoneIndices.z,
+            animationData.aBoneIndices.w,
+        };
+
+        UINT uLargest = 0u;
+        for (UINT k = 1u; k < 4u; ++k)
+        {
+            if (aWeights[k] > aWeights[uLargest])
+            {
+                uLargest = k;
+            }
+        }
+
+        return aBoneIndices[uLargest];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::flipsTriangle
+
+      Summary:  Returns whether replacing a vertex of a triangle turns
+                the triangle over or makes it degenerate
+
+      Args:     const UINT* aTriangle
+                  Indices of the triangle
+                UINT uSource
+                  Vertex of the triangle that is replaced
+                UINT uTarget
+                  Vertex it is replaced with
+                const SimpleVertex* aVertices
+                  Vertices of the mesh
+
+      Returns:  BOOL
+                  TRUE if the collapse must be rejected
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL MeshSimplifier::flipsTriangle(
+        _In_reads_(3) const UINT* aTriangle,
+        _In_ UINT uSource,
+        _In_ UINT uTarget,
+        _In_ const SimpleVertex* aVertices
+    )
+    {
+        XMVECTOR aPositions[3];
+        XMVECTOR aMovedPositions[3];
+        for (UINT k = 0u; k < 3u; ++k)
+        {
+            aPositions[k] = XMLoadFloat3(&aVertices[aTriangle[k]].Position);
+            aMovedPositions[k] = XMLoadFloat3(&aVertices[aTriangle[k] == uSource ? uTarget : aTriangle[k]].Position);
+        }
+
+        const XMVECTOR normal = XMVector3Cross(XMVectorSubtract(aPositions[1], aPositions[0]), XMVectorSubtract(aPositions[2], aPositions[0]));
+        const XMVECTOR movedNormal = XMVector3Cross(XMVectorSubtract(aMovedPositions[1], aMovedPositions[0]), XMVectorSubtract(aMovedPositions[2], aMovedPositions[0]));
+
+        const FLOAT lengths = XMVectorGetX(XMVector3Length(normal)) * XMVectorGetX(XMVector3Length(movedNormal));
+        if (lengths <= 0.0f)
+        {
+            return TRUE;
+        }
+
+        // The normal may turn by up to about 84 degrees
+        return XMVectorGetX(XMVector3Dot(normal, movedNormal)) < 0.1f * lengths;
+    }
+}
@@ -0,0 +1,105 @@
+/*+===================================================================
+  File:      MESHSIMPLIFIER.H
+
+  Summary:   MeshSimplifier header file contains declaration of class
+             MeshSimplifier used to build the coarser detail levels of
+             imported meshes.
+
+  Classes:  MeshSimplifier
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   LodStatistics
+
+      Summary:  Triangles, largest geometric error in model units and
+                CPU time spent simplifying, summed over the meshes of a
+                model for one detail level
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct LodStatistics
+    {
+        UINT uNumTriangles;
+        FLOAT maxError;
+        DOUBLE generationTime;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshSimplifier
+
+      Summary:  Simplifies a triangle list by quadric error edge
+                collapse. Vertices are never moved or created, a
+                collapse only replaces one vertex of an edge with the
+                other, so every detail level indexes the vertex buffer
+                of the full mesh. Vertices on open borders and on UV,
+                normal or skinning seams, where several vertices share
+                a position, are never collapsed, and an edge is only
+                collapsed between vertices mostly bound to the same
+                bone.
+
+      Methods:  Simplify
+                  Collapses edges until a target index count or error
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshSimplifier
+    {
+    public:
+        // Fraction of the triangles of the previous level each level aims for
+        static constexpr const FLOAT LOD_TRIANGLE_RATIO = 0.5f;
+        // A level that keeps more of the previous level is not worth its indices
+        static constexpr const FLOAT MIN_LOD_REDUCTION = 0.8f;
+        // Largest error of a level relative to the bounding radius of the mesh
+        static constexpr const FLOAT MAX_RELATIVE_ERROR = 0.05f;
+
+    public:
+        MeshSimplifier() = delete;
+        MeshSimplifier(const MeshSimplifier& other) = delete;
+        MeshSimplifier(MeshSimplifier&& other) = delete;
+        MeshSimplifier& operator=(const MeshSimplifier& other) = delete;
+        MeshSimplifier& operator=(MeshSimplifier&& other) = delete;
+        ~MeshSimplifier() = delete;
+
+        static FLOAT Simplify(
+            _In_reads_(uNumIndices) const UINT* aIndices,
+            _In_ UINT uNumIndices,
+            _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+            _In_reads_opt_(uNumVertices) const AnimationData* aAnimationData,
+            _In_ UINT uNumVertices,
+            _In_ UINT uTargetNumIndices,
+            _In_ FLOAT maxError,
+            _Out_ std::vector<UINT>& aOutIndices
+        );
+
+    private:
+        struct Quadric
+        {
+            DOUBLE a00, a11, a22, a01, a02, a12;
+            DOUBLE b0, b1, b2;
+            DOUBLE c;
+            DOUBLE weight;
+        };
+
+        struct Collapse
+        {
+            UINT uSource;
+            UINT uTarget;
+            DOUBLE cost;
+        };
+
+        static void addPlane(_Inout_ Quadric& quadric, _In_ const XMFLOAT3& normal, _In_ FLOAT distance, _In_ FLOAT weight);
+        static void addQuadric(_Inout_ Quadric& quadric, _In_ const Quadric& other);
+        static DOUBLE evaluateQuadric(_In_ const Quadric& quadric, _In_ const XMFLOAT3& position);
+        static UINT getDominantBone(_In_ const AnimationData& animationData);
+        static BOOL flipsTriangle(
+            _In_reads_(3) const UINT* aTriangle,
+            _In_ UINT uSource,
+            _In_ UINT uTarget,
+            _In_ const SimpleVertex* aVertices
+        );
+    };
+}
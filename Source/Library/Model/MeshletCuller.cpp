@@ -0,0 +1,338 @@
+#include "Model/MeshletCuller.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshletCuller::Build
+
+      Summary:  Walks the triangles in index buffer order and starts a
+                new meshlet whenever the next triangle would exceed the
+                vertex or triangle limit, then pads the meshlets of the
+                mesh with empty ones to a multiple of MESHLET_GROUP_SIZE
+                so each group of bounds belongs to a single mesh
+
+      Args:     const UINT* aIndices
+                  Triangle list indices of the mesh, relative to its
+                  base vertex
+                UINT uNumIndices
+                  Number of indices
+                UINT uBaseIndex
+                  Location of the first index in the index buffer
+                const SimpleVertex* aVertices
+                  Vertices of the mesh
+                UINT uNumVertices
+                  Number of vertices of the mesh
+                std::vector<Meshlet>& aMeshlets
+                  Meshlets the meshlets of the mesh are appended to
+                std::vector<MeshletBounds>& aBounds
+                  Bounds the bounds of the meshlets are appended to
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshletCuller::Build(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ UINT uBaseIndex,
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_ UINT uNumVertices,
+        _Inout_ std::vector<Meshlet>& aMeshlets,
+        _Inout_ std::vector<MeshletBounds>& aBounds
+    )
+    {
+        assert(aMeshlets.size() % MESHLET_GROUP_SIZE == 0u);
+        assert(aBounds.size() * MESHLET_GROUP_SIZE == aMeshlets.size());
+
+        const size_t uFirstMeshlet = aMeshlets.size();
+        const UINT uNumTriangleIndices = (uNumIndices / 3u) * 3u;
+
+        // Meshlet that last counted each vertex
+        std::vector<UINT> aVertexMeshlets(uNumVertices, UINT_MAX);
+        UINT uMeshletStart = 0u;
+        UINT uNumMeshletVertices = 0u;
+
+        for (UINT i = 0u; i < uNumTriangleIndices; i += 3u)
+        {
+            UINT uMeshlet = static_cast<UINT>(aMeshlets.size());
+
+            UINT uNumNewVertices = 0u;
+            for (UINT j = 0u; j < 3u; ++j)
+            {
+                uNumNewVertices += aVertexMeshlets[aIndices[i + j]] != uMeshlet ? 1u : 0u;
+            }
+
+            if (i > uMeshletStart
+                && (uNumMeshletVertices + uNumNewVertices > MAX_MESHLET_VERTICES || (i - uMeshletStart) / 3u >= MAX_MESHLET_TRIANGLES))
+            {
+                aMeshlets.push_back(Meshlet{ .uBaseIndex = uBaseIndex + uMeshletStart, .uNumIndices = i - uMeshletStart });
+                uMeshletStart = i;
+                uNumMeshletVertices = 0u;
+                ++uMeshlet;
+            }
+
+            for (UINT j = 0u; j < 3u; ++j)
+            {
+                UINT& uVertexMeshlet = aVertexMeshlets[aIndices[i + j]];
+                if (uVertexMeshlet != uMeshlet)
+                {
+                    uVertexMeshlet = uMeshlet;
+                    ++uNumMeshletVertices;
+                }
+            }
+        }
+
+        if (uMeshletStart < uNumTriangleIndices)
+        {
+            aMeshlets.push_back(Meshlet{ .uBaseIndex = uBaseIndex + uMeshletStart, .uNumIndices = uNumTriangleIndices - uMeshletStart });
+        }
+
+        while (aMeshlets.size() % MESHLET_GROUP_SIZE != 0u)
+        {
+            aMeshlets.push_back(Meshlet{ .uBaseIndex = uBaseIndex + uNumTriangleIndices, .uNumIndices = 0u });
+        }
+
+        aBounds.resize(aMeshlets.size() / MESHLET_GROUP_SIZE, MeshletBounds{});
+        for (size_t i = uFirstMeshlet; i < aMeshlets.size(); ++i)
+        {
+            setBounds(
+                aIndices + (aMeshlets[i].uBaseIndex - uBaseIndex),
+                aMeshlets[i].uNumIndices,
+                aVertices,
+                static_cast<UINT>(i % MESHLET_GROUP_SIZE),
+                aBounds[i / MESHLET_GROUP_SIZE]
+            );
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshletCuller::Cull
+
+      Summary:  Tests 4 meshlets at a time in model space. A meshlet is
+                culled when its sphere is behind a plane of the view
+                frustum, or when it is back facing: every direction from
+                the eye to its sphere makes an angle under 90 degrees
+                with every normal in its cone. The visible meshlets are
+                appended as index ranges, adjacent ones merged into one.
+                World matrices that mirror the model flip the winding
+                and are not supported.
+
+      Args:     const Meshlet* aMeshlets
+                  Meshlets of a mesh
+                const MeshletBounds* aBounds
+                  Bounds of the meshlets
+                UINT uNumMeshlets
+                  Number of meshlets, a multiple of MESHLET_GROUP_SIZE
+                FXMVECTOR eyePosition
+                  Position of the eye in model space
+                CXMMATRIX worldViewProjection
+                  Transform from model space to clip space
+                std::vector<Meshlet>& aOutRanges
+                  Index ranges the visible triangles are appended to
+
+      Returns:  UINT
+                  Number of visible triangles
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT MeshletCuller::Cull(
+        _In_reads_(uNumMeshlets) const Meshlet* aMeshlets,
+        _In_reads_(uNumMeshlets / MESHLET_GROUP_SIZE) const MeshletBounds* aBounds,
+        _In_ UINT uNumMeshlets,
+        _In_ FXMVECTOR eyePosition,
+        _In_ CXMMATRIX worldViewProjection,
+        _Inout_ std::vector<Meshlet>& aOutRanges
+    )
+    {
+        assert(uNumMeshlets % MESHLET_GROUP_SIZE == 0u);
+
+        // Rows of the transpose are the columns of the clip transform, so
+        // the frustum planes in model space are sums of them
+        const XMMATRIX columns = XMMatrixTranspose(worldViewProjection);
+        const XMVECTOR aPlanes[6] =
+        {
+            XMVectorAdd(columns.r[3], columns.r[0]),
+            XMVectorSubtract(columns.r[3], columns.r[0]),
+            XMVectorAdd(columns.r[3], columns.r[1]),
+            XMVectorSubtract(columns.r[3], columns.r[1]),
+            columns.r[2],
+            XMVectorSubtract(columns.r[3], columns.r[2]),
+        };
+
+        XMVECTOR aPlaneComponents[ARRAYSIZE(aPlanes)][4];
+        for (size_t i = 0u; i < ARRAYSIZE(aPlanes); ++i)
+        {
+            const XMVECTOR plane = XMVectorDivide(aPlanes[i], XMVector3Length(aPlanes[i]));
+            aPlaneComponents[i][0] = XMVectorSplatX(plane);
+            aPlaneComponents[i][1] = XMVectorSplatY(plane);
+            aPlaneComponents[i][2] = XMVectorSplatZ(plane);
+            aPlaneComponents[i][3] = XMVectorSplatW(plane);
+        }
+
+        const XMVECTOR eyeX = XMVectorSplatX(eyePosition);
+        const XMVECTOR eyeY = XMVectorSplatY(eyePosition);
+        const XMVECTOR eyeZ = XMVectorSplatZ(eyePosition);
+        const XMVECTOR minDistance = XMVectorReplicate(1e-6f);
+        const XMVECTOR one = XMVectorSplatOne();
+        const XMVECTOR zero = XMVectorZero();
+
+        UINT uNumVisibleTriangles = 0u;
+        for (UINT i = 0u; i < uNumMeshlets / MESHLET_GROUP_SIZE; ++i)
+        {
+            const MeshletBounds& bounds = aBounds[i];
+            const XMVECTOR centerX = XMLoadFloat4(&bounds.centerX);
+            const XMVECTOR centerY = XMLoadFloat4(&bounds.centerY);
+            const XMVECTOR centerZ = XMLoadFloat4(&bounds.centerZ);
+            const XMVECTOR radius = XMLoadFloat4(&bounds.radius);
+            const XMVECTOR negativeRadius = XMVectorNegate(radius);
+
+            XMVECTOR isVisible = XMVectorTrueInt();
+            for (size_t j = 0u; j < ARRAYSIZE(aPlanes); ++j)
+            {
+                XMVECTOR distance = XMVectorMultiplyAdd(centerZ, aPlaneComponents[j][2], aPlaneComponents[j][3]);
+                distance = XMVectorMultiplyAdd(centerY, aPlaneComponents[j][1], distance);
+                distance = XMVectorMultiplyAdd(centerX, aPlaneComponents[j][0], distance);
+                isVisible = XMVectorAndInt(isVisible, XMVectorGreaterOrEqual(distance, negativeRadius));
+            }
+
+            const XMVECTOR toCenterX = XMVectorSubtract(centerX, eyeX);
+            const XMVECTOR toCenterY = XMVectorSubtract(centerY, eyeY);
+            const XMVECTOR toCenterZ = XMVectorSubtract(centerZ, eyeZ);
+            XMVECTOR distanceSq = XMVectorMultiply(toCenterZ, toCenterZ);
+            distanceSq = XMVectorMultiplyAdd(toCenterY, toCenterY, distanceSq);
+            distanceSq = XMVectorMultiplyAdd(toCenterX, toCenterX, distanceSq);
+            const XMVECTOR distance = XMVectorMax(XMVectorSqrt(distanceSq), minDistance);
+
+            XMVECTOR axisDot = XMVectorMultiply(XMLoadFloat4(&bounds.axisZ), toCenterZ);
+            axisDot = XMVectorMultiplyAdd(XMLoadFloat4(&bounds.axisY), toCenterY, axisDot);
+            axisDot = XMVectorMultiplyAdd(XMLoadFloat4(&bounds.axisX), toCenterX, axisDot);
+
+            // The sphere covers the view directions within asin(radius / distance) of
+            // the center direction, the cone the normals within its spread of the axis
+            const XMVECTOR cosSpread = XMLoadFloat4(&bounds.cosSpread);
+            const XMVECTOR sinSphere = XMVectorDivide(radius, distance);
+            const XMVECTOR cosSphere = XMVectorSqrt(XMVectorMax(XMVectorSubtract(one, XMVectorMultiply(sinSphere, sinSphere)), zero));
+            const XMVECTOR sinLimit = XMVectorMultiplyAdd(sinSphere, cosSpread, XMVectorMultiply(cosSphere, XMLoadFloat4(&bounds.sinSpread)));
+            const XMVECTOR isBackFacing = XMVectorAndInt(
+                XMVectorLess(sinSphere, cosSpread),
+                XMVectorGreater(XMVectorDivide(axisDot, distance), sinLimit)
+            );
+            isVisible = XMVectorAndCInt(isVisible, isBackFacing);
+
+            XMUINT4 visibility;
+            XMStoreUInt4(&visibility, isVisible);
+            const UINT aVisibility[MESHLET_GROUP_SIZE] = { visibility.x, visibility.y, visibility.z, visibility.w };
+
+            for (UINT j = 0u; j < MESHLET_GROUP_SIZE; ++j)
+            {
+                const Meshlet& meshlet = aMeshlets[i * MESHLET_GROUP_SIZE + j];
+                if (!aVisibility[j] || meshlet.uNumIndices == 0u)
+                {
+                    continue;
+                }
+
+                uNumVisibleTriangles += meshlet.uNumIndices / 3u;
+                if (!aOutRanges.empty() && aOutRanges.back().uBaseIndex + aOutRanges.back().uNumIndices == meshlet.uBaseIndex)
+                {
+                    aOutRanges.back().uNumIndices += meshlet.uNumIndices;
+                }
+                else
+                {
+                    aOutRanges.push_back(meshlet);
+                }
+            }
+        }
+
+        return uNumVisibleTriangles;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshletCuller::setBounds
+
+      Summary:  Sets the bounding sphere and normal cone of a meshlet.
+                The cone axis is the average of the triangle normals and
+                its spread the largest angle between a normal and the
+                axis. Degenerate triangles are never drawn and are left
+                out of the cone.
+
+      Args:     const UINT* aIndices
+                  Triangle list indices of the meshlet
+                UINT uNumIndices
+                  Number of indices
+                const SimpleVertex* aVertices
+                  Vertices of the mesh
+                UINT uComponent
+                  Component of the bounds the meshlet is stored in
+                MeshletBounds& bounds
+                  Bounds of the group of the meshlet
+
+      Modifies: [bounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshletCuller::setBounds(
+        _In_reads_(uNumIndices) const UINT* aIndices,
+        _In_ UINT uNumIndices,
+        _In_ const SimpleVertex* aVertices,
+        _In_ UINT uComponent,
+        _Inout_ MeshletBounds& bounds
+    )
+    {
+        assert(uComponent < MESHLET_GROUP_SIZE);
+
+        // A cone that is never back facing
+        FLOAT cosSpread = -1.0f;
+        FLOAT sinSpread = 0.0f;
+        BoundingSphere sphere;
+        XMFLOAT3 axis(0.0f, 0.0f, 0.0f);
+
+        if (uNumIndices > 0u)
+        {
+            std::vector<XMFLOAT3> aPositions(uNumIndices);
+            for (UINT i = 0u; i < uNumIndices; ++i)
+            {
+                aPositions[i] = aVertices[aIndices[i]].Position;
+            }
+            BoundingSphere::CreateFromPoints(sphere, uNumIndices, aPositions.data(), sizeof(XMFLOAT3));
+
+            std::vector<XMVECTOR> aNormals;
+            aNormals.reserve(uNumIndices / 3u);
+            XMVECTOR normalSum = XMVectorZero();
+            for (UINT i = 0u; i + 2u < uNumIndices; i += 3u)
+            {
+                const XMVECTOR position0 = XMLoadFloat3(&aPositions[i]);
+                const XMVECTOR normal = XMVector3Cross(
+                    XMVectorSubtract(XMLoadFloat3(&aPositions[i + 1u]), position0),
+                    XMVectorSubtract(XMLoadFloat3(&aPositions[i + 2u]), position0)
+                );
+
+                if (XMVectorGetX(XMVector3LengthSq(normal)) > 0.0f)
+                {
+                    aNormals.push_back(XMVector3Normalize(normal));
+                    normalSum = XMVectorAdd(normalSum, aNormals.back());
+                }
+            }
+
+            // Normals spread over more than a hemisphere average to a short axis
+            if (!aNormals.empty() && XMVectorGetX(XMVector3Length(normalSum)) > 1e-3f * static_cast<FLOAT>(aNormals.size()))
+            {
+                const XMVECTOR axisVector = XMVector3Normalize(normalSum);
+
+                FLOAT minDot = 1.0f;
+                for (const XMVECTOR& normal : aNormals)
+                {
+                    minDot = std::min(minDot, XMVectorGetX(XMVector3Dot(normal, axisVector)));
+                }
+
+                if (minDot > 0.0f)
+                {
+                    cosSpread = minDot;
+                    sinSpread = std::sqrt(std::max(1.0f - minDot * minDot, 0.0f));
+                    XMStoreFloat3(&axis, axisVector);
+                }
+            }
+        }
+
+        (&bounds.centerX.x)[uComponent] = sphere.Center.x;
+        (&bounds.centerY.x)[uComponent] = sphere.Center.y;
+        (&bounds.centerZ.x)[uComponent] = sphere.Center.z;
+        (&bounds.radius.x)[uComponent] = sphere.Radius;
+        (&bounds.axisX.x)[uComponent] = axis.x;
+        (&bounds.axisY.x)[uComponent] = axis.y;
+        (&bounds.axisZ.x)[uComponent] = axis.z;
+        (&bounds.cosSpread.x)[uComponent] = cosSpread;
+        (&bounds.sinSpread.x)[uComponent] = sinSpread;
+    }
+}
@@ -0,0 +1,135 @@
+/*+===================================================================
+  File:      MESHLETCULLER.H
+
+  Summary:   MeshletCuller header file contains declaration of class
+             MeshletCuller used to split imported meshes into small
+             clusters of triangles and to skip the clusters that cannot
+             be seen before drawing.
+
+  Classes:  MeshletCuller
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Meshlet
+
+      Summary:  Range of the index buffer holding the triangles of a
+                meshlet, or a range of visible triangles after culling.
+                Empty meshlets pad the meshlets of a mesh to a multiple
+                of 4.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Meshlet
+    {
+        UINT uBaseIndex;
+        UINT uNumIndices;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshletBounds
+
+      Summary:  Bounding spheres and normal cones of 4 consecutive
+                meshlets in model space, one meshlet per component, so
+                they are tested together. The triangle normals of a
+                meshlet are within the spread angle of the cone axis;
+                cosSpread is -1 when they are not within 90 degrees and
+                the meshlet can never be back facing.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshletBounds
+    {
+        XMFLOAT4 centerX;
+        XMFLOAT4 centerY;
+        XMFLOAT4 centerZ;
+        XMFLOAT4 radius;
+        XMFLOAT4 axisX;
+        XMFLOAT4 axisY;
+        XMFLOAT4 axisZ;
+        XMFLOAT4 cosSpread;
+        XMFLOAT4 sinSpread;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshletCullingStatistics
+
+      Summary:  Meshlets tested, index ranges drawn, triangles tested and
+                kept, and CPU time in milliseconds spent culling, summed
+                over the meshes culled in a frame
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshletCullingStatistics
+    {
+        UINT uNumMeshlets;
+        UINT uNumRanges;
+        UINT uNumTriangles;
+        UINT uNumVisibleTriangles;
+        DOUBLE cullingTime;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshletCuller
+
+      Summary:  Splits the triangle list of a mesh into meshlets of at
+                most MAX_MESHLET_VERTICES vertices and
+                MAX_MESHLET_TRIANGLES triangles, each bounded by a
+                sphere and a normal cone. The triangles are taken in
+                their order in the index buffer, which is already
+                optimized for the vertex cache, so a meshlet is a
+                contiguous index range and the index buffer is not
+                changed. Culling tests 4 meshlets at a time against the
+                view frustum and their normal cones and merges the
+                visible meshlets into as few index ranges as possible.
+
+      Methods:  Build
+                  Splits the triangles of a mesh into meshlets
+                Cull
+                  Returns the index ranges of the visible meshlets
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshletCuller
+    {
+    public:
+        static constexpr const UINT MAX_MESHLET_VERTICES = 64u;
+        static constexpr const UINT MAX_MESHLET_TRIANGLES = 124u;
+        // Meshlets are tested in groups of this many, one per vector component
+        static constexpr const UINT MESHLET_GROUP_SIZE = 4u;
+
+    public:
+        MeshletCuller() = delete;
+        MeshletCuller(const MeshletCuller& other) = delete;
+        MeshletCuller(MeshletCuller&& other) = delete;
+        MeshletCuller& operator=(const MeshletCuller& other) = delete;
+        MeshletCuller& operator=(MeshletCuller&& other) = delete;
+        ~MeshletCuller() = delete;
+
+        static void Build(
+            _In_reads_(uNumIndices) const UINT* aIndices,
+            _In_ UINT uNumIndices,
+            _In_ UINT uBaseIndex,
+            _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+            _In_ UINT uNumVertices,
+            _Inout_ std::vector<Meshlet>& aMeshlets,
+            _Inout_ std::vector<MeshletBounds>& aBounds
+        );
+        static UINT Cull(
+            _In_reads_(uNumMeshlets) const Meshlet* aMeshlets,
+            _In_reads_(uNumMeshlets / MESHLET_GROUP_SIZE) const MeshletBounds* aBounds,
+            _In_ UINT uNumMeshlets,
+            _In_ FXMVECTOR eyePosition,
+            _In_ CXMMATRIX worldViewProjection,
+            _Inout_ std::vector<Meshlet>& aOutRanges
+        );
+
+    private:
+        static void setBounds(
+            _In_reads_(uNumIndices) const UINT* aIndices,
+            _In_ UINT uNumIndices,
+            _In_ const SimpleVertex* aVertices,
+            _In_ UINT uComponent,
+            _Inout_ MeshletBounds& bounds
+        );
+    };
+}
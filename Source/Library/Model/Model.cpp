@@ -1,9 +1,17 @@
 #include "Model/Model.h"
 
+#include "Renderer/TangentFrameGenerator.h"
+#include "Renderer/VertexCompression.h"
+#include "Texture/TextureCache.h"
+
 #include "assimp/Importer.hpp"
 #include "assimp/scene.h"		
 #include "assimp/postprocess.h"
 
+#include <execution>
+#include <numeric>
+#include <thread>
+
 namespace library
 {
 
@@ -36,32 +44,10 @@ namespace library
         );
     }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   ConvertVector3dToFloat3
-
-      Summary:  Conver aiVector3D to XMFLOAT3
-
-      Returns:  XMFLOAT3
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    XMFLOAT3 ConvertVector3dToFloat3(_In_ const aiVector3D& vector)
-    {
-        return XMFLOAT3(vector.x, vector.y, vector.z);
-    }
-
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   ConvertQuaternionToVector
-
-      Summary:  Convert aiQuaternion to XMVECTOR
-
-      Returns:  XMVECTOR
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    XMVECTOR ConvertQuaternionToVector(_In_ const aiQuaternion& quaternion)
-    {
-        XMFLOAT4 float4 = XMFLOAT4(quaternion.x, quaternion.y, quaternion.z, quaternion.w);
-        return XMLoadFloat4(&float4);
-    }
-
-    std::unique_ptr<Assimp::Importer> Model::sm_pImporter = std::make_unique<Assimp::Importer>();
+    std::unordered_map<std::wstring, std::weak_ptr<Model::ModelAsset>> Model::sm_assetCache;
+    std::atomic<UINT> Model::sm_uNumImportThreads = 0u;
+    std::mutex Model::sm_assetCacheMutex;
+    std::unordered_map<std::wstring, std::shared_ptr<std::mutex>> Model::sm_importMutexes;
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Model
@@ -72,10 +58,13 @@ namespace library
                   Path to the model to load
 
       Modifies: [m_filePath, m_animationBuffer, m_skinningConstantBuffer,
-                 m_skinningConstantBuffer, m_aVertices, m_aAnimationData,
-                 m_aIndices, m_aBoneData, m_aBoneInfo, m_aTransforms,
-                 m_aBoneInfo, m_aTransforms, m_boneNameToIndexMap,
-                 m_pScene, m_timeSinceLoaded, m_globalInverseTransform].
+                 m_skinnedVertexBuffer, m_pAsset, m_aTransforms,
+                 m_aGlobalTransforms, m_aKeyCursors, m_aAnimationLayers,
+                 m_aPoses, m_aLayerPoseIndices, m_skinnedVertexCache,
+                 m_aSkinningPalette, m_timeSinceLoaded,
+                 m_skinningPaletteFormat, m_uMeshOptimizationFlags,
+                 m_bUseAssetCache, m_bIsSkinnedVertexBufferDirty,
+                 m_bIsCpuSkinningEnabled].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Model::Model definition (remove the comment)
@@ -84,31 +73,49 @@ namespace library
         m_filePath(filePath),
         m_animationBuffer(),
         m_skinningConstantBuffer(),
-        m_aVertices(),
-        m_aAnimationData(),
-        m_aIndices(),
-        m_aBoneData(),
-        m_aBoneInfo(),
+        m_skinnedVertexBuffer(),
+        m_pAsset(),
         m_aTransforms(),
-        m_boneNameToIndexMap(),
-        m_pScene(),
+        m_aSkinningPalette(),
+        m_aGlobalTransforms(),
+        m_aKeyCursors(),
+        m_aAnimationLayers(),
+        m_aPoses(),
+        m_aLayerPoseIndices(),
+        m_skinnedVertexCache(),
+        m_importProfiler(),
         m_timeSinceLoaded(),
-        m_globalInverseTransform(),
+        m_skinningPaletteFormat(eSkinningPaletteFormat::AFFINE_3X4),
+        m_uMeshOptimizationFlags(MeshOptimizer::DEFAULT_FLAGS),
+        m_bUseAssetCache(TRUE),
+        m_bIsSkinnedVertexBufferDirty(FALSE),
+        m_bIsCpuSkinningEnabled(TRUE),
+        m_bIsLoaded(FALSE),
         Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f))
     {
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Initialize
 
-      Summary:  Load and initialize the 3d model and create buffers
+      Summary:  Load and initialize the 3d model and create buffers. A
+                model file already loaded by another instance with the
+                same import flags is not imported again; its asset is
+                shared and only the per-instance buffers are created.
+                Models may be initialized on loader threads with a
+                deferred context, whose commands must be executed
+                before the model is marked loaded. A file is imported
+                and cooked by one thread at a time; the other threads
+                loading it wait and share its asset.
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
 
-      Modifies: [m_pScene, m_globalInverseTransform, m_animationBuffer,
-                 m_skinningConstantBuffer].
+      Modifies: [m_pAsset, m_aGlobalTransforms, m_aKeyCursors,
+                 m_aAnimationLayers, m_aTransforms, m_aSkinningPalette,
+                 m_skinningConstantBuffer, m_skinnedVertexCache,
+                 m_skinnedVertexBuffer].
 
       Returns:  HRESULT
                   Status code
@@ -120,51 +127,80 @@ namespace library
     {
         HRESULT hr = S_OK;
 
-        m_pScene = sm_pImporter->ReadFile(m_filePath.string().c_str(), ASSIMP_LOAD_FLAGS);
-
-        if (m_pScene)
+        std::error_code errorCode;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(m_filePath, errorCode);
+        if (errorCode)
         {
-            XMMATRIX rootNodeTransform = ConvertMatrix(m_pScene->mRootNode->mTransformation);
-            XMVECTOR det = XMMatrixDeterminant(rootNodeTransform);
-            m_globalInverseTransform = XMMatrixInverse(&det, rootNodeTransform);
-            hr = initFromScene(pDevice, pImmediateContext, m_pScene, m_filePath);
+            canonicalPath = m_filePath;
         }
-        else
+        std::wstring szAssetKey = canonicalPath.wstring() + L"|" + std::to_wstring(ASSIMP_LOAD_FLAGS) + L"|" + std::to_wstring(m_uMeshOptimizationFlags)
+            + L"|" + std::to_wstring(static_cast<UINT>(m_vertexFormat));
+
+        // Held while the file is imported so its cooked file is written once
+        std::shared_ptr<std::mutex> pImportMutex;
+        std::unique_lock<std::mutex> importLock;
+        if (m_bUseAssetCache)
         {
-            hr = E_FAIL;
-            OutputDebugString(L"Error parsing ");
-            OutputDebugString(m_filePath.c_str());
-            OutputDebugString(L": ");
-            OutputDebugStringA(sm_pImporter->GetErrorString());
-            OutputDebugString(L"\n");
+            {
+                std::lock_guard<std::mutex> lock(sm_assetCacheMutex);
+                std::shared_ptr<std::mutex>& pMutex = sm_importMutexes[canonicalPath.wstring()];
+                if (!pMutex)
+                {
+                    pMutex = std::make_shared<std::mutex>();
+                }
+                pImportMutex = pMutex;
+            }
+
+            importLock = std::unique_lock<std::mutex>(*pImportMutex);
+
+            std::lock_guard<std::mutex> lock(sm_assetCacheMutex);
+            auto iAsset = sm_assetCache.find(szAssetKey);
+            if (iAsset != sm_assetCache.end())
+            {
+                m_pAsset = iAsset->second.lock();
+            }
         }
 
-        D3D11_BUFFER_DESC bd_anim =
+        if (m_pAsset)
         {
-            .ByteWidth = sizeof(AnimationData) * static_cast<UINT>(m_aAnimationData.size()),
-            .Usage = D3D11_USAGE_DEFAULT,
-            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
-            .CPUAccessFlags = 0,
-            .MiscFlags = 0,
-            .StructureByteStride = 0
-        };
+            hr = initFromAsset(pDevice);
+        }
+        else
+        {
+            hr = initAsset(pDevice, pImmediateContext);
 
-        D3D11_SUBRESOURCE_DATA initData_anim =
+            if (SUCCEEDED(hr) && m_bUseAssetCache)
+            {
+                std::lock_guard<std::mutex> lock(sm_assetCacheMutex);
+                sm_assetCache[szAssetKey] = m_pAsset;
+            }
+        }
+
+        if (importLock.owns_lock())
         {
-            .pSysMem = m_aAnimationData.data(),
-            .SysMemPitch = 0,
-            .SysMemSlicePitch = 0
-        };
+            importLock.unlock();
 
-        hr = pDevice->CreateBuffer(&bd_anim, &initData_anim, m_animationBuffer.GetAddressOf());
+            // The last thread that loaded the file erases its import mutex
+            std::lock_guard<std::mutex> lock(sm_assetCacheMutex);
+            pImportMutex.reset();
+            auto iImportMutex = sm_importMutexes.find(canonicalPath.wstring());
+            if (iImportMutex != sm_importMutexes.end() && iImportMutex->second.use_count() == 1)
+            {
+                sm_importMutexes.erase(iImportMutex);
+            }
+        }
 
-        if (FAILED(hr))        
+        if (FAILED(hr))
             return hr;
-    
+
+        // Only the rows of the bones the model has are uploaded, so the
+        // buffer is sized to the palette rather than to MAX_NUM_BONES
+        const UINT uNumBones = static_cast<UINT>(m_pAsset->aBoneInfo.size());
+        const UINT uNumPaletteRows = std::min(uNumBones, static_cast<UINT>(MAX_NUM_BONES)) * getNumPaletteRowsPerBone();
 
         D3D11_BUFFER_DESC bd_cs =
         {
-            .ByteWidth = sizeof(CBSkinning),
+            .ByteWidth = static_cast<UINT>(std::max(uNumPaletteRows, 1u) * sizeof(XMFLOAT4)),
             .Usage = D3D11_USAGE_DEFAULT,
             .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
             .CPUAccessFlags = 0,
@@ -177,7 +213,41 @@ namespace library
 
         if (FAILED(hr))       
             return hr;
-        
+
+        const UINT uNumJoints = static_cast<UINT>(m_pAsset->skeleton.aParentIndices.size());
+        m_aGlobalTransforms.resize(uNumJoints);
+        m_aKeyCursors.assign(m_pAsset->aAnimationClips.size(), std::vector<AnimationClip::KeyCursor>(uNumJoints));
+
+        if (!m_pAsset->aAnimationClips.empty())
+        {
+            m_aTransforms.assign(uNumBones, XMMatrixIdentity());
+            m_aSkinningPalette.resize(static_cast<size_t>(uNumBones) * getNumPaletteRowsPerBone());
+            for (UINT uBoneIndex = 0u; uBoneIndex < uNumBones; ++uBoneIndex)
+            {
+                writeSkinningPalette(uBoneIndex, m_aTransforms[uBoneIndex]);
+            }
+            PlayAnimation(0u, TRUE);
+        }
+
+        if (m_pAsset->pSkinningStreams && m_bIsCpuSkinningEnabled)
+        {
+            m_skinnedVertexCache.Initialize(m_pAsset->pSkinningStreams);
+
+            D3D11_BUFFER_DESC bd_skinned =
+            {
+                .ByteWidth = sizeof(SimpleVertex) * m_skinnedVertexCache.GetNumVertices(),
+                .Usage = D3D11_USAGE_DYNAMIC,
+                .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+                .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+                .MiscFlags = 0,
+                .StructureByteStride = 0
+            };
+
+            hr = pDevice->CreateBuffer(&bd_skinned, nullptr, m_skinnedVertexBuffer.GetAddressOf());
+
+            if (FAILED(hr))
+                return hr;
+        }
 
         return hr;
     }
@@ -190,7 +260,10 @@ namespace library
       Args:     FLOAT deltaTime
                   Time difference of a frame
 
-      Modifies: [m_aTransforms].
+      Modifies: [m_timeSinceLoaded, m_aAnimationLayers, m_aKeyCursors,
+                 m_aPoses, m_aLayerPoseIndices, m_aGlobalTransforms,
+                 m_aTransforms, m_skinnedVertexCache,
+                 m_bIsSkinnedVertexBufferDirty].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Model::Update definition (remove the comment)
@@ -198,23 +271,16 @@ namespace library
     void Model::Update(_In_ FLOAT deltaTime)
     {
         m_timeSinceLoaded += deltaTime;
-        XMMATRIX identity = XMMatrixIdentity();
-        if (m_pScene->HasAnimations()) {
-            FLOAT ticksPerSecond = static_cast<FLOAT>(m_pScene->mAnimations[0]->mTicksPerSecond != 0.0 ? m_pScene->mAnimations[0]->mTicksPerSecond : 25.0f);
-            FLOAT timeInTicks = m_timeSinceLoaded * ticksPerSecond;
-            FLOAT animationTimeTicks = fmod(timeInTicks, static_cast<FLOAT>(m_pScene->mAnimations[0]->mDuration));
+        if (!m_aAnimationLayers.empty()) {
+            updateAnimationLayers(deltaTime);
+            sampleAnimationLayers();
+            evaluateSkeleton();
 
-            if (m_pScene->mRootNode)
+            // Skin once on the CPU for every pass that cannot use the skinning shader
+            if (m_bIsCpuSkinningEnabled)
             {
-
-                readNodeHierarchy(animationTimeTicks, m_pScene->mRootNode, identity);
-
-                m_aTransforms.resize(m_aBoneInfo.size());
-
-                for (UINT i = 0u; i < m_aTransforms.size(); ++i)
-                {
-                    m_aTransforms[i] = m_aBoneInfo[i].FinalTransformation;
-                }
+                m_skinnedVertexCache.Update(m_aTransforms);
+                m_bIsSkinnedVertexBufferDirty = m_skinnedVertexCache.IsValid();
             }
         }
     }
@@ -246,340 +312,2170 @@ namespace library
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-     Method:   Model::GetNumVertices
-
-     Summary:  Returns the number of vetices
+      Method:   Model::GetSkinnedVertexBuffer
 
-     Returns:  UINT
+      Summary:  Returns the vertex buffer holding the CPU skinned
+                vertices, empty if the model is not animated
 
-   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::GetNumVertices() const
+      Returns:  ComPtr<ID3D11Buffer>&
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& Model::GetSkinnedVertexBuffer()
     {
-        return static_cast<UINT>(m_aVertices.size());
+        return m_skinnedVertexBuffer;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-       Method:   Model::GetNumIndices
+      Method:   Model::UpdateSkinnedVertexBuffer
 
-       Summary:  Returns the number of indices
+      Summary:  Uploads the vertices skinned by the last Update. Does
+                nothing if they were already uploaded.
 
-       Returns:  UINT
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to map the buffer
 
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::GetNumIndices() const
+      Modifies: [m_skinnedVertexBuffer, m_bIsSkinnedVertexBufferDirty].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::UpdateSkinnedVertexBuffer(_In_ ID3D11DeviceContext* pImmediateContext)
     {
-        return static_cast<UINT>(m_aIndices.size());
-    }
+        if (!m_skinnedVertexBuffer || !m_bIsSkinnedVertexBufferDirty)
+        {
+            return S_OK;
+        }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-       Method:   Model::GetBoneTransforms
+        D3D11_MAPPED_SUBRESOURCE mappedResource = {};
+        HRESULT hr = pImmediateContext->Map(m_skinnedVertexBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mappedResource);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
 
-       Summary:  Returns the vector containing bone transforms
+        m_skinnedVertexCache.CopyVertices(static_cast<SimpleVertex*>(mappedResource.pData));
+        pImmediateContext->Unmap(m_skinnedVertexBuffer.Get(), 0u);
 
-       Returns:  std::vector<XMMATRIX>&
+        m_bIsSkinnedVertexBufferDirty = FALSE;
 
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::vector<XMMATRIX>& Model::GetBoneTransforms()
-    {
-        return m_aTransforms;
+        return hr;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-        Method:   Model::GetBoneNameToIndexMap
-        
-        Summary:  Returns the bone name to index map
-        
-        Returns:  std::unordered_map<std::string, UINT>&
+      Method:   Model::GetSkinnedVertexCache
 
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const std::unordered_map<std::string, UINT>& Model::GetBoneNameToIndexMap() const
+      Summary:  Returns the vertices skinned on the CPU by the last
+                Update
+
+      Returns:  const SkinnedVertexCache&
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const SkinnedVertexCache& Model::GetSkinnedVertexCache() const
     {
-        return m_boneNameToIndexMap;
+        return m_skinnedVertexCache;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-        Method:   Model::countVerticesAndIndices
+      Method:   Model::GetSkinnedBounds
 
-        Summary:  Fill the BasicMeshEntry information
+      Summary:  Returns the world space bounds of the skinned mesh, for
+                culling
 
-        Args:     UINT& uOutNumVertices
-                    Total number of vertices
-                  UINT& uOutNumIndices
-                    Total number of indices
-                  const aiScene* pScene
-                    Pointer to an assimp scene object that contains the
-                    mesh information
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-     /*--------------------------------------------------------------------
-        TODO: Model::countVerticesAndIndices definition (remove the comment)
-     --------------------------------------------------------------------*/
-    void Model::countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene)
+      Args:     BoundingBox& bounds
+                  Bounds of the skinned mesh
+
+      Returns:  BOOL
+                  FALSE if the mesh has not been skinned on the CPU
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Model::GetSkinnedBounds(_Out_ BoundingBox& bounds) const
     {
-        for (UINT i = 0; i < pScene->mNumMeshes; i++)
+        if (!m_skinnedVertexCache.IsValid())
         {
-            m_aMeshes[i].uMaterialIndex = pScene->mMeshes[i]->mMaterialIndex;
-            m_aMeshes[i].uBaseIndex = uOutNumIndices;
-            m_aMeshes[i].uBaseVertex = uOutNumVertices;
-            m_aMeshes[i].uNumIndices = pScene->mMeshes[i]->mNumFaces * 3;
-
-            uOutNumIndices += pScene->mMeshes[i]->mNumFaces * 3;
-            uOutNumVertices += pScene->mMeshes[i]->mNumVertices;
+            bounds = BoundingBox();
+            return FALSE;
         }
+
+        m_skinnedVertexCache.GetBounds().Transform(bounds, m_world);
+
+        return TRUE;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-        Method:   Model::findNodeAnimOrNull
+      Method:   Model::Pick
 
-        Summary:  Find the aiNodeAnim with the givne node name in the given animation
+      Summary:  Tests a world space ray against the triangles of the
+                skinned mesh
 
-        Args:     const aiAnimation* pAnimation
-                    Pointer to an assimp animation object
-                  PCSTR pszNodeName
-                    Node name to find
+      Args:     FXMVECTOR origin
+                  Origin of the ray in world space
+                FXMVECTOR direction
+                  Normalized direction of the ray in world space
+                FLOAT& distance
+                  World space distance to the closest hit
 
-        Returns:  aiNodeAnim* or nullptr
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const aiNodeAnim* Model::findNodeAnimOrNull(_In_ const aiAnimation* pAnimation, _In_ PCSTR pszNodeName)
+      Returns:  BOOL
+                  TRUE if the ray hits the mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Model::Pick(_In_ FXMVECTOR origin, _In_ FXMVECTOR direction, _Out_ FLOAT& distance) const
     {
-        for (UINT i = 0u; i < pAnimation->mNumChannels; ++i)
+        distance = 0.0f;
+
+        if (!m_skinnedVertexCache.IsValid())
+        {
+            return FALSE;
+        }
+
+        XMVECTOR det = XMMatrixDeterminant(m_world);
+        const XMMATRIX inverseWorld = XMMatrixInverse(&det, m_world);
+
+        // The model space distance is scaled by the length of the transformed direction
+        const XMVECTOR localOrigin = XMVector3TransformCoord(origin, inverseWorld);
+        const XMVECTOR localDirection = XMVector3TransformNormal(direction, inverseWorld);
+        const FLOAT localLength = XMVectorGetX(XMVector3Length(localDirection));
+        if (localLength <= 0.0f)
         {
-            const aiNodeAnim* pNodeAnim = pAnimation->mChannels[i];
+            return FALSE;
+        }
+        const XMVECTOR localDirectionNormalized = XMVectorScale(localDirection, 1.0f / localLength);
 
-            if (strncmp(pNodeAnim->mNodeName.data, pszNodeName, pNodeAnim->mNodeName.length) == 0)
+        BOOL bHasHit = FALSE;
+        FLOAT closestDistance = FLT_MAX;
+
+        for (const BasicMeshEntry& mesh : m_aMeshes)
+        {
+            const void* pMeshIndices = m_pAsset->indexFormat == DXGI_FORMAT_R32_UINT
+                ? static_cast<const void*>(m_pAsset->aWideIndices.data() + mesh.uBaseIndex)
+                : static_cast<const void*>(m_pAsset->aIndices.data() + mesh.uBaseIndex);
+
+            FLOAT meshDistance = 0.0f;
+            if (m_skinnedVertexCache.Intersects(
+                localOrigin,
+                localDirectionNormalized,
+                pMeshIndices,
+                m_pAsset->indexFormat,
+                mesh.uNumIndices,
+                mesh.uBaseVertex,
+                meshDistance
+            ) && meshDistance < closestDistance)
             {
-                return pNodeAnim;
+                closestDistance = meshDistance;
+                bHasHit = TRUE;
             }
         }
 
-        return nullptr;
+        if (bHasHit)
+        {
+            distance = closestDistance / localLength;
+        }
+
+        return bHasHit;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-        Method:   Model::findPosition
+      Method:   Model::SharesAsset
 
-        Summary:  Find the index of the position key right before the given animation time
+      Summary:  Returns whether both models were initialized from the
+                same cached asset, and so use the same vertex, index and
+                animation buffers
 
-        Args:     FLOAT animationTimeTicks
-                    Animation time
-                  const aiNodeAnim* pNodeAnim
-                     Pointer to an assimp node anim object
+      Args:     const Model& other
+                  Model to compare with
 
-        Returns:  UINT
-                    Index of the key
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+      Returns:  BOOL
+                  TRUE if the asset is shared
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Model::SharesAsset(_In_ const Model& other) const
     {
-        assert(pNodeAnim->mNumPositionKeys > 0);
+        return m_pAsset && m_pAsset == other.m_pAsset;
+    }
 
-        for (UINT i = 0; i < pNodeAnim->mNumPositionKeys - 1; ++i)
-        {
-            FLOAT t = static_cast<FLOAT>(pNodeAnim->mPositionKeys[i + 1].mTime);
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SetSkinningPaletteFormat
 
-            if (animationTimeTicks < t)
-            {
-                return i;
-            }
-        }
+      Summary:  Sets how the bone transforms are laid out in the
+                skinning constant buffer. The buffer is sized for the
+                format in Initialize, so this must be called before it.
+                The vertex shader bound to the model has to read the
+                same format.
 
-        return 0u;
+      Args:     eSkinningPaletteFormat format
+                  AFFINE_3X4 for three float4 rows per bone, or
+                  DUAL_QUATERNION for two. Dual quaternions cannot
+                  represent scale, which is dropped.
+
+      Modifies: [m_skinningPaletteFormat].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetSkinningPaletteFormat(_In_ eSkinningPaletteFormat format)
+    {
+        assert(!m_skinningConstantBuffer);
+        assert(format < eSkinningPaletteFormat::COUNT);
+
+        m_skinningPaletteFormat = format;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-        Method:   Model::findRotation
+      Method:   Model::GetSkinningPaletteFormat
 
-        Summary:  Find the index of the rotation key right before the given animation time
+      Summary:  Returns the layout of the bone palette
 
-        Args:     FLOAT animationTimeTicks
-                    Animation time
-                  const aiNodeAnim* pNodeAnim
-                     Pointer to an assimp node anim object
+      Returns:  eSkinningPaletteFormat
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eSkinningPaletteFormat Model::GetSkinningPaletteFormat() const
+    {
+        return m_skinningPaletteFormat;
+    }
 
-        Returns:  UINT
-                    Index of the key
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SetCpuSkinningEnabled
+
+      Summary:  Sets whether Update also skins the vertices on the CPU
+                for the shadow pass, culling and picking. Models drawn
+                only through the skinning shader, like the instances of
+                a crowd, turn it off so neither the skinned vertices
+                nor their vertex buffer are created. Must be called
+                before Initialize.
+
+      Args:     BOOL bIsEnabled
+                  TRUE to skin on the CPU, the default
+
+      Modifies: [m_bIsCpuSkinningEnabled].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetCpuSkinningEnabled(_In_ BOOL bIsEnabled)
     {
-        assert(pNodeAnim->mNumRotationKeys > 0);
+        assert(!m_skinningConstantBuffer);
 
-        for (UINT i = 0u; i < pNodeAnim->mNumRotationKeys - 1; ++i)
-        {
-            FLOAT t = static_cast<FLOAT>(pNodeAnim->mRotationKeys[i + 1].mTime);
+        m_bIsCpuSkinningEnabled = bIsEnabled;
+    }
 
-            if (animationTimeTicks < t)
-            {
-                return i;
-            }
-        }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::IsCpuSkinningEnabled
+
+      Summary:  Returns whether Update also skins the vertices on the
+                CPU
+
+      Returns:  BOOL
+                  TRUE if the mesh is skinned on the CPU
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Model::IsCpuSkinningEnabled() const
+    {
+        return m_bIsCpuSkinningEnabled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetSkinningPalette
+
+      Summary:  Returns the bone palette written by the last Update, as
+                float4 rows in the order the shader reads them. It can
+                be copied to the skinning constant buffer as is.
 
-        return 0u;
+      Returns:  const std::vector<XMFLOAT4>&
+                  Palette rows, empty if the model is not animated
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<XMFLOAT4>& Model::GetSkinningPalette() const
+    {
+        return m_aSkinningPalette;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-       Method:   Model::findScaling
+      Method:   Model::SetMeshOptimizationFlags
 
-       Summary:  Find the index of the scaling key right before the given animation time
+      Summary:  Sets how the meshes are reordered when the model file is
+                imported. The flags are part of the asset cache key and
+                of the cooked file, so models with different flags do
+                not share their asset. Must be called before Initialize.
 
-       Args:     FLOAT animationTimeTicks
-                   Animation time
-                 const aiNodeAnim* pNodeAnim
-                    Pointer to an assimp node anim object
+      Args:     UINT uFlags
+                  Combination of MeshOptimizer::OPTIMIZE_VERTEX_CACHE,
+                  OPTIMIZE_OVERDRAW and OPTIMIZE_VERTEX_FETCH, 0 to keep
+                  the order assimp emits
 
-       Returns:  UINT
-                   Index of the key
+      Modifies: [m_uMeshOptimizationFlags].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    void Model::SetMeshOptimizationFlags(_In_ UINT uFlags)
     {
-        assert(pNodeAnim->mNumScalingKeys > 0);
+        assert(!m_pAsset);
 
-        for (UINT i = 0u; i < pNodeAnim->mNumScalingKeys - 1; ++i)
-        {
-            FLOAT t = static_cast<FLOAT>(pNodeAnim->mScalingKeys[i + 1].mTime);
+        m_uMeshOptimizationFlags = uFlags;
+    }
 
-            if (animationTimeTicks < t)
-            {
-                return i;
-            }
-        }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetAnimationDataStride
+
+      Summary:  Returns the stride of the animation buffer
 
-        return 0u;
+      Returns:  UINT
+                  Size of AnimationData or PackedAnimationData
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetAnimationDataStride() const
+    {
+        return m_vertexFormat == eVertexFormat::PACKED ? sizeof(PackedAnimationData) : sizeof(AnimationData);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-        Method:   Model::getBoneId
+      Method:   Model::GetLodStatistics
 
-        Summary:  Find the the index of the bone
+      Summary:  Returns the triangles, largest error and simplification
+                time of each detail level summed over the meshes. The
+                time is 0 when the model was loaded from its cooked
+                file.
 
-        Args:      const aiBone* pBone
-                     Pointer to an assimp bone object
+      Returns:  const std::vector<LodStatistics>&
+                  Statistics of each detail level, empty before
+                  Initialize
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<LodStatistics>& Model::GetLodStatistics() const
+    {
+        static const std::vector<LodStatistics> aEmptyStatistics;
 
-        Modifies: [m_boneNameToIndexMap].
+        return m_pAsset ? m_pAsset->aLodStatistics : aEmptyStatistics;
+    }
 
-        Returns:  UINT
-                    Index of the bone
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::getBoneId(_In_ const aiBone* pBone)
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetBoneWeightErrors
+
+      Summary:  Returns for each mesh the largest difference between a
+                bone weight used for skinning, after the smallest weights
+                were dropped and the others renormalized, and the
+                imported weight
+
+      Returns:  const std::vector<FLOAT>&
+                  Largest weight error of each mesh, empty before
+                  Initialize
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<FLOAT>& Model::GetBoneWeightErrors() const
     {
-        UINT uBoneIndex = 0u;
-        PCSTR pszBoneName = pBone->mName.C_Str();
-        if (!m_boneNameToIndexMap.contains(pszBoneName))
-        {
-            uBoneIndex = static_cast<UINT>(m_boneNameToIndexMap.size());
-            m_boneNameToIndexMap[pszBoneName] = uBoneIndex;
-        }
-        else
+        static const std::vector<FLOAT> aEmptyErrors;
+
+        return m_pAsset ? m_pAsset->aBoneWeightErrors : aEmptyErrors;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::CullMeshlets
+
+      Summary:  Culls the meshlets of the full detail level of a mesh
+                against the view frustum and their normal cones, and
+                adds the work done to the statistics
+
+      Args:     UINT uMeshIndex
+                  Index of the mesh
+                FXMVECTOR eyePosition
+                  Position of the camera in world space
+                CXMMATRIX viewProjection
+                  View and projection transform of the camera
+                std::vector<Meshlet>& aOutRanges
+                  Index ranges of the visible triangles, drawn with the
+                  base vertex of the mesh
+                MeshletCullingStatistics& statistics
+                  Statistics the meshlets, triangles and time are added to
+
+      Returns:  BOOL
+                  FALSE if the mesh has no meshlets and must be drawn
+                  whole
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Model::CullMeshlets(
+        _In_ UINT uMeshIndex,
+        _In_ FXMVECTOR eyePosition,
+        _In_ CXMMATRIX viewProjection,
+        _Out_ std::vector<Meshlet>& aOutRanges,
+        _Inout_ MeshletCullingStatistics& statistics
+    ) const
+    {
+        aOutRanges.clear();
+
+        if (!m_pAsset || uMeshIndex >= m_aMeshes.size() || m_aMeshes[uMeshIndex].uNumMeshlets == 0u)
         {
-            uBoneIndex = m_boneNameToIndexMap[pszBoneName];
+            return FALSE;
         }
 
-        return uBoneIndex;
-    }
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        // The bounds are in model space, so the eye is moved there instead
+        const BasicMeshEntry& mesh = m_aMeshes[uMeshIndex];
+        const XMVECTOR modelEyePosition = XMVector3TransformCoord(eyePosition, XMMatrixInverse(nullptr, m_world));
+        const UINT uNumVisibleTriangles = MeshletCuller::Cull(
+            m_pAsset->aMeshlets.data() + mesh.uFirstMeshlet,
+            m_pAsset->aMeshletBounds.data() + mesh.uFirstMeshlet / MeshletCuller::MESHLET_GROUP_SIZE,
+            mesh.uNumMeshlets,
+            modelEyePosition,
+            m_world * viewProjection,
+            aOutRanges
+        );
+
+        QueryPerformanceCounter(&endingTime);
 
+        statistics.uNumMeshlets += mesh.uNumMeshlets;
+        statistics.uNumRanges += static_cast<UINT>(aOutRanges.size());
+        statistics.uNumTriangles += mesh.uNumIndices / 3u;
+        statistics.uNumVisibleTriangles += uNumVisibleTriangles;
+        statistics.cullingTime += static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart);
+
+        return TRUE;
+    }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::getVertices
+      Method:   Model::SetLoaded
 
-      Summary:  Returns the vertices data
+      Summary:  Marks whether the buffers and textures of the model are
+                ready to draw. A model initialized with a deferred context
+                is only loaded once its command list has been executed.
 
-      Returns:  const SimpleVertex*
-                  Array of vertices
+      Args:     BOOL bIsLoaded
+                  TRUE when the model can be drawn
+
+      Modifies: [m_bIsLoaded].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const SimpleVertex* Model::getVertices() const
+    void Model::SetLoaded(_In_ BOOL bIsLoaded)
     {
-        return m_aVertices.data();
+        m_bIsLoaded.store(bIsLoaded, std::memory_order_release);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::getIndices
+      Method:   Model::IsLoaded
 
-      Summary:  Returns the indices data
+      Summary:  Returns whether the model can be drawn
 
-      Returns:  const WORD*
-                  Array of indices
+      Returns:  BOOL
+                  TRUE if the model has been marked loaded
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const WORD* Model::getIndices() const
+    BOOL Model::IsLoaded() const
     {
-        return m_aIndices.data();
+        return m_bIsLoaded.load(std::memory_order_acquire);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetImportProfiler
+
+      Summary:  Returns the stage timings and allocations of the import
+                done by this instance, empty if it shared the asset of
+                another instance
+
+      Returns:  const ImportProfiler&
+                  Profiler of the last import
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const ImportProfiler& Model::GetImportProfiler() const
+    {
+        return m_importProfiler;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+     Method:   Model::GetNumVertices
+
+     Summary:  Returns the number of vetices
+
+     Returns:  UINT
+
+   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumVertices() const
+    {
+        return m_pAsset ? static_cast<UINT>(m_pAsset->aVertices.size()) : 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+       Method:   Model::GetNumIndices
+
+       Summary:  Returns the number of indices
+
+       Returns:  UINT
+
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumIndices() const
+    {
+        if (!m_pAsset)
+        {
+            return 0u;
+        }
+
+        return static_cast<UINT>(m_pAsset->indexFormat == DXGI_FORMAT_R32_UINT ? m_pAsset->aWideIndices.size() : m_pAsset->aIndices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+       Method:   Model::GetIndexFormat
+
+       Summary:  Returns the format of the indices, 32-bit only when a
+                 mesh has more vertices than a 16-bit index can address
+
+       Returns:  DXGI_FORMAT
+                   DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DXGI_FORMAT Model::GetIndexFormat() const
+    {
+        return m_pAsset && m_pAsset->indexFormat == DXGI_FORMAT_R32_UINT ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+       Method:   Model::GetBoneTransforms
+
+       Summary:  Returns the vector containing bone transforms
+
+       Returns:  std::vector<XMMATRIX>&
+
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<XMMATRIX>& Model::GetBoneTransforms()
+    {
+        return m_aTransforms;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetBoneNameToIndexMap
+        
+        Summary:  Returns the bone name to index map
+        
+        Returns:  std::unordered_map<std::string, UINT>&
+
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::unordered_map<std::string, UINT>& Model::GetBoneNameToIndexMap() const
+    {
+        return m_pAsset->boneNameToIndexMap;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetNumAnimations
+
+        Summary:  Returns the number of animations bound to the skeleton
+
+        Returns:  UINT
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumAnimations() const
+    {
+        return static_cast<UINT>(m_pAsset->aAnimationClips.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetNumAnimatedNodes
+
+        Summary:  Returns the number of joints driven by a channel of the
+                  given animation
+
+        Args:     UINT uAnimationIndex
+                    Index of the animation
+
+        Returns:  UINT
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumAnimatedNodes(_In_ UINT uAnimationIndex) const
+    {
+        return m_pAsset->aAnimationClips[uAnimationIndex]->GetNumAnimatedJoints();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetNumStaticNodes
+
+        Summary:  Returns the number of joints that keep their bind
+                  transform in the given animation
+
+        Args:     UINT uAnimationIndex
+                    Index of the animation
+
+        Returns:  UINT
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumStaticNodes(_In_ UINT uAnimationIndex) const
+    {
+        return static_cast<UINT>(m_pAsset->skeleton.aParentIndices.size()) - m_pAsset->aAnimationClips[uAnimationIndex]->GetNumAnimatedJoints();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetNumSampledPoses
+
+        Summary:  Returns the number of poses sampled for the layers in
+                  the last update. Layers playing the same clip at the
+                  same time share one pose.
+
+        Returns:  UINT
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumSampledPoses() const
+    {
+        if (m_aLayerPoseIndices.empty())
+        {
+            return 0u;
+        }
+
+        // Poses are numbered in the order they are sampled
+        return *std::max_element(m_aLayerPoseIndices.begin(), m_aLayerPoseIndices.end()) + 1u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::PlayAnimation
+
+        Summary:  Stop every layer and play the given animation alone
+
+        Args:     UINT uAnimationIndex
+                    Index of the animation
+                  BOOL bLoop
+                    Whether the animation restarts when it ends
+
+        Modifies: [m_aAnimationLayers].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::PlayAnimation(_In_ UINT uAnimationIndex, _In_ BOOL bLoop)
+    {
+        assert(uAnimationIndex < m_pAsset->aAnimationClips.size());
+
+        m_aAnimationLayers.clear();
+        m_aAnimationLayers.push_back(
+            {
+                .uAnimationIndex = uAnimationIndex,
+                .time = 0.0f,
+                .animationTimeTicks = 0.0f,
+                .weight = 1.0f,
+                .fadeRate = 0.0f,
+                .bLoop = bLoop,
+                .bAdditive = FALSE
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::CrossFadeAnimation
+
+        Summary:  Start the given animation from zero weight and fade out
+                  every other non-additive layer over the same duration
+
+        Args:     UINT uAnimationIndex
+                    Index of the animation
+                  FLOAT fadeDuration
+                    Duration of the fade in seconds
+                  BOOL bLoop
+                    Whether the animation restarts when it ends
+
+        Modifies: [m_aAnimationLayers].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::CrossFadeAnimation(_In_ UINT uAnimationIndex, _In_ FLOAT fadeDuration, _In_ BOOL bLoop)
+    {
+        assert(uAnimationIndex < m_pAsset->aAnimationClips.size());
+
+        if (fadeDuration <= 0.0f)
+        {
+            PlayAnimation(uAnimationIndex, bLoop);
+            return;
+        }
+
+        for (AnimationLayer& layer : m_aAnimationLayers)
+        {
+            if (!layer.bAdditive)
+            {
+                layer.fadeRate = -layer.weight / fadeDuration;
+            }
+        }
+
+        m_aAnimationLayers.push_back(
+            {
+                .uAnimationIndex = uAnimationIndex,
+                .time = 0.0f,
+                .animationTimeTicks = 0.0f,
+                .weight = 0.0f,
+                .fadeRate = 1.0f / fadeDuration,
+                .bLoop = bLoop,
+                .bAdditive = FALSE
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SetAnimationWeight
+
+        Summary:  Set the weight of the layer playing the given animation,
+                  adding a looping layer if there is none. A weight of
+                  zero removes the layer.
+
+        Args:     UINT uAnimationIndex
+                    Index of the animation
+                  FLOAT weight
+                    Weight of the layer
+                  BOOL bAdditive
+                    Whether the layer is added on top of the blend
+
+        Modifies: [m_aAnimationLayers].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetAnimationWeight(_In_ UINT uAnimationIndex, _In_ FLOAT weight, _In_ BOOL bAdditive)
+    {
+        assert(uAnimationIndex < m_pAsset->aAnimationClips.size());
+
+        auto iLayer = std::find_if(m_aAnimationLayers.begin(), m_aAnimationLayers.end(),
+            [uAnimationIndex, bAdditive](const AnimationLayer& layer)
+            {
+                return layer.uAnimationIndex == uAnimationIndex && layer.bAdditive == bAdditive;
+            }
+        );
+
+        if (weight <= 0.0f)
+        {
+            if (iLayer != m_aAnimationLayers.end())
+            {
+                m_aAnimationLayers.erase(iLayer);
+            }
+            return;
+        }
+
+        if (iLayer != m_aAnimationLayers.end())
+        {
+            iLayer->weight = weight;
+            iLayer->fadeRate = 0.0f;
+            return;
+        }
+
+        m_aAnimationLayers.push_back(
+            {
+                .uAnimationIndex = uAnimationIndex,
+                .time = 0.0f,
+                .animationTimeTicks = 0.0f,
+                .weight = weight,
+                .fadeRate = 0.0f,
+                .bLoop = TRUE,
+                .bAdditive = bAdditive
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SetNumImportThreads
+
+        Summary:  Limit the number of threads that import the meshes of
+                  a model. Zero lets the parallel algorithms of the
+                  standard library pick the number of threads.
+
+        Args:     UINT uNumThreads
+                    Number of threads, including the calling one
+
+        Modifies: [sm_uNumImportThreads].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetNumImportThreads(_In_ UINT uNumThreads)
+    {
+        sm_uNumImportThreads = uNumThreads;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::bindAnimation
+
+        Summary:  Convert the given animation into a clip that follows
+                  the joint order of the skeleton
+
+        Args:     const aiAnimation* pAnimation
+                    Pointer to an assimp animation object
+
+        Modifies: [m_pAsset].
+
+        Returns:  HRESULT
+                    Status code
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::bindAnimation(_In_ const aiAnimation* pAnimation)
+    {
+        std::shared_ptr<AnimationClip> clip = std::make_shared<AnimationClip>();
+
+        HRESULT hr = clip->Initialize(pAnimation, m_pAsset->skeleton.aNames);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_pAsset->aAnimationClips.push_back(clip);
+
+        UINT uAnimationIndex = static_cast<UINT>(m_pAsset->aAnimationClips.size()) - 1u;
+        CHAR szDebugMessage[256];
+        sprintf_s(szDebugMessage, "Bound animation %u: %u animated nodes, %u static nodes\n", uAnimationIndex, GetNumAnimatedNodes(uAnimationIndex), GetNumStaticNodes(uAnimationIndex));
+        OutputDebugStringA(szDebugMessage);
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::cookAsset
+
+        Summary:  Write the asset to a cooked file that initAsset can
+                  load instead of importing the model again
+
+        Args:     const std::filesystem::path& cookedFilePath
+                    Path to the cooked file
+
+        Returns:  HRESULT
+                    Status code
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::cookAsset(_In_ const std::filesystem::path& cookedFilePath) const
+    {
+        CookedModelWriter writer;
+
+        writer.AddSection(eCookedSection::VERTICES, m_pAsset->aVertices);
+        writer.AddSection(eCookedSection::NORMAL_DATA, m_pAsset->aNormalData);
+        writer.AddSection(eCookedSection::ANIMATION_DATA, m_pAsset->aAnimationData);
+        writer.AddSection(eCookedSection::BONE_WEIGHT_ERRORS, m_pAsset->aBoneWeightErrors);
+        writer.AddSection(eCookedSection::INDICES, m_pAsset->aIndices);
+        writer.AddSection(eCookedSection::WIDE_INDICES, m_pAsset->aWideIndices);
+        writer.AddSection(eCookedSection::MESHES, m_pAsset->aMeshes);
+        writer.AddSection(eCookedSection::MESHLETS, m_pAsset->aMeshlets);
+        writer.AddSection(eCookedSection::MESHLET_BOUNDS, m_pAsset->aMeshletBounds);
+
+        std::vector<CookedMaterial> aMaterials;
+        aMaterials.reserve(m_pAsset->aMaterialTexturePaths.size());
+        for (const MaterialTexturePaths& paths : m_pAsset->aMaterialTexturePaths)
+        {
+            aMaterials.push_back(
+                CookedMaterial
+                {
+                    .diffuse = writer.AddString(paths.szDiffuse),
+                    .specular = writer.AddString(paths.szSpecular),
+                    .normal = writer.AddString(paths.szNormal)
+                }
+            );
+        }
+        writer.AddSection(eCookedSection::MATERIALS, aMaterials);
+
+        std::vector<XMFLOAT4X4> aBoneOffsets(m_pAsset->aBoneInfo.size());
+        for (size_t i = 0u; i < aBoneOffsets.size(); ++i)
+        {
+            XMStoreFloat4x4(&aBoneOffsets[i], m_pAsset->aBoneInfo[i].OffsetMatrix);
+        }
+        writer.AddSection(eCookedSection::BONE_OFFSETS, aBoneOffsets);
+
+        std::vector<CookedString> aBoneNames(m_pAsset->boneNameToIndexMap.size());
+        for (const auto& [szName, uBoneIndex] : m_pAsset->boneNameToIndexMap)
+        {
+            aBoneNames[uBoneIndex] = writer.AddString(szName);
+        }
+        writer.AddSection(eCookedSection::BONE_NAMES, aBoneNames);
+
+        const Skeleton& skeleton = m_pAsset->skeleton;
+        std::vector<CookedString> aJointNames;
+        aJointNames.reserve(skeleton.aNames.size());
+        for (const std::string& szName : skeleton.aNames)
+        {
+            aJointNames.push_back(writer.AddString(szName));
+        }
+
+        std::vector<XMFLOAT4X4> aBindTransforms(skeleton.aBindTransforms.size());
+        for (size_t i = 0u; i < aBindTransforms.size(); ++i)
+        {
+            XMStoreFloat4x4(&aBindTransforms[i], skeleton.aBindTransforms[i]);
+        }
+
+        writer.AddSection(eCookedSection::JOINT_NAMES, aJointNames);
+        writer.AddSection(eCookedSection::JOINT_PARENTS, skeleton.aParentIndices);
+        writer.AddSection(eCookedSection::JOINT_BONES, skeleton.aBoneIndices);
+        writer.AddSection(eCookedSection::JOINT_BIND_SCALES, skeleton.aBindScales);
+        writer.AddSection(eCookedSection::JOINT_BIND_ROTATIONS, skeleton.aBindRotations);
+        writer.AddSection(eCookedSection::JOINT_BIND_TRANSLATIONS, skeleton.aBindTranslations);
+        writer.AddSection(eCookedSection::JOINT_BIND_TRANSFORMS, aBindTransforms);
+
+        std::vector<CookedClip> aClips;
+        std::vector<CookedTrack> aTracks;
+        std::vector<FLOAT> aPositionTimes;
+        std::vector<XMFLOAT3> aPositions;
+        std::vector<FLOAT> aRotationTimes;
+        std::vector<UINT64> aRotations;
+        std::vector<FLOAT> aScalingTimes;
+        std::vector<XMFLOAT3> aScales;
+        for (const std::shared_ptr<AnimationClip>& clip : m_pAsset->aAnimationClips)
+        {
+            aClips.push_back(
+                CookedClip
+                {
+                    .uSourceSize = static_cast<UINT64>(clip->GetSourceSize()),
+                    .ticksPerSecond = clip->GetTicksPerSecond(),
+                    .durationTicks = clip->GetDurationTicks(),
+                    .uFirstTrack = static_cast<UINT>(aTracks.size()),
+                    .uNumTracks = static_cast<UINT>(clip->GetTracks().size())
+                }
+            );
+
+            for (const AnimationClip::Track& track : clip->GetTracks())
+            {
+                aTracks.push_back(
+                    CookedTrack
+                    {
+                        .uFirstPositionKey = static_cast<UINT>(aPositions.size()),
+                        .uNumPositionKeys = static_cast<UINT>(track.aPositions.size()),
+                        .uFirstRotationKey = static_cast<UINT>(aRotations.size()),
+                        .uNumRotationKeys = static_cast<UINT>(track.aRotations.size()),
+                        .uFirstScalingKey = static_cast<UINT>(aScales.size()),
+                        .uNumScalingKeys = static_cast<UINT>(track.aScales.size())
+                    }
+                );
+
+                aPositionTimes.insert(aPositionTimes.end(), track.aPositionTimes.begin(), track.aPositionTimes.end());
+                aPositions.insert(aPositions.end(), track.aPositions.begin(), track.aPositions.end());
+                aRotationTimes.insert(aRotationTimes.end(), track.aRotationTimes.begin(), track.aRotationTimes.end());
+                aRotations.insert(aRotations.end(), track.aRotations.begin(), track.aRotations.end());
+                aScalingTimes.insert(aScalingTimes.end(), track.aScalingTimes.begin(), track.aScalingTimes.end());
+                aScales.insert(aScales.end(), track.aScales.begin(), track.aScales.end());
+            }
+        }
+
+        writer.AddSection(eCookedSection::CLIPS, aClips);
+        writer.AddSection(eCookedSection::TRACKS, aTracks);
+        writer.AddSection(eCookedSection::POSITION_TIMES, aPositionTimes);
+        writer.AddSection(eCookedSection::POSITION_KEYS, aPositions);
+        writer.AddSection(eCookedSection::ROTATION_TIMES, aRotationTimes);
+        writer.AddSection(eCookedSection::ROTATION_KEYS, aRotations);
+        writer.AddSection(eCookedSection::SCALING_TIMES, aScalingTimes);
+        writer.AddSection(eCookedSection::SCALING_KEYS, aScales);
+
+        return writer.Save(cookedFilePath, m_filePath, ASSIMP_LOAD_FLAGS, m_uMeshOptimizationFlags, m_pAsset->globalInverseTransform);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::countVerticesAndIndices
+
+        Summary:  Fill the BasicMeshEntry information
+
+        Args:     UINT& uOutNumVertices
+                    Total number of vertices
+                  UINT& uOutNumIndices
+                    Total number of indices
+                  const aiScene* pScene
+                    Pointer to an assimp scene object that contains the
+                    mesh information
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+     /*--------------------------------------------------------------------
+        TODO: Model::countVerticesAndIndices definition (remove the comment)
+     --------------------------------------------------------------------*/
+    void Model::countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene)
+    {
+        for (UINT i = 0; i < pScene->mNumMeshes; i++)
+        {
+            m_aMeshes[i].uMaterialIndex = pScene->mMeshes[i]->mMaterialIndex;
+            m_aMeshes[i].uBaseIndex = uOutNumIndices;
+            m_aMeshes[i].uBaseVertex = uOutNumVertices;
+            m_aMeshes[i].uNumIndices = pScene->mMeshes[i]->mNumFaces * 3;
+
+            uOutNumIndices += pScene->mMeshes[i]->mNumFaces * 3;
+            uOutNumVertices += pScene->mMeshes[i]->mNumVertices;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::evaluateSkeleton
+
+        Summary:  Blend the sampled layer poses and compute the bone
+                  transforms in a single pass over the joints. Joints
+                  are visited in array order, which puts every parent
+                  before its children, so each global transform is a
+                  single multiply with an already computed one.
+
+        Modifies: [m_aGlobalTransforms, m_aTransforms,
+                   m_aSkinningPalette].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::evaluateSkeleton()
+    {
+        const XMVECTOR zero = XMVectorZero();
+        const XMVECTOR one = XMVectorSplatOne();
+        const XMVECTOR identityRotation = XMQuaternionIdentity();
+        const UINT uNumJoints = static_cast<UINT>(m_pAsset->skeleton.aParentIndices.size());
+        const UINT uNumLayers = static_cast<UINT>(m_aAnimationLayers.size());
+
+        for (UINT i = 0u; i < uNumJoints; ++i)
+        {
+            BOOL bAnimated = FALSE;
+            for (UINT l = 0u; l < uNumLayers; ++l)
+            {
+                if (m_pAsset->aAnimationClips[m_aAnimationLayers[l].uAnimationIndex]->HasTrack(i))
+                {
+                    bAnimated = TRUE;
+                    break;
+                }
+            }
+
+            XMMATRIX localTransform = m_pAsset->skeleton.aBindTransforms[i];
+
+            if (bAnimated)
+            {
+                XMVECTOR scale = zero;
+                XMVECTOR rotation = zero;
+                XMVECTOR translation = zero;
+                FLOAT totalWeight = 0.0f;
+
+                for (UINT l = 0u; l < uNumLayers; ++l)
+                {
+                    const AnimationLayer& layer = m_aAnimationLayers[l];
+                    if (layer.bAdditive)
+                    {
+                        continue;
+                    }
+
+                    const Pose& pose = m_aPoses[m_aLayerPoseIndices[l]];
+                    XMVECTOR weight = XMVectorReplicate(layer.weight);
+
+                    // Keep every quaternion in the hemisphere of the running sum before the nlerp
+                    XMVECTOR layerRotation = pose.aRotations[i];
+                    layerRotation = XMVectorSelect(layerRotation, XMVectorNegate(layerRotation), XMVectorLess(XMVector4Dot(rotation, layerRotation), zero));
+
+                    scale = XMVectorMultiplyAdd(pose.aScales[i], weight, scale);
+                    rotation = XMVectorMultiplyAdd(layerRotation, weight, rotation);
+                    translation = XMVectorMultiplyAdd(pose.aTranslations[i], weight, translation);
+                    totalWeight += layer.weight;
+                }
+
+                if (totalWeight < 1.0f)
+                {
+                    // Whatever weight is left goes to the bind pose
+                    XMVECTOR weight = XMVectorReplicate(1.0f - totalWeight);
+
+                    XMVECTOR bindRotation = XMLoadFloat4(&m_pAsset->skeleton.aBindRotations[i]);
+                    bindRotation = XMVectorSelect(bindRotation, XMVectorNegate(bindRotation), XMVectorLess(XMVector4Dot(rotation, bindRotation), zero));
+
+                    scale = XMVectorMultiplyAdd(XMLoadFloat3(&m_pAsset->skeleton.aBindScales[i]), weight, scale);
+                    rotation = XMVectorMultiplyAdd(bindRotation, weight, rotation);
+                    translation = XMVectorMultiplyAdd(XMLoadFloat3(&m_pAsset->skeleton.aBindTranslations[i]), weight, translation);
+                }
+                else
+                {
+                    XMVECTOR inverseWeight = XMVectorReplicate(1.0f / totalWeight);
+
+                    scale = XMVectorMultiply(scale, inverseWeight);
+                    translation = XMVectorMultiply(translation, inverseWeight);
+                }
+
+                rotation = XMQuaternionNormalize(rotation);
+
+                for (UINT l = 0u; l < uNumLayers; ++l)
+                {
+                    const AnimationLayer& layer = m_aAnimationLayers[l];
+                    if (!layer.bAdditive)
+                    {
+                        continue;
+                    }
+
+                    const Pose& pose = m_aPoses[m_aLayerPoseIndices[l]];
+                    XMVECTOR weight = XMVectorReplicate(layer.weight);
+
+                    scale = XMVectorMultiply(scale, XMVectorLerpV(one, pose.aScales[i], weight));
+                    rotation = XMQuaternionMultiply(rotation, XMQuaternionSlerp(identityRotation, pose.aRotations[i], layer.weight));
+                    translation = XMVectorMultiplyAdd(pose.aTranslations[i], weight, translation);
+                }
+
+                localTransform = XMMatrixAffineTransformation(scale, zero, rotation, translation);
+            }
+
+            UINT uParentIndex = m_pAsset->skeleton.aParentIndices[i];
+            XMMATRIX globalTransform = (uParentIndex == INVALID_INDEX) ?
+                localTransform : XMMatrixMultiply(localTransform, m_aGlobalTransforms[uParentIndex]);
+            m_aGlobalTransforms[i] = globalTransform;
+
+            UINT uBoneIndex = m_pAsset->skeleton.aBoneIndices[i];
+            if (uBoneIndex != INVALID_INDEX)
+            {
+                m_aTransforms[uBoneIndex] = m_pAsset->aBoneInfo[uBoneIndex].OffsetMatrix * globalTransform * m_pAsset->globalInverseTransform;
+                writeSkinningPalette(uBoneIndex, m_aTransforms[uBoneIndex]);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::forEachMesh
+
+        Summary:  Call a function with the index of every mesh, from as
+                  many threads as SetNumImportThreads allows. The calling
+                  thread takes part, and each thread pulls the next
+                  unclaimed mesh, so a large mesh does not hold up the
+                  others.
+
+        Args:     const std::function<void(UINT)>& function
+                    Function called once per mesh index
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::forEachMesh(_In_ const std::function<void(UINT)>& function) const
+    {
+        const UINT uNumMeshes = static_cast<UINT>(m_aMeshes.size());
+        const UINT uNumThreads = sm_uNumImportThreads;
+
+        if (uNumThreads == 0u)
+        {
+            std::vector<UINT> aMeshIndices(uNumMeshes);
+            std::iota(aMeshIndices.begin(), aMeshIndices.end(), 0u);
+            std::for_each(std::execution::par, aMeshIndices.begin(), aMeshIndices.end(), function);
+            return;
+        }
+
+        std::atomic<UINT> uNextMesh = 0u;
+        auto importMeshes = [&uNextMesh, uNumMeshes, &function]()
+        {
+            for (UINT uMeshIndex = uNextMesh++; uMeshIndex < uNumMeshes; uMeshIndex = uNextMesh++)
+            {
+                function(uMeshIndex);
+            }
+        };
+
+        std::vector<std::jthread> aThreads;
+        aThreads.reserve(std::min(uNumThreads, uNumMeshes));
+        for (UINT i = 1u; i < std::min(uNumThreads, uNumMeshes); ++i)
+        {
+            aThreads.emplace_back(importMeshes);
+        }
+
+        importMeshes();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::getBoneId
+
+        Summary:  Find the the index of the bone
+
+        Args:      const aiBone* pBone
+                     Pointer to an assimp bone object
+
+        Modifies: [m_pAsset].
+
+        Returns:  UINT
+                    Index of the bone
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::getBoneId(_In_ const aiBone* pBone)
+    {
+        UINT uBoneIndex = 0u;
+        PCSTR pszBoneName = pBone->mName.C_Str();
+        if (!m_pAsset->boneNameToIndexMap.contains(pszBoneName))
+        {
+            uBoneIndex = static_cast<UINT>(m_pAsset->boneNameToIndexMap.size());
+            m_pAsset->boneNameToIndexMap[pszBoneName] = uBoneIndex;
+        }
+        else
+        {
+            uBoneIndex = m_pAsset->boneNameToIndexMap[pszBoneName];
+        }
+
+        return uBoneIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::getNumPaletteRowsPerBone
+
+        Summary:  Returns the number of float4 rows a bone takes in the
+                  skinning palette
+
+        Returns:  UINT
+                    Number of rows
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::getNumPaletteRowsPerBone() const
+    {
+        return m_skinningPaletteFormat == eSkinningPaletteFormat::DUAL_QUATERNION ?
+            NUM_PALETTE_ROWS_DUAL_QUATERNION : NUM_PALETTE_ROWS_AFFINE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::importAsset
+
+      Summary:  Import the model file with assimp and convert the scene
+                into the asset
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_pAsset, m_vertexBuffer, m_indexBuffer, m_normalBuffer,
+                 m_constantBuffer, m_aMeshes, m_aMaterials,
+                 m_aNormalData].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::importAsset(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        HRESULT hr = S_OK;
+
+        // Each call has its own importer so models can be imported on several threads
+        Assimp::Importer importer;
+        m_importProfiler.BeginStage(eImportStage::READ);
+        const aiScene* pScene = importer.ReadFile(m_filePath.string().c_str(), ASSIMP_LOAD_FLAGS);
+        m_importProfiler.EndStage(eImportStage::READ);
+
+        if (!pScene)
+        {
+            OutputDebugString(L"Error parsing ");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L": ");
+            OutputDebugStringA(importer.GetErrorString());
+            OutputDebugString(L"\n");
+
+            return E_FAIL;
+        }
+
+        XMMATRIX rootNodeTransform = ConvertMatrix(pScene->mRootNode->mTransformation);
+        XMVECTOR det = XMMatrixDeterminant(rootNodeTransform);
+        m_pAsset->globalInverseTransform = XMMatrixInverse(&det, rootNodeTransform);
+
+        hr = initFromScene(pDevice, pImmediateContext, pScene, m_filePath);
+
+        if (SUCCEEDED(hr))
+        {
+            initSkeleton(pScene->mRootNode);
+
+            for (UINT i = 0u; i < pScene->mNumAnimations && SUCCEEDED(hr); ++i)
+            {
+                hr = bindAnimation(pScene->mAnimations[i]);
+            }
+        }
+
+        // Everything needed at runtime has been copied out of the scene
+        importer.FreeScene();
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getVertices
+
+      Summary:  Returns the vertices data
+
+      Returns:  const SimpleVertex*
+                  Array of vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const SimpleVertex* Model::getVertices() const
+    {
+        return m_pAsset->aVertices.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getIndices
+
+      Summary:  Returns the indices data
+
+      Returns:  const void*
+                  Array of indices in the format of GetIndexFormat
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const void* Model::getIndices() const
+    {
+        if (GetIndexFormat() == DXGI_FORMAT_R32_UINT)
+        {
+            return m_pAsset->aWideIndices.data();
+        }
+
+        return m_pAsset->aIndices.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+     Method:   Model::initAllMeshes
+
+     Summary:  Initialize all meshes in a given assimp scene. The
+               meshes are converted in parallel, then bone ids are
+               assigned in mesh order, so they do not depend on
+               scheduling, and the bone weights are binned in parallel.
+               Each mesh only writes its own range of the arrays sized
+               by reserveSpace.
+
+     Args:     const aiScene* pScene
+                 Assimp scene
+   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initAllMeshes(_In_ const aiScene* pScene)
+    {
+        m_importProfiler.BeginStage(eImportStage::MESH_FILL);
+        forEachMesh(
+            [this, pScene](UINT uMeshIndex)
+            {
+                initSingleMesh(uMeshIndex, pScene->mMeshes[uMeshIndex]);
+            }
+        );
+        m_importProfiler.EndStage(eImportStage::MESH_FILL);
+
+        m_importProfiler.BeginStage(eImportStage::BONE_BINNING);
+        initBoneIds(pScene);
+        forEachMesh(
+            [this, pScene](UINT uMeshIndex)
+            {
+                initMeshBones(uMeshIndex, pScene->mMeshes[uMeshIndex]);
+            }
+        );
+        m_importProfiler.EndStage(eImportStage::BONE_BINNING);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initAnimationData
+
+      Summary:  Renormalizes the bone weights kept while binning so they
+                sum to one and stores them as the animation data of the
+                vertices. For each mesh, the largest difference between
+                a kept weight and its share of all the imported weights
+                of the vertex, or the largest dropped share, is kept as
+                its weight error and reported.
+
+      Modifies: [m_pAsset].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initAnimationData()
+    {
+        const UINT uNumVertices = static_cast<UINT>(m_pAsset->aVertices.size());
+        m_pAsset->aAnimationData.resize(uNumVertices);
+        m_pAsset->aBoneWeightErrors.assign(m_aMeshes.size(), 0.0f);
+
+        UINT uNumTruncatedVertices = 0u;
+        for (UINT uMeshIndex = 0u; uMeshIndex < m_aMeshes.size(); ++uMeshIndex)
+        {
+            // The vertices of a mesh end where the next mesh starts
+            const UINT uBaseVertex = m_aMeshes[uMeshIndex].uBaseVertex;
+            const UINT uEndVertex = uMeshIndex + 1u < m_aMeshes.size() ? m_aMeshes[uMeshIndex + 1u].uBaseVertex : uNumVertices;
+
+            FLOAT maxError = 0.0f;
+            for (UINT i = uBaseVertex; i < uEndVertex; ++i)
+            {
+                const VertexBoneData& boneData = m_pAsset->aBoneData[i];
+
+                FLOAT keptWeight = 0.0f;
+                for (UINT k = 0u; k < boneData.uNumBones; ++k)
+                {
+                    keptWeight += boneData.aWeights[k];
+                }
+
+                FLOAT aWeights[MAX_NUM_BONES_PER_VERTEX] = { 0.0f, };
+                for (UINT k = 0u; k < boneData.uNumBones && keptWeight > 0.0f; ++k)
+                {
+                    aWeights[k] = boneData.aWeights[k] / keptWeight;
+                }
+
+                m_pAsset->aAnimationData[i] =
+                {
+                    .aBoneIndices = XMUINT4(boneData.aBoneIds),
+                    .aBoneWeights = XMFLOAT4(aWeights)
+                };
+
+                const FLOAT totalWeight = keptWeight + boneData.droppedWeight;
+                if (totalWeight <= 0.0f)
+                {
+                    continue;
+                }
+
+                FLOAT error = boneData.maxDroppedWeight / totalWeight;
+                for (UINT k = 0u; k < boneData.uNumBones; ++k)
+                {
+                    error = std::max(error, fabsf(aWeights[k] - boneData.aWeights[k] / totalWeight));
+                }
+                maxError = std::max(maxError, error);
+
+                if (boneData.droppedWeight > 0.0f)
+                {
+                    ++uNumTruncatedVertices;
+                }
+            }
+
+            m_pAsset->aBoneWeightErrors[uMeshIndex] = maxError;
+        }
+
+        if (m_pAsset->aBoneInfo.empty() || ImportProfiler::GetVerbosity() == eImportVerbosity::SILENT)
+        {
+            return;
+        }
+
+        CHAR szDebugMessage[256];
+        sprintf_s(szDebugMessage, "Bone weights of %s: %u vertices had more than %u influences, largest weight error %.4f\n",
+            m_filePath.string().c_str(),
+            uNumTruncatedVertices,
+            static_cast<UINT>(MAX_NUM_BONES_PER_VERTEX),
+            *std::max_element(m_pAsset->aBoneWeightErrors.begin(), m_pAsset->aBoneWeightErrors.end()));
+        OutputDebugStringA(szDebugMessage);
+
+        if (ImportProfiler::GetVerbosity() < eImportVerbosity::STAGES)
+        {
+            return;
+        }
+
+        for (UINT uMeshIndex = 0u; uMeshIndex < m_aMeshes.size(); ++uMeshIndex)
+        {
+            sprintf_s(szDebugMessage, "    mesh %u: largest weight error %.4f\n",
+                uMeshIndex,
+                m_pAsset->aBoneWeightErrors[uMeshIndex]);
+            OutputDebugStringA(szDebugMessage);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initAssetBuffers
+
+      Summary:  Computes the tangent frames the import did not provide
+                and creates the vertex, index and normal buffers of the
+                asset, timing both stages
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_aNormalData, m_vertexBuffer, m_indexBuffer,
+                 m_normalBuffer, m_constantBuffer].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initAssetBuffers(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        m_importProfiler.BeginStage(eImportStage::TANGENTS);
+        if (m_aNormalData.empty())
+        {
+            calculateNormalMapVectors();
+        }
+        m_importProfiler.EndStage(eImportStage::TANGENTS);
+
+        if (ImportProfiler::GetVerbosity() == eImportVerbosity::STAGES)
+        {
+            reportTangentFrameError();
+        }
+
+        m_importProfiler.BeginStage(eImportStage::GPU_UPLOAD);
+        HRESULT hr = initialize(pDevice, pImmediateContext);
+        m_importProfiler.EndStage(eImportStage::GPU_UPLOAD);
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::reportTangentFrameError
+
+      Summary:  Generates the tangent frames of the model again and
+                reports how long it took and how far they are from the
+                tangent frames of the import. The tangent frames of the
+                import are kept.
+
+      Modifies: [m_aNormalData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::reportTangentFrameError()
+    {
+        std::vector<NormalData> aImportedNormalData = std::move(m_aNormalData);
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        calculateNormalMapVectors();
+
+        QueryPerformanceCounter(&endingTime);
+
+        const TangentFrameError error = TangentFrameGenerator::Compare(
+            aImportedNormalData.data(),
+            m_aNormalData.data(),
+            static_cast<UINT>(std::min(aImportedNormalData.size(), m_aNormalData.size()))
+        );
+        m_aNormalData = std::move(aImportedNormalData);
+
+        CHAR szDebugMessage[256];
+        sprintf_s(szDebugMessage, "Tangent frames of %s: generated in %.3f ms, %u vertices compared, tangent angle mean %.2f max %.2f degrees, %u flipped\n",
+            m_filePath.string().c_str(),
+            static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart),
+            error.uNumVertices,
+            error.meanTangentAngle,
+            error.maxTangentAngle,
+            error.uNumFlippedVertices);
+        OutputDebugStringA(szDebugMessage);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+     Method:   Model::initBoneIds
+
+     Summary:  Assign an id and an offset matrix to every bone of the
+               scene, visiting the meshes and their bones in order
+
+     Args:     const aiScene* pScene
+                 Assimp scene
+
+     Modifies: [m_pAsset].
+   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initBoneIds(_In_ const aiScene* pScene)
+    {
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const aiMesh* pMesh = pScene->mMeshes[i];
+            for (UINT j = 0u; j < pMesh->mNumBones; ++j)
+            {
+                const aiBone* pBone = pMesh->mBones[j];
+                if (getBoneId(pBone) == m_pAsset->aBoneInfo.size())
+                {
+                    m_pAsset->aBoneInfo.push_back(BoneInfo(ConvertMatrix(pBone->mOffsetMatrix)));
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initAsset
+
+      Summary:  Load the model into a new asset and create the buffers
+                shared by every instance. The asset comes from the
+                cooked file next to the model when it is up to date;
+                otherwise the model is imported with assimp and cooked
+                for the next launch. Models that do not use the asset
+                cache, like the skybox, always import.
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_pAsset, m_vertexBuffer, m_indexBuffer, m_normalBuffer,
+                 m_constantBuffer, m_animationBuffer, m_aMeshes,
+                 m_aMaterials, m_aNormalData].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initAsset(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        HRESULT hr = S_OK;
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        m_pAsset = std::make_shared<ModelAsset>();
+        m_importProfiler.Reset();
+
+        const std::filesystem::path cookedFilePath = CookedModel::GetCookedFilePath(m_filePath);
+        CookedModel cookedModel;
+        m_importProfiler.BeginStage(eImportStage::READ);
+        const BOOL bIsCooked = m_bUseAssetCache
+            && SUCCEEDED(cookedModel.Open(cookedFilePath, m_filePath, ASSIMP_LOAD_FLAGS, m_uMeshOptimizationFlags))
+            && isValidCookedModel(cookedModel);
+        m_importProfiler.EndStage(eImportStage::READ);
+
+        if (bIsCooked)
+        {
+            hr = initFromCookedModel(pDevice, pImmediateContext, cookedModel);
+        }
+        else
+        {
+            hr = importAsset(pDevice, pImmediateContext);
+        }
+
+        cookedModel.Close();
+
+        if (FAILED(hr))
+            return hr;
+
+        // The cooked file keeps full precision, the bone data is packed here
+        m_importProfiler.BeginStage(eImportStage::GPU_UPLOAD);
+        std::vector<PackedAnimationData> aPackedAnimationData;
+        if (m_vertexFormat == eVertexFormat::PACKED)
+        {
+            aPackedAnimationData.reserve(m_pAsset->aAnimationData.size());
+            for (const AnimationData& animationData : m_pAsset->aAnimationData)
+            {
+                if (!VertexCompression::CanPackAnimationData(animationData))
+                {
+                    CHAR szDebugMessage[256];
+                    sprintf_s(szDebugMessage, "%s has more than %u bones and cannot use packed vertices\n",
+                        m_filePath.string().c_str(),
+                        UINT8_MAX + 1u);
+                    OutputDebugStringA(szDebugMessage);
+                    m_importProfiler.EndStage(eImportStage::GPU_UPLOAD);
+                    return E_FAIL;
+                }
+                aPackedAnimationData.push_back(VertexCompression::PackAnimationData(animationData));
+            }
+
+            // Renderable::initialize reported the vertices without the bone data
+            if (m_pAsset->aAnimationData.size() == m_pAsset->aVertices.size() && ImportProfiler::GetVerbosity() != eImportVerbosity::SILENT)
+            {
+                VertexCompression::ReportError(
+                    m_filePath.string().c_str(),
+                    VertexCompression::MeasureError(
+                        m_pAsset->aVertices.data(),
+                        m_aNormalData.size() == m_pAsset->aVertices.size() ? m_aNormalData.data() : nullptr,
+                        m_pAsset->aAnimationData.data(),
+                        static_cast<UINT>(m_pAsset->aVertices.size())
+                    )
+                );
+            }
+        }
+
+        D3D11_BUFFER_DESC bd_anim =
+        {
+            .ByteWidth = GetAnimationDataStride() * static_cast<UINT>(m_pAsset->aAnimationData.size()),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0,
+            .MiscFlags = 0,
+            .StructureByteStride = 0
+        };
+
+        D3D11_SUBRESOURCE_DATA initData_anim =
+        {
+            .pSysMem = m_vertexFormat == eVertexFormat::PACKED ? static_cast<const void*>(aPackedAnimationData.data()) : m_pAsset->aAnimationData.data(),
+            .SysMemPitch = 0,
+            .SysMemSlicePitch = 0
+        };
+
+        hr = pDevice->CreateBuffer(&bd_anim, &initData_anim, m_animationBuffer.GetAddressOf());
+        m_importProfiler.EndStage(eImportStage::GPU_UPLOAD);
+
+        if (FAILED(hr))        
+            return hr;
+
+        if (!m_pAsset->aAnimationClips.empty() && m_pAsset->aAnimationData.size() == m_pAsset->aVertices.size())
+        {
+            m_pAsset->pSkinningStreams = std::make_shared<SkinningStreams>();
+
+            hr = m_pAsset->pSkinningStreams->Initialize(
+                m_pAsset->aVertices.data(),
+                m_aNormalData.size() == m_pAsset->aVertices.size() ? m_aNormalData.data() : nullptr,
+                m_pAsset->aAnimationData.data(),
+                static_cast<UINT>(m_pAsset->aVertices.size())
+            );
+
+            if (FAILED(hr))
+                return hr;
+        }
+
+        m_pAsset->vertexBuffer = m_vertexBuffer;
+        m_pAsset->indexBuffer = m_indexBuffer;
+        m_pAsset->normalBuffer = m_normalBuffer;
+        m_pAsset->animationBuffer = m_animationBuffer;
+        m_pAsset->aMeshes = m_aMeshes;
+        m_pAsset->aMaterials = m_aMaterials;
+        m_pAsset->aNormalData = std::move(m_aNormalData);
+        m_pAsset->bHasNormalMap = m_bHasNormalMap;
+
+        // Bone weights are only needed to build the animation data
+        m_pAsset->aBoneData.clear();
+        m_pAsset->aBoneData.shrink_to_fit();
+
+        QueryPerformanceCounter(&endingTime);
+
+        m_importProfiler.Report(
+            m_filePath.string().c_str(),
+            bIsCooked,
+            static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart)
+        );
+
+        if (!bIsCooked && m_bUseAssetCache)
+        {
+            // A model that cannot be cooked still loads, only slower
+            if (FAILED(cookAsset(cookedFilePath)))
+            {
+                OutputDebugString(L"Could not write cooked model \"");
+                OutputDebugString(cookedFilePath.c_str());
+                OutputDebugString(L"\"\n");
+            }
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initFromAsset
+
+      Summary:  Use the buffers, meshes and materials of the shared asset
+                and create the buffers owned by this instance
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+
+      Modifies: [m_vertexBuffer, m_indexBuffer, m_normalBuffer,
+                 m_constantBuffer, m_animationBuffer, m_aMeshes,
+                 m_aMaterials, m_bHasNormalMap].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initFromAsset(_In_ ID3D11Device* pDevice)
+    {
+        m_vertexBuffer = m_pAsset->vertexBuffer;
+        m_indexBuffer = m_pAsset->indexBuffer;
+        m_normalBuffer = m_pAsset->normalBuffer;
+        m_animationBuffer = m_pAsset->animationBuffer;
+        m_aMeshes = m_pAsset->aMeshes;
+        m_aMaterials = m_pAsset->aMaterials;
+        m_bHasNormalMap = m_pAsset->bHasNormalMap;
+
+        D3D11_BUFFER_DESC bd =
+        {
+            .ByteWidth = sizeof(CBChangesEveryFrame),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0,
+            .MiscFlags = 0,
+            .StructureByteStride = 0
+        };
+
+        return pDevice->CreateBuffer(&bd, nullptr, m_constantBuffer.GetAddressOf());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initFromCookedModel
+
+      Summary:  Fill the asset from a cooked file checked by
+                isValidCookedModel. The sections already hold the
+                engine types, so they are copied as they are.
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+                const CookedModel& cookedModel
+                  Open cooked file
+
+      Modifies: [m_pAsset, m_vertexBuffer, m_indexBuffer, m_normalBuffer,
+                 m_constantBuffer, m_aMeshes, m_aMaterials,
+                 m_aNormalData, m_bHasNormalMap].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initFromCookedModel(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const CookedModel& cookedModel)
+    {
+        HRESULT hr = S_OK;
+
+        m_importProfiler.BeginStage(eImportStage::READ);
+        m_pAsset->globalInverseTransform = XMLoadFloat4x4(&cookedModel.GetHeader().globalInverseTransform);
+
+        std::span<const SimpleVertex> aVertices = cookedModel.GetSection<SimpleVertex>(eCookedSection::VERTICES);
+        std::span<const NormalData> aNormalData = cookedModel.GetSection<NormalData>(eCookedSection::NORMAL_DATA);
+        std::span<const AnimationData> aAnimationData = cookedModel.GetSection<AnimationData>(eCookedSection::ANIMATION_DATA);
+        std::span<const FLOAT> aBoneWeightErrors = cookedModel.GetSection<FLOAT>(eCookedSection::BONE_WEIGHT_ERRORS);
+        std::span<const WORD> aIndices = cookedModel.GetSection<WORD>(eCookedSection::INDICES);
+        std::span<const UINT> aWideIndices = cookedModel.GetSection<UINT>(eCookedSection::WIDE_INDICES);
+        std::span<const BasicMeshEntry> aMeshes = cookedModel.GetSection<BasicMeshEntry>(eCookedSection::MESHES);
+        std::span<const Meshlet> aMeshlets = cookedModel.GetSection<Meshlet>(eCookedSection::MESHLETS);
+        std::span<const MeshletBounds> aMeshletBounds = cookedModel.GetSection<MeshletBounds>(eCookedSection::MESHLET_BOUNDS);
+
+        m_pAsset->aVertices.assign(aVertices.begin(), aVertices.end());
+        m_pAsset->aAnimationData.assign(aAnimationData.begin(), aAnimationData.end());
+        m_pAsset->aBoneWeightErrors.assign(aBoneWeightErrors.begin(), aBoneWeightErrors.end());
+        m_pAsset->aIndices.assign(aIndices.begin(), aIndices.end());
+        m_pAsset->aWideIndices.assign(aWideIndices.begin(), aWideIndices.end());
+        m_pAsset->indexFormat = aWideIndices.empty() ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+        m_aNormalData.assign(aNormalData.begin(), aNormalData.end());
+        m_aMeshes.assign(aMeshes.begin(), aMeshes.end());
+        m_pAsset->aMeshlets.assign(aMeshlets.begin(), aMeshlets.end());
+        m_pAsset->aMeshletBounds.assign(aMeshletBounds.begin(), aMeshletBounds.end());
+        initLodStatistics();
+
+        std::span<const XMFLOAT4X4> aBoneOffsets = cookedModel.GetSection<XMFLOAT4X4>(eCookedSection::BONE_OFFSETS);
+        std::span<const CookedString> aBoneNames = cookedModel.GetSection<CookedString>(eCookedSection::BONE_NAMES);
+        m_pAsset->aBoneInfo.reserve(aBoneOffsets.size());
+        for (UINT i = 0u; i < aBoneOffsets.size(); ++i)
+        {
+            m_pAsset->aBoneInfo.push_back(BoneInfo(XMLoadFloat4x4(&aBoneOffsets[i])));
+            m_pAsset->boneNameToIndexMap.emplace(cookedModel.GetString(aBoneNames[i]), i);
+        }
+
+        Skeleton& skeleton = m_pAsset->skeleton;
+        std::span<const CookedString> aJointNames = cookedModel.GetSection<CookedString>(eCookedSection::JOINT_NAMES);
+        std::span<const UINT> aParentIndices = cookedModel.GetSection<UINT>(eCookedSection::JOINT_PARENTS);
+        std::span<const UINT> aBoneIndices = cookedModel.GetSection<UINT>(eCookedSection::JOINT_BONES);
+        std::span<const XMFLOAT3> aBindScales = cookedModel.GetSection<XMFLOAT3>(eCookedSection::JOINT_BIND_SCALES);
+        std::span<const XMFLOAT4> aBindRotations = cookedModel.GetSection<XMFLOAT4>(eCookedSection::JOINT_BIND_ROTATIONS);
+        std::span<const XMFLOAT3> aBindTranslations = cookedModel.GetSection<XMFLOAT3>(eCookedSection::JOINT_BIND_TRANSLATIONS);
+        std::span<const XMFLOAT4X4> aBindTransforms = cookedModel.GetSection<XMFLOAT4X4>(eCookedSection::JOINT_BIND_TRANSFORMS);
+
+        for (const CookedString& name : aJointNames)
+        {
+            skeleton.aNames.emplace_back(cookedModel.GetString(name));
+        }
+        skeleton.aParentIndices.assign(aParentIndices.begin(), aParentIndices.end());
+        skeleton.aBoneIndices.assign(aBoneIndices.begin(), aBoneIndices.end());
+        skeleton.aBindScales.assign(aBindScales.begin(), aBindScales.end());
+        skeleton.aBindRotations.assign(aBindRotations.begin(), aBindRotations.end());
+        skeleton.aBindTranslations.assign(aBindTranslations.begin(), aBindTranslations.end());
+        skeleton.aBindTransforms.reserve(aBindTransforms.size());
+        for (const XMFLOAT4X4& bindTransform : aBindTransforms)
+        {
+            skeleton.aBindTransforms.push_back(XMLoadFloat4x4(&bindTransform));
+        }
+
+        std::span<const CookedTrack> aTracks = cookedModel.GetSection<CookedTrack>(eCookedSection::TRACKS);
+        std::span<const FLOAT> aPositionTimes = cookedModel.GetSection<FLOAT>(eCookedSection::POSITION_TIMES);
+        std::span<const XMFLOAT3> aPositions = cookedModel.GetSection<XMFLOAT3>(eCookedSection::POSITION_KEYS);
+        std::span<const FLOAT> aRotationTimes = cookedModel.GetSection<FLOAT>(eCookedSection::ROTATION_TIMES);
+        std::span<const UINT64> aRotations = cookedModel.GetSection<UINT64>(eCookedSection::ROTATION_KEYS);
+        std::span<const FLOAT> aScalingTimes = cookedModel.GetSection<FLOAT>(eCookedSection::SCALING_TIMES);
+        std::span<const XMFLOAT3> aScales = cookedModel.GetSection<XMFLOAT3>(eCookedSection::SCALING_KEYS);
+
+        for (const CookedClip& cookedClip : cookedModel.GetSection<CookedClip>(eCookedSection::CLIPS))
+        {
+            std::vector<AnimationClip::Track> aClipTracks(cookedClip.uNumTracks);
+            for (UINT i = 0u; i < cookedClip.uNumTracks; ++i)
+            {
+                const CookedTrack& cookedTrack = aTracks[cookedClip.uFirstTrack + i];
+                AnimationClip::Track& track = aClipTracks[i];
+
+                auto positionTimes = aPositionTimes.subspan(cookedTrack.uFirstPositionKey, cookedTrack.uNumPositionKeys);
+                auto positions = aPositions.subspan(cookedTrack.uFirstPositionKey, cookedTrack.uNumPositionKeys);
+                auto rotationTimes = aRotationTimes.subspan(cookedTrack.uFirstRotationKey, cookedTrack.uNumRotationKeys);
+                auto rotations = aRotations.subspan(cookedTrack.uFirstRotationKey, cookedTrack.uNumRotationKeys);
+                auto scalingTimes = aScalingTimes.subspan(cookedTrack.uFirstScalingKey, cookedTrack.uNumScalingKeys);
+                auto scales = aScales.subspan(cookedTrack.uFirstScalingKey, cookedTrack.uNumScalingKeys);
+
+                track.aPositionTimes.assign(positionTimes.begin(), positionTimes.end());
+                track.aPositions.assign(positions.begin(), positions.end());
+                track.aRotationTimes.assign(rotationTimes.begin(), rotationTimes.end());
+                track.aRotations.assign(rotations.begin(), rotations.end());
+                track.aScalingTimes.assign(scalingTimes.begin(), scalingTimes.end());
+                track.aScales.assign(scales.begin(), scales.end());
+            }
+
+            std::shared_ptr<AnimationClip> clip = std::make_shared<AnimationClip>();
+            hr = clip->Initialize(std::move(aClipTracks), cookedClip.ticksPerSecond, cookedClip.durationTicks, static_cast<size_t>(cookedClip.uSourceSize));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            m_pAsset->aAnimationClips.push_back(clip);
+        }
+        m_importProfiler.EndStage(eImportStage::READ);
+
+        m_importProfiler.BeginStage(eImportStage::MATERIALS);
+        hr = initCookedMaterials(pDevice, pImmediateContext, cookedModel);
+        m_importProfiler.EndStage(eImportStage::MATERIALS);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return initAssetBuffers(pDevice, pImmediateContext);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initCookedMaterials
+
+      Summary:  Create the materials of a cooked file and load their
+                textures the same way loadTextures does
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the textures
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set textures
+                const CookedModel& cookedModel
+                  Open cooked file
+
+      Modifies: [m_pAsset, m_aMaterials, m_bHasNormalMap].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initCookedMaterials(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const CookedModel& cookedModel)
+    {
+        HRESULT hr = S_OK;
+
+        std::filesystem::path parentDirectory = m_filePath.parent_path();
+        std::span<const CookedMaterial> aMaterials = cookedModel.GetSection<CookedMaterial>(eCookedSection::MATERIALS);
+
+        for (UINT i = 0u; i < aMaterials.size(); ++i)
+        {
+            std::string szName = m_filePath.string() + std::to_string(i);
+            std::wstring pwszName(szName.length(), L' ');
+            std::copy(szName.begin(), szName.end(), pwszName.begin());
+            std::shared_ptr<Material> pMaterial = std::make_shared<Material>(pwszName);
+            m_aMaterials.push_back(pMaterial);
+
+            MaterialTexturePaths paths =
+            {
+                .szDiffuse = std::string(cookedModel.GetString(aMaterials[i].diffuse)),
+                .szSpecular = std::string(cookedModel.GetString(aMaterials[i].specular)),
+                .szNormal = std::string(cookedModel.GetString(aMaterials[i].normal))
+            };
+
+            if (!paths.szDiffuse.empty())
+            {
+                hr = loadCookedTexture(pDevice, pImmediateContext, parentDirectory / paths.szDiffuse, pMaterial->pDiffuse);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+
+            if (!paths.szSpecular.empty())
+            {
+                hr = loadCookedTexture(pDevice, pImmediateContext, parentDirectory / paths.szSpecular, pMaterial->pSpecularExponent);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+
+            // Like loadNormalTexture, the normal map is created by the material
+            if (!paths.szNormal.empty())
+            {
+                pMaterial->pNormal = TextureCache::GetTexture(parentDirectory / paths.szNormal, eTextureSamplerType::TRILINEAR_WRAP);
+                m_bHasNormalMap = true;
+            }
+
+            m_pAsset->aMaterialTexturePaths.push_back(std::move(paths));
+        }
+
+        return hr;
+    }
+
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+     Method:   Model::initFromScene
+
+     Summary:  Initialize all meshes in a given assimp scene
+
+     Args:     ID3D11Device* pDevice
+                 The Direct3D device to create the buffers
+               ID3D11DeviceContext* pImmediateContext
+                 The Direct3D context to set buffers
+               const aiScene* pScene
+                 Assimp scene
+               const std::filesystem::path& filePath
+                 Path to the model
+
+     Returns:  HRESULT
+                 Status code
+   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initFromScene(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const aiScene* pScene,
+        _In_ const std::filesystem::path& filePath
+    )
+    {
+        HRESULT hr = S_OK;
+
+        m_aMeshes.resize(pScene->mNumMeshes);
+
+        UINT uNumVertices = 0u;
+        UINT uNumIndices = 0u;
+
+        m_importProfiler.BeginStage(eImportStage::COUNT_ELEMENTS);
+        countVerticesAndIndices(uNumVertices, uNumIndices, pScene);
+
+        reserveSpace(uNumVertices, uNumIndices);
+        m_importProfiler.EndStage(eImportStage::COUNT_ELEMENTS);
+
+        initAllMeshes(pScene);
+
+        m_importProfiler.BeginStage(eImportStage::MESH_PROCESSING);
+        optimizeMeshes();
+
+        initAnimationData();
+
+        generateLods();
+        generateMeshlets();
+        initIndexFormat();
+        m_importProfiler.EndStage(eImportStage::MESH_PROCESSING);
+
+        m_importProfiler.BeginStage(eImportStage::MATERIALS);
+        hr = initMaterials(pDevice, pImmediateContext, pScene, filePath);
+        m_importProfiler.EndStage(eImportStage::MATERIALS);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        hr = initAssetBuffers(pDevice, pImmediateContext);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initIndexFormat
+
+      Summary:  Select the index format after all meshes are imported.
+                Indices are relative to the base vertex of their mesh,
+                so 16-bit indices are kept unless a single mesh has
+                more vertices than they can address.
+
+      Modifies: [m_pAsset].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initIndexFormat()
+    {
+        const BOOL bNeedsWideIndices = std::any_of(
+            m_pAsset->aWideIndices.begin(),
+            m_pAsset->aWideIndices.end(),
+            [](UINT uIndex) { return uIndex > 0xFFFFu; }
+        );
+
+        if (bNeedsWideIndices)
+        {
+            m_pAsset->indexFormat = DXGI_FORMAT_R32_UINT;
+            return;
+        }
+
+        m_pAsset->indexFormat = DXGI_FORMAT_R16_UINT;
+        m_pAsset->aIndices.assign(m_pAsset->aWideIndices.begin(), m_pAsset->aWideIndices.end());
+        m_pAsset->aWideIndices.clear();
+        m_pAsset->aWideIndices.shrink_to_fit();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initLodStatistics
+
+      Summary:  Sum the triangles and take the largest error of each
+                detail level over the meshes
+
+      Modifies: [m_pAsset].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initLodStatistics()
+    {
+        UINT uNumLods = 0u;
+        for (const BasicMeshEntry& mesh : m_aMeshes)
+        {
+            uNumLods = std::max(uNumLods, mesh.uNumLods);
+        }
+
+        m_pAsset->aLodStatistics.assign(uNumLods, LodStatistics{ .uNumTriangles = 0u, .maxError = 0.0f, .generationTime = 0.0 });
+        for (const BasicMeshEntry& mesh : m_aMeshes)
+        {
+            for (UINT i = 0u; i < mesh.uNumLods; ++i)
+            {
+                m_pAsset->aLodStatistics[i].uNumTriangles += mesh.aLods[i].uNumIndices / 3u;
+                m_pAsset->aLodStatistics[i].maxError = std::max(m_pAsset->aLodStatistics[i].maxError, mesh.aLods[i].error);
+            }
+        }
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-     Method:   Model::initAllMeshes
+      Method:   Model::generateLods
+
+      Summary:  Build up to MAX_NUM_LODS detail levels of each mesh.
+                Each level simplifies the previous one to about half of
+                its triangles, with an error of at most a fraction of
+                the bounding radius of the mesh, and is stopped when it
+                cannot remove enough triangles. The index ranges of the
+                levels are appended after the full meshes, so the full
+                meshes keep their ranges, and every level is reordered
+                for the vertex cache.
+
+      Modifies: [m_pAsset, m_aMeshes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::generateLods()
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
 
-     Summary:  Initialize all meshes in a given assimp scene
+        const UINT uNumVertices = static_cast<UINT>(m_pAsset->aVertices.size());
+        const BOOL bHasAnimationData = m_pAsset->aAnimationData.size() == uNumVertices;
+        std::vector<DOUBLE> aGenerationTimes(MAX_NUM_LODS, 0.0);
+        std::vector<UINT> aPreviousIndices;
+        std::vector<UINT> aLodIndices;
 
-     Args:     const aiScene* pScene
-                 Assimp scene
-   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::initAllMeshes(_In_ const aiScene* pScene)
-    {
-        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        for (size_t i = 0; i < m_aMeshes.size(); ++i)
         {
-            const aiMesh* pMesh = pScene->mMeshes[i];
-            initSingleMesh(i, pMesh);
-        }
-    }
+            BasicMeshEntry& mesh = m_aMeshes[i];
+            const UINT uEndVertex = i + 1 < m_aMeshes.size() ? m_aMeshes[i + 1].uBaseVertex : uNumVertices;
+            const UINT uNumMeshVertices = uEndVertex - mesh.uBaseVertex;
 
+            mesh.uNumLods = 1u;
+            mesh.aLods[0] = { .uNumIndices = mesh.uNumIndices, .uBaseIndex = mesh.uBaseIndex, .error = 0.0f };
+            if (uNumMeshVertices == 0u)
+            {
+                continue;
+            }
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-     Method:   Model::initFromScene
+            BoundingSphere::CreateFromPoints(mesh.bounds, uNumMeshVertices, &m_pAsset->aVertices[mesh.uBaseVertex].Position, sizeof(SimpleVertex));
 
-     Summary:  Initialize all meshes in a given assimp scene
+            aPreviousIndices.assign(
+                m_pAsset->aWideIndices.begin() + mesh.uBaseIndex,
+                m_pAsset->aWideIndices.begin() + mesh.uBaseIndex + mesh.uNumIndices
+            );
 
-     Args:     ID3D11Device* pDevice
-                 The Direct3D device to create the buffers
-               ID3D11DeviceContext* pImmediateContext
-                 The Direct3D context to set buffers
-               const aiScene* pScene
-                 Assimp scene
-               const std::filesystem::path& filePath
-                 Path to the model
+            for (UINT uLod = 1u; uLod < MAX_NUM_LODS; ++uLod)
+            {
+                LARGE_INTEGER startingTime;
+                LARGE_INTEGER endingTime;
+                QueryPerformanceCounter(&startingTime);
+
+                const UINT uTargetNumIndices = static_cast<UINT>(static_cast<FLOAT>(aPreviousIndices.size() / 3u) * MeshSimplifier::LOD_TRIANGLE_RATIO) * 3u;
+                const FLOAT error = MeshSimplifier::Simplify(
+                    aPreviousIndices.data(),
+                    static_cast<UINT>(aPreviousIndices.size()),
+                    m_pAsset->aVertices.data() + mesh.uBaseVertex,
+                    bHasAnimationData ? m_pAsset->aAnimationData.data() + mesh.uBaseVertex : nullptr,
+                    uNumMeshVertices,
+                    uTargetNumIndices,
+                    MeshSimplifier::MAX_RELATIVE_ERROR * mesh.bounds.Radius,
+                    aLodIndices
+                );
+
+                const BOOL bIsReduced = !aLodIndices.empty()
+                    && static_cast<FLOAT>(aLodIndices.size()) <= static_cast<FLOAT>(aPreviousIndices.size()) * MeshSimplifier::MIN_LOD_REDUCTION;
+                if (bIsReduced)
+                {
+                    MeshOptimizer::OptimizeVertexCache(aLodIndices.data(), static_cast<UINT>(aLodIndices.size()), uNumMeshVertices);
+
+                    // Each level simplifies the previous one, so the errors add up at most
+                    mesh.aLods[uLod] =
+                    {
+                        .uNumIndices = static_cast<UINT>(aLodIndices.size()),
+                        .uBaseIndex = static_cast<UINT>(m_pAsset->aWideIndices.size()),
+                        .error = mesh.aLods[uLod - 1u].error + error
+                    };
+                    mesh.uNumLods = uLod + 1u;
+                    m_pAsset->aWideIndices.insert(m_pAsset->aWideIndices.end(), aLodIndices.begin(), aLodIndices.end());
+                }
 
-     Returns:  HRESULT
-                 Status code
-   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::initFromScene(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const aiScene* pScene,
-        _In_ const std::filesystem::path& filePath
-    )
-    {
-        HRESULT hr = S_OK;
+                QueryPerformanceCounter(&endingTime);
+                aGenerationTimes[uLod] += static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart);
 
-        m_aMeshes.resize(pScene->mNumMeshes);
+                if (!bIsReduced)
+                {
+                    break;
+                }
 
-        UINT uNumVertices = 0u;
-        UINT uNumIndices = 0u;
+                aPreviousIndices.swap(aLodIndices);
+            }
+        }
 
-        countVerticesAndIndices(uNumVertices, uNumIndices, pScene);
+        initLodStatistics();
 
-        reserveSpace(uNumVertices, uNumIndices);
+        for (UINT i = 0u; i < m_pAsset->aLodStatistics.size(); ++i)
+        {
+            m_pAsset->aLodStatistics[i].generationTime = aGenerationTimes[i];
+        }
 
-        initAllMeshes(pScene);
+        if (ImportProfiler::GetVerbosity() < eImportVerbosity::STAGES)
+        {
+            return;
+        }
 
-        hr = initMaterials(pDevice, pImmediateContext, pScene, filePath);
-        if (FAILED(hr))
+        CHAR szDebugMessage[256];
+        for (UINT i = 0u; i < m_pAsset->aLodStatistics.size(); ++i)
         {
-            return hr;
+            const LodStatistics& statistics = m_pAsset->aLodStatistics[i];
+
+            sprintf_s(szDebugMessage, "LOD %u of %s: %u triangles, error %.5f, simplified in %.3f ms\n",
+                i,
+                m_filePath.string().c_str(),
+                statistics.uNumTriangles,
+                statistics.maxError,
+                statistics.generationTime);
+            OutputDebugStringA(szDebugMessage);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::generateMeshlets
+
+      Summary:  Split the full detail level of each mesh into meshlets.
+                Skinned models are left out, since their bounds and
+                normal cones change with every pose.
+
+      Modifies: [m_pAsset, m_aMeshes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::generateMeshlets()
+    {
+        if (!m_pAsset->aBoneInfo.empty())
+        {
+            return;
         }
 
-        for (size_t i = 0; i < m_aVertices.size(); ++i)
+        const UINT uNumVertices = static_cast<UINT>(m_pAsset->aVertices.size());
+        for (size_t i = 0; i < m_aMeshes.size(); ++i)
         {
-            m_aAnimationData.push_back(
-                AnimationData
-                {
-                    .aBoneIndices = XMUINT4(m_aBoneData.at(i).aBoneIds),
-                    .aBoneWeights = XMFLOAT4(m_aBoneData.at(i).aWeights)
-                }
+            BasicMeshEntry& mesh = m_aMeshes[i];
+            const UINT uEndVertex = i + 1 < m_aMeshes.size() ? m_aMeshes[i + 1].uBaseVertex : uNumVertices;
+
+            mesh.uFirstMeshlet = static_cast<UINT>(m_pAsset->aMeshlets.size());
+            MeshletCuller::Build(
+                m_pAsset->aWideIndices.data() + mesh.uBaseIndex,
+                mesh.uNumIndices,
+                mesh.uBaseIndex,
+                m_pAsset->aVertices.data() + mesh.uBaseVertex,
+                uEndVertex - mesh.uBaseVertex,
+                m_pAsset->aMeshlets,
+                m_pAsset->aMeshletBounds
             );
+            mesh.uNumMeshlets = static_cast<UINT>(m_pAsset->aMeshlets.size()) - mesh.uFirstMeshlet;
         }
 
-        hr = initialize(pDevice, pImmediateContext);
-        if (FAILED(hr))
+        if (ImportProfiler::GetVerbosity() == eImportVerbosity::SILENT)
         {
-            return hr;
+            return;
         }
 
-        return hr;
+        CHAR szDebugMessage[256];
+        sprintf_s(szDebugMessage, "Meshlets of %s: %zu\n", m_filePath.string().c_str(), m_pAsset->aMeshlets.size());
+        OutputDebugStringA(szDebugMessage);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -611,6 +2507,8 @@ namespace library
         // Extract the directory part from the file name
         std::filesystem::path parentDirectory = filePath.parent_path();
 
+        m_pAsset->aMaterialTexturePaths.resize(pScene->mNumMaterials);
+
         // Initialize the materials
         for (UINT i = 0u; i < pScene->mNumMaterials; ++i)
         {
@@ -650,26 +2548,24 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
      Method:   Model::initMeshSingleBone
 
-     Summary:  Initialize a single bone of the mesh
+     Summary:  Add the weights of a single bone to the vertices of the
+               mesh. The bone already has its id from initBoneIds, so
+               meshes can be binned in parallel.
 
-     Args:     const aiScene* pScene
-                 Assimp scene
+     Args:     UINT uMeshIndex
+                 Index of the mesh
+               const aiBone* pBone
+                 Bone of the mesh
    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Model::initMeshSingleBone(_In_ UINT uMeshIndex, _In_ const aiBone* pBone)
     {
-        UINT uBoneId = getBoneId(pBone);
-
-        if (uBoneId == m_aBoneInfo.size())
-        {
-            BoneInfo boneInfo(ConvertMatrix(pBone->mOffsetMatrix));
-            m_aBoneInfo.push_back(boneInfo);
-        }
+        const UINT uBoneId = m_pAsset->boneNameToIndexMap.at(pBone->mName.C_Str());
 
         for (UINT i = 0u; i < pBone->mNumWeights; ++i)
         {
             const aiVertexWeight& vertexWeight = pBone->mWeights[i];
             UINT uGlobalVertexId = m_aMeshes[uMeshIndex].uBaseVertex + vertexWeight.mVertexId;
-            m_aBoneData[uGlobalVertexId].AddBoneData(uBoneId, vertexWeight.mWeight);
+            m_pAsset->aBoneData[uGlobalVertexId].AddBoneData(uBoneId, vertexWeight.mWeight);
         }
     }
 
@@ -689,6 +2585,7 @@ namespace library
     --------------------------------------------------------------------*/
     void Model::initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh) {
         const aiVector3D zero3d(0.0f, 0.0f, 0.0f);
+        const UINT uBaseVertex = m_aMeshes[uMeshIndex].uBaseVertex;
         for (UINT i = 0u; i < pMesh->mNumVertices; ++i)
         {
             const aiVector3D& position = pMesh->mVertices[i];
@@ -703,7 +2600,7 @@ namespace library
                 .Normal = XMFLOAT3(normal.x, normal.y, normal.z)
             };
 
-            m_aVertices.push_back(vertex);
+            m_pAsset->aVertices[uBaseVertex + i] = vertex;
 
             NormalData normalData =
             {
@@ -711,136 +2608,233 @@ namespace library
                 .Bitangent = XMFLOAT3(bitangent.x,bitangent.y,bitangent.z)
             };
 
-            m_aNormalData.push_back(normalData);
+            m_aNormalData[uBaseVertex + i] = normalData;
         }
 
+        UINT* aIndices = m_pAsset->aWideIndices.data() + m_aMeshes[uMeshIndex].uBaseIndex;
         for (UINT i = 0u; i < pMesh->mNumFaces; i++)
         {
             const aiFace& face = pMesh->mFaces[i];
             assert(face.mNumIndices == 3u);
 
-            WORD aIndices[3] =
-            {
-                static_cast<WORD>(face.mIndices[0]),
-                static_cast<WORD>(face.mIndices[1]),
-                static_cast<WORD>(face.mIndices[2]),
-            };
+            aIndices[i * 3u] = face.mIndices[0];
+            aIndices[i * 3u + 1u] = face.mIndices[1];
+            aIndices[i * 3u + 2u] = face.mIndices[2];
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initSkeleton
+
+      Summary:  Flatten the node hierarchy into the skeleton arrays
+
+      Args:     const aiNode* pRootNode
+                  Root node of the assimp scene
+
+      Modifies: [m_pAsset].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initSkeleton(_In_ const aiNode* pRootNode)
+    {
+        m_pAsset->skeleton = Skeleton();
 
-            m_aIndices.push_back(aIndices[0]);
-            m_aIndices.push_back(aIndices[1]);
-            m_aIndices.push_back(aIndices[2]);
+        if (pRootNode)
+        {
+            initSkeletonJoint(pRootNode, INVALID_INDEX);
         }
-        initMeshBones(uMeshIndex, pMesh);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::interpolatePosition
+      Method:   Model::initSkeletonJoint
 
-      Summary:  Interpolate two keyframes to find translate vector
+      Summary:  Append the given node and its children to the skeleton.
+                A subtree without any bone is removed again, since it
+                never contributes to the bone transforms.
 
-      Args:     XMFLOAT3& outTranslate
-                  Translate vector
-                FLOAT animationTimeTicks
-                  Animation time
-                const aiNodeAnim* pNodeAnim
-                  Pointer to an assimp node anim object
+      Args:     const aiNode* pNode
+                  Pointer to an assimp node object
+                UINT uParentIndex
+                  Joint index of the parent, INVALID_INDEX for the root
+
+      Modifies: [m_pAsset].
+
+      Returns:  BOOL
+                  TRUE if the subtree contains a bone
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    BOOL Model::initSkeletonJoint(_In_ const aiNode* pNode, _In_ UINT uParentIndex)
     {
-        if (pNodeAnim->mNumRotationKeys == 1)
+        const UINT uJointIndex = static_cast<UINT>(m_pAsset->skeleton.aParentIndices.size());
+
+        UINT uBoneIndex = INVALID_INDEX;
+        auto iBoneIndex = m_pAsset->boneNameToIndexMap.find(pNode->mName.C_Str());
+        if (iBoneIndex != m_pAsset->boneNameToIndexMap.end())
         {
-            outTranslate = ConvertVector3dToFloat3(pNodeAnim->mPositionKeys[0].mValue);
-            return;
+            uBoneIndex = iBoneIndex->second;
+        }
+
+        XMMATRIX bindTransform = ConvertMatrix(pNode->mTransformation);
+        XMVECTOR scale = XMVECTOR();
+        XMVECTOR rotation = XMVECTOR();
+        XMVECTOR translation = XMVECTOR();
+        XMMatrixDecompose(&scale, &rotation, &translation, bindTransform);
+
+        XMFLOAT3 bindScale = XMFLOAT3();
+        XMFLOAT4 bindRotation = XMFLOAT4();
+        XMFLOAT3 bindTranslation = XMFLOAT3();
+        XMStoreFloat3(&bindScale, scale);
+        XMStoreFloat4(&bindRotation, rotation);
+        XMStoreFloat3(&bindTranslation, translation);
+
+        m_pAsset->skeleton.aNames.push_back(pNode->mName.C_Str());
+        m_pAsset->skeleton.aParentIndices.push_back(uParentIndex);
+        m_pAsset->skeleton.aBoneIndices.push_back(uBoneIndex);
+        m_pAsset->skeleton.aBindScales.push_back(bindScale);
+        m_pAsset->skeleton.aBindRotations.push_back(bindRotation);
+        m_pAsset->skeleton.aBindTranslations.push_back(bindTranslation);
+        m_pAsset->skeleton.aBindTransforms.push_back(bindTransform);
+
+        BOOL bHasBones = (uBoneIndex != INVALID_INDEX);
+        for (UINT i = 0u; i < pNode->mNumChildren; ++i)
+        {
+            if (initSkeletonJoint(pNode->mChildren[i], uJointIndex))
+            {
+                bHasBones = TRUE;
+            }
         }
 
-        UINT uPositionIndex = findPosition(animationTimeTicks, pNodeAnim);
-        UINT uNextPositionIndex = uPositionIndex + 1u;
-        assert(uNextPositionIndex < pNodeAnim->mNumPositionKeys);
+        if (!bHasBones)
+        {
+            m_pAsset->skeleton.aNames.resize(uJointIndex);
+            m_pAsset->skeleton.aParentIndices.resize(uJointIndex);
+            m_pAsset->skeleton.aBoneIndices.resize(uJointIndex);
+            m_pAsset->skeleton.aBindScales.resize(uJointIndex);
+            m_pAsset->skeleton.aBindRotations.resize(uJointIndex);
+            m_pAsset->skeleton.aBindTranslations.resize(uJointIndex);
+            m_pAsset->skeleton.aBindTransforms.resize(uJointIndex);
+        }
 
-        FLOAT t1 = static_cast<FLOAT>(pNodeAnim->mPositionKeys[uPositionIndex].mTime);
-        FLOAT t2 = static_cast<FLOAT>(pNodeAnim->mPositionKeys[uNextPositionIndex].mTime);
-        FLOAT deltaTime = t2 - t1;
-        FLOAT factor = (animationTimeTicks - t1) / deltaTime;
-        assert(factor >= 0.0f && factor <= 1.0f);
-        const aiVector3D& start = pNodeAnim->mPositionKeys[uPositionIndex].mValue;
-        const aiVector3D& end = pNodeAnim->mPositionKeys[uNextPositionIndex].mValue;
-        aiVector3D delta = end - start;
-        outTranslate = ConvertVector3dToFloat3(start + factor * delta);
+        return bHasBones;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::interpolateRotation
+      Method:   Model::isValidCookedModel
 
-      Summary:  Interpolate two keyframes to find rotation vector
+      Summary:  Check that the sections of a cooked file agree with each
+                other, so initFromCookedModel never reads outside of
+                them. A file that fails is imported again instead.
 
-      Args:     XMVECTOR& outQuaternion
-                  Quaternion vector
-                FLOAT animationTimeTicks
-                  Animation time
-                const aiNodeAnim* pNodeAnim
-                  Pointer to an assimp node anim object
+      Args:     const CookedModel& cookedModel
+                  Open cooked file
+
+      Returns:  BOOL
+                  TRUE if the file can be loaded
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    /*--------------------------------------------------------------------
-      TODO: Model::interpolateRotation definition (remove the comment)
-    --------------------------------------------------------------------*/
-    void Model::interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim) {
-        if (pNodeAnim->mNumRotationKeys == 1)
+    BOOL Model::isValidCookedModel(_In_ const CookedModel& cookedModel) const
+    {
+        const size_t uNumVertices = cookedModel.GetSection<SimpleVertex>(eCookedSection::VERTICES).size();
+        const size_t uNumNormalData = cookedModel.GetSection<NormalData>(eCookedSection::NORMAL_DATA).size();
+        const size_t uNumShortIndices = cookedModel.GetSection<WORD>(eCookedSection::INDICES).size();
+        const size_t uNumWideIndices = cookedModel.GetSection<UINT>(eCookedSection::WIDE_INDICES).size();
+        const size_t uNumIndices = uNumWideIndices > 0u ? uNumWideIndices : uNumShortIndices;
+        const size_t uNumMaterials = cookedModel.GetSection<CookedMaterial>(eCookedSection::MATERIALS).size();
+        const size_t uNumBones = cookedModel.GetSection<XMFLOAT4X4>(eCookedSection::BONE_OFFSETS).size();
+        const size_t uNumJoints = cookedModel.GetSection<UINT>(eCookedSection::JOINT_PARENTS).size();
+        const size_t uNumTracks = cookedModel.GetSection<CookedTrack>(eCookedSection::TRACKS).size();
+        const size_t uNumPositionKeys = cookedModel.GetSection<XMFLOAT3>(eCookedSection::POSITION_KEYS).size();
+        const size_t uNumRotationKeys = cookedModel.GetSection<UINT64>(eCookedSection::ROTATION_KEYS).size();
+        const size_t uNumScalingKeys = cookedModel.GetSection<XMFLOAT3>(eCookedSection::SCALING_KEYS).size();
+        const size_t uNumMeshlets = cookedModel.GetSection<Meshlet>(eCookedSection::MESHLETS).size();
+
+        BOOL bIsValid = uNumVertices > 0u
+            && (uNumShortIndices == 0u || uNumWideIndices == 0u)
+            && cookedModel.GetSection<AnimationData>(eCookedSection::ANIMATION_DATA).size() == uNumVertices
+            && cookedModel.GetSection<FLOAT>(eCookedSection::BONE_WEIGHT_ERRORS).size() == cookedModel.GetSection<BasicMeshEntry>(eCookedSection::MESHES).size()
+            && (uNumNormalData == 0u || uNumNormalData == uNumVertices)
+            && cookedModel.GetSection<CookedString>(eCookedSection::BONE_NAMES).size() == uNumBones
+            && cookedModel.GetSection<CookedString>(eCookedSection::JOINT_NAMES).size() == uNumJoints
+            && cookedModel.GetSection<UINT>(eCookedSection::JOINT_BONES).size() == uNumJoints
+            && cookedModel.GetSection<XMFLOAT3>(eCookedSection::JOINT_BIND_SCALES).size() == uNumJoints
+            && cookedModel.GetSection<XMFLOAT4>(eCookedSection::JOINT_BIND_ROTATIONS).size() == uNumJoints
+            && cookedModel.GetSection<XMFLOAT3>(eCookedSection::JOINT_BIND_TRANSLATIONS).size() == uNumJoints
+            && cookedModel.GetSection<XMFLOAT4X4>(eCookedSection::JOINT_BIND_TRANSFORMS).size() == uNumJoints
+            && cookedModel.GetSection<FLOAT>(eCookedSection::POSITION_TIMES).size() == uNumPositionKeys
+            && cookedModel.GetSection<FLOAT>(eCookedSection::ROTATION_TIMES).size() == uNumRotationKeys
+            && cookedModel.GetSection<FLOAT>(eCookedSection::SCALING_TIMES).size() == uNumScalingKeys
+            && cookedModel.GetSection<MeshletBounds>(eCookedSection::MESHLET_BOUNDS).size() * MeshletCuller::MESHLET_GROUP_SIZE == uNumMeshlets;
+
+        for (const BasicMeshEntry& mesh : cookedModel.GetSection<BasicMeshEntry>(eCookedSection::MESHES))
         {
-            outQuaternion = ConvertQuaternionToVector(pNodeAnim->mRotationKeys[0].mValue);
-            return;
+            bIsValid = bIsValid
+                && static_cast<size_t>(mesh.uBaseIndex) + mesh.uNumIndices <= uNumIndices
+                && mesh.uBaseVertex < uNumVertices
+                && (mesh.uMaterialIndex == INVALID_MATERIAL || mesh.uMaterialIndex < uNumMaterials)
+                && mesh.uNumLods >= 1u && mesh.uNumLods <= MAX_NUM_LODS
+                && mesh.uFirstMeshlet % MeshletCuller::MESHLET_GROUP_SIZE == 0u
+                && mesh.uNumMeshlets % MeshletCuller::MESHLET_GROUP_SIZE == 0u
+                && static_cast<size_t>(mesh.uFirstMeshlet) + mesh.uNumMeshlets <= uNumMeshlets;
+
+            for (UINT i = 0u; bIsValid && i < mesh.uNumLods; ++i)
+            {
+                bIsValid = static_cast<size_t>(mesh.aLods[i].uBaseIndex) + mesh.aLods[i].uNumIndices <= uNumIndices;
+            }
+        }
+
+        for (const CookedClip& clip : cookedModel.GetSection<CookedClip>(eCookedSection::CLIPS))
+        {
+            bIsValid = bIsValid
+                && clip.uNumTracks == uNumJoints
+                && static_cast<size_t>(clip.uFirstTrack) + clip.uNumTracks <= uNumTracks;
+        }
+
+        for (const CookedTrack& track : cookedModel.GetSection<CookedTrack>(eCookedSection::TRACKS))
+        {
+            bIsValid = bIsValid
+                && static_cast<size_t>(track.uFirstPositionKey) + track.uNumPositionKeys <= uNumPositionKeys
+                && static_cast<size_t>(track.uFirstRotationKey) + track.uNumRotationKeys <= uNumRotationKeys
+                && static_cast<size_t>(track.uFirstScalingKey) + track.uNumScalingKeys <= uNumScalingKeys;
         }
-        UINT RotationIndex = findRotation(animationTimeTicks, pNodeAnim);
-        UINT NextRotationIndex = RotationIndex + 1;
-        assert(NextRotationIndex < pNodeAnim->mNumRotationKeys);
-        FLOAT t1 = static_cast<FLOAT>(pNodeAnim->mRotationKeys[RotationIndex].mTime);
-        FLOAT t2 = static_cast<FLOAT>(pNodeAnim->mRotationKeys[NextRotationIndex].mTime);
-        FLOAT DeltaTime = t2 - t1;
-        FLOAT Factor = (animationTimeTicks - t1) / DeltaTime;
-        assert(Factor >= 0.0f && Factor <= 1.0f);
-        const aiQuaternion& StartRotationQ = pNodeAnim->mRotationKeys[RotationIndex].mValue;
-        const aiQuaternion& EndRotationQ = pNodeAnim->mRotationKeys[NextRotationIndex].mValue;
-        aiQuaternion out;
-        aiQuaternion::Interpolate(out, StartRotationQ, EndRotationQ, Factor);
-        out.Normalize();
-        outQuaternion = ConvertQuaternionToVector(out);
 
+        return bIsValid;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::interpolateScaling
+      Method:   Model::loadCookedTexture
 
-      Summary:  Interpolate two keyframes to find scaling vector
+      Summary:  Create and load a texture named in a cooked file
 
-      Args:     XMFLOAT3& outScale
-                  Scaling vector
-                FLOAT animationTimeTicks
-                  Animation time
-                const aiNodeAnim* pNodeAnim
-                  Pointer to an assimp node anim object
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set the texture
+                const std::filesystem::path& fullPath
+                  Path to the texture
+                std::shared_ptr<Texture>& pOutTexture
+                  Created texture
+
+      Returns:  HRESULT
+                  Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    /*--------------------------------------------------------------------
-      TODO: Model::interpolateScaling definition (remove the comment)
-    --------------------------------------------------------------------*/
-    void Model::interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim) {
-        // we need at least two values to interpolate...
-        if (pNodeAnim->mNumScalingKeys == 1) {
-            outScale = ConvertVector3dToFloat3(pNodeAnim->mScalingKeys[0].mValue);
-            return;
+    HRESULT Model::loadCookedTexture(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const std::filesystem::path& fullPath,
+        _Out_ std::shared_ptr<Texture>& pOutTexture
+    )
+    {
+        pOutTexture = TextureCache::GetTexture(fullPath, eTextureSamplerType::TRILINEAR_WRAP);
+
+        HRESULT hr = pOutTexture->Initialize(pDevice, pImmediateContext);
+        if (FAILED(hr))
+        {
+            OutputDebugString(L"Error loading texture \"");
+            OutputDebugString(fullPath.c_str());
+            OutputDebugString(L"\"\n");
+
+            return hr;
         }
 
-        UINT ScalingIndex = findScaling(animationTimeTicks, pNodeAnim);
-        UINT NextScalingIndex = ScalingIndex + 1;
-        assert(NextScalingIndex < pNodeAnim->mNumScalingKeys);
-        FLOAT t1 = (float)pNodeAnim->mScalingKeys[ScalingIndex].mTime;
-        FLOAT t2 = (float)pNodeAnim->mScalingKeys[NextScalingIndex].mTime;
-        FLOAT DeltaTime = t2 - t1;
-        FLOAT Factor = (animationTimeTicks - (FLOAT)t1) / DeltaTime;
-        assert(Factor >= 0.0f && Factor <= 1.0f);
-        const aiVector3D& Start = pNodeAnim->mScalingKeys[ScalingIndex].mValue;
-        const aiVector3D& End = pNodeAnim->mScalingKeys[NextScalingIndex].mValue;
-        aiVector3D Delta = End - Start;
-        outScale = ConvertVector3dToFloat3(Start + Factor * Delta);
+        return hr;
     }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::loadDiffuseTexture
 
@@ -882,8 +2876,9 @@ namespace library
                 }
 
                 std::filesystem::path fullPath = parentDirectory / szPath;
+                m_pAsset->aMaterialTexturePaths[uIndex].szDiffuse = szPath;
 
-                m_aMaterials[uIndex]->pDiffuse = std::make_shared<Texture>(fullPath);
+                m_aMaterials[uIndex]->pDiffuse = TextureCache::GetTexture(fullPath, eTextureSamplerType::TRILINEAR_WRAP);
 
                 hr = m_aMaterials[uIndex]->pDiffuse->Initialize(pDevice, pImmediateContext);
                 if (FAILED(hr))
@@ -946,8 +2941,9 @@ namespace library
                 }
 
                 std::filesystem::path fullPath = parentDirectory / szPath;
+                m_pAsset->aMaterialTexturePaths[uIndex].szSpecular = szPath;
 
-                m_aMaterials[uIndex]->pSpecularExponent = std::make_shared<Texture>(fullPath);
+                m_aMaterials[uIndex]->pSpecularExponent = TextureCache::GetTexture(fullPath, eTextureSamplerType::TRILINEAR_WRAP);
 
                 hr = m_aMaterials[uIndex]->pSpecularExponent->Initialize(pDevice, pImmediateContext);
                 if (FAILED(hr))
@@ -1002,8 +2998,9 @@ namespace library
                 }
 
                 std::filesystem::path fullPath = parentDirectory / szPath;
+                m_pAsset->aMaterialTexturePaths[uIndex].szNormal = szPath;
 
-                m_aMaterials[uIndex]->pNormal = std::make_shared<Texture>(fullPath);
+                m_aMaterials[uIndex]->pNormal = TextureCache::GetTexture(fullPath, eTextureSamplerType::TRILINEAR_WRAP);
                 m_bHasNormalMap = true;
 
                 if (FAILED(hr))
@@ -1064,66 +3061,106 @@ namespace library
 
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-     Method:   Model::readNodeHierarchy
+      Method:   Model::optimizeMeshes
 
-     Summary:  Calculate bone transformation of the given assimp node
+      Summary:  Reorder the triangles and vertices of each mesh as set by
+                m_uMeshOptimizationFlags, and report the ACMR and ATVR of
+                a FIFO_CACHE_SIZE vertex cache before and after unless
+                the import verbosity is SILENT. Vertices
+                stay inside the range of their mesh, so the mesh entries
+                do not change.
 
-     Args:     FLOAT animationTimeTicks
-                 Animation time
-              const aiNode* pNode
-                 Pointer to an assimp node object
-               const XMMATRIX& parentTransform
-                 Parent transform in hierarchy
-   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-   /*--------------------------------------------------------------------
-     TODO: Model::readNodeHierarchy definition (remove the comment)
-   --------------------------------------------------------------------*/
-    void Model::readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform)
+      Modifies: [m_pAsset, m_aNormalData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::optimizeMeshes()
     {
-        const aiNodeAnim* pNodeAnim = findNodeAnimOrNull(m_pScene->mAnimations[0], pNode->mName.C_Str());
-        XMMATRIX nodeTransformation = ConvertMatrix(pNode->mTransformation);
+        if (m_uMeshOptimizationFlags == 0u)
+        {
+            return;
+        }
 
-        if (pNodeAnim)
+        const BOOL bReport = ImportProfiler::GetVerbosity() != eImportVerbosity::SILENT;
+        const UINT uNumVertices = static_cast<UINT>(m_pAsset->aVertices.size());
+        UINT uNumReferencedVertices = 0u;
+        UINT uNumTriangles = 0u;
+        UINT uNumTransformedBefore = 0u;
+        UINT uNumTransformedAfter = 0u;
+        std::vector<UINT> aRemap;
+
+        for (size_t i = 0; i < m_aMeshes.size(); ++i)
         {
-            XMMATRIX scalingMatrix = XMMATRIX();
-            XMMATRIX rotationMatrix = XMMATRIX();
-            XMMATRIX translationMatrix = XMMATRIX();
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            const UINT uEndVertex = i + 1 < m_aMeshes.size() ? m_aMeshes[i + 1].uBaseVertex : uNumVertices;
+            const UINT uNumMeshVertices = uEndVertex - mesh.uBaseVertex;
+            UINT* aIndices = m_pAsset->aWideIndices.data() + mesh.uBaseIndex;
 
-            XMFLOAT3 scale = XMFLOAT3();
-            interpolateScaling(scale, animationTimeTicks, pNodeAnim);
-            scalingMatrix = XMMatrixScaling(scale.x, scale.y, scale.z);
+            VertexCacheStatistics before = {};
+            if (bReport)
+            {
+                before = MeshOptimizer::AnalyzeVertexCache(aIndices, mesh.uNumIndices, uNumMeshVertices, MeshOptimizer::FIFO_CACHE_SIZE);
+            }
 
-            XMVECTOR rotation = XMVECTOR();
-            interpolateRotation(rotation, animationTimeTicks, pNodeAnim);
-            rotationMatrix = XMMatrixRotationQuaternion(rotation);
+            if (m_uMeshOptimizationFlags & MeshOptimizer::OPTIMIZE_VERTEX_CACHE)
+            {
+                MeshOptimizer::OptimizeVertexCache(aIndices, mesh.uNumIndices, uNumMeshVertices);
+            }
 
-            XMFLOAT3 position = XMFLOAT3();
-            interpolatePosition(position, animationTimeTicks, pNodeAnim);
-            translationMatrix = XMMatrixTranslation(position.x, position.y, position.z);
+            if (m_uMeshOptimizationFlags & MeshOptimizer::OPTIMIZE_OVERDRAW)
+            {
+                MeshOptimizer::OptimizeOverdraw(
+                    aIndices,
+                    mesh.uNumIndices,
+                    m_pAsset->aVertices.data() + mesh.uBaseVertex,
+                    uNumMeshVertices,
+                    MeshOptimizer::OVERDRAW_THRESHOLD
+                );
+            }
 
-            nodeTransformation = scalingMatrix * rotationMatrix * translationMatrix;
-        }
+            if (m_uMeshOptimizationFlags & MeshOptimizer::OPTIMIZE_VERTEX_FETCH)
+            {
+                MeshOptimizer::OptimizeVertexFetch(aIndices, mesh.uNumIndices, uNumMeshVertices, aRemap);
+                MeshOptimizer::RemapIndices(aIndices, mesh.uNumIndices, aRemap);
+                MeshOptimizer::RemapVertices(m_pAsset->aVertices.data() + mesh.uBaseVertex, aRemap);
+                MeshOptimizer::RemapVertices(m_pAsset->aBoneData.data() + mesh.uBaseVertex, aRemap);
+                if (m_aNormalData.size() == uNumVertices)
+                {
+                    MeshOptimizer::RemapVertices(m_aNormalData.data() + mesh.uBaseVertex, aRemap);
+                }
+            }
+
+            if (!bReport)
+            {
+                continue;
+            }
 
-        XMMATRIX globalTransformation = nodeTransformation * parentTransform;
+            const VertexCacheStatistics after = MeshOptimizer::AnalyzeVertexCache(aIndices, mesh.uNumIndices, uNumMeshVertices, MeshOptimizer::FIFO_CACHE_SIZE);
 
-        auto iBoneIndex = m_boneNameToIndexMap.find(pNode->mName.C_Str());
-        if (iBoneIndex != m_boneNameToIndexMap.end())
-        {
-            UINT boneIndex = 0u;
-            boneIndex = iBoneIndex->second;
-            m_aBoneInfo[boneIndex].FinalTransformation = m_aBoneInfo[boneIndex].OffsetMatrix * globalTransformation *
-                m_globalInverseTransform;
+            uNumReferencedVertices += before.uNumReferencedVertices;
+            uNumTriangles += before.uNumTriangles;
+            uNumTransformedBefore += before.uNumTransformedVertices;
+            uNumTransformedAfter += after.uNumTransformedVertices;
         }
-        for (UINT i = 0u; i < pNode->mNumChildren; ++i)
+
+        if (uNumTriangles == 0u || uNumReferencedVertices == 0u)
         {
-            readNodeHierarchy(animationTimeTicks, pNode->mChildren[i], globalTransformation);
+            return;
         }
+
+        CHAR szDebugMessage[256];
+        sprintf_s(szDebugMessage, "Optimized %s: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+            m_filePath.string().c_str(),
+            static_cast<FLOAT>(uNumTransformedBefore) / static_cast<FLOAT>(uNumTriangles),
+            static_cast<FLOAT>(uNumTransformedAfter) / static_cast<FLOAT>(uNumTriangles),
+            static_cast<FLOAT>(uNumTransformedBefore) / static_cast<FLOAT>(uNumReferencedVertices),
+            static_cast<FLOAT>(uNumTransformedAfter) / static_cast<FLOAT>(uNumReferencedVertices));
+        OutputDebugStringA(szDebugMessage);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::reserveSpace
 
-      Summary:  Reserve space for vertices and indices vectors
+      Summary:  Size the vertex, normal, bone and index vectors for all
+                meshes, so each mesh fills its own range of them
 
       Args:     UINT uNumVertices
                   Number of vertices
@@ -1132,8 +3169,212 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Model::reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices)
     {
-        m_aVertices.reserve(uNumVertices);
-        m_aIndices.reserve(uNumIndices);
-        m_aBoneData.resize(uNumVertices);
+        m_pAsset->aVertices.resize(uNumVertices);
+        m_pAsset->aWideIndices.resize(uNumIndices);
+        m_pAsset->aBoneData.resize(uNumVertices);
+        m_aNormalData.resize(uNumVertices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::sampleAnimation
+
+      Summary:  Sample the local pose of every joint at the given time.
+                Joints without a track keep their bind pose. An
+                additive pose is stored as the difference to the bind
+                pose.
+
+      Args:     UINT uAnimationIndex
+                  Index of the animation to sample
+                FLOAT animationTimeTicks
+                  Animation time
+                BOOL bAdditive
+                  Whether to store the difference to the bind pose
+                Pose& outPose
+                  Sampled pose
+
+      Modifies: [m_aKeyCursors, outPose].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::sampleAnimation(_In_ UINT uAnimationIndex, _In_ FLOAT animationTimeTicks, _In_ BOOL bAdditive, _Inout_ Pose& outPose)
+    {
+        const AnimationClip& clip = *m_pAsset->aAnimationClips[uAnimationIndex];
+        std::vector<AnimationClip::KeyCursor>& aCursors = m_aKeyCursors[uAnimationIndex];
+        const UINT uNumJoints = static_cast<UINT>(m_pAsset->skeleton.aParentIndices.size());
+
+        for (UINT i = 0u; i < uNumJoints; ++i)
+        {
+            XMVECTOR bindScale = XMLoadFloat3(&m_pAsset->skeleton.aBindScales[i]);
+            XMVECTOR bindRotation = XMLoadFloat4(&m_pAsset->skeleton.aBindRotations[i]);
+            XMVECTOR bindTranslation = XMLoadFloat3(&m_pAsset->skeleton.aBindTranslations[i]);
+
+            XMVECTOR scale = bindScale;
+            XMVECTOR rotation = bindRotation;
+            XMVECTOR translation = bindTranslation;
+            clip.Sample(animationTimeTicks, i, aCursors[i], scale, rotation, translation);
+
+            if (bAdditive)
+            {
+                outPose.aScales[i] = XMVectorDivide(scale, bindScale);
+                outPose.aRotations[i] = XMQuaternionMultiply(XMQuaternionInverse(bindRotation), rotation);
+                outPose.aTranslations[i] = XMVectorSubtract(translation, bindTranslation);
+            }
+            else
+            {
+                outPose.aScales[i] = scale;
+                outPose.aRotations[i] = rotation;
+                outPose.aTranslations[i] = translation;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::sampleAnimationLayers
+
+      Summary:  Sample the pose of every layer. Layers playing the same
+                clip at the same time share one sampled pose.
+
+      Modifies: [m_aKeyCursors, m_aPoses, m_aLayerPoseIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::sampleAnimationLayers()
+    {
+        const UINT uNumJoints = static_cast<UINT>(m_pAsset->skeleton.aParentIndices.size());
+        const UINT uNumLayers = static_cast<UINT>(m_aAnimationLayers.size());
+
+        if (m_aPoses.size() < uNumLayers)
+        {
+            m_aPoses.resize(uNumLayers);
+        }
+        m_aLayerPoseIndices.resize(uNumLayers);
+
+        UINT uNumPoses = 0u;
+        for (UINT l = 0u; l < uNumLayers; ++l)
+        {
+            const AnimationLayer& layer = m_aAnimationLayers[l];
+
+            UINT uPoseIndex = uNumPoses;
+            for (UINT k = 0u; k < l; ++k)
+            {
+                const AnimationLayer& sampledLayer = m_aAnimationLayers[k];
+                if (sampledLayer.uAnimationIndex == layer.uAnimationIndex &&
+                    sampledLayer.bAdditive == layer.bAdditive &&
+                    sampledLayer.animationTimeTicks == layer.animationTimeTicks)
+                {
+                    uPoseIndex = m_aLayerPoseIndices[k];
+                    break;
+                }
+            }
+
+            m_aLayerPoseIndices[l] = uPoseIndex;
+            if (uPoseIndex < uNumPoses)
+            {
+                continue;
+            }
+
+            Pose& pose = m_aPoses[uNumPoses++];
+            pose.aScales.resize(uNumJoints);
+            pose.aRotations.resize(uNumJoints);
+            pose.aTranslations.resize(uNumJoints);
+
+            sampleAnimation(layer.uAnimationIndex, layer.animationTimeTicks, layer.bAdditive, pose);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::updateAnimationLayers
+
+      Summary:  Advance the time and the fade of every layer and remove
+                the layers that faded out
+
+      Args:     FLOAT deltaTime
+                  Time difference of a frame
+
+      Modifies: [m_aAnimationLayers].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::updateAnimationLayers(_In_ FLOAT deltaTime)
+    {
+        for (AnimationLayer& layer : m_aAnimationLayers)
+        {
+            const AnimationClip& clip = *m_pAsset->aAnimationClips[layer.uAnimationIndex];
+
+            layer.time += deltaTime;
+            layer.weight = std::clamp(layer.weight + layer.fadeRate * deltaTime, 0.0f, 1.0f);
+
+            FLOAT timeInTicks = layer.time * clip.GetTicksPerSecond();
+            FLOAT durationTicks = clip.GetDurationTicks();
+            if (durationTicks <= 0.0f)
+            {
+                layer.animationTimeTicks = 0.0f;
+            }
+            else if (layer.bLoop)
+            {
+                layer.animationTimeTicks = fmod(timeInTicks, durationTicks);
+            }
+            else
+            {
+                layer.animationTimeTicks = std::min(timeInTicks, durationTicks);
+            }
+        }
+
+        std::erase_if(m_aAnimationLayers,
+            [](const AnimationLayer& layer)
+            {
+                return layer.fadeRate < 0.0f && layer.weight <= 0.0f;
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::writeSkinningPalette
+
+      Summary:  Writes a bone transform in the palette in the layout of
+                the current format. The 3x4 rows are the columns of the
+                transform, so the shader skins with three dot products
+                and the render thread no longer transposes anything.
+                The dual quaternion is the unit rotation quaternion and
+                half the translation times it; scale is dropped.
+
+      Args:     UINT uBoneIndex
+                  Index of the bone
+                FXMMATRIX boneTransform
+                  Skinning transform of the bone
+
+      Modifies: [m_aSkinningPalette].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::writeSkinningPalette(_In_ UINT uBoneIndex, _In_ FXMMATRIX boneTransform)
+    {
+        const size_t uFirstRow = static_cast<size_t>(uBoneIndex) * getNumPaletteRowsPerBone();
+        assert(uFirstRow + getNumPaletteRowsPerBone() <= m_aSkinningPalette.size());
+
+        switch (m_skinningPaletteFormat)
+        {
+        case eSkinningPaletteFormat::DUAL_QUATERNION:
+        {
+            XMVECTOR scale;
+            XMVECTOR rotation;
+            XMVECTOR translation;
+            if (!XMMatrixDecompose(&scale, &rotation, &translation, boneTransform))
+            {
+                rotation = XMQuaternionIdentity();
+                translation = boneTransform.r[3];
+            }
+
+            // XMQuaternionMultiply(q0, t) is the product t * q0
+            XMVECTOR dual = XMVectorScale(XMQuaternionMultiply(rotation, XMVectorSetW(translation, 0.0f)), 0.5f);
+
+            XMStoreFloat4(&m_aSkinningPalette[uFirstRow], rotation);
+            XMStoreFloat4(&m_aSkinningPalette[uFirstRow + 1u], dual);
+            break;
+        }
+        case eSkinningPaletteFormat::AFFINE_3X4:
+        default:
+        {
+            XMFLOAT3X4 rows;
+            XMStoreFloat3x4(&rows, boneTransform);
+
+            m_aSkinningPalette[uFirstRow] = XMFLOAT4(rows.m[0]);
+            m_aSkinningPalette[uFirstRow + 1u] = XMFLOAT4(rows.m[1]);
+            m_aSkinningPalette[uFirstRow + 2u] = XMFLOAT4(rows.m[2]);
+            break;
+        }
+        }
     }
-}
\ No newline at end of file
+}
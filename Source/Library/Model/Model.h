@@ -12,6 +12,18 @@
 #pragma once
 
 #include "Common.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#include "Model/AnimationClip.h"
+#include "Model/CookedModel.h"
+#include "Model/ImportProfiler.h"
+#include "Model/MeshOptimizer.h"
+#include "Model/MeshletCuller.h"
+#include "Model/MeshSimplifier.h"
+#include "Model/SkinnedVertexCache.h"
 #include "Renderer/DataTypes.h"
 #include "Renderer/Renderable.h"
 #include "Shader/PixelShader.h"
@@ -24,12 +36,6 @@ struct aiMaterial;
 struct aiAnimation;
 struct aiBone;
 struct aiNode;
-struct aiNodeAnim;
-
-namespace Assimp
-{
-    class Importer;
-}
 
 namespace library
 {
@@ -57,6 +63,52 @@ namespace library
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                GetIndexFormat
+                  Returns the format of the indices of the asset
+                UpdateSkinnedVertexBuffer
+                  Uploads the CPU skinned vertices for the shadow pass
+                GetSkinnedVertexBuffer
+                  Returns the CPU skinned vertex buffer
+                GetSkinnedVertexCache
+                  Returns the CPU skinned vertices
+                GetSkinnedBounds
+                  Returns the world space bounds of the skinned mesh
+                Pick
+                  Tests a world space ray against the skinned mesh
+                SharesAsset
+                  Returns whether two models use the same asset
+                SetSkinningPaletteFormat
+                  Sets the layout of the bone palette uploaded to the
+                  GPU
+                GetSkinningPaletteFormat
+                  Returns the layout of the bone palette
+                GetSkinningPalette
+                  Returns the bone palette rows in GPU order
+                SetCpuSkinningEnabled
+                  Sets whether the mesh is also skinned on the CPU
+                IsCpuSkinningEnabled
+                  Returns whether the mesh is also skinned on the CPU
+                SetMeshOptimizationFlags
+                  Sets how the meshes are reordered when imported
+                GetAnimationDataStride
+                  Returns the stride of the animation buffer
+                GetLodStatistics
+                  Returns the triangles, error and simplification time
+                  of each detail level
+                GetBoneWeightErrors
+                  Returns the largest bone weight error of each mesh
+                CullMeshlets
+                  Returns the index ranges of the meshlets of a mesh
+                  that can be seen
+                SetLoaded
+                  Marks the GPU resources of the model as ready to draw
+                IsLoaded
+                  Returns whether the model can be drawn
+                GetImportProfiler
+                  Returns the stage timings of the last import
+                SetNumImportThreads
+                  Limits the number of threads importing the meshes of
+                  a model
                 Model
                   Constructor.
                 ~Model
@@ -64,6 +116,9 @@ namespace library
     C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Model : public Renderable
     {
+    public:
+        static constexpr const UINT INVALID_INDEX = (0xFFFFFFFF);
+
     public:
         Model() = delete;
         Model(_In_ const std::filesystem::path& filePath);
@@ -78,41 +133,104 @@ namespace library
 
         ComPtr<ID3D11Buffer>& GetAnimationBuffer();
         ComPtr<ID3D11Buffer>& GetSkinningConstantBuffer();
+        ComPtr<ID3D11Buffer>& GetSkinnedVertexBuffer();
+        HRESULT UpdateSkinnedVertexBuffer(_In_ ID3D11DeviceContext* pImmediateContext);
+        const SkinnedVertexCache& GetSkinnedVertexCache() const;
+        BOOL GetSkinnedBounds(_Out_ BoundingBox& bounds) const;
+        BOOL Pick(_In_ FXMVECTOR origin, _In_ FXMVECTOR direction, _Out_ FLOAT& distance) const;
+        BOOL SharesAsset(_In_ const Model& other) const;
+        void SetSkinningPaletteFormat(_In_ eSkinningPaletteFormat format);
+        eSkinningPaletteFormat GetSkinningPaletteFormat() const;
+        const std::vector<XMFLOAT4>& GetSkinningPalette() const;
+        void SetCpuSkinningEnabled(_In_ BOOL bIsEnabled);
+        BOOL IsCpuSkinningEnabled() const;
+        void SetMeshOptimizationFlags(_In_ UINT uFlags);
+        UINT GetAnimationDataStride() const;
+        const std::vector<LodStatistics>& GetLodStatistics() const;
+        const std::vector<FLOAT>& GetBoneWeightErrors() const;
+        BOOL CullMeshlets(
+            _In_ UINT uMeshIndex,
+            _In_ FXMVECTOR eyePosition,
+            _In_ CXMMATRIX viewProjection,
+            _Out_ std::vector<Meshlet>& aOutRanges,
+            _Inout_ MeshletCullingStatistics& statistics
+        ) const;
+        void SetLoaded(_In_ BOOL bIsLoaded);
+        BOOL IsLoaded() const;
+        const ImportProfiler& GetImportProfiler() const;
 
         virtual UINT GetNumVertices() const override;
         virtual UINT GetNumIndices() const override;
+        virtual DXGI_FORMAT GetIndexFormat() const override;
 
         std::vector<XMMATRIX>& GetBoneTransforms();
         const std::unordered_map<std::string, UINT>& GetBoneNameToIndexMap() const;
+        UINT GetNumAnimations() const;
+        UINT GetNumAnimatedNodes(_In_ UINT uAnimationIndex) const;
+        UINT GetNumStaticNodes(_In_ UINT uAnimationIndex) const;
+        UINT GetNumSampledPoses() const;
+
+        void PlayAnimation(_In_ UINT uAnimationIndex, _In_ BOOL bLoop);
+        void CrossFadeAnimation(_In_ UINT uAnimationIndex, _In_ FLOAT fadeDuration, _In_ BOOL bLoop);
+        void SetAnimationWeight(_In_ UINT uAnimationIndex, _In_ FLOAT weight, _In_ BOOL bAdditive);
+
+        static void SetNumImportThreads(_In_ UINT uNumThreads);
 
     protected:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   VertexBoneData
+
+          Summary:  The MAX_NUM_BONES_PER_VERTEX largest bone weights of a
+                    vertex, in the order they were added. A smaller weight
+                    is dropped when it is added, and only the sum and the
+                    largest of the dropped weights are kept to measure the
+                    error of renormalizing the kept ones.
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
         struct VertexBoneData
         {
             VertexBoneData()
                 : aBoneIds{ 0u, }
                 , aWeights{ 0.0f, }
+                , droppedWeight(0.0f)
+                , maxDroppedWeight(0.0f)
                 , uNumBones(0u)
             {
-                ZeroMemory(aBoneIds, ARRAYSIZE(aBoneIds) * sizeof(aBoneIds[0]));
-                ZeroMemory(aWeights, ARRAYSIZE(aWeights) * sizeof(aWeights[0]));
             }
 
             void AddBoneData(_In_ UINT uBoneId, _In_ FLOAT weight)
             {
-                assert(uNumBones < ARRAYSIZE(aBoneIds));
+                if (uNumBones < MAX_NUM_BONES_PER_VERTEX)
+                {
+                    aBoneIds[uNumBones] = uBoneId;
+                    aWeights[uNumBones] = weight;
+
+                    ++uNumBones;
+                    return;
+                }
 
-                aBoneIds[uNumBones] = uBoneId;
-                aWeights[uNumBones] = weight;
+                UINT uSmallest = 0u;
+                for (UINT i = 1u; i < MAX_NUM_BONES_PER_VERTEX; ++i)
+                {
+                    if (aWeights[i] < aWeights[uSmallest])
+                    {
+                        uSmallest = i;
+                    }
+                }
 
-                static CHAR szDebugMessage[256];
-                sprintf_s(szDebugMessage, "\t\t\tBone %d, weight: %f, index %u\n", uBoneId, weight, uNumBones);
-                OutputDebugStringA(szDebugMessage);
+                if (weight > aWeights[uSmallest])
+                {
+                    std::swap(uBoneId, aBoneIds[uSmallest]);
+                    std::swap(weight, aWeights[uSmallest]);
+                }
 
-                ++uNumBones;
+                droppedWeight += weight;
+                maxDroppedWeight = std::max(maxDroppedWeight, weight);
             }
 
             UINT aBoneIds[MAX_NUM_BONES_PER_VERTEX];
             FLOAT aWeights[MAX_NUM_BONES_PER_VERTEX];
+            FLOAT droppedWeight;
+            FLOAT maxDroppedWeight;
             UINT uNumBones;
         };
 
@@ -121,23 +239,134 @@ namespace library
             BoneInfo() = default;
             BoneInfo(const XMMATRIX& Offset)
                 : OffsetMatrix(Offset)
-                , FinalTransformation()
             {
             }
 
             XMMATRIX OffsetMatrix;
-            XMMATRIX FinalTransformation;
         };
 
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Skeleton
+
+          Summary:  Node hierarchy flattened into arrays, one entry per
+                    joint. Joints are stored in pre-order so a parent
+                    always comes before its children, and nodes without
+                    any bone below them are left out.
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Skeleton
+        {
+            std::vector<std::string> aNames;
+            std::vector<UINT> aParentIndices;
+            std::vector<UINT> aBoneIndices;
+            std::vector<XMFLOAT3> aBindScales;
+            std::vector<XMFLOAT4> aBindRotations;
+            std::vector<XMFLOAT3> aBindTranslations;
+            std::vector<XMMATRIX> aBindTransforms;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   AnimationLayer
+
+          Summary:  Clip currently played with its own time and weight.
+                    Additive layers are applied on top of the weighted
+                    blend of all other layers.
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct AnimationLayer
+        {
+            UINT uAnimationIndex;
+            FLOAT time;
+            FLOAT animationTimeTicks;
+            FLOAT weight;
+            FLOAT fadeRate;
+            BOOL bLoop;
+            BOOL bAdditive;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Pose
+
+          Summary:  Local scale, rotation and translation of every joint
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Pose
+        {
+            std::vector<XMVECTOR> aScales;
+            std::vector<XMVECTOR> aRotations;
+            std::vector<XMVECTOR> aTranslations;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   MaterialTexturePaths
+
+          Summary:  Texture paths of a material relative to the model
+                    directory, kept so the asset can be cooked
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct MaterialTexturePaths
+        {
+            std::string szDiffuse;
+            std::string szSpecular;
+            std::string szNormal;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ModelAsset
+
+          Summary:  Data imported from a model file, or loaded from its
+                    cooked file. It does not change after loading, so
+                    every instance of the same file shares one asset
+                    through the asset cache.
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ModelAsset
+        {
+            std::vector<SimpleVertex> aVertices;
+            std::vector<AnimationData> aAnimationData;
+            std::vector<WORD> aIndices;
+            std::vector<UINT> aWideIndices;
+            std::vector<NormalData> aNormalData;
+            std::vector<VertexBoneData> aBoneData;
+            std::vector<BoneInfo> aBoneInfo;
+            std::vector<BasicMeshEntry> aMeshes;
+            std::vector<std::shared_ptr<Material>> aMaterials;
+            std::vector<std::shared_ptr<AnimationClip>> aAnimationClips;
+            std::vector<MaterialTexturePaths> aMaterialTexturePaths;
+            std::vector<LodStatistics> aLodStatistics;
+            std::vector<FLOAT> aBoneWeightErrors;
+            std::vector<Meshlet> aMeshlets;
+            std::vector<MeshletBounds> aMeshletBounds;
+            std::shared_ptr<SkinningStreams> pSkinningStreams;
+            std::unordered_map<std::string, UINT> boneNameToIndexMap;
+            Skeleton skeleton;
+
+            ComPtr<ID3D11Buffer> vertexBuffer;
+            ComPtr<ID3D11Buffer> indexBuffer;
+            ComPtr<ID3D11Buffer> normalBuffer;
+            ComPtr<ID3D11Buffer> animationBuffer;
+
+            XMMATRIX globalInverseTransform;
+            DXGI_FORMAT indexFormat;
+            BOOL bHasNormalMap;
+        };
+
+        HRESULT bindAnimation(_In_ const aiAnimation* pAnimation);
+        HRESULT cookAsset(_In_ const std::filesystem::path& cookedFilePath) const;
         void countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene);
-        const aiNodeAnim* findNodeAnimOrNull(_In_ const aiAnimation* pAnimation, _In_ PCSTR pszNodeName);
-        UINT findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        UINT findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        UINT findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
+        void evaluateSkeleton();
+        void forEachMesh(_In_ const std::function<void(UINT)>& function) const;
+        void generateLods();
+        void generateMeshlets();
         UINT getBoneId(_In_ const aiBone* pBone);
+        UINT getNumPaletteRowsPerBone() const;
+        HRESULT importAsset(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
         const virtual SimpleVertex* getVertices() const override;
-        virtual const WORD* getIndices() const override;
+        virtual const void* getIndices() const override;
         void initAllMeshes(_In_ const aiScene* pScene);
+        void initAnimationData();
+        HRESULT initAssetBuffers(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        void reportTangentFrameError();
+        void initBoneIds(_In_ const aiScene* pScene);
+        HRESULT initAsset(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        HRESULT initFromAsset(_In_ ID3D11Device* pDevice);
+        HRESULT initFromCookedModel(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const CookedModel& cookedModel);
+        HRESULT initCookedMaterials(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const CookedModel& cookedModel);
         HRESULT initFromScene(
             _In_ ID3D11Device* pDevice,
             _In_ ID3D11DeviceContext* pImmediateContext,
@@ -153,9 +382,17 @@ namespace library
         void initMeshBones(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
         void initMeshSingleBone(_In_ UINT uBoneIndex, _In_ const aiBone* pBone);
         virtual void initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
-        void interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        void interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        void interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
+        void initIndexFormat();
+        void initLodStatistics();
+        void initSkeleton(_In_ const aiNode* pRootNode);
+        BOOL initSkeletonJoint(_In_ const aiNode* pNode, _In_ UINT uParentIndex);
+        BOOL isValidCookedModel(_In_ const CookedModel& cookedModel) const;
+        HRESULT loadCookedTexture(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::filesystem::path& fullPath,
+            _Out_ std::shared_ptr<Texture>& pOutTexture
+        );
         HRESULT loadDiffuseTexture(
             _In_ ID3D11Device* pDevice,
             _In_ ID3D11DeviceContext* pImmediateContext,
@@ -184,31 +421,45 @@ namespace library
             _In_ const aiMaterial* pMaterial,
             _In_ UINT uIndex
         );
-        void readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform);
+        void optimizeMeshes();
         void reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices);
+        void sampleAnimation(_In_ UINT uAnimationIndex, _In_ FLOAT animationTimeTicks, _In_ BOOL bAdditive, _Inout_ Pose& outPose);
+        void sampleAnimationLayers();
+        void updateAnimationLayers(_In_ FLOAT deltaTime);
+        void writeSkinningPalette(_In_ UINT uBoneIndex, _In_ FXMMATRIX boneTransform);
 
     protected:
-        static std::unique_ptr<Assimp::Importer> sm_pImporter;
+        static std::unordered_map<std::wstring, std::weak_ptr<ModelAsset>> sm_assetCache;
+        static std::atomic<UINT> sm_uNumImportThreads;
+        static std::mutex sm_assetCacheMutex;
+        static std::unordered_map<std::wstring, std::shared_ptr<std::mutex>> sm_importMutexes;
 
     protected:
         std::filesystem::path m_filePath;
 
         ComPtr<ID3D11Buffer> m_animationBuffer;
         ComPtr<ID3D11Buffer> m_skinningConstantBuffer;
+        ComPtr<ID3D11Buffer> m_skinnedVertexBuffer;
 
-        std::vector<SimpleVertex> m_aVertices;
-        std::vector<AnimationData> m_aAnimationData;
-        std::vector<WORD> m_aIndices;
-        std::vector<VertexBoneData> m_aBoneData;
-        std::vector<BoneInfo> m_aBoneInfo;
-        std::vector<XMMATRIX> m_aTransforms;
-        std::unordered_map<std::string, UINT> m_boneNameToIndexMap;
+        std::shared_ptr<ModelAsset> m_pAsset;
 
-        const aiScene* m_pScene;
+        std::vector<XMMATRIX> m_aTransforms;
+        std::vector<XMFLOAT4> m_aSkinningPalette;
+        std::vector<XMMATRIX> m_aGlobalTransforms;
+        std::vector<std::vector<AnimationClip::KeyCursor>> m_aKeyCursors;
+        std::vector<AnimationLayer> m_aAnimationLayers;
+        std::vector<Pose> m_aPoses;
+        std::vector<UINT> m_aLayerPoseIndices;
+        SkinnedVertexCache m_skinnedVertexCache;
+        ImportProfiler m_importProfiler;
 
         float m_timeSinceLoaded;
-
-        XMMATRIX m_globalInverseTransform;
+        eSkinningPaletteFormat m_skinningPaletteFormat;
+        UINT m_uMeshOptimizationFlags;
+        BOOL m_bUseAssetCache;
+        BOOL m_bIsSkinnedVertexBufferDirty;
+        BOOL m_bIsCpuSkinningEnabled;
+        std::atomic<BOOL> m_bIsLoaded;
 
         //BYTE m_padding[8];
     };
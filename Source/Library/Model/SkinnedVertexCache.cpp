@@ -0,0 +1,727 @@
+#include "Model/SkinnedVertexCache.h"
+
+#if defined(_M_X64) || defined(_M_IX86)
+#define SKINNING_AVX2_AVAILABLE
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace library
+{
+    namespace
+    {
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: DetectAvx2
+
+          Summary:  Returns whether the CPU and the operating system
+                    support AVX2 and FMA instructions
+
+          Returns:  BOOL
+                      TRUE if the AVX2 skinning path can be used
+        -----------------------------------------------------------------F-F*/
+        BOOL DetectAvx2()
+        {
+#if defined(SKINNING_AVX2_AVAILABLE)
+            INT aCpuInfo[4] = { 0, };
+
+            __cpuid(aCpuInfo, 0);
+            if (aCpuInfo[0] < 7)
+            {
+                return FALSE;
+            }
+
+            __cpuid(aCpuInfo, 1);
+            const BOOL bHasFma = (aCpuInfo[2] & (1 << 12)) != 0;
+            const BOOL bHasOsxsave = (aCpuInfo[2] & (1 << 27)) != 0;
+            const BOOL bHasAvx = (aCpuInfo[2] & (1 << 28)) != 0;
+            if (!bHasFma || !bHasOsxsave || !bHasAvx)
+            {
+                return FALSE;
+            }
+
+            // The operating system must save the YMM registers on context switches
+            if ((_xgetbv(0) & 0x6) != 0x6)
+            {
+                return FALSE;
+            }
+
+            __cpuidex(aCpuInfo, 7, 0);
+
+            return (aCpuInfo[1] & (1 << 5)) != 0;
+#else
+            return FALSE;
+#endif
+        }
+
+#if defined(SKINNING_AVX2_AVAILABLE)
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: NormalizeAvx2
+
+          Summary:  Normalizes eight vectors stored as one register per
+                    component. Zero vectors stay zero.
+
+          Args:     __m256& x
+                      X components
+                    __m256& y
+                      Y components
+                    __m256& z
+                      Z components
+        -----------------------------------------------------------------F-F*/
+        void NormalizeAvx2(_Inout_ __m256& x, _Inout_ __m256& y, _Inout_ __m256& z)
+        {
+            const __m256 lengthSq = _mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_mul_ps(z, z)));
+            const __m256 invLength = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(_mm256_max_ps(lengthSq, _mm256_set1_ps(1.0e-24f))));
+
+            x = _mm256_mul_ps(x, invLength);
+            y = _mm256_mul_ps(y, invLength);
+            z = _mm256_mul_ps(z, invLength);
+        }
+#endif
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinningStreams::Initialize
+
+      Summary:  Split the vertices into one array per component. The
+                padding at the end repeats the last vertex so a batch
+                never reads past the arrays and the bounds are not
+                affected.
+
+      Args:     const SimpleVertex* aVertices
+                  Bind pose vertices
+                const NormalData* aNormalData
+                  Tangents of the vertices, can be nullptr
+                const AnimationData* aAnimationData
+                  Bone indices and weights of the vertices
+                UINT uNumVertices
+                  Number of vertices
+
+      Modifies: [aPositionsX, aPositionsY, aPositionsZ, aNormalsX,
+                 aNormalsY, aNormalsZ, aTangentsX, aTangentsY,
+                 aTangentsZ, aTexCoords, aBoneIndices, aBoneWeights,
+                 uNumVertices, uNumPaddedVertices, uMaxBoneIndex,
+                 bHasTangents].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SkinningStreams::Initialize(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+        _In_reads_(uNumVertices) const AnimationData* aAnimationData,
+        _In_ UINT uNumVertices
+    )
+    {
+        if (!aVertices || !aAnimationData || uNumVertices == 0u)
+        {
+            return E_INVALIDARG;
+        }
+
+        const UINT uBatchSize = SkinnedVertexCache::BATCH_SIZE;
+
+        this->uNumVertices = uNumVertices;
+        uNumPaddedVertices = (uNumVertices + uBatchSize - 1u) / uBatchSize * uBatchSize;
+        uMaxBoneIndex = 0u;
+        bHasTangents = aNormalData != nullptr;
+
+        for (std::vector<FLOAT>* pStream : { &aPositionsX, &aPositionsY, &aPositionsZ, &aNormalsX, &aNormalsY, &aNormalsZ, &aTangentsX, &aTangentsY, &aTangentsZ })
+        {
+            pStream->resize(uNumPaddedVertices);
+        }
+        aTexCoords.resize(uNumPaddedVertices);
+
+        for (UINT k = 0u; k < NUM_INFLUENCES; ++k)
+        {
+            aBoneIndices[k].resize(uNumPaddedVertices);
+            aBoneWeights[k].resize(uNumPaddedVertices);
+        }
+
+        for (UINT i = 0u; i < uNumPaddedVertices; ++i)
+        {
+            const UINT uSource = std::min(i, uNumVertices - 1u);
+            const SimpleVertex& vertex = aVertices[uSource];
+            const AnimationData& animationData = aAnimationData[uSource];
+
+            aPositionsX[i] = vertex.Position.x;
+            aPositionsY[i] = vertex.Position.y;
+            aPositionsZ[i] = vertex.Position.z;
+            aNormalsX[i] = vertex.Normal.x;
+            aNormalsY[i] = vertex.Normal.y;
+            aNormalsZ[i] = vertex.Normal.z;
+            aTexCoords[i] = vertex.TexCoord;
+
+            if (bHasTangents)
+            {
+                aTangentsX[i] = aNormalData[uSource].Tangent.x;
+                aTangentsY[i] = aNormalData[uSource].Tangent.y;
+                aTangentsZ[i] = aNormalData[uSource].Tangent.z;
+            }
+
+            const UINT aIndices[NUM_INFLUENCES] =
+            {
+                animationData.aBoneIndices.x,
+                animationData.aBoneIndices.y,
+                animationData.aBoneIndices.z,
+                animationData.aBoneIndices.w
+            };
+            const FLOAT aWeights[NUM_INFLUENCES] =
+            {
+                animationData.aBoneWeights.x,
+                animationData.aBoneWeights.y,
+                animationData.aBoneWeights.z,
+                animationData.aBoneWeights.w
+            };
+
+            for (UINT k = 0u; k < NUM_INFLUENCES; ++k)
+            {
+                // Unused influences point at bone 0 so the palette is never read out of range
+                const BOOL bIsUsed = aWeights[k] != 0.0f;
+
+                aBoneIndices[k][i] = bIsUsed ? static_cast<INT>(aIndices[k]) : 0;
+                aBoneWeights[k][i] = bIsUsed ? aWeights[k] : 0.0f;
+
+                if (bIsUsed)
+                {
+                    uMaxBoneIndex = std::max(uMaxBoneIndex, aIndices[k]);
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    const BOOL SkinnedVertexCache::sm_bHasAvx2 = DetectAvx2();
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::SkinnedVertexCache
+
+      Summary:  Constructor
+
+      Modifies: [m_pStreams, m_aPositionsX, m_aPositionsY,
+                 m_aPositionsZ, m_aNormalsX, m_aNormalsY, m_aNormalsZ,
+                 m_aTangentsX, m_aTangentsY, m_aTangentsZ, m_bounds,
+                 m_bIsValid].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SkinnedVertexCache::SkinnedVertexCache()
+        : m_pStreams()
+        , m_aPositionsX()
+        , m_aPositionsY()
+        , m_aPositionsZ()
+        , m_aNormalsX()
+        , m_aNormalsY()
+        , m_aNormalsZ()
+        , m_aTangentsX()
+        , m_aTangentsY()
+        , m_aTangentsZ()
+        , m_bounds()
+        , m_bIsValid(FALSE)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::Initialize
+
+      Summary:  Sets the bind pose streams and allocates the skinned
+                vertices
+
+      Args:     const std::shared_ptr<const SkinningStreams>& pStreams
+                  Bind pose streams shared with the model asset
+
+      Modifies: [m_pStreams, m_aPositionsX, m_aPositionsY,
+                 m_aPositionsZ, m_aNormalsX, m_aNormalsY, m_aNormalsZ,
+                 m_aTangentsX, m_aTangentsY, m_aTangentsZ, m_bIsValid].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedVertexCache::Initialize(_In_ const std::shared_ptr<const SkinningStreams>& pStreams)
+    {
+        m_pStreams = pStreams;
+        m_bIsValid = FALSE;
+
+        const UINT uNumPaddedVertices = m_pStreams ? m_pStreams->uNumPaddedVertices : 0u;
+
+        for (std::vector<FLOAT>* pStream : { &m_aPositionsX, &m_aPositionsY, &m_aPositionsZ, &m_aNormalsX, &m_aNormalsY, &m_aNormalsZ, &m_aTangentsX, &m_aTangentsY, &m_aTangentsZ })
+        {
+            pStream->assign(uNumPaddedVertices, 0.0f);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::Update
+
+      Summary:  Skins the vertices with the given bone palette and
+                recomputes their bounds, with AVX2 when the CPU
+                supports it
+
+      Args:     const std::vector<XMMATRIX>& aBoneTransforms
+                  Bone palette, the same matrices uploaded to the
+                  skinning constant buffer before transposing
+
+      Modifies: [m_aPositionsX, m_aPositionsY, m_aPositionsZ,
+                 m_aNormalsX, m_aNormalsY, m_aNormalsZ, m_aTangentsX,
+                 m_aTangentsY, m_aTangentsZ, m_bounds, m_bIsValid].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedVertexCache::Update(_In_ const std::vector<XMMATRIX>& aBoneTransforms)
+    {
+        update(aBoneTransforms, sm_bHasAvx2);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::UpdateScalar
+
+      Summary:  Skins the vertices with the given bone palette one at a
+                time with DirectXMath, even if the CPU supports AVX2
+
+      Args:     const std::vector<XMMATRIX>& aBoneTransforms
+                  Bone palette, the same matrices uploaded to the
+                  skinning constant buffer before transposing
+
+      Modifies: [m_aPositionsX, m_aPositionsY, m_aPositionsZ,
+                 m_aNormalsX, m_aNormalsY, m_aNormalsZ, m_aTangentsX,
+                 m_aTangentsY, m_aTangentsZ, m_bounds, m_bIsValid].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedVertexCache::UpdateScalar(_In_ const std::vector<XMMATRIX>& aBoneTransforms)
+    {
+        update(aBoneTransforms, FALSE);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::CopyVertices
+
+      Summary:  Writes the skinned vertices in the layout of the model
+                vertex buffer
+
+      Args:     SimpleVertex* aVertices
+                  Destination, GetNumVertices() elements
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedVertexCache::CopyVertices(_Out_writes_(GetNumVertices()) SimpleVertex* aVertices) const
+    {
+        const UINT uNumVertices = GetNumVertices();
+
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            aVertices[i] =
+            {
+                .Position = XMFLOAT3(m_aPositionsX[i], m_aPositionsY[i], m_aPositionsZ[i]),
+                .TexCoord = m_pStreams->aTexCoords[i],
+                .Normal = XMFLOAT3(m_aNormalsX[i], m_aNormalsY[i], m_aNormalsZ[i])
+            };
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::Intersects
+
+      Summary:  Tests a ray in model space against the skinned
+                triangles of a mesh. Rays that miss the bounds are
+                rejected before testing any triangle.
+
+      Args:     FXMVECTOR origin
+                  Origin of the ray
+                FXMVECTOR direction
+                  Normalized direction of the ray
+                const void* pIndices
+                  Triangle list indices of the mesh
+                DXGI_FORMAT indexFormat
+                  DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT
+                UINT uNumIndices
+                  Number of indices
+                UINT uBaseVertex
+                  Value added to each index
+                FLOAT& distance
+                  Distance to the closest hit
+
+      Returns:  BOOL
+                  TRUE if the ray hits a triangle
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL SkinnedVertexCache::Intersects(
+        _In_ FXMVECTOR origin,
+        _In_ FXMVECTOR direction,
+        _In_ const void* pIndices,
+        _In_ DXGI_FORMAT indexFormat,
+        _In_ UINT uNumIndices,
+        _In_ UINT uBaseVertex,
+        _Out_ FLOAT& distance
+    ) const
+    {
+        distance = 0.0f;
+
+        FLOAT boundsDistance = 0.0f;
+        if (!m_bIsValid || !m_bounds.Intersects(origin, direction, boundsDistance))
+        {
+            return FALSE;
+        }
+
+        BOOL bHasHit = FALSE;
+        FLOAT closestDistance = FLT_MAX;
+
+        auto getIndex = [pIndices, indexFormat](UINT uIndex) -> UINT
+        {
+            return indexFormat == DXGI_FORMAT_R32_UINT
+                ? static_cast<const UINT*>(pIndices)[uIndex]
+                : static_cast<const WORD*>(pIndices)[uIndex];
+        };
+
+        for (UINT i = 0u; i + 2u < uNumIndices; i += 3u)
+        {
+            const UINT uIndex0 = uBaseVertex + getIndex(i);
+            const UINT uIndex1 = uBaseVertex + getIndex(i + 1u);
+            const UINT uIndex2 = uBaseVertex + getIndex(i + 2u);
+            assert(uIndex0 < GetNumVertices() && uIndex1 < GetNumVertices() && uIndex2 < GetNumVertices());
+
+            FLOAT triangleDistance = 0.0f;
+            if (TriangleTests::Intersects(
+                origin,
+                direction,
+                GetPosition(uIndex0),
+                GetPosition(uIndex1),
+                GetPosition(uIndex2),
+                triangleDistance
+            ) && triangleDistance < closestDistance)
+            {
+                closestDistance = triangleDistance;
+                bHasHit = TRUE;
+            }
+        }
+
+        if (bHasHit)
+        {
+            distance = closestDistance;
+        }
+
+        return bHasHit;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::GetPosition
+
+      Summary:  Returns the skinned position of a vertex
+
+      Args:     UINT uVertexIndex
+                  Index of the vertex
+
+      Returns:  XMVECTOR
+                  Position in model space, w is 1
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR SkinnedVertexCache::GetPosition(_In_ UINT uVertexIndex) const
+    {
+        return XMVectorSet(m_aPositionsX[uVertexIndex], m_aPositionsY[uVertexIndex], m_aPositionsZ[uVertexIndex], 1.0f);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::GetNormal
+
+      Summary:  Returns the skinned normal of a vertex
+
+      Args:     UINT uVertexIndex
+                  Index of the vertex
+
+      Returns:  XMVECTOR
+                  Normalized normal in model space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR SkinnedVertexCache::GetNormal(_In_ UINT uVertexIndex) const
+    {
+        return XMVectorSet(m_aNormalsX[uVertexIndex], m_aNormalsY[uVertexIndex], m_aNormalsZ[uVertexIndex], 0.0f);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::GetTangent
+
+      Summary:  Returns the skinned tangent of a vertex
+
+      Args:     UINT uVertexIndex
+                  Index of the vertex
+
+      Returns:  XMVECTOR
+                  Normalized tangent in model space, zero if the model
+                  has no tangents
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR SkinnedVertexCache::GetTangent(_In_ UINT uVertexIndex) const
+    {
+        return XMVectorSet(m_aTangentsX[uVertexIndex], m_aTangentsY[uVertexIndex], m_aTangentsZ[uVertexIndex], 0.0f);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::GetBounds
+
+      Summary:  Returns the bounds of the skinned vertices
+
+      Returns:  const BoundingBox&
+                  Axis aligned bounds in model space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingBox& SkinnedVertexCache::GetBounds() const
+    {
+        return m_bounds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::GetNumVertices
+
+      Summary:  Returns the number of vertices
+
+      Returns:  UINT
+                  Number of vertices, without the padding
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SkinnedVertexCache::GetNumVertices() const
+    {
+        return m_pStreams ? m_pStreams->uNumVertices : 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::IsValid
+
+      Summary:  Returns whether the vertices were skinned by the last
+                Update
+
+      Returns:  BOOL
+                  TRUE if the skinned vertices can be used
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL SkinnedVertexCache::IsValid() const
+    {
+        return m_bIsValid;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::HasAvx2
+
+      Summary:  Returns whether the CPU and the OS support the AVX2 path
+
+      Returns:  BOOL
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL SkinnedVertexCache::HasAvx2()
+    {
+        return sm_bHasAvx2;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::update
+
+      Summary:  Skins the vertices with the given bone palette and
+                recomputes their bounds
+
+      Args:     const std::vector<XMMATRIX>& aBoneTransforms
+                  Bone palette
+                BOOL bUseAvx2
+                  Whether to skin with AVX2, only if the CPU supports it
+
+      Modifies: [m_aPositionsX, m_aPositionsY, m_aPositionsZ,
+                 m_aNormalsX, m_aNormalsY, m_aNormalsZ, m_aTangentsX,
+                 m_aTangentsY, m_aTangentsZ, m_bounds, m_bIsValid].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedVertexCache::update(_In_ const std::vector<XMMATRIX>& aBoneTransforms, _In_ BOOL bUseAvx2)
+    {
+        m_bIsValid = FALSE;
+
+        if (!m_pStreams || aBoneTransforms.size() <= m_pStreams->uMaxBoneIndex)
+        {
+            return;
+        }
+
+        if (bUseAvx2)
+        {
+            skinAvx2(aBoneTransforms);
+        }
+        else
+        {
+            skinScalar(aBoneTransforms);
+        }
+
+        m_bIsValid = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::skinScalar
+
+      Summary:  Skins one vertex at a time with DirectXMath
+
+      Args:     const std::vector<XMMATRIX>& aBoneTransforms
+                  Bone palette
+
+      Modifies: [m_aPositionsX, m_aPositionsY, m_aPositionsZ,
+                 m_aNormalsX, m_aNormalsY, m_aNormalsZ, m_aTangentsX,
+                 m_aTangentsY, m_aTangentsZ, m_bounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedVertexCache::skinScalar(_In_ const std::vector<XMMATRIX>& aBoneTransforms)
+    {
+        const SkinningStreams& streams = *m_pStreams;
+
+        XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+        XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+
+        for (UINT i = 0u; i < streams.uNumVertices; ++i)
+        {
+            XMMATRIX skinTransform(XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero());
+
+            for (UINT k = 0u; k < SkinningStreams::NUM_INFLUENCES; ++k)
+            {
+                const FLOAT weight = streams.aBoneWeights[k][i];
+                if (weight == 0.0f)
+                {
+                    continue;
+                }
+
+                const XMMATRIX& boneTransform = aBoneTransforms[streams.aBoneIndices[k][i]];
+                const XMVECTOR weights = XMVectorReplicate(weight);
+
+                for (UINT uRow = 0u; uRow < 4u; ++uRow)
+                {
+                    skinTransform.r[uRow] = XMVectorMultiplyAdd(weights, boneTransform.r[uRow], skinTransform.r[uRow]);
+                }
+            }
+
+            const XMVECTOR position = XMVector3Transform(XMVectorSet(streams.aPositionsX[i], streams.aPositionsY[i], streams.aPositionsZ[i], 1.0f), skinTransform);
+            const XMVECTOR normal = XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(streams.aNormalsX[i], streams.aNormalsY[i], streams.aNormalsZ[i], 0.0f), skinTransform));
+
+            m_aPositionsX[i] = XMVectorGetX(position);
+            m_aPositionsY[i] = XMVectorGetY(position);
+            m_aPositionsZ[i] = XMVectorGetZ(position);
+            m_aNormalsX[i] = XMVectorGetX(normal);
+            m_aNormalsY[i] = XMVectorGetY(normal);
+            m_aNormalsZ[i] = XMVectorGetZ(normal);
+
+            if (streams.bHasTangents)
+            {
+                const XMVECTOR tangent = XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(streams.aTangentsX[i], streams.aTangentsY[i], streams.aTangentsZ[i], 0.0f), skinTransform));
+
+                m_aTangentsX[i] = XMVectorGetX(tangent);
+                m_aTangentsY[i] = XMVectorGetY(tangent);
+                m_aTangentsZ[i] = XMVectorGetZ(tangent);
+            }
+
+            minimum = XMVectorMin(minimum, position);
+            maximum = XMVectorMax(maximum, position);
+        }
+
+        BoundingBox::CreateFromPoints(m_bounds, minimum, maximum);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedVertexCache::skinAvx2
+
+      Summary:  Skins BATCH_SIZE vertices at a time. For every influence
+                the twelve affine elements of the bone matrices are
+                gathered from the palette and blended by weight, then
+                applied to the positions, normals and tangents of the
+                batch. Influences unused by the whole batch are skipped.
+
+      Args:     const std::vector<XMMATRIX>& aBoneTransforms
+                  Bone palette
+
+      Modifies: [m_aPositionsX, m_aPositionsY, m_aPositionsZ,
+                 m_aNormalsX, m_aNormalsY, m_aNormalsZ, m_aTangentsX,
+                 m_aTangentsY, m_aTangentsZ, m_bounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedVertexCache::skinAvx2(_In_ const std::vector<XMMATRIX>& aBoneTransforms)
+    {
+#if defined(SKINNING_AVX2_AVAILABLE)
+        constexpr const UINT NUM_ELEMENTS = 12u;
+
+        const SkinningStreams& streams = *m_pStreams;
+        const FLOAT* pPalette = reinterpret_cast<const FLOAT*>(aBoneTransforms.data());
+        const __m256 zero = _mm256_setzero_ps();
+
+        __m256 minimumX = _mm256_set1_ps(FLT_MAX);
+        __m256 minimumY = minimumX;
+        __m256 minimumZ = minimumX;
+        __m256 maximumX = _mm256_set1_ps(-FLT_MAX);
+        __m256 maximumY = maximumX;
+        __m256 maximumZ = maximumX;
+
+        for (UINT i = 0u; i < streams.uNumPaddedVertices; i += BATCH_SIZE)
+        {
+            // Rows 0-3, columns 0-2 of the blended matrix; column 3 is always (0, 0, 0, 1)
+            __m256 aBlend[NUM_ELEMENTS];
+            for (UINT e = 0u; e < NUM_ELEMENTS; ++e)
+            {
+                aBlend[e] = zero;
+            }
+
+            for (UINT k = 0u; k < SkinningStreams::NUM_INFLUENCES; ++k)
+            {
+                const __m256 weights = _mm256_loadu_ps(&streams.aBoneWeights[k][i]);
+                if (_mm256_movemask_ps(_mm256_cmp_ps(weights, zero, _CMP_NEQ_OQ)) == 0)
+                {
+                    continue;
+                }
+
+                const __m256i offsets = _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&streams.aBoneIndices[k][i])), 4);
+
+                for (UINT uRow = 0u; uRow < 4u; ++uRow)
+                {
+                    for (UINT uColumn = 0u; uColumn < 3u; ++uColumn)
+                    {
+                        const __m256 elements = _mm256_i32gather_ps(pPalette + uRow * 4u + uColumn, offsets, 4);
+                        aBlend[uRow * 3u + uColumn] = _mm256_fmadd_ps(weights, elements, aBlend[uRow * 3u + uColumn]);
+                    }
+                }
+            }
+
+            const __m256 x = _mm256_loadu_ps(&streams.aPositionsX[i]);
+            const __m256 y = _mm256_loadu_ps(&streams.aPositionsY[i]);
+            const __m256 z = _mm256_loadu_ps(&streams.aPositionsZ[i]);
+
+            const __m256 positionX = _mm256_fmadd_ps(x, aBlend[0], _mm256_fmadd_ps(y, aBlend[3], _mm256_fmadd_ps(z, aBlend[6], aBlend[9])));
+            const __m256 positionY = _mm256_fmadd_ps(x, aBlend[1], _mm256_fmadd_ps(y, aBlend[4], _mm256_fmadd_ps(z, aBlend[7], aBlend[10])));
+            const __m256 positionZ = _mm256_fmadd_ps(x, aBlend[2], _mm256_fmadd_ps(y, aBlend[5], _mm256_fmadd_ps(z, aBlend[8], aBlend[11])));
+
+            _mm256_storeu_ps(&m_aPositionsX[i], positionX);
+            _mm256_storeu_ps(&m_aPositionsY[i], positionY);
+            _mm256_storeu_ps(&m_aPositionsZ[i], positionZ);
+
+            minimumX = _mm256_min_ps(minimumX, positionX);
+            minimumY = _mm256_min_ps(minimumY, positionY);
+            minimumZ = _mm256_min_ps(minimumZ, positionZ);
+            maximumX = _mm256_max_ps(maximumX, positionX);
+            maximumY = _mm256_max_ps(maximumY, positionY);
+            maximumZ = _mm256_max_ps(maximumZ, positionZ);
+
+            const __m256 nx = _mm256_loadu_ps(&streams.aNormalsX[i]);
+            const __m256 ny = _mm256_loadu_ps(&streams.aNormalsY[i]);
+            const __m256 nz = _mm256_loadu_ps(&streams.aNormalsZ[i]);
+
+            __m256 normalX = _mm256_fmadd_ps(nx, aBlend[0], _mm256_fmadd_ps(ny, aBlend[3], _mm256_mul_ps(nz, aBlend[6])));
+            __m256 normalY = _mm256_fmadd_ps(nx, aBlend[1], _mm256_fmadd_ps(ny, aBlend[4], _mm256_mul_ps(nz, aBlend[7])));
+            __m256 normalZ = _mm256_fmadd_ps(nx, aBlend[2], _mm256_fmadd_ps(ny, aBlend[5], _mm256_mul_ps(nz, aBlend[8])));
+            NormalizeAvx2(normalX, normalY, normalZ);
+
+            _mm256_storeu_ps(&m_aNormalsX[i], normalX);
+            _mm256_storeu_ps(&m_aNormalsY[i], normalY);
+            _mm256_storeu_ps(&m_aNormalsZ[i], normalZ);
+
+            if (streams.bHasTangents)
+            {
+                const __m256 tx = _mm256_loadu_ps(&streams.aTangentsX[i]);
+                const __m256 ty = _mm256_loadu_ps(&streams.aTangentsY[i]);
+                const __m256 tz = _mm256_loadu_ps(&streams.aTangentsZ[i]);
+
+                __m256 tangentX = _mm256_fmadd_ps(tx, aBlend[0], _mm256_fmadd_ps(ty, aBlend[3], _mm256_mul_ps(tz, aBlend[6])));
+                __m256 tangentY = _mm256_fmadd_ps(tx, aBlend[1], _mm256_fmadd_ps(ty, aBlend[4], _mm256_mul_ps(tz, aBlend[7])));
+                __m256 tangentZ = _mm256_fmadd_ps(tx, aBlend[2], _mm256_fmadd_ps(ty, aBlend[5], _mm256_mul_ps(tz, aBlend[8])));
+                NormalizeAvx2(tangentX, tangentY, tangentZ);
+
+                _mm256_storeu_ps(&m_aTangentsX[i], tangentX);
+                _mm256_storeu_ps(&m_aTangentsY[i], tangentY);
+                _mm256_storeu_ps(&m_aTangentsZ[i], tangentZ);
+            }
+        }
+
+        FLOAT aLanes[6][BATCH_SIZE];
+        _mm256_storeu_ps(aLanes[0], minimumX);
+        _mm256_storeu_ps(aLanes[1], minimumY);
+        _mm256_storeu_ps(aLanes[2], minimumZ);
+        _mm256_storeu_ps(aLanes[3], maximumX);
+        _mm256_storeu_ps(aLanes[4], maximumY);
+        _mm256_storeu_ps(aLanes[5], maximumZ);
+
+        XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+        XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+        for (UINT uLane = 0u; uLane < BATCH_SIZE; ++uLane)
+        {
+            minimum = XMVectorMin(minimum, XMVectorSet(aLanes[0][uLane], aLanes[1][uLane], aLanes[2][uLane], 0.0f));
+            maximum = XMVectorMax(maximum, XMVectorSet(aLanes[3][uLane], aLanes[4][uLane], aLanes[5][uLane], 0.0f));
+        }
+
+        BoundingBox::CreateFromPoints(m_bounds, minimum, maximum);
+#else
+        skinScalar(aBoneTransforms);
+#endif
+    }
+}
@@ -0,0 +1,158 @@
+/*+===================================================================
+  File:      SKINNEDVERTEXCACHE.H
+
+  Summary:   SkinnedVertexCache header file contains declaration of
+             class SkinnedVertexCache used to skin the vertices of a
+             model on the CPU once per frame, so every pass that needs
+             the animated mesh can read the same result.
+
+  Classes:  SkinnedVertexCache
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SkinningStreams
+
+      Summary:  Bind pose vertices and their bone influences stored as
+                one array per component, padded to a multiple of
+                SkinnedVertexCache::BATCH_SIZE. The streams do not change
+                after loading and are shared by every instance of a
+                model.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SkinningStreams
+    {
+        static constexpr const UINT NUM_INFLUENCES = 4u;
+
+        HRESULT Initialize(
+            _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+            _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+            _In_reads_(uNumVertices) const AnimationData* aAnimationData,
+            _In_ UINT uNumVertices
+        );
+
+        std::vector<FLOAT> aPositionsX;
+        std::vector<FLOAT> aPositionsY;
+        std::vector<FLOAT> aPositionsZ;
+        std::vector<FLOAT> aNormalsX;
+        std::vector<FLOAT> aNormalsY;
+        std::vector<FLOAT> aNormalsZ;
+        std::vector<FLOAT> aTangentsX;
+        std::vector<FLOAT> aTangentsY;
+        std::vector<FLOAT> aTangentsZ;
+        std::vector<XMFLOAT2> aTexCoords;
+        std::vector<INT> aBoneIndices[NUM_INFLUENCES];
+        std::vector<FLOAT> aBoneWeights[NUM_INFLUENCES];
+        UINT uNumVertices;
+        UINT uNumPaddedVertices;
+        UINT uMaxBoneIndex;
+        BOOL bHasTangents;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SkinnedVertexCache
+
+      Summary:  Applies a bone palette to the positions, normals and
+                tangents of a model with up to four weights per vertex,
+                the same blend as SkinningShaders.fxh. Vertices are
+                processed BATCH_SIZE at a time with AVX2 when the CPU
+                supports it, otherwise one at a time with DirectXMath.
+                The skinned vertices and their bounds stay valid until
+                the next Update, so the shadow pass, culling and picking
+                all share one skinning per frame.
+
+      Methods:  Initialize
+                  Sets the bind pose streams to skin
+                Update
+                  Skins the vertices with the given bone palette
+                UpdateScalar
+                  Skins the vertices without AVX2
+                CopyVertices
+                  Writes the skinned vertices in the vertex buffer
+                  layout
+                Intersects
+                  Tests a ray against the skinned triangles
+                GetPosition
+                  Returns the skinned position of a vertex
+                GetNormal
+                  Returns the skinned normal of a vertex
+                GetTangent
+                  Returns the skinned tangent of a vertex
+                GetBounds
+                  Returns the bounds of the skinned vertices
+                GetNumVertices
+                  Returns the number of vertices
+                IsValid
+                  Returns whether the vertices were skinned
+                HasAvx2
+                  Returns whether the CPU supports the AVX2 path
+                SkinnedVertexCache
+                  Constructor.
+                ~SkinnedVertexCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SkinnedVertexCache
+    {
+    public:
+        static constexpr const UINT BATCH_SIZE = 8u;
+
+    public:
+        SkinnedVertexCache();
+        SkinnedVertexCache(const SkinnedVertexCache& other) = delete;
+        SkinnedVertexCache(SkinnedVertexCache&& other) = delete;
+        SkinnedVertexCache& operator=(const SkinnedVertexCache& other) = delete;
+        SkinnedVertexCache& operator=(SkinnedVertexCache&& other) = delete;
+        virtual ~SkinnedVertexCache() = default;
+
+        void Initialize(_In_ const std::shared_ptr<const SkinningStreams>& pStreams);
+        void Update(_In_ const std::vector<XMMATRIX>& aBoneTransforms);
+        void UpdateScalar(_In_ const std::vector<XMMATRIX>& aBoneTransforms);
+
+        void CopyVertices(_Out_writes_(GetNumVertices()) SimpleVertex* aVertices) const;
+        BOOL Intersects(
+            _In_ FXMVECTOR origin,
+            _In_ FXMVECTOR direction,
+            _In_ const void* pIndices,
+            _In_ DXGI_FORMAT indexFormat,
+            _In_ UINT uNumIndices,
+            _In_ UINT uBaseVertex,
+            _Out_ FLOAT& distance
+        ) const;
+
+        XMVECTOR GetPosition(_In_ UINT uVertexIndex) const;
+        XMVECTOR GetNormal(_In_ UINT uVertexIndex) const;
+        XMVECTOR GetTangent(_In_ UINT uVertexIndex) const;
+        const BoundingBox& GetBounds() const;
+        UINT GetNumVertices() const;
+        BOOL IsValid() const;
+
+        static BOOL HasAvx2();
+
+    private:
+        void update(_In_ const std::vector<XMMATRIX>& aBoneTransforms, _In_ BOOL bUseAvx2);
+        void skinScalar(_In_ const std::vector<XMMATRIX>& aBoneTransforms);
+        void skinAvx2(_In_ const std::vector<XMMATRIX>& aBoneTransforms);
+
+    private:
+        static const BOOL sm_bHasAvx2;
+
+        std::shared_ptr<const SkinningStreams> m_pStreams;
+        std::vector<FLOAT> m_aPositionsX;
+        std::vector<FLOAT> m_aPositionsY;
+        std::vector<FLOAT> m_aPositionsZ;
+        std::vector<FLOAT> m_aNormalsX;
+        std::vector<FLOAT> m_aNormalsY;
+        std::vector<FLOAT> m_aNormalsZ;
+        std::vector<FLOAT> m_aTangentsX;
+        std::vector<FLOAT> m_aTangentsY;
+        std::vector<FLOAT> m_aTangentsZ;
+        BoundingBox m_bounds;
+        BOOL m_bIsValid;
+    };
+}
@@ -0,0 +1,45 @@
+/*+===================================================================
+  File:      BUFFERUPLOADER.H
+
+  Summary:   BufferUploader header file contains declaration of the
+             abstract class BufferUploader used to replace the content
+             of dynamic buffers.
+
+  Classes: BufferUploader
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BufferUploader
+
+      Summary:  Writes whole dynamic buffers. Code that packs data on
+                the CPU uploads it through this interface, so it can be
+                run and checked without a device.
+
+      Methods:  Write
+                  Pure virtual function that replaces the content of a
+                  buffer
+                BufferUploader
+                  Constructor.
+                ~BufferUploader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BufferUploader
+    {
+    public:
+        BufferUploader() = default;
+        BufferUploader(const BufferUploader& other) = delete;
+        BufferUploader(BufferUploader&& other) = delete;
+        BufferUploader& operator=(const BufferUploader& other) = delete;
+        BufferUploader& operator=(BufferUploader&& other) = delete;
+        virtual ~BufferUploader() = default;
+
+        virtual HRESULT Write(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize) = 0;
+    };
+}
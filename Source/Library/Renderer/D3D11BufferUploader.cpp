@@ -0,0 +1,49 @@
+#include "Renderer/D3D11BufferUploader.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11BufferUploader::D3D11BufferUploader
+
+      Summary:  Constructor
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to map the buffers
+
+      Modifies: [m_pImmediateContext].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    D3D11BufferUploader::D3D11BufferUploader(_In_ ID3D11DeviceContext* pImmediateContext)
+        : m_pImmediateContext(pImmediateContext)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11BufferUploader::Write
+
+      Summary:  Replaces the content of a dynamic buffer
+
+      Args:     ID3D11Buffer* pBuffer
+                  Dynamic buffer to write
+                const void* pData
+                  Data to copy
+                UINT uSize
+                  Number of bytes to copy
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT D3D11BufferUploader::Write(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize)
+    {
+        D3D11_MAPPED_SUBRESOURCE mappedResource = {};
+        HRESULT hr = m_pImmediateContext->Map(pBuffer, 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mappedResource);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        memcpy(mappedResource.pData, pData, uSize);
+        m_pImmediateContext->Unmap(pBuffer, 0u);
+
+        return hr;
+    }
+}
@@ -0,0 +1,49 @@
+/*+===================================================================
+  File:      D3D11BUFFERUPLOADER.H
+
+  Summary:   D3D11BufferUploader header file contains declaration of
+             class D3D11BufferUploader used to write dynamic buffers
+             through a Direct3D context.
+
+  Classes: D3D11BufferUploader
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/BufferUploader.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    D3D11BufferUploader
+
+      Summary:  Replaces the content of dynamic buffers by mapping them
+                with D3D11_MAP_WRITE_DISCARD
+
+      Methods:  Write
+                  Maps a buffer and copies the data into it
+                D3D11BufferUploader
+                  Constructor.
+                ~D3D11BufferUploader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class D3D11BufferUploader : public BufferUploader
+    {
+    public:
+        D3D11BufferUploader() = delete;
+        D3D11BufferUploader(_In_ ID3D11DeviceContext* pImmediateContext);
+        D3D11BufferUploader(const D3D11BufferUploader& other) = delete;
+        D3D11BufferUploader(D3D11BufferUploader&& other) = delete;
+        D3D11BufferUploader& operator=(const D3D11BufferUploader& other) = delete;
+        D3D11BufferUploader& operator=(D3D11BufferUploader&& other) = delete;
+        virtual ~D3D11BufferUploader() = default;
+
+        virtual HRESULT Write(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize) override;
+
+    private:
+        ID3D11DeviceContext* m_pImmediateContext;
+    };
+}
@@ -6,7 +6,23 @@ namespace library
 {
 #define NUM_LIGHTS (1)
 #define MAX_NUM_BONES (256)
-#define MAX_NUM_BONES_PER_VERTEX (16)
+#define MAX_NUM_BONES_PER_VERTEX (4)
+#define NUM_PALETTE_ROWS_AFFINE (3)
+#define NUM_PALETTE_ROWS_DUAL_QUATERNION (2)
+
+	enum class eSkinningPaletteFormat : UINT
+	{
+		AFFINE_3X4 = 0,
+		DUAL_QUATERNION,
+		COUNT,
+	};
+
+	enum class eVertexFormat : UINT
+	{
+		FULL = 0,
+		PACKED,
+		COUNT,
+	};
 
 	struct SimpleVertex
 	{
@@ -20,6 +36,12 @@ namespace library
 		XMMATRIX Transformation;
 	};
 
+	struct CrowdInstanceData
+	{
+		XMMATRIX Transformation;
+		UINT PaletteOffset;
+	};
+
 	struct AnimationData
 	{
 		XMUINT4 aBoneIndices;
@@ -32,6 +54,26 @@ namespace library
 		XMFLOAT3 Bitangent;
 	};
 
+	// Compressed counterparts of SimpleVertex, NormalData and AnimationData
+	// used by eVertexFormat::PACKED, see VertexCompression
+	struct PackedVertex
+	{
+		XMFLOAT3 Position;
+		XMHALF2 TexCoord;
+		XMSHORTN2 Normal;
+	};
+
+	struct PackedNormalData
+	{
+		XMSHORTN4 TangentFrame;
+	};
+
+	struct PackedAnimationData
+	{
+		XMUBYTE4 aBoneIndices;
+		XMUBYTEN4 aBoneWeights;
+	};
+
 	struct CBChangeOnCameraMovement
 	{
 		XMMATRIX View;
@@ -52,7 +94,7 @@ namespace library
 
 	struct CBSkinning
 	{
-		XMMATRIX BoneTransforms[MAX_NUM_BONES];
+		XMFLOAT4 BonePalette[MAX_NUM_BONES * NUM_PALETTE_ROWS_AFFINE];
 	};
 
 	struct CBLights
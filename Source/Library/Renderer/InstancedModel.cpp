@@ -0,0 +1,208 @@
+#include "Renderer/InstancedModel.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::InstancedModel
+
+      Summary:  Constructor
+
+      Args:     const std::shared_ptr<Model>& pModel
+                  Static model to draw, not initialized yet
+
+      Modifies: [m_pModel, m_aInstanceData, m_instanceBuffer,
+                 m_vertexShader, m_pixelShader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    InstancedModel::InstancedModel(_In_ const std::shared_ptr<Model>& pModel)
+        : m_pModel(pModel)
+        , m_aInstanceData()
+        , m_instanceBuffer()
+        , m_vertexShader()
+        , m_pixelShader()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::AddInstance
+
+      Summary:  Adds a copy of the model. Instances cannot be added or
+                moved once the model is initialized.
+
+      Args:     const XMMATRIX& transform
+                  Transform of the instance, applied before the world
+                  matrix of the model
+
+      Modifies: [m_aInstanceData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void InstancedModel::AddInstance(_In_ const XMMATRIX& transform)
+    {
+        assert(!m_instanceBuffer);
+
+        m_aInstanceData.push_back({ .Transformation = transform });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::Initialize
+
+      Summary:  Initializes the model and creates the instance buffer
+                holding the transform of every instance
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_pModel, m_instanceBuffer].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT InstancedModel::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (!m_pModel || m_aInstanceData.empty())
+        {
+            return E_FAIL;
+        }
+
+        HRESULT hr = m_pModel->Initialize(pDevice, pImmediateContext);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // Every instance shares the pose, so animated models go to a SkinnedCrowd
+        if (!m_pModel->GetSkinningPalette().empty())
+        {
+            OutputDebugString(L"InstancedModel: animated models are not supported\n");
+            return E_INVALIDARG;
+        }
+
+        D3D11_BUFFER_DESC bd =
+        {
+            .ByteWidth = static_cast<UINT>(sizeof(InstanceData) * m_aInstanceData.size()),
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u
+        };
+
+        D3D11_SUBRESOURCE_DATA initData =
+        {
+            .pSysMem = m_aInstanceData.data(),
+            .SysMemPitch = 0u,
+            .SysMemSlicePitch = 0u
+        };
+
+        return pDevice->CreateBuffer(&bd, &initData, m_instanceBuffer.GetAddressOf());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::SetVertexShader
+
+      Summary:  Sets the vertex shader used to draw the instances
+
+      Args:     const std::shared_ptr<VertexShader>& vertexShader
+                  Vertex shader reading the instance transform
+
+      Modifies: [m_vertexShader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void InstancedModel::SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader)
+    {
+        m_vertexShader = vertexShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::SetPixelShader
+
+      Summary:  Sets the pixel shader used to draw the instances
+
+      Args:     const std::shared_ptr<PixelShader>& pixelShader
+                  Pixel shader to set to
+
+      Modifies: [m_pixelShader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void InstancedModel::SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader)
+    {
+        m_pixelShader = pixelShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::GetVertexShader
+
+      Summary:  Returns the vertex shader
+
+      Returns:  ComPtr<ID3D11VertexShader>&
+                  Vertex shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11VertexShader>& InstancedModel::GetVertexShader()
+    {
+        return m_vertexShader->GetVertexShader();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::GetPixelShader
+
+      Summary:  Returns the pixel shader
+
+      Returns:  ComPtr<ID3D11PixelShader>&
+                  Pixel shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11PixelShader>& InstancedModel::GetPixelShader()
+    {
+        return m_pixelShader->GetPixelShader();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::GetVertexLayout
+
+      Summary:  Returns the vertex input layout
+
+      Returns:  ComPtr<ID3D11InputLayout>&
+                  Vertex input layout
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11InputLayout>& InstancedModel::GetVertexLayout()
+    {
+        return m_vertexShader->GetVertexLayout();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::GetModel
+
+      Summary:  Returns the model whose buffers and materials are used
+                to draw every instance
+
+      Returns:  const std::shared_ptr<Model>&
+                  Model
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<Model>& InstancedModel::GetModel() const
+    {
+        return m_pModel;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::GetNumInstances
+
+      Summary:  Returns the number of instances
+
+      Returns:  UINT
+                  Number of instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT InstancedModel::GetNumInstances() const
+    {
+        return static_cast<UINT>(m_aInstanceData.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedModel::GetInstanceBuffer
+
+      Summary:  Returns the instance buffer
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Instance buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& InstancedModel::GetInstanceBuffer()
+    {
+        return m_instanceBuffer;
+    }
+}
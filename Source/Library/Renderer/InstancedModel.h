@@ -0,0 +1,93 @@
+/*+===================================================================
+  File:      INSTANCEDMODEL.H
+
+  Summary:   InstancedModel header file contains declarations of
+             InstancedModel class used to draw many copies of the same
+             static model with one instanced draw per mesh.
+
+  Classes: InstancedModel
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Model/Model.h"
+#include "Renderer/DataTypes.h"
+#include "Shader/PixelShader.h"
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    InstancedModel
+
+      Summary:  One static model drawn at many places. The transforms of
+                the instances are stored in an immutable instance
+                buffer, like the instance data of voxels, so scenery is
+                drawn with one instanced draw per mesh instead of a
+                constant buffer upload and a draw per copy of the
+                model. The world matrix of the model is applied after
+                the transform of each instance, so the whole group can
+                still be moved. Meshes are always drawn at full detail
+                since every instance shares the draw.
+
+      Methods:  AddInstance
+                  Adds a copy of the model
+                Initialize
+                  Initializes the model and creates the instance buffer
+                SetVertexShader
+                  Sets the instanced vertex shader
+                SetPixelShader
+                  Sets the pixel shader
+                GetVertexShader
+                  Returns the vertex shader
+                GetPixelShader
+                  Returns the pixel shader
+                GetVertexLayout
+                  Returns the vertex input layout
+                GetModel
+                  Returns the model
+                GetNumInstances
+                  Returns the number of instances
+                GetInstanceBuffer
+                  Returns the instance buffer
+                InstancedModel
+                  Constructor.
+                ~InstancedModel
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class InstancedModel
+    {
+    public:
+        InstancedModel(_In_ const std::shared_ptr<Model>& pModel);
+        InstancedModel(const InstancedModel& other) = delete;
+        InstancedModel(InstancedModel&& other) = delete;
+        InstancedModel& operator=(const InstancedModel& other) = delete;
+        InstancedModel& operator=(InstancedModel&& other) = delete;
+        virtual ~InstancedModel() = default;
+
+        void AddInstance(_In_ const XMMATRIX& transform);
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+
+        void SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader);
+        void SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader);
+        ComPtr<ID3D11VertexShader>& GetVertexShader();
+        ComPtr<ID3D11PixelShader>& GetPixelShader();
+        ComPtr<ID3D11InputLayout>& GetVertexLayout();
+
+        const std::shared_ptr<Model>& GetModel() const;
+        UINT GetNumInstances() const;
+        ComPtr<ID3D11Buffer>& GetInstanceBuffer();
+
+    protected:
+        std::shared_ptr<Model> m_pModel;
+        std::vector<InstanceData> m_aInstanceData;
+        ComPtr<ID3D11Buffer> m_instanceBuffer;
+
+        std::shared_ptr<VertexShader> m_vertexShader;
+        std::shared_ptr<PixelShader> m_pixelShader;
+    };
+}
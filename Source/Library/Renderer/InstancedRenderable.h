@@ -60,7 +60,7 @@ namespace library
 
     protected:
         const SimpleVertex* getVertices() const override = 0;
-        const WORD* getIndices() const override = 0;
+        const void* getIndices() const override = 0;
 
         virtual HRESULT initializeInstance(_In_ ID3D11Device* pDevice);
 
@@ -0,0 +1,71 @@
+#include "Renderer/RecordingBufferUploader.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingBufferUploader::RecordingBufferUploader
+
+      Summary:  Constructor
+
+      Modifies: [m_aWrites].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    RecordingBufferUploader::RecordingBufferUploader()
+        : m_aWrites()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingBufferUploader::Write
+
+      Summary:  Records the buffer and a copy of the data
+
+      Args:     ID3D11Buffer* pBuffer
+                  Buffer that would be written, may be null
+                const void* pData
+                  Data to copy
+                UINT uSize
+                  Number of bytes to copy
+
+      Modifies: [m_aWrites].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT RecordingBufferUploader::Write(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize)
+    {
+        const BYTE* pBytes = static_cast<const BYTE*>(pData);
+        m_aWrites.push_back(
+            {
+                .pBuffer = pBuffer,
+                .aData = std::vector<BYTE>(pBytes, pBytes + uSize)
+            }
+        );
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingBufferUploader::GetWrites
+
+      Summary:  Returns the writes recorded since the last Clear
+
+      Returns:  const std::vector<RecordedBufferWrite>&
+                  Writes in the order they were made
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<RecordedBufferWrite>& RecordingBufferUploader::GetWrites() const
+    {
+        return m_aWrites;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingBufferUploader::Clear
+
+      Summary:  Forgets the recorded writes
+
+      Modifies: [m_aWrites].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingBufferUploader::Clear()
+    {
+        m_aWrites.clear();
+    }
+}
@@ -0,0 +1,66 @@
+/*+===================================================================
+  File:      RECORDINGBUFFERUPLOADER.H
+
+  Summary:   RecordingBufferUploader header file contains declaration
+             of class RecordingBufferUploader used to check buffer
+             uploads without a device.
+
+  Classes: RecordingBufferUploader
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/BufferUploader.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   RecordedBufferWrite
+
+      Summary:  Buffer written by an upload and a copy of the data
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct RecordedBufferWrite
+    {
+        ID3D11Buffer* pBuffer;
+        std::vector<BYTE> aData;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RecordingBufferUploader
+
+      Summary:  Null backend that never touches the buffers and keeps a
+                copy of every write instead
+
+      Methods:  Write
+                  Records a write
+                GetWrites
+                  Returns the writes recorded since the last Clear
+                Clear
+                  Forgets the recorded writes
+                RecordingBufferUploader
+                  Constructor.
+                ~RecordingBufferUploader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RecordingBufferUploader : public BufferUploader
+    {
+    public:
+        RecordingBufferUploader();
+        RecordingBufferUploader(const RecordingBufferUploader& other) = delete;
+        RecordingBufferUploader(RecordingBufferUploader&& other) = delete;
+        RecordingBufferUploader& operator=(const RecordingBufferUploader& other) = delete;
+        RecordingBufferUploader& operator=(RecordingBufferUploader&& other) = delete;
+        virtual ~RecordingBufferUploader() = default;
+
+        virtual HRESULT Write(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize) override;
+
+        const std::vector<RecordedBufferWrite>& GetWrites() const;
+        void Clear();
+
+    private:
+        std::vector<RecordedBufferWrite> m_aWrites;
+    };
+}
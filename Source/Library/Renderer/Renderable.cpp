@@ -4,6 +4,9 @@
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
 
+#include "Model/ImportProfiler.h"
+#include "Renderer/TangentFrameGenerator.h"
+#include "Renderer/VertexCompression.h"
 #include "Texture/DDSTextureLoader.h"
 
 namespace library
@@ -19,7 +22,7 @@ namespace library
   Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
                  m_normalBuffer, m_aMeshes, m_aMaterials, m_vertexShader,
                  m_pixelShader, m_outputColor, m_world, m_bHasNormalMap
-                 m_aNormalData].
+                 m_aNormalData, m_vertexFormat].
 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 /*--------------------------------------------------------------------
   TODO: Renderable::Renderable definition (remove the comment)
@@ -35,7 +38,8 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
         m_aMeshes(),
         m_aMaterials(),
         m_bHasNormalMap(FALSE),
-        m_aNormalData()
+        m_aNormalData(),
+        m_vertexFormat(eVertexFormat::FULL)
     {
 
     }
@@ -63,11 +67,32 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     --------------------------------------------------------------------*/
     HRESULT Renderable::initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) {
         HRESULT hr = S_OK;
-         
+
+        if (m_aNormalData.empty())
+        {
+            calculateNormalMapVectors();
+        }
+
+        // Packed vertices and tangent frames only live in the GPU buffers
+        std::vector<PackedVertex> aPackedVertices;
+        std::vector<PackedNormalData> aPackedNormalData;
+        if (m_vertexFormat == eVertexFormat::PACKED)
+        {
+            aPackedVertices.reserve(GetNumVertices());
+            aPackedNormalData.reserve(m_aNormalData.size());
+            for (UINT i = 0u; i < GetNumVertices(); ++i)
+            {
+                aPackedVertices.push_back(VertexCompression::PackVertex(getVertices()[i]));
+            }
+            for (size_t i = 0; i < m_aNormalData.size(); ++i)
+            {
+                aPackedNormalData.push_back(VertexCompression::PackNormalData(getVertices()[i], m_aNormalData[i]));
+            }
+        }
 
         // vetex buffer desc
         D3D11_BUFFER_DESC bd = {
-            .ByteWidth = sizeof(SimpleVertex) * GetNumVertices(),
+            .ByteWidth = GetVertexStride() * GetNumVertices(),
             .Usage = D3D11_USAGE_DEFAULT,         
             .BindFlags = D3D11_BIND_VERTEX_BUFFER,
             .CPUAccessFlags = 0,
@@ -75,7 +100,7 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
         };
 
         D3D11_SUBRESOURCE_DATA InitData = {
-            .pSysMem = getVertices(),
+            .pSysMem = m_vertexFormat == eVertexFormat::PACKED ? static_cast<const void*>(aPackedVertices.data()) : getVertices(),
             .SysMemPitch = 0,
             .SysMemSlicePitch = 0
         };
@@ -83,12 +108,8 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
         if (FAILED(hr))
             return hr;
 
-        // Set vertex buffer
-        UINT stride = sizeof(SimpleVertex);
-        UINT offset = 0;
-
         bd.Usage = D3D11_USAGE_DEFAULT;
-        bd.ByteWidth = sizeof(WORD) * GetNumIndices();
+        bd.ByteWidth = (GetIndexFormat() == DXGI_FORMAT_R32_UINT ? sizeof(UINT) : sizeof(WORD)) * GetNumIndices();
         bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
         bd.CPUAccessFlags = 0,
         InitData.pSysMem = getIndices();
@@ -96,16 +117,9 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
         if (FAILED(hr))
             return hr;
 
-
-        
-        if (m_aNormalData.empty())
-        {
-            calculateNormalMapVectors();
-        }
-
         D3D11_BUFFER_DESC bd_normal =
         {
-            .ByteWidth = sizeof(NormalData) * static_cast<UINT>(m_aNormalData.size()),
+            .ByteWidth = GetNormalDataStride() * static_cast<UINT>(m_aNormalData.size()),
             .Usage = D3D11_USAGE_DEFAULT,
             .BindFlags = D3D11_BIND_VERTEX_BUFFER,
             .CPUAccessFlags = 0,
@@ -115,7 +129,7 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 
         D3D11_SUBRESOURCE_DATA init_normal =
         {
-            .pSysMem = m_aNormalData.data(),
+            .pSysMem = m_vertexFormat == eVertexFormat::PACKED ? static_cast<const void*>(aPackedNormalData.data()) : m_aNormalData.data(),
             .SysMemPitch = 0,
             .SysMemSlicePitch = 0
         };
@@ -124,8 +138,19 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 
         if (FAILED(hr))      
             return hr;
-        
 
+        if (m_vertexFormat == eVertexFormat::PACKED && ImportProfiler::GetVerbosity() != eImportVerbosity::SILENT)
+        {
+            VertexCompression::ReportError(
+                typeid(*this).name(),
+                VertexCompression::MeasureError(
+                    getVertices(),
+                    m_aNormalData.size() == GetNumVertices() ? m_aNormalData.data() : nullptr,
+                    nullptr,
+                    GetNumVertices()
+                )
+            );
+        }
 
         // Create constant buffer
         bd.Usage = D3D11_USAGE_DEFAULT;
@@ -294,100 +319,41 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-     Method:   Renderable::calculateNormalMapVectors
-
-     Summary:  Calculate tangent and bitangent vectors of every vertex
-
-     Modifies: [m_aNormalData].
-   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-   /*--------------------------------------------------------------------
-     TODO: Renderable::calculateNormalMapVectors definition (remove the comment)
-   --------------------------------------------------------------------*/
-    void Renderable::calculateNormalMapVectors() {
-        UINT uNumFaces = GetNumIndices() / 3;
-        const SimpleVertex* aVertices = getVertices();
-        const WORD* aIndices = getIndices();
-
-        m_aNormalData.resize(GetNumVertices(), NormalData());
-
-        XMFLOAT3 tangent = XMFLOAT3(0.0f, 0.0f, 0.0f);
-        XMFLOAT3 bitangent = XMFLOAT3(0.0f, 0.0f, 0.0f);
-
-        for (int i = 0; i < uNumFaces; ++i) {
-            calculateTangentBitangent(aVertices[aIndices[i * 3]], aVertices[aIndices[i * 3 + 1]], aVertices[aIndices[i * 3 + 2]], tangent, bitangent);
-            m_aNormalData[aIndices[i * 3]].Tangent = tangent;
-            m_aNormalData[aIndices[i * 3]].Bitangent = bitangent;
-            m_aNormalData[aIndices[i * 3 + 1]].Tangent = tangent;
-            m_aNormalData[aIndices[i * 3 + 1]].Bitangent = bitangent;
-            m_aNormalData[aIndices[i * 3 + 2]].Tangent = tangent;
-            m_aNormalData[aIndices[i * 3 + 2]].Bitangent = bitangent;
-        }
-    }
+      Method:   Renderable::calculateNormalMapVectors
 
-   /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-     Method:   Renderable::calculateTangentBitangent
+      Summary:  Calculates the tangent and bitangent of every vertex,
+                one mesh at a time since the indices of a mesh are
+                relative to its base vertex
 
-     Summary:  Calculate tangent/bitangent vectors of the given face
-
-     Args:     SimpleVertex& v1
-                 The first vertex of the face
-               SimpleVertex& v2
-                 The second vertex of the face
-               SimpleVertex& v3
-                 The third vertex of the face
-               XMFLOAT3& tangent
-                 Calculated tangent vector
-               XMFLOAT3& bitangent
-                 Calculated bitangent vector
-   M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Renderable::calculateTangentBitangent(_In_ const SimpleVertex& v1, _In_ const SimpleVertex& v2, _In_ const SimpleVertex& v3, _Out_ XMFLOAT3& tangent, _Out_ XMFLOAT3& bitangent)
+      Modifies: [m_aNormalData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::calculateNormalMapVectors()
     {
-        XMFLOAT3 vector1, vector2;
-        XMFLOAT2 tuVector, tvVector;
+        const UINT uNumVertices = GetNumVertices();
+        m_aNormalData.assign(uNumVertices, NormalData());
 
-        // Calculate the two vectors for this face.
-        vector1.x = v2.Position.x - v1.Position.x;
-        vector1.y = v2.Position.y - v1.Position.y;
-        vector1.z = v2.Position.z - v1.Position.z;
-
-        vector2.x = v3.Position.x - v1.Position.x;
-        vector2.y = v3.Position.y - v1.Position.y;
-        vector2.z = v3.Position.z - v1.Position.z;
-
-        // Calculate the tu and tv texture space vectors.
-        tuVector.x = v2.TexCoord.x - v1.TexCoord.x;
-        tvVector.x = v2.TexCoord.y - v1.TexCoord.y;
-
-        tuVector.y = v3.TexCoord.x - v1.TexCoord.x;
-        tvVector.y = v3.TexCoord.y - v1.TexCoord.y;
-
-        // Calculate the denominator of the tangent/binormal equation.
-        float den = 1.0f / (tuVector.x * tvVector.y - tuVector.y * tvVector.x);
-
-        // Calculate the cross products and multiply by the coefficient to get the tangent and binormal.
-        tangent.x = (tvVector.y * vector1.x - tvVector.x * vector2.x) * den;
-        tangent.y = (tvVector.y * vector1.y - tvVector.x * vector2.y) * den;
-        tangent.z = (tvVector.y * vector1.z - tvVector.x * vector2.z) * den;
-
-        bitangent.x = (tuVector.x * vector2.x - tuVector.y * vector1.x) * den;
-        bitangent.y = (tuVector.x * vector2.y - tuVector.y * vector1.y) * den;
-        bitangent.z = (tuVector.x * vector2.z - tuVector.y * vector1.z) * den;
-
-        // Calculate the length of this normal.
-        float length = sqrt((tangent.x * tangent.x) + (tangent.y * tangent.y) + (tangent.z * tangent.z));
-
-        // Normalize the normal and then store it
-        tangent.x = tangent.x / length;
-        tangent.y = tangent.y / length;
-        tangent.z = tangent.z / length;
-
-        // Calculate the length of this normal.
-        length = sqrt((bitangent.x * bitangent.x) + (bitangent.y * bitangent.y) + (bitangent.z * bitangent.z));
+        if (m_aMeshes.empty())
+        {
+            TangentFrameGenerator::Generate(getVertices(), uNumVertices, getIndices(), GetIndexFormat(), GetNumIndices(), m_aNormalData.data());
+            return;
+        }
 
-        // Normalize the normal and then store it
-        bitangent.x = bitangent.x / length;
-        bitangent.y = bitangent.y / length;
-        bitangent.z = bitangent.z / length;
+        const UINT uIndexSize = GetIndexFormat() == DXGI_FORMAT_R32_UINT ? sizeof(UINT) : sizeof(WORD);
+        for (UINT uMeshIndex = 0u; uMeshIndex < m_aMeshes.size(); ++uMeshIndex)
+        {
+            // The vertices of a mesh end where the next mesh starts
+            const BasicMeshEntry& mesh = m_aMeshes[uMeshIndex];
+            const UINT uEndVertex = uMeshIndex + 1u < m_aMeshes.size() ? m_aMeshes[uMeshIndex + 1u].uBaseVertex : uNumVertices;
+
+            TangentFrameGenerator::Generate(
+                getVertices() + mesh.uBaseVertex,
+                uEndVertex - mesh.uBaseVertex,
+                static_cast<const BYTE*>(getIndices()) + static_cast<size_t>(mesh.uBaseIndex) * uIndexSize,
+                GetIndexFormat(),
+                mesh.uNumIndices,
+                m_aNormalData.data() + mesh.uBaseVertex
+            );
+        }
     }
 
 
@@ -603,6 +569,130 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     {
         m_world *= XMMatrixTranslationFromVector(offset);
     }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetIndexFormat
+      Summary:  Returns the format of the indices, 16-bit unless a
+                derived class stores wider indices
+      Returns:  DXGI_FORMAT
+                  DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DXGI_FORMAT Renderable::GetIndexFormat() const
+    {
+        return DXGI_FORMAT_R16_UINT;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SelectLod
+      Summary:  Projects the error of each detail level of a mesh at the
+                distance of its bounding sphere and returns the coarsest
+                level that stays under the given error in pixels
+      Args:     UINT uMeshIndex
+                  Index of the mesh
+                FXMVECTOR eyePosition
+                  World space position of the camera
+                FLOAT projectionScale
+                  Pixels covered by one unit at a distance of one unit,
+                  half the viewport height times the vertical focal
+                  length of the projection
+                FLOAT maxPixelError
+                  Largest error allowed on screen in pixels
+      Returns:  UINT
+                  Detail level, 0 for the full mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::SelectLod(_In_ UINT uMeshIndex, _In_ FXMVECTOR eyePosition, _In_ FLOAT projectionScale, _In_ FLOAT maxPixelError) const
+    {
+        const BasicMeshEntry& mesh = m_aMeshes[uMeshIndex];
+        if (mesh.uNumLods <= 1u)
+        {
+            return 0u;
+        }
+
+        const FLOAT scale = sqrtf(std::max({
+            XMVectorGetX(XMVector3LengthSq(m_world.r[0])),
+            XMVectorGetX(XMVector3LengthSq(m_world.r[1])),
+            XMVectorGetX(XMVector3LengthSq(m_world.r[2]))
+        }));
+        const XMVECTOR center = XMVector3Transform(XMLoadFloat3(&mesh.bounds.Center), m_world);
+
+        // The nearest point of the bounding sphere decides, the camera may be inside it
+        const FLOAT distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(center, eyePosition))) - mesh.bounds.Radius * scale;
+        if (distance <= 0.0f)
+        {
+            return 0u;
+        }
+
+        const FLOAT pixelsPerUnit = projectionScale * scale / distance;
+
+        UINT uLod = 0u;
+        while (uLod + 1u < mesh.uNumLods && mesh.aLods[uLod + 1u].error * pixelsPerUnit <= maxPixelError)
+        {
+            ++uLod;
+        }
+
+        return uLod;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SetVertexFormat
+      Summary:  Sets whether the vertex and normal buffers hold full
+                precision or packed vertices. The vertex shader must
+                have the matching input layout. Must be called before
+                Initialize.
+      Args:     eVertexFormat vertexFormat
+                  Format of the vertex buffers
+      Modifies: [m_vertexFormat].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::SetVertexFormat(_In_ eVertexFormat vertexFormat)
+    {
+        assert(!m_vertexBuffer);
+
+        m_vertexFormat = vertexFormat;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetVertexFormat
+      Summary:  Returns the format of the vertex buffers
+      Returns:  eVertexFormat
+                  Format of the vertex buffers
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eVertexFormat Renderable::GetVertexFormat() const
+    {
+        return m_vertexFormat;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetVertexStride
+      Summary:  Returns the stride of the vertex buffer
+      Returns:  UINT
+                  Size of SimpleVertex or PackedVertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::GetVertexStride() const
+    {
+        return m_vertexFormat == eVertexFormat::PACKED ? sizeof(PackedVertex) : sizeof(SimpleVertex);
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetNormalDataStride
+      Summary:  Returns the stride of the normal buffer
+      Returns:  UINT
+                  Size of NormalData or PackedNormalData
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::GetNormalDataStride() const
+    {
+        return m_vertexFormat == eVertexFormat::PACKED ? sizeof(PackedNormalData) : sizeof(NormalData);
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::getIndex
+      Summary:  Returns an index of getIndices read with the index format
+      Args:     UINT uIndex
+                  Position of the index
+      Returns:  UINT
+                  Vertex index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::getIndex(_In_ UINT uIndex) const
+    {
+        if (GetIndexFormat() == DXGI_FORMAT_R32_UINT)
+        {
+            return static_cast<const UINT*>(getIndices())[uIndex];
+        }
+
+        return static_cast<const WORD*>(getIndices())[uIndex];
+    }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetNumMeshes
       Summary:  Returns the number of meshes
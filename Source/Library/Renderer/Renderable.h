@@ -45,6 +45,19 @@ namespace library
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                GetIndexFormat
+                  Returns the format of the indices
+                SelectLod
+                  Returns the coarsest detail level of a mesh whose
+                  error stays under a number of pixels
+                SetVertexFormat
+                  Sets whether the vertex buffers are packed
+                GetVertexFormat
+                  Returns the format of the vertex buffers
+                GetVertexStride
+                  Returns the stride of the vertex buffer
+                GetNormalDataStride
+                  Returns the stride of the normal buffer
                 Renderable
                   Constructor.
                 ~Renderable
@@ -54,8 +67,17 @@ namespace library
     {
     public:
         static constexpr const UINT INVALID_MATERIAL = (0xFFFFFFFF);
+        static constexpr const UINT MAX_NUM_LODS = 4u;
 
     protected:
+        // Index range of one detail level and its geometric error in model units
+        struct MeshLod
+        {
+            UINT uNumIndices;
+            UINT uBaseIndex;
+            FLOAT error;
+        };
+
         struct BasicMeshEntry
         {
             BasicMeshEntry()
@@ -63,6 +85,11 @@ namespace library
                 , uBaseVertex(0u)
                 , uBaseIndex(0u)
                 , uMaterialIndex(INVALID_MATERIAL)
+                , uNumLods(0u)
+                , aLods()
+                , bounds()
+                , uFirstMeshlet(0u)
+                , uNumMeshlets(0u)
             {
             }
 
@@ -70,6 +97,13 @@ namespace library
             UINT uBaseVertex;
             UINT uBaseIndex;
             UINT uMaterialIndex;
+            // aLods[0] is the full mesh, empty when no detail levels were built
+            UINT uNumLods;
+            MeshLod aLods[MAX_NUM_LODS];
+            BoundingSphere bounds;
+            // Meshlets of the full mesh, none when it is not culled per meshlet
+            UINT uFirstMeshlet;
+            UINT uNumMeshlets;
         };
 
     public:
@@ -112,6 +146,14 @@ namespace library
 
         virtual UINT GetNumVertices() const = 0;
         virtual UINT GetNumIndices() const = 0;
+        virtual DXGI_FORMAT GetIndexFormat() const;
+
+        void SetVertexFormat(_In_ eVertexFormat vertexFormat);
+        eVertexFormat GetVertexFormat() const;
+        UINT GetVertexStride() const;
+        UINT GetNormalDataStride() const;
+
+        UINT SelectLod(_In_ UINT uMeshIndex, _In_ FXMVECTOR eyePosition, _In_ FLOAT projectionScale, _In_ FLOAT maxPixelError) const;
 
         UINT GetNumMeshes() const;
         UINT GetNumMaterials() const;
@@ -119,14 +161,14 @@ namespace library
 
     protected:
         const virtual SimpleVertex* getVertices() const = 0;
-        virtual const WORD* getIndices() const = 0;
+        virtual const void* getIndices() const = 0;
+        UINT getIndex(_In_ UINT uIndex) const;
         virtual HRESULT initialize(
             _In_ ID3D11Device* pDevice,
             _In_ ID3D11DeviceContext* pImmediateContext
         );
 
         void calculateNormalMapVectors();
-        void calculateTangentBitangent(_In_ const SimpleVertex& v1, _In_ const SimpleVertex& v2, _In_ const SimpleVertex& v3, _Out_ XMFLOAT3& tangent, _Out_ XMFLOAT3& bitangent);
 
     protected:
         ComPtr<ID3D11Buffer> m_vertexBuffer;
@@ -145,5 +187,6 @@ namespace library
         BYTE m_padding[8];
         XMMATRIX m_world;
         BOOL m_bHasNormalMap;
+        eVertexFormat m_vertexFormat;
     };
 }
\ No newline at end of file
@@ -11,7 +11,10 @@ namespace library
                   m_immediateContext, m_immediateContext1, m_swapChain,
                   m_swapChain1, m_renderTargetView, m_depthStencil,
                   m_depthStencilView, m_cbChangeOnResize, m_cbShadowMatrix,
-                  m_pszMainSceneName, m_camera, m_projection, m_scenes
+                  m_pszMainSceneName, m_camera, m_projection,
+                  m_lodProjectionScale, m_maxLodPixelError,
+                  m_meshletCullingStatistics, m_drawStatistics,
+                  m_aVisibleMeshletRanges, m_scenes
                   m_invalidTexture, m_shadowMapTexture, m_shadowVertexShader,
                   m_shadowPixelShader].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -32,6 +35,11 @@ namespace library
         , m_padding{ '\0' }
         , m_camera(XMVectorSet(0.0f, 3.0f, -6.0f, 0.0f))
         , m_projection()
+        , m_lodProjectionScale(0.0f)
+        , m_maxLodPixelError(DEFAULT_MAX_LOD_PIXEL_ERROR)
+        , m_meshletCullingStatistics()
+        , m_drawStatistics()
+        , m_aVisibleMeshletRanges()
         , m_scenes()
         , m_invalidTexture(std::make_shared<Texture>(L"Content/Common/InvalidTexture.png"))
         , m_shadowMapTexture()
@@ -266,6 +274,7 @@ namespace library
 
         // Initialize the projection matrix
         m_projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uHeight), 0.01f, 1000.0f);
+        m_lodProjectionScale = XMVectorGetY(m_projection.r[1]) * static_cast<FLOAT>(uHeight) * 0.5f;
 
         CBChangeOnResize cbChangesOnResize =
         {
@@ -420,13 +429,15 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Update
 
-      Summary:  Update the renderables each frame
+      Summary:  Upload the models loaded since the last frame and
+                update the renderables each frame
 
       Args:     FLOAT deltaTime
                   Time difference of a frame
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderer::Update(_In_ FLOAT deltaTime)
     {
+        m_scenes[m_pszMainSceneName]->UploadLoadedModels(m_immediateContext.Get());
         m_scenes[m_pszMainSceneName]->Update(deltaTime);
 
         m_camera.Update(deltaTime);
@@ -468,6 +479,14 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
         UINT uStride = sizeof(SimpleVertex);
         UINT uOffset = 0;
 
+        m_meshletCullingStatistics = MeshletCullingStatistics{ .uNumMeshlets = 0u, .uNumRanges = 0u, .uNumTriangles = 0u, .uNumVisibleTriangles = 0u, .cullingTime = 0.0 };
+        m_drawStatistics = DrawStatistics{ .uNumModels = 0u, .uNumModelDrawCalls = 0u, .modelSubmitTime = 0.0, .uNumInstances = 0u, .uNumInstancedDrawCalls = 0u, .instancedSubmitTime = 0.0 };
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+        const XMMATRIX viewProjection = m_camera.GetView() * m_projection;
+
         CBChangeOnCameraMovement cb_changesOnCameraMovement;
         cb_changesOnCameraMovement.View = XMMatrixTranspose(m_camera.GetView());
         XMStoreFloat4(&cb_changesOnCameraMovement.CameraPosition, m_camera.GetEye());
@@ -482,8 +501,8 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
             {
                 UINT aStrides[2] =
                 {
-                    sizeof(SimpleVertex),
-                    sizeof(NormalData)
+                    s.second->GetSkyBox()->GetVertexStride(),
+                    s.second->GetSkyBox()->GetNormalDataStride()
                 };
                 UINT aOffsets[2] = { 0u, 0u };
 
@@ -495,7 +514,7 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 
                 // Set the vertex buffer
                 m_immediateContext->IASetVertexBuffers(0u, 2u, aBuffers->GetAddressOf(), aStrides, aOffsets);
-                m_immediateContext->IASetIndexBuffer(s.second->GetSkyBox()->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+                m_immediateContext->IASetIndexBuffer(s.second->GetSkyBox()->GetIndexBuffer().Get(), s.second->GetSkyBox()->GetIndexFormat(), 0u);
                 m_immediateContext->IASetInputLayout(s.second->GetSkyBox()->GetVertexLayout().Get());
                 
                 XMMATRIX world = s.second->GetSkyBox()->GetWorldMatrix();
@@ -571,8 +590,8 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
                 // Set the vertex buffer
                 UINT aStrides[2] =
                 {
-                    static_cast<UINT>(sizeof(SimpleVertex)),
-                    static_cast<UINT>(sizeof(NormalData))
+                    renderable->second->GetVertexStride(),
+                    renderable->second->GetNormalDataStride()
                 };
                 UINT aOffsets[2] = { 0u, 0u };
                 ComPtr<ID3D11Buffer> aBuffers[2]
@@ -584,7 +603,7 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
                 m_immediateContext->IASetVertexBuffers(0u, 2u, aBuffers->GetAddressOf(), aStrides, aOffsets);
 
                 // Set the index buffer
-                m_immediateContext->IASetIndexBuffer(renderable->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+                m_immediateContext->IASetIndexBuffer(renderable->second->GetIndexBuffer().Get(), renderable->second->GetIndexFormat(), 0u);
 
                 // Set the input layout
                 m_immediateContext->IASetInputLayout(renderable->second->GetVertexLayout().Get());
@@ -649,14 +668,14 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
             }
 
             // voxel
-            UINT stride[3] = { sizeof(SimpleVertex), sizeof(NormalData), sizeof(InstanceData) };
             UINT offset[3] = { 0u, 0u, 0u };
            
             for (auto i : s.second->GetVoxels()) {
+                UINT stride[3] = { i->GetVertexStride(), i->GetNormalDataStride(), sizeof(InstanceData) };
 
                 ComPtr<ID3D11Buffer> buffer[3] = { i->GetVertexBuffer().Get(), i->GetNormalBuffer().Get(), i->GetInstanceBuffer().Get() };
                 m_immediateContext->IASetVertexBuffers(0, 3, buffer->GetAddressOf(), stride, offset);
-                m_immediateContext->IASetIndexBuffer(i->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+                m_immediateContext->IASetIndexBuffer(i->GetIndexBuffer().Get(), i->GetIndexFormat(), 0);
                 m_immediateContext->IASetInputLayout(i->GetVertexLayout().Get());
 
                 CBChangesEveryFrame cbChanges = {
@@ -709,16 +728,24 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
             // model
 
             // Animation을 지워야 한다.
-            UINT aStrides[2] =
-            {
-                static_cast<UINT>(sizeof(SimpleVertex)),
-                static_cast<UINT>(sizeof(NormalData))
-
-            };
             UINT aOffsets[2] = { 0u,  0u };
 
+            QueryPerformanceCounter(&startingTime);
             for (auto k : s.second->GetModels())
             {
+                // Models still loading are skipped until the scene uploads them
+                if (!k.second->IsLoaded())
+                {
+                    continue;
+                }
+
+                ++m_drawStatistics.uNumModels;
+
+                UINT aStrides[2] =
+                {
+                    k.second->GetVertexStride(),
+                    k.second->GetNormalDataStride()
+                };
                 ComPtr<ID3D11Buffer> aBuffers[2]
                 {
                    k.second->GetVertexBuffer().Get(),
@@ -726,7 +753,7 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
                 };
 
                 m_immediateContext->IASetVertexBuffers(0, 2, aBuffers->GetAddressOf(), aStrides, aOffsets);
-                m_immediateContext->IASetIndexBuffer(k.second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+                m_immediateContext->IASetIndexBuffer(k.second->GetIndexBuffer().Get(), k.second->GetIndexFormat(), 0);
                 m_immediateContext->IASetInputLayout(k.second->GetVertexLayout().Get());
 
 
@@ -739,16 +766,14 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
                 };
                 m_immediateContext->UpdateSubresource(k.second->GetConstantBuffer().Get(), 0, nullptr, &cb_ChangesEveryFrame, 0, 0);
 
-                CBSkinning cb_Skinning = {
-                    .BoneTransforms = {}
-                };
-                for (UINT i = 0; i < k.second->GetBoneTransforms().size(); ++i)
+                // The palette is already in GPU order and the buffer is sized
+                // to the bones of the model, so it is copied as is
+                const std::vector<XMFLOAT4>& aSkinningPalette = k.second->GetSkinningPalette();
+                if (!aSkinningPalette.empty())
                 {
-                    cb_Skinning.BoneTransforms[i] = XMMatrixTranspose(k.second->GetBoneTransforms()[i]);
+                    m_immediateContext->UpdateSubresource(k.second->GetSkinningConstantBuffer().Get(), 0, nullptr, aSkinningPalette.data(), 0, 0);
                 }
 
-                m_immediateContext->UpdateSubresource(k.second->GetSkinningConstantBuffer().Get(), 0, nullptr, &cb_Skinning, 0, 0);
-
                 m_immediateContext->VSSetShader(k.second->GetVertexShader().Get(), nullptr, 0);
                 m_immediateContext->VSSetConstantBuffers(2, 1, k.second->GetConstantBuffer().GetAddressOf());
                 m_immediateContext->VSSetConstantBuffers(4, 1, k.second->GetSkinningConstantBuffer().GetAddressOf());
@@ -759,9 +784,9 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
                 m_immediateContext->PSSetShaderResources(2u, 1, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
                 m_immediateContext->PSSetSamplers(2u, 1, m_shadowMapTexture->GetSamplerState().GetAddressOf());
 
-                if (k.second->HasTexture())
+                for (UINT i = 0u; i < k.second->GetNumMeshes(); i++)
                 {
-                    for (UINT i = 0u; i < k.second->GetNumMeshes(); i++)
+                    if (k.second->HasTexture())
                     {
                         const UINT materialIndex = k.second->GetMesh(i).uMaterialIndex;
                         eTextureSamplerType textureSamplerType = k.second->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
@@ -775,14 +800,176 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
                             m_immediateContext->PSSetShaderResources(1, 1, k.second->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
                             m_immediateContext->PSSetSamplers(1, 1, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
                         }
-                        m_immediateContext->DrawIndexed(
-                            k.second->GetMesh(i).uNumIndices,
-                            k.second->GetMesh(i).uBaseIndex,
-                            k.second->GetMesh(i).uBaseVertex);
                     }
+
+                    // Distant meshes are drawn from a coarser index range of the same vertices
+                    const UINT uLod = k.second->SelectLod(i, m_camera.GetEye(), m_lodProjectionScale, m_maxLodPixelError);
+
+                    // Near meshes only draw the meshlets that can be seen
+                    if (uLod == 0u && k.second->CullMeshlets(i, m_camera.GetEye(), viewProjection, m_aVisibleMeshletRanges, m_meshletCullingStatistics))
+                    {
+                        for (const Meshlet& range : m_aVisibleMeshletRanges)
+                        {
+                            m_immediateContext->DrawIndexed(range.uNumIndices, range.uBaseIndex, k.second->GetMesh(i).uBaseVertex);
+                        }
+                        m_drawStatistics.uNumModelDrawCalls += static_cast<UINT>(m_aVisibleMeshletRanges.size());
+                        continue;
+                    }
+
+                    const UINT uNumIndices = uLod > 0u ? k.second->GetMesh(i).aLods[uLod].uNumIndices : k.second->GetMesh(i).uNumIndices;
+                    const UINT uBaseIndex = uLod > 0u ? k.second->GetMesh(i).aLods[uLod].uBaseIndex : k.second->GetMesh(i).uBaseIndex;
+                    m_immediateContext->DrawIndexed(
+                        uNumIndices,
+                        uBaseIndex,
+                        k.second->GetMesh(i).uBaseVertex);
+                    ++m_drawStatistics.uNumModelDrawCalls;
                 }
-                else {
-                    m_immediateContext->DrawIndexed(k.second->GetNumIndices(), 0, 0);
+            }
+            QueryPerformanceCounter(&endingTime);
+            m_drawStatistics.modelSubmitTime += static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart);
+
+            // instanced models: the instance buffer never changes, so only the
+            // world matrix of the group is uploaded and each mesh is one draw
+            QueryPerformanceCounter(&startingTime);
+            for (auto k : s.second->GetInstancedModels())
+            {
+                const std::shared_ptr<Model>& pModel = k.second->GetModel();
+                if (!pModel->IsLoaded())
+                {
+                    continue;
+                }
+
+                UINT aInstancedStrides[3] =
+                {
+                    pModel->GetVertexStride(),
+                    pModel->GetNormalDataStride(),
+                    static_cast<UINT>(sizeof(InstanceData))
+                };
+                UINT aInstancedOffsets[3] = { 0u, 0u, 0u };
+                ID3D11Buffer* aInstancedBuffers[3] =
+                {
+                    pModel->GetVertexBuffer().Get(),
+                    pModel->GetNormalBuffer().Get(),
+                    k.second->GetInstanceBuffer().Get()
+                };
+
+                m_immediateContext->IASetVertexBuffers(0u, 3u, aInstancedBuffers, aInstancedStrides, aInstancedOffsets);
+                m_immediateContext->IASetIndexBuffer(pModel->GetIndexBuffer().Get(), pModel->GetIndexFormat(), 0u);
+                m_immediateContext->IASetInputLayout(k.second->GetVertexLayout().Get());
+
+                CBChangesEveryFrame cb_ChangesEveryFrame =
+                {
+                    .World = XMMatrixTranspose(pModel->GetWorldMatrix()),
+                    .OutputColor = pModel->GetOutputColor(),
+                    .HasNormalMap = pModel->HasNormalMap()
+                };
+                m_immediateContext->UpdateSubresource(pModel->GetConstantBuffer().Get(), 0u, nullptr, &cb_ChangesEveryFrame, 0u, 0u);
+
+                m_immediateContext->VSSetShader(k.second->GetVertexShader().Get(), nullptr, 0u);
+                m_immediateContext->VSSetConstantBuffers(2u, 1u, pModel->GetConstantBuffer().GetAddressOf());
+                m_immediateContext->PSSetShader(k.second->GetPixelShader().Get(), nullptr, 0u);
+                m_immediateContext->PSSetConstantBuffers(2u, 1u, pModel->GetConstantBuffer().GetAddressOf());
+
+                m_immediateContext->PSSetShaderResources(2u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
+                m_immediateContext->PSSetSamplers(2u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
+
+                for (UINT i = 0u; i < pModel->GetNumMeshes(); ++i)
+                {
+                    const UINT materialIndex = pModel->GetMesh(i).uMaterialIndex;
+
+                    if (pModel->HasTexture() && pModel->GetMaterial(materialIndex)->pDiffuse)
+                    {
+                        eTextureSamplerType textureSamplerType = pModel->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
+                        m_immediateContext->PSSetShaderResources(0u, 1u, pModel->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
+                        m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+
+                        if (pModel->GetMaterial(materialIndex)->pNormal)
+                        {
+                            m_immediateContext->PSSetShaderResources(1u, 1u, pModel->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
+                            m_immediateContext->PSSetSamplers(1u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                        }
+                    }
+
+                    m_immediateContext->DrawIndexedInstanced(
+                        pModel->GetMesh(i).uNumIndices,
+                        k.second->GetNumInstances(),
+                        pModel->GetMesh(i).uBaseIndex,
+                        pModel->GetMesh(i).uBaseVertex,
+                        0u
+                    );
+                    ++m_drawStatistics.uNumInstancedDrawCalls;
+                }
+
+                m_drawStatistics.uNumInstances += k.second->GetNumInstances();
+            }
+            QueryPerformanceCounter(&endingTime);
+            m_drawStatistics.instancedSubmitTime += static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart);
+
+            // crowd: one palette upload and one instanced draw per mesh for all instances
+            for (auto c : s.second->GetCrowds())
+            {
+                if (!c.second->GetInstance(0u)->IsLoaded())
+                {
+                    continue;
+                }
+
+                if (FAILED(c.second->Upload(m_immediateContext.Get())))
+                {
+                    continue;
+                }
+
+                const std::shared_ptr<Model>& pModel = c.second->GetInstance(0u);
+
+                UINT aCrowdStrides[3] =
+                {
+                    pModel->GetVertexStride(),
+                    pModel->GetAnimationDataStride(),
+                    static_cast<UINT>(sizeof(CrowdInstanceData))
+                };
+                UINT aCrowdOffsets[3] = { 0u, 0u, 0u };
+                ID3D11Buffer* aCrowdBuffers[3] =
+                {
+                    pModel->GetVertexBuffer().Get(),
+                    pModel->GetAnimationBuffer().Get(),
+                    c.second->GetInstanceBuffer().Get()
+                };
+
+                m_immediateContext->IASetVertexBuffers(0u, 3u, aCrowdBuffers, aCrowdStrides, aCrowdOffsets);
+                m_immediateContext->IASetIndexBuffer(pModel->GetIndexBuffer().Get(), pModel->GetIndexFormat(), 0u);
+                m_immediateContext->IASetInputLayout(c.second->GetVertexLayout().Get());
+
+                CBChangesEveryFrame cb_ChangesEveryFrame = {
+                    .World = XMMatrixIdentity(),
+                    .OutputColor = pModel->GetOutputColor(),
+                    .HasNormalMap = pModel->HasNormalMap()
+                };
+                m_immediateContext->UpdateSubresource(pModel->GetConstantBuffer().Get(), 0u, nullptr, &cb_ChangesEveryFrame, 0u, 0u);
+
+                m_immediateContext->VSSetShader(c.second->GetVertexShader().Get(), nullptr, 0u);
+                m_immediateContext->VSSetConstantBuffers(2u, 1u, pModel->GetConstantBuffer().GetAddressOf());
+                m_immediateContext->VSSetShaderResources(3u, 1u, c.second->GetPaletteShaderResourceView().GetAddressOf());
+                m_immediateContext->PSSetShader(c.second->GetPixelShader().Get(), nullptr, 0u);
+                m_immediateContext->PSSetConstantBuffers(2u, 1u, pModel->GetConstantBuffer().GetAddressOf());
+
+                for (UINT i = 0u; i < pModel->GetNumMeshes(); ++i)
+                {
+                    const UINT materialIndex = pModel->GetMesh(i).uMaterialIndex;
+
+                    if (pModel->HasTexture() && pModel->GetMaterial(materialIndex)->pDiffuse)
+                    {
+                        eTextureSamplerType textureSamplerType = pModel->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
+
+                        m_immediateContext->PSSetShaderResources(0u, 1u, pModel->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
+                        m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                    }
+
+                    m_immediateContext->DrawIndexedInstanced(
+                        pModel->GetMesh(i).uNumIndices,
+                        c.second->GetNumInstances(),
+                        pModel->GetMesh(i).uBaseIndex,
+                        pModel->GetMesh(i).uBaseVertex,
+                        0u
+                    );
                 }
             }
             m_swapChain->Present(0, 0);
@@ -808,10 +995,10 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
         m_immediateContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
 
         for (auto i : m_scenes[m_pszMainSceneName]->GetRenderables()) {
-            UINT uStride = sizeof(SimpleVertex);
+            UINT uStride = i.second->GetVertexStride();
             UINT uOffset = 0;
             m_immediateContext->IASetVertexBuffers(0u, 1u, i.second->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
-            m_immediateContext->IASetIndexBuffer(i.second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0); 
+            m_immediateContext->IASetIndexBuffer(i.second->GetIndexBuffer().Get(), i.second->GetIndexFormat(), 0); 
             m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
 
             CBShadowMatrix cb = {
@@ -833,10 +1020,10 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
         }
 
         for (auto i : m_scenes[m_pszMainSceneName]->GetVoxels()) {
-            UINT uStride = sizeof(SimpleVertex);
+            UINT uStride = i->GetVertexStride();
             UINT uOffset = 0;
             m_immediateContext->IASetVertexBuffers(0u, 2u, i->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
-            m_immediateContext->IASetIndexBuffer(i->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0); 
+            m_immediateContext->IASetIndexBuffer(i->GetIndexBuffer().Get(), i->GetIndexFormat(), 0); 
             m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
 
             m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0u);
@@ -859,10 +1046,21 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
         }
 
         for (auto i : m_scenes[m_pszMainSceneName]->GetModels()) {
-            UINT uStride = sizeof(SimpleVertex);
+            if (!i.second->IsLoaded())
+            {
+                continue;
+            }
+
             UINT uOffset = 0;
-            m_immediateContext->IASetVertexBuffers(0u, 1u, i.second->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
-            m_immediateContext->IASetIndexBuffer(i.second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0); 
+
+            // Animated models cast shadows from the vertices skinned on the CPU in Update,
+            // which are always full precision
+            i.second->UpdateSkinnedVertexBuffer(m_immediateContext.Get());
+            ComPtr<ID3D11Buffer>& vertexBuffer = i.second->GetSkinnedVertexBuffer() ? i.second->GetSkinnedVertexBuffer() : i.second->GetVertexBuffer();
+            UINT uStride = i.second->GetSkinnedVertexBuffer() ? static_cast<UINT>(sizeof(SimpleVertex)) : i.second->GetVertexStride();
+
+            m_immediateContext->IASetVertexBuffers(0u, 1u, vertexBuffer.GetAddressOf(), &uStride, &uOffset);
+            m_immediateContext->IASetIndexBuffer(i.second->GetIndexBuffer().Get(), i.second->GetIndexFormat(), 0); 
             m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
 
             m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0u);
@@ -890,6 +1088,55 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     }
 
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetMaxLodPixelError
+
+      Summary:  Sets how many pixels the simplification error of a model
+                mesh may cover on screen before a finer detail level is
+                drawn, 0 only allows detail levels without error
+
+      Args:     FLOAT maxPixelError
+                  Largest error on screen in pixels
+
+      Modifies: [m_maxLodPixelError].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::SetMaxLodPixelError(_In_ FLOAT maxPixelError)
+    {
+        m_maxLodPixelError = maxPixelError;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetMeshletCullingStatistics
+
+      Summary:  Returns the meshlets, triangles and CPU time of the
+                meshlet culling of model meshes in the last frame. The
+                fraction of triangles culled is 1 - uNumVisibleTriangles
+                / uNumTriangles.
+
+      Returns:  const MeshletCullingStatistics&
+                  Culling work of the last rendered frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const MeshletCullingStatistics& Renderer::GetMeshletCullingStatistics() const
+    {
+        return m_meshletCullingStatistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetDrawStatistics
+
+      Summary:  Returns the draw calls and the CPU time spent submitting
+                the models drawn one by one and the instanced models in
+                the last frame, so both paths can be compared for the
+                same scenery
+
+      Returns:  const DrawStatistics&
+                  Model draws of the last rendered frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const DrawStatistics& Renderer::GetDrawStatistics() const
+    {
+        return m_drawStatistics;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
     * 
       Method:   Renderer::GetDriverType
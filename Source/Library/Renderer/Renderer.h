@@ -27,6 +27,23 @@
 
 namespace library
 {
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DrawStatistics
+
+      Summary:  Draw calls issued and CPU time in milliseconds spent
+                submitting them in a frame, for the models drawn one by
+                one and for the instanced models
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DrawStatistics
+    {
+        UINT uNumModels;
+        UINT uNumModelDrawCalls;
+        DOUBLE modelSubmitTime;
+        UINT uNumInstances;
+        UINT uNumInstancedDrawCalls;
+        DOUBLE instancedSubmitTime;
+    };
+
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
       Class:    Renderer
 
@@ -41,6 +58,13 @@ namespace library
                   Update the renderables each frame
                 Render
                   Renders the frame
+                SetMaxLodPixelError
+                  Sets the screen space error allowed when selecting
+                  the detail level of model meshes
+                GetMeshletCullingStatistics
+                  Returns the meshlet culling work of the last frame
+                GetDrawStatistics
+                  Returns the model draw calls of the last frame
                 GetDriverType
                   Returns the Direct3D driver type
                 Renderer
@@ -50,6 +74,9 @@ namespace library
     C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Renderer final
     {
+    public:
+        static constexpr const FLOAT DEFAULT_MAX_LOD_PIXEL_ERROR = 1.0f;
+
     public:
         Renderer();
         Renderer(const Renderer& other) = delete;
@@ -69,6 +96,9 @@ namespace library
         void Update(_In_ FLOAT deltaTime);
         void Render();
         void RenderSceneToTexture();
+        void SetMaxLodPixelError(_In_ FLOAT maxPixelError);
+        const MeshletCullingStatistics& GetMeshletCullingStatistics() const;
+        const DrawStatistics& GetDrawStatistics() const;
 
         D3D_DRIVER_TYPE GetDriverType() const;
 
@@ -91,6 +121,11 @@ namespace library
         BYTE m_padding[8];
         Camera m_camera;
         XMMATRIX m_projection;
+        FLOAT m_lodProjectionScale;
+        FLOAT m_maxLodPixelError;
+        MeshletCullingStatistics m_meshletCullingStatistics;
+        DrawStatistics m_drawStatistics;
+        std::vector<Meshlet> m_aVisibleMeshletRanges;
 
         std::unordered_map<std::wstring, std::shared_ptr<Scene>> m_scenes;
         std::shared_ptr<Texture> m_invalidTexture;
@@ -0,0 +1,536 @@
+#include "Renderer/SkinnedCrowd.h"
+
+#include <execution>
+
+#include "Renderer/D3D11BufferUploader.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::SkinnedCrowd
+
+      Summary:  Constructor
+
+      Modifies: [m_aInstances, m_aPalettes, m_aInstanceData,
+                 m_paletteBuffer, m_paletteView, m_instanceBuffer,
+                 m_vertexShader, m_pixelShader, m_uNumPaletteRowsPerInstance,
+                 m_uLastUploadSize, m_uTotalUploadSize, m_uNumUploads].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SkinnedCrowd::SkinnedCrowd()
+        : m_aInstances()
+        , m_aPalettes()
+        , m_aInstanceData()
+        , m_paletteBuffer()
+        , m_paletteView()
+        , m_instanceBuffer()
+        , m_vertexShader()
+        , m_pixelShader()
+        , m_uNumPaletteRowsPerInstance(0u)
+        , m_uLastUploadSize(0u)
+        , m_uTotalUploadSize(0u)
+        , m_uNumUploads(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::AddInstance
+
+      Summary:  Adds a model to the crowd. Every model of a crowd must
+                be loaded from the same file. The crowd is only drawn
+                with the skinning shader, so the model is not skinned on
+                the CPU.
+
+      Args:     const std::shared_ptr<Model>& pModel
+                  Model to add, not initialized yet
+
+      Modifies: [m_aInstances].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SkinnedCrowd::AddInstance(_In_ const std::shared_ptr<Model>& pModel)
+    {
+        if (!pModel)
+        {
+            return E_INVALIDARG;
+        }
+
+        pModel->SetCpuSkinningEnabled(FALSE);
+        m_aInstances.push_back(pModel);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::Initialize
+
+      Summary:  Initializes the models and creates the palette and
+                instance buffers sized for every instance
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_aPalettes, m_aInstanceData, m_paletteBuffer,
+                 m_paletteView, m_instanceBuffer, m_uNumPaletteRowsPerInstance,
+                 m_uLastUploadSize, m_uTotalUploadSize, m_uNumUploads].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SkinnedCrowd::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        HRESULT hr = S_OK;
+
+        if (m_aInstances.empty())
+        {
+            return E_FAIL;
+        }
+
+        for (const std::shared_ptr<Model>& pModel : m_aInstances)
+        {
+            hr = pModel->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            // Instances are drawn with the buffers of the first one
+            if (!pModel->SharesAsset(*m_aInstances[0]))
+            {
+                OutputDebugString(L"SkinnedCrowd: every instance must be loaded from the same file\n");
+                return E_INVALIDARG;
+            }
+
+            if (pModel->GetSkinningPaletteFormat() != m_aInstances[0]->GetSkinningPaletteFormat())
+            {
+                OutputDebugString(L"SkinnedCrowd: every instance must use the same skinning palette format\n");
+                return E_INVALIDARG;
+            }
+        }
+
+        // The crowd input layout reads full precision vertices
+        if (m_aInstances[0]->GetVertexFormat() != eVertexFormat::FULL)
+        {
+            OutputDebugString(L"SkinnedCrowd: packed vertices are not supported\n");
+            return E_INVALIDARG;
+        }
+
+        m_uNumPaletteRowsPerInstance = static_cast<UINT>(m_aInstances[0]->GetSkinningPalette().size());
+        if (m_uNumPaletteRowsPerInstance == 0u)
+        {
+            OutputDebugString(L"SkinnedCrowd: the model is not animated\n");
+            return E_INVALIDARG;
+        }
+
+        const UINT uNumInstances = GetNumInstances();
+        const UINT uNumPaletteRows = m_uNumPaletteRowsPerInstance * uNumInstances;
+
+        m_aPalettes.resize(uNumPaletteRows);
+        m_aInstanceData.resize(uNumInstances);
+
+        D3D11_BUFFER_DESC bd_palette =
+        {
+            .ByteWidth = sizeof(XMFLOAT4) * uNumPaletteRows,
+            .Usage = D3D11_USAGE_DYNAMIC,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+            .MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+            .StructureByteStride = sizeof(XMFLOAT4)
+        };
+
+        hr = pDevice->CreateBuffer(&bd_palette, nullptr, m_paletteBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc =
+        {
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D11_SRV_DIMENSION_BUFFER,
+            .Buffer =
+            {
+                .FirstElement = 0u,
+                .NumElements = uNumPaletteRows
+            }
+        };
+
+        hr = pDevice->CreateShaderResourceView(m_paletteBuffer.Get(), &srvDesc, m_paletteView.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_BUFFER_DESC bd_instance =
+        {
+            .ByteWidth = sizeof(CrowdInstanceData) * uNumInstances,
+            .Usage = D3D11_USAGE_DYNAMIC,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+            .MiscFlags = 0,
+            .StructureByteStride = 0
+        };
+
+        hr = pDevice->CreateBuffer(&bd_instance, nullptr, m_instanceBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_uLastUploadSize = 0u;
+        m_uTotalUploadSize = 0u;
+        m_uNumUploads = 0u;
+
+        Pack();
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::Update
+
+      Summary:  Updates the animation of every instance in parallel,
+                then packs their palettes
+
+      Args:     FLOAT deltaTime
+                  Time difference of a frame
+
+      Modifies: [m_aInstances, m_aPalettes, m_aInstanceData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedCrowd::Update(_In_ FLOAT deltaTime)
+    {
+        std::for_each(std::execution::par, m_aInstances.begin(), m_aInstances.end(),
+            [deltaTime](const std::shared_ptr<Model>& pModel)
+            {
+                pModel->Update(deltaTime);
+            }
+        );
+
+        Pack();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::Pack
+
+      Summary:  Copies the palette rows of every instance after the
+                previous one and records the row where each palette
+                starts. The models already write their rows in GPU
+                order, so this is a plain copy. Does not touch the
+                device.
+
+      Modifies: [m_aPalettes, m_aInstanceData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedCrowd::Pack()
+    {
+        for (UINT i = 0u; i < m_aInstanceData.size(); ++i)
+        {
+            const std::vector<XMFLOAT4>& aSkinningPalette = m_aInstances[i]->GetSkinningPalette();
+            const UINT uPaletteOffset = i * m_uNumPaletteRowsPerInstance;
+
+            assert(aSkinningPalette.size() == m_uNumPaletteRowsPerInstance);
+
+            std::copy(aSkinningPalette.begin(), aSkinningPalette.end(), m_aPalettes.begin() + uPaletteOffset);
+
+            m_aInstanceData[i] =
+            {
+                .Transformation = m_aInstances[i]->GetWorldMatrix(),
+                .PaletteOffset = uPaletteOffset
+            };
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::Upload
+
+      Summary:  Uploads the packed palettes and instance data through
+                the Direct3D context
+
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to map the buffers
+
+      Modifies: [m_paletteBuffer, m_instanceBuffer, m_uLastUploadSize,
+                 m_uTotalUploadSize, m_uNumUploads].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SkinnedCrowd::Upload(_In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        D3D11BufferUploader uploader(pImmediateContext);
+
+        return Upload(uploader);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::Upload
+
+      Summary:  Uploads the packed palettes and instance data and
+                records how many bytes were written
+
+      Args:     BufferUploader& uploader
+                  Writes the buffers, a RecordingBufferUploader checks
+                  the upload without a device
+
+      Modifies: [m_paletteBuffer, m_instanceBuffer, m_uLastUploadSize,
+                 m_uTotalUploadSize, m_uNumUploads].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SkinnedCrowd::Upload(_In_ BufferUploader& uploader)
+    {
+        m_uLastUploadSize = 0u;
+
+        HRESULT hr = uploadBuffer(uploader, m_paletteBuffer.Get(), m_aPalettes.data(), static_cast<UINT>(sizeof(XMFLOAT4) * m_aPalettes.size()));
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return uploadBuffer(uploader, m_instanceBuffer.Get(), m_aInstanceData.data(), static_cast<UINT>(sizeof(CrowdInstanceData) * m_aInstanceData.size()));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::SetVertexShader
+
+      Summary:  Sets the vertex shader used to draw the crowd
+
+      Args:     const std::shared_ptr<VertexShader>& vertexShader
+                  Vertex shader with the crowd input layout
+
+      Modifies: [m_vertexShader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedCrowd::SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader)
+    {
+        m_vertexShader = vertexShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::SetPixelShader
+
+      Summary:  Sets the pixel shader used to draw the crowd
+
+      Args:     const std::shared_ptr<PixelShader>& pixelShader
+                  Pixel shader to set to
+
+      Modifies: [m_pixelShader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinnedCrowd::SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader)
+    {
+        m_pixelShader = pixelShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetVertexShader
+
+      Summary:  Returns the vertex shader
+
+      Returns:  ComPtr<ID3D11VertexShader>&
+                  Vertex shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11VertexShader>& SkinnedCrowd::GetVertexShader()
+    {
+        return m_vertexShader->GetVertexShader();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetPixelShader
+
+      Summary:  Returns the pixel shader
+
+      Returns:  ComPtr<ID3D11PixelShader>&
+                  Pixel shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11PixelShader>& SkinnedCrowd::GetPixelShader()
+    {
+        return m_pixelShader->GetPixelShader();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetVertexLayout
+
+      Summary:  Returns the vertex input layout
+
+      Returns:  ComPtr<ID3D11InputLayout>&
+                  Vertex input layout
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11InputLayout>& SkinnedCrowd::GetVertexLayout()
+    {
+        return m_vertexShader->GetVertexLayout();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetInstance
+
+      Summary:  Returns a model of the crowd. The vertex, index and
+                animation buffers and the materials of the first
+                instance are used to draw the whole crowd.
+
+      Args:     UINT uIndex
+                  Index of the model
+
+      Returns:  const std::shared_ptr<Model>&
+                  Model
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<Model>& SkinnedCrowd::GetInstance(_In_ UINT uIndex) const
+    {
+        assert(uIndex < m_aInstances.size());
+
+        return m_aInstances[uIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetNumInstances
+
+      Summary:  Returns the number of models
+
+      Returns:  UINT
+                  Number of models
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SkinnedCrowd::GetNumInstances() const
+    {
+        return static_cast<UINT>(m_aInstances.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetNumPaletteRowsPerInstance
+
+      Summary:  Returns the number of float4 rows in a palette
+
+      Returns:  UINT
+                  Number of bones of the model times the rows per bone
+                  of its palette format
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SkinnedCrowd::GetNumPaletteRowsPerInstance() const
+    {
+        return m_uNumPaletteRowsPerInstance;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetPalettes
+
+      Summary:  Returns the palettes packed by the last Pack
+
+      Returns:  const std::vector<XMFLOAT4>&
+                  Palette rows of every instance
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<XMFLOAT4>& SkinnedCrowd::GetPalettes() const
+    {
+        return m_aPalettes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetInstanceData
+
+      Summary:  Returns the instance data packed by the last Pack
+
+      Returns:  const std::vector<CrowdInstanceData>&
+                  World matrix and palette offset of every instance
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<CrowdInstanceData>& SkinnedCrowd::GetInstanceData() const
+    {
+        return m_aInstanceData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetPaletteShaderResourceView
+
+      Summary:  Returns the view of the palette buffer
+
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Shader resource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& SkinnedCrowd::GetPaletteShaderResourceView()
+    {
+        return m_paletteView;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetInstanceBuffer
+
+      Summary:  Returns the instance buffer
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Instance buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& SkinnedCrowd::GetInstanceBuffer()
+    {
+        return m_instanceBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetLastUploadSize
+
+      Summary:  Returns the number of bytes written by the last Upload
+
+      Returns:  UINT64
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 SkinnedCrowd::GetLastUploadSize() const
+    {
+        return m_uLastUploadSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetTotalUploadSize
+
+      Summary:  Returns the number of bytes written since Initialize
+
+      Returns:  UINT64
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 SkinnedCrowd::GetTotalUploadSize() const
+    {
+        return m_uTotalUploadSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::GetNumUploads
+
+      Summary:  Returns the number of buffer updates since Initialize
+
+      Returns:  UINT
+                  Number of buffer updates
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SkinnedCrowd::GetNumUploads() const
+    {
+        return m_uNumUploads;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinnedCrowd::uploadBuffer
+
+      Summary:  Replaces the content of a dynamic buffer and counts the
+                bytes written
+
+      Args:     BufferUploader& uploader
+                  Writes the buffer
+                ID3D11Buffer* pBuffer
+                  Dynamic buffer to write
+                const void* pData
+                  Data to copy
+                UINT uSize
+                  Number of bytes to copy
+
+      Modifies: [m_uLastUploadSize, m_uTotalUploadSize, m_uNumUploads].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SkinnedCrowd::uploadBuffer(_In_ BufferUploader& uploader, _In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize)
+    {
+        HRESULT hr = uploader.Write(pBuffer, pData, uSize);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_uLastUploadSize += uSize;
+        m_uTotalUploadSize += uSize;
+        ++m_uNumUploads;
+
+        return hr;
+    }
+}
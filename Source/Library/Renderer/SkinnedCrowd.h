@@ -0,0 +1,139 @@
+/*+===================================================================
+  File:      SKINNEDCROWD.H
+
+  Summary:   SkinnedCrowd header file contains declarations of
+             SkinnedCrowd class used to draw many instances of the same
+             skinned model with one instanced draw per mesh.
+
+  Classes: SkinnedCrowd
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Model/Model.h"
+#include "Renderer/BufferUploader.h"
+#include "Renderer/DataTypes.h"
+#include "Shader/PixelShader.h"
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SkinnedCrowd
+
+      Summary:  Group of models loaded from the same file. Every frame
+                the bone palettes of all instances are packed into one
+                structured buffer and their world matrices and palette
+                offsets into one instance buffer, so the group is drawn
+                with a single upload of each buffer and one instanced
+                draw per mesh instead of a constant buffer upload and a
+                draw per model. Every instance must use the same
+                skinning palette format, which the vertex shader has to
+                read.
+
+      Methods:  AddInstance
+                  Adds a model to the crowd
+                Initialize
+                  Initializes the models and creates the buffers
+                Update
+                  Updates the models and packs their palettes
+                Pack
+                  Packs the palettes and the instance data
+                Upload
+                  Uploads the packed data through a Direct3D context or
+                  a BufferUploader
+                SetVertexShader
+                  Sets the crowd vertex shader
+                SetPixelShader
+                  Sets the pixel shader
+                GetVertexShader
+                  Returns the vertex shader
+                GetPixelShader
+                  Returns the pixel shader
+                GetVertexLayout
+                  Returns the vertex input layout
+                GetInstance
+                  Returns a model of the crowd
+                GetNumInstances
+                  Returns the number of models
+                GetNumPaletteRowsPerInstance
+                  Returns the number of rows of a palette
+                GetPalettes
+                  Returns the packed palette rows
+                GetInstanceData
+                  Returns the packed instance data
+                GetPaletteShaderResourceView
+                  Returns the view of the palette buffer
+                GetInstanceBuffer
+                  Returns the instance buffer
+                GetLastUploadSize
+                  Returns the bytes uploaded by the last Upload
+                GetTotalUploadSize
+                  Returns the bytes uploaded since Initialize
+                GetNumUploads
+                  Returns the number of buffer updates since Initialize
+                SkinnedCrowd
+                  Constructor.
+                ~SkinnedCrowd
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SkinnedCrowd
+    {
+    public:
+        SkinnedCrowd();
+        SkinnedCrowd(const SkinnedCrowd& other) = delete;
+        SkinnedCrowd(SkinnedCrowd&& other) = delete;
+        SkinnedCrowd& operator=(const SkinnedCrowd& other) = delete;
+        SkinnedCrowd& operator=(SkinnedCrowd&& other) = delete;
+        virtual ~SkinnedCrowd() = default;
+
+        HRESULT AddInstance(_In_ const std::shared_ptr<Model>& pModel);
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        void Update(_In_ FLOAT deltaTime);
+        void Pack();
+        HRESULT Upload(_In_ ID3D11DeviceContext* pImmediateContext);
+        HRESULT Upload(_In_ BufferUploader& uploader);
+
+        void SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader);
+        void SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader);
+        ComPtr<ID3D11VertexShader>& GetVertexShader();
+        ComPtr<ID3D11PixelShader>& GetPixelShader();
+        ComPtr<ID3D11InputLayout>& GetVertexLayout();
+
+        const std::shared_ptr<Model>& GetInstance(_In_ UINT uIndex) const;
+        UINT GetNumInstances() const;
+        UINT GetNumPaletteRowsPerInstance() const;
+        const std::vector<XMFLOAT4>& GetPalettes() const;
+        const std::vector<CrowdInstanceData>& GetInstanceData() const;
+        ComPtr<ID3D11ShaderResourceView>& GetPaletteShaderResourceView();
+        ComPtr<ID3D11Buffer>& GetInstanceBuffer();
+
+        UINT64 GetLastUploadSize() const;
+        UINT64 GetTotalUploadSize() const;
+        UINT GetNumUploads() const;
+
+    protected:
+        HRESULT uploadBuffer(_In_ BufferUploader& uploader, _In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize);
+
+    protected:
+        std::vector<std::shared_ptr<Model>> m_aInstances;
+        std::vector<XMFLOAT4> m_aPalettes;
+        std::vector<CrowdInstanceData> m_aInstanceData;
+
+        ComPtr<ID3D11Buffer> m_paletteBuffer;
+        ComPtr<ID3D11ShaderResourceView> m_paletteView;
+        ComPtr<ID3D11Buffer> m_instanceBuffer;
+
+        std::shared_ptr<VertexShader> m_vertexShader;
+        std::shared_ptr<PixelShader> m_pixelShader;
+
+        UINT m_uNumPaletteRowsPerInstance;
+        UINT64 m_uLastUploadSize;
+        UINT64 m_uTotalUploadSize;
+        UINT m_uNumUploads;
+    };
+}
@@ -26,6 +26,8 @@ namespace library
         m_scale(scale),
         Model("Content/Common/Sphere.obj")
     {
+        // The cube map replaces the sphere's material, so it cannot be shared
+        m_bUseAssetCache = FALSE;
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Skybox::Initialize
@@ -90,6 +92,7 @@ namespace library
     --------------------------------------------------------------------*/
     void Skybox::initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh) {
         const aiVector3D zero3d(0.0f, 0.0f, 0.0f);
+        const UINT uBaseVertex = m_aMeshes[uMeshIndex].uBaseVertex;
         for (UINT i = 0u; i < pMesh->mNumVertices; ++i)
         {
             const aiVector3D& position = pMesh->mVertices[i];
@@ -104,7 +107,7 @@ namespace library
                 .Normal = XMFLOAT3(normal.x, normal.y, normal.z)
             };
 
-            m_aVertices.push_back(vertex);
+            m_pAsset->aVertices[uBaseVertex + i] = vertex;
 
             NormalData normalData =
             {
@@ -112,18 +115,18 @@ namespace library
                 .Bitangent = XMFLOAT3(bitangent.x,bitangent.y,bitangent.z)
             };
 
-            m_aNormalData.push_back(normalData);
+            m_aNormalData[uBaseVertex + i] = normalData;
         }
 
+        UINT* aIndices = m_pAsset->aWideIndices.data() + m_aMeshes[uMeshIndex].uBaseIndex;
         for (UINT i = 0u; i < pMesh->mNumFaces; i++)
         {
             const aiFace& face = pMesh->mFaces[i];
             assert(face.mNumIndices == 3u);
 
-            m_aIndices.push_back(static_cast<WORD>(face.mIndices[2]));
-            m_aIndices.push_back(static_cast<WORD>(face.mIndices[1]));
-            m_aIndices.push_back(static_cast<WORD>(face.mIndices[0]));
+            aIndices[i * 3u] = face.mIndices[2];
+            aIndices[i * 3u + 1u] = face.mIndices[1];
+            aIndices[i * 3u + 2u] = face.mIndices[0];
         }
-        initMeshBones(uMeshIndex, pMesh);
     }
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "Renderer/TangentFrameGenerator.h"
+
+#include <execution>
+#include <numeric>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TangentFrameGenerator::Generate
+
+      Summary:  Computes the tangent and bitangent of every vertex of a
+                triangle list. The indices are relative to aVertices.
+                Faces with degenerate texture coordinates contribute
+                nothing, and a vertex without any contribution gets a
+                tangent orthogonal to its normal.
+
+      Args:     const SimpleVertex* aVertices
+                  Vertices of the triangle list
+                UINT uNumVertices
+                  Number of vertices
+                const void* pIndices
+                  Indices of the triangle list
+                DXGI_FORMAT indexFormat
+                  DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT
+                UINT uNumIndices
+                  Number of indices
+                NormalData* aOutNormalData
+                  Tangent frame of every vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TangentFrameGenerator::Generate(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_ UINT uNumVertices,
+        _In_ const void* pIndices,
+        _In_ DXGI_FORMAT indexFormat,
+        _In_ UINT uNumIndices,
+        _Out_writes_(uNumVertices) NormalData* aOutNormalData
+    )
+    {
+        const UINT uNumFaces = uNumIndices / 3u;
+        const UINT uNumCorners = uNumFaces * 3u;
+
+        // Each corner writes its own weighted contribution, so the blocks share nothing
+        std::vector<XMFLOAT3> aCornerTangents(uNumCorners);
+        std::vector<XMFLOAT3> aCornerBitangents(uNumCorners);
+
+        std::vector<UINT> aBlocks((uNumFaces + FACE_BLOCK_SIZE - 1u) / FACE_BLOCK_SIZE);
+        std::iota(aBlocks.begin(), aBlocks.end(), 0u);
+
+        std::for_each(std::execution::par, aBlocks.begin(), aBlocks.end(),
+            [&](UINT uBlock)
+            {
+                const UINT uEndFace = std::min(uNumFaces, (uBlock + 1u) * FACE_BLOCK_SIZE);
+                for (UINT uFace = uBlock * FACE_BLOCK_SIZE; uFace < uEndFace; ++uFace)
+                {
+                    const SimpleVertex* aFaceVertices[3] =
+                    {
+                        &aVertices[readIndex(pIndices, indexFormat, uFace * 3u)],
+                        &aVertices[readIndex(pIndices, indexFormat, uFace * 3u + 1u)],
+                        &aVertices[readIndex(pIndices, indexFormat, uFace * 3u + 2u)]
+                    };
+                    const XMVECTOR aPositions[3] =
+                    {
+                        XMLoadFloat3(&aFaceVertices[0]->Position),
+                        XMLoadFloat3(&aFaceVertices[1]->Position),
+                        XMLoadFloat3(&aFaceVertices[2]->Position)
+                    };
+
+                    const XMVECTOR edge1 = XMVectorSubtract(aPositions[1], aPositions[0]);
+                    const XMVECTOR edge2 = XMVectorSubtract(aPositions[2], aPositions[0]);
+                    const FLOAT du1 = aFaceVertices[1]->TexCoord.x - aFaceVertices[0]->TexCoord.x;
+                    const FLOAT dv1 = aFaceVertices[1]->TexCoord.y - aFaceVertices[0]->TexCoord.y;
+                    const FLOAT du2 = aFaceVertices[2]->TexCoord.x - aFaceVertices[0]->TexCoord.x;
+                    const FLOAT dv2 = aFaceVertices[2]->TexCoord.y - aFaceVertices[0]->TexCoord.y;
+
+                    const FLOAT determinant = du1 * dv2 - du2 * dv1;
+                    const FLOAT area = 0.5f * XMVectorGetX(XMVector3Length(XMVector3Cross(edge1, edge2)));
+                    if (fabsf(determinant) < 1e-12f || area <= 0.0f)
+                    {
+                        for (UINT k = 0u; k < 3u; ++k)
+                        {
+                            aCornerTangents[uFace * 3u + k] = XMFLOAT3(0.0f, 0.0f, 0.0f);
+                            aCornerBitangents[uFace * 3u + k] = XMFLOAT3(0.0f, 0.0f, 0.0f);
+                        }
+                        continue;
+                    }
+
+                    // Dividing by the determinant keeps the orientation of mirrored texture coordinates
+                    const XMVECTOR tangent = XMVector3Normalize(XMVectorScale(
+                        XMVectorSubtract(XMVectorScale(edge1, dv2), XMVectorScale(edge2, dv1)), 1.0f / determinant));
+                    const XMVECTOR bitangent = XMVector3Normalize(XMVectorScale(
+                        XMVectorSubtract(XMVectorScale(edge2, du1), XMVectorScale(edge1, du2)), 1.0f / determinant));
+
+                    for (UINT k = 0u; k < 3u; ++k)
+                    {
+                        const XMVECTOR toNext = XMVector3Normalize(XMVectorSubtract(aPositions[(k + 1u) % 3u], aPositions[k]));
+                        const XMVECTOR toPrevious = XMVector3Normalize(XMVectorSubtract(aPositions[(k + 2u) % 3u], aPositions[k]));
+                        const FLOAT angle = acosf(std::clamp(XMVectorGetX(XMVector3Dot(toNext, toPrevious)), -1.0f, 1.0f));
+
+                        XMStoreFloat3(&aCornerTangents[uFace * 3u + k], XMVectorScale(tangent, area * angle));
+                        XMStoreFloat3(&aCornerBitangents[uFace * 3u + k], XMVectorScale(bitangent, area * angle));
+                    }
+                }
+            }
+        );
+
+        // Corners of every vertex in index buffer order
+        std::vector<UINT> aFirstCorners(uNumVertices + 1u, 0u);
+        for (UINT i = 0u; i < uNumCorners; ++i)
+        {
+            ++aFirstCorners[readIndex(pIndices, indexFormat, i) + 1u];
+        }
+        std::partial_sum(aFirstCorners.begin(), aFirstCorners.end(), aFirstCorners.begin());
+
+        std::vector<UINT> aVertexCorners(uNumCorners);
+        std::vector<UINT> aNextCorners(aFirstCorners.begin(), aFirstCorners.end() - 1);
+        for (UINT i = 0u; i < uNumCorners; ++i)
+        {
+            aVertexCorners[aNextCorners[readIndex(pIndices, indexFormat, i)]++] = i;
+        }
+
+        std::vector<UINT> aVertexIndices(uNumVertices);
+        std::iota(aVertexIndices.begin(), aVertexIndices.end(), 0u);
+
+        std::for_each(std::execution::par, aVertexIndices.begin(), aVertexIndices.end(),
+            [&](UINT uVertex)
+            {
+                XMVECTOR tangentSum = XMVectorZero();
+                XMVECTOR bitangentSum = XMVectorZero();
+                for (UINT i = aFirstCorners[uVertex]; i < aFirstCorners[uVertex + 1u]; ++i)
+                {
+                    tangentSum = XMVectorAdd(tangentSum, XMLoadFloat3(&aCornerTangents[aVertexCorners[i]]));
+                    bitangentSum = XMVectorAdd(bitangentSum, XMLoadFloat3(&aCornerBitangents[aVertexCorners[i]]));
+                }
+
+                const XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&aVertices[uVertex].Normal));
+
+                // Gram-Schmidt against the normal
+                XMVECTOR tangent = XMVectorSubtract(tangentSum, XMVectorScale(normal, XMVectorGetX(XMVector3Dot(normal, tangentSum))));
+                if (XMVectorGetX(XMVector3LengthSq(tangent)) < 1e-12f)
+                {
+                    const XMVECTOR axis = fabsf(XMVectorGetX(normal)) < 0.9f ? XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+                    tangent = XMVector3Cross(axis, normal);
+                }
+                tangent = XMVector3Normalize(tangent);
+
+                const XMVECTOR crossed = XMVector3Cross(normal, tangent);
+                const FLOAT handedness = XMVectorGetX(XMVector3Dot(crossed, bitangentSum)) < 0.0f ? -1.0f : 1.0f;
+
+                XMStoreFloat3(&aOutNormalData[uVertex].Tangent, tangent);
+                XMStoreFloat3(&aOutNormalData[uVertex].Bitangent, XMVectorScale(crossed, handedness));
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TangentFrameGenerator::Compare
+
+      Summary:  Measures the angle between the generated and the
+                reference tangents and counts the vertices whose
+                bitangents point to opposite sides
+
+      Args:     const NormalData* aReference
+                  Reference tangent frames, like those of the import
+                const NormalData* aNormalData
+                  Generated tangent frames
+                UINT uNumVertices
+                  Number of vertices
+
+      Returns:  TangentFrameError
+                  Difference over the vertices with a reference tangent
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TangentFrameError TangentFrameGenerator::Compare(
+        _In_reads_(uNumVertices) const NormalData* aReference,
+        _In_reads_(uNumVertices) const NormalData* aNormalData,
+        _In_ UINT uNumVertices
+    )
+    {
+        TangentFrameError error =
+        {
+            .maxTangentAngle = 0.0f,
+            .meanTangentAngle = 0.0f,
+            .uNumFlippedVertices = 0u,
+            .uNumVertices = 0u
+        };
+
+        DOUBLE angleSum = 0.0;
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            const XMVECTOR referenceTangent = XMLoadFloat3(&aReference[i].Tangent);
+            if (XMVectorGetX(XMVector3LengthSq(referenceTangent)) < 1e-12f)
+            {
+                continue;
+            }
+
+            const FLOAT cosAngle = XMVectorGetX(XMVector3Dot(XMVector3Normalize(referenceTangent), XMVector3Normalize(XMLoadFloat3(&aNormalData[i].Tangent))));
+            const FLOAT angle = XMConvertToDegrees(acosf(std::clamp(cosAngle, -1.0f, 1.0f)));
+
+            error.maxTangentAngle = std::max(error.maxTangentAngle, angle);
+            angleSum += angle;
+            ++error.uNumVertices;
+
+            if (XMVectorGetX(XMVector3Dot(XMLoadFloat3(&aReference[i].Bitangent), XMLoadFloat3(&aNormalData[i].Bitangent))) < 0.0f)
+            {
+                ++error.uNumFlippedVertices;
+            }
+        }
+
+        if (error.uNumVertices > 0u)
+        {
+            error.meanTangentAngle = static_cast<FLOAT>(angleSum / error.uNumVertices);
+        }
+
+        return error;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TangentFrameGenerator::readIndex
+
+      Summary:  Returns an index read with the index format
+
+      Args:     const void* pIndices
+                  Indices of the triangle list
+                DXGI_FORMAT indexFormat
+                  DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT
+                UINT uIndex
+                  Position of the index
+
+      Returns:  UINT
+                  Vertex index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TangentFrameGenerator::readIndex(_In_ const void* pIndices, _In_ DXGI_FORMAT indexFormat, _In_ UINT uIndex)
+    {
+        if (indexFormat == DXGI_FORMAT_R32_UINT)
+        {
+            return static_cast<const UINT*>(pIndices)[uIndex];
+        }
+
+        return static_cast<const WORD*>(pIndices)[uIndex];
+    }
+}
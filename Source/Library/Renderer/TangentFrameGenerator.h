@@ -0,0 +1,88 @@
+/*+===================================================================
+  File:      TANGENTFRAMEGENERATOR.H
+
+  Summary:   TangentFrameGenerator header file contains declaration of
+             class TangentFrameGenerator used to compute the tangent
+             and bitangent of every vertex of a triangle list, and to
+             compare them with tangent frames from another source.
+
+  Classes:  TangentFrameGenerator
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TangentFrameError
+
+      Summary:  Difference between generated tangent frames and the
+                reference frames of the same vertices. Angles are in
+                degrees. Vertices whose reference tangent is zero are
+                not compared.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TangentFrameError
+    {
+        FLOAT maxTangentAngle;
+        FLOAT meanTangentAngle;
+        UINT uNumFlippedVertices;
+        UINT uNumVertices;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TangentFrameGenerator
+
+      Summary:  Computes tangent frames by accumulating the tangent and
+                bitangent of every face into its three vertices,
+                weighted by the area of the face and the angle of the
+                face at the vertex. The accumulated tangent is then made
+                orthogonal to the vertex normal, and the bitangent is
+                the cross product of both, signed by the accumulated
+                bitangent so mirrored texture coordinates keep their
+                handedness. Faces are processed in parallel in blocks of
+                FACE_BLOCK_SIZE, each corner writing its own
+                contribution, and every vertex sums its contributions in
+                index buffer order, so the result does not depend on
+                the number of threads.
+
+      Methods:  Generate
+                  Computes the tangent frames of a triangle list
+                Compare
+                  Measures the difference between two tangent frames
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TangentFrameGenerator
+    {
+    public:
+        // Faces handled by one parallel task
+        static constexpr const UINT FACE_BLOCK_SIZE = 4096u;
+
+    public:
+        TangentFrameGenerator() = delete;
+        TangentFrameGenerator(const TangentFrameGenerator& other) = delete;
+        TangentFrameGenerator(TangentFrameGenerator&& other) = delete;
+        TangentFrameGenerator& operator=(const TangentFrameGenerator& other) = delete;
+        TangentFrameGenerator& operator=(TangentFrameGenerator&& other) = delete;
+        ~TangentFrameGenerator() = delete;
+
+        static void Generate(
+            _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+            _In_ UINT uNumVertices,
+            _In_ const void* pIndices,
+            _In_ DXGI_FORMAT indexFormat,
+            _In_ UINT uNumIndices,
+            _Out_writes_(uNumVertices) NormalData* aOutNormalData
+        );
+        static TangentFrameError Compare(
+            _In_reads_(uNumVertices) const NormalData* aReference,
+            _In_reads_(uNumVertices) const NormalData* aNormalData,
+            _In_ UINT uNumVertices
+        );
+
+    private:
+        static UINT readIndex(_In_ const void* pIndices, _In_ DXGI_FORMAT indexFormat, _In_ UINT uIndex);
+    };
+}
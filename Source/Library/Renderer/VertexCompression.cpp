@@ -0,0 +1,411 @@
+#include "Renderer/VertexCompression.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::PackVertex
+
+      Summary:  Packs the position, texture coordinate and normal of a
+                vertex
+
+      Args:     const SimpleVertex& vertex
+                  Full precision vertex
+
+      Returns:  PackedVertex
+                  Vertex with half float texture coordinates and an
+                  octahedral encoded normal
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PackedVertex VertexCompression::PackVertex(_In_ const SimpleVertex& vertex)
+    {
+        PackedVertex packed =
+        {
+            .Position = vertex.Position,
+            .TexCoord = XMHALF2(),
+            .Normal = encodeOctahedral(vertex.Normal)
+        };
+        packed.TexCoord.x = XMConvertFloatToHalf(vertex.TexCoord.x);
+        packed.TexCoord.y = XMConvertFloatToHalf(vertex.TexCoord.y);
+
+        return packed;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::PackNormalData
+
+      Summary:  Packs the tangent frame of a vertex as an octahedral
+                encoded tangent in x and y, and the sign of the
+                bitangent relative to cross(normal, tangent) in z
+
+      Args:     const SimpleVertex& vertex
+                  Vertex holding the normal
+                const NormalData& normalData
+                  Tangent and bitangent of the vertex
+
+      Returns:  PackedNormalData
+                  Packed tangent frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PackedNormalData VertexCompression::PackNormalData(_In_ const SimpleVertex& vertex, _In_ const NormalData& normalData)
+    {
+        const XMSHORTN2 tangent = encodeOctahedral(normalData.Tangent);
+
+        const XMVECTOR crossNormalTangent = XMVector3Cross(XMLoadFloat3(&vertex.Normal), XMLoadFloat3(&normalData.Tangent));
+        const FLOAT handedness = XMVectorGetX(XMVector3Dot(crossNormalTangent, XMLoadFloat3(&normalData.Bitangent)));
+
+        PackedNormalData packed = {};
+        packed.TangentFrame.x = tangent.x;
+        packed.TangentFrame.y = tangent.y;
+        packed.TangentFrame.z = handedness < 0.0f ? -32767 : 32767;
+        packed.TangentFrame.w = 0;
+
+        return packed;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::PackAnimationData
+
+      Summary:  Packs the bone indices into UINT8 and the bone weights
+                into UNORM8. When the weights sum to one the rounding
+                error is given to the largest weight, so the packed
+                weights also sum to one.
+
+      Args:     const AnimationData& animationData
+                  Bone indices and weights, indices below 256
+
+      Returns:  PackedAnimationData
+                  Packed bone indices and weights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PackedAnimationData VertexCompression::PackAnimationData(_In_ const AnimationData& animationData)
+    {
+        assert(CanPackAnimationData(animationData));
+
+        const FLOAT aWeights[4] =
+        {
+            animationData.aBoneWeights.x,
+            animationData.aBoneWeights.y,
+            animationData.aBoneWeights.z,
+            animationData.aBoneWeights.w,
+        };
+
+        INT aQuantizedWeights[4] = { 0, };
+        INT iSum = 0;
+        FLOAT totalWeight = 0.0f;
+        UINT uLargest = 0u;
+        for (UINT k = 0u; k < 4u; ++k)
+        {
+            aQuantizedWeights[k] = static_cast<INT>(lroundf(std::clamp(aWeights[k], 0.0f, 1.0f) * 255.0f));
+            iSum += aQuantizedWeights[k];
+            totalWeight += aWeights[k];
+            if (aWeights[k] > aWeights[uLargest])
+            {
+                uLargest = k;
+            }
+        }
+
+        if (fabsf(totalWeight - 1.0f) < 0.01f)
+        {
+            aQuantizedWeights[uLargest] = std::clamp(aQuantizedWeights[uLargest] + 255 - iSum, 0, 255);
+        }
+
+        PackedAnimationData packed = {};
+        packed.aBoneIndices.x = static_cast<UINT8>(animationData.aBoneIndices.x);
+        packed.aBoneIndices.y = static_cast<UINT8>(animationData.aBoneIndices.y);
+        packed.aBoneIndices.z = static_cast<UINT8>(animationData.aBoneIndices.z);
+        packed.aBoneIndices.w = static_cast<UINT8>(animationData.aBoneIndices.w);
+        packed.aBoneWeights.x = static_cast<UINT8>(aQuantizedWeights[0]);
+        packed.aBoneWeights.y = static_cast<UINT8>(aQuantizedWeights[1]);
+        packed.aBoneWeights.z = static_cast<UINT8>(aQuantizedWeights[2]);
+        packed.aBoneWeights.w = static_cast<UINT8>(aQuantizedWeights[3]);
+
+        return packed;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::CanPackAnimationData
+
+      Summary:  Returns whether every bone index fits in UINT8
+
+      Args:     const AnimationData& animationData
+                  Bone indices and weights
+
+      Returns:  BOOL
+                  TRUE if PackAnimationData keeps the bone indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VertexCompression::CanPackAnimationData(_In_ const AnimationData& animationData)
+    {
+        return animationData.aBoneIndices.x <= UINT8_MAX
+            && animationData.aBoneIndices.y <= UINT8_MAX
+            && animationData.aBoneIndices.z <= UINT8_MAX
+            && animationData.aBoneIndices.w <= UINT8_MAX;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::UnpackVertex
+
+      Summary:  Decodes a packed vertex the same way the vertex shaders
+                do
+
+      Args:     const PackedVertex& vertex
+                  Packed vertex
+
+      Returns:  SimpleVertex
+                  Decoded vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SimpleVertex VertexCompression::UnpackVertex(_In_ const PackedVertex& vertex)
+    {
+        return SimpleVertex
+        {
+            .Position = vertex.Position,
+            .TexCoord = XMFLOAT2(XMConvertHalfToFloat(vertex.TexCoord.x), XMConvertHalfToFloat(vertex.TexCoord.y)),
+            .Normal = decodeOctahedral(
+                std::max(static_cast<FLOAT>(vertex.Normal.x) / 32767.0f, -1.0f),
+                std::max(static_cast<FLOAT>(vertex.Normal.y) / 32767.0f, -1.0f)
+            )
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::UnpackNormalData
+
+      Summary:  Decodes a packed tangent frame. The bitangent is rebuilt
+                from the decoded normal and tangent.
+
+      Args:     const PackedVertex& vertex
+                  Packed vertex holding the normal
+                const PackedNormalData& normalData
+                  Packed tangent frame
+
+      Returns:  NormalData
+                  Decoded tangent and bitangent
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    NormalData VertexCompression::UnpackNormalData(_In_ const PackedVertex& vertex, _In_ const PackedNormalData& normalData)
+    {
+        const XMFLOAT3 normal = UnpackVertex(vertex).Normal;
+        const XMFLOAT3 tangent = decodeOctahedral(
+            std::max(static_cast<FLOAT>(normalData.TangentFrame.x) / 32767.0f, -1.0f),
+            std::max(static_cast<FLOAT>(normalData.TangentFrame.y) / 32767.0f, -1.0f)
+        );
+        const FLOAT handedness = normalData.TangentFrame.z < 0 ? -1.0f : 1.0f;
+
+        NormalData unpacked =
+        {
+            .Tangent = tangent,
+            .Bitangent = XMFLOAT3(0.0f, 0.0f, 0.0f)
+        };
+        XMStoreFloat3(&unpacked.Bitangent, XMVectorScale(XMVector3Cross(XMLoadFloat3(&normal), XMLoadFloat3(&tangent)), handedness));
+
+        return unpacked;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::UnpackAnimationData
+
+      Summary:  Decodes packed bone indices and weights
+
+      Args:     const PackedAnimationData& animationData
+                  Packed bone indices and weights
+
+      Returns:  AnimationData
+                  Decoded bone indices and weights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AnimationData VertexCompression::UnpackAnimationData(_In_ const PackedAnimationData& animationData)
+    {
+        return AnimationData
+        {
+            .aBoneIndices = XMUINT4(
+                animationData.aBoneIndices.x,
+                animationData.aBoneIndices.y,
+                animationData.aBoneIndices.z,
+                animationData.aBoneIndices.w
+            ),
+            .aBoneWeights = XMFLOAT4(
+                static_cast<FLOAT>(animationData.aBoneWeights.x) / 255.0f,
+                static_cast<FLOAT>(animationData.aBoneWeights.y) / 255.0f,
+                static_cast<FLOAT>(animationData.aBoneWeights.z) / 255.0f,
+                static_cast<FLOAT>(animationData.aBoneWeights.w) / 255.0f
+            )
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::MeasureError
+
+      Summary:  Packs and unpacks every vertex and records the largest
+                difference to the full precision data
+
+      Args:     const SimpleVertex* aVertices
+                  Full precision vertices
+                const NormalData* aNormalData
+                  Tangent frames of the vertices, or nullptr
+                const AnimationData* aAnimationData
+                  Bone indices and weights of the vertices, or nullptr
+                UINT uNumVertices
+                  Number of vertices
+
+      Returns:  VertexQuantizationError
+                  Largest error of each component
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VertexQuantizationError VertexCompression::MeasureError(
+        _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+        _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+        _In_reads_opt_(uNumVertices) const AnimationData* aAnimationData,
+        _In_ UINT uNumVertices
+    )
+    {
+        VertexQuantizationError error =
+        {
+            .maxTexCoordError = 0.0f,
+            .maxNormalAngle = 0.0f,
+            .maxTangentAngle = 0.0f,
+            .maxBitangentAngle = 0.0f,
+            .maxBoneWeightError = 0.0f,
+            .uNumVertices = uNumVertices
+        };
+
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            const PackedVertex packedVertex = PackVertex(aVertices[i]);
+            const SimpleVertex vertex = UnpackVertex(packedVertex);
+
+            error.maxTexCoordError = std::max(error.maxTexCoordError, fabsf(vertex.TexCoord.x - aVertices[i].TexCoord.x));
+            error.maxTexCoordError = std::max(error.maxTexCoordError, fabsf(vertex.TexCoord.y - aVertices[i].TexCoord.y));
+            error.maxNormalAngle = std::max(error.maxNormalAngle, computeAngle(aVertices[i].Normal, vertex.Normal));
+
+            if (aNormalData)
+            {
+                const NormalData normalData = UnpackNormalData(packedVertex, PackNormalData(aVertices[i], aNormalData[i]));
+
+                error.maxTangentAngle = std::max(error.maxTangentAngle, computeAngle(aNormalData[i].Tangent, normalData.Tangent));
+                error.maxBitangentAngle = std::max(error.maxBitangentAngle, computeAngle(aNormalData[i].Bitangent, normalData.Bitangent));
+            }
+
+            if (aAnimationData && CanPackAnimationData(aAnimationData[i]))
+            {
+                const AnimationData animationData = UnpackAnimationData(PackAnimationData(aAnimationData[i]));
+
+                error.maxBoneWeightError = std::max(error.maxBoneWeightError, fabsf(animationData.aBoneWeights.x - aAnimationData[i].aBoneWeights.x));
+                error.maxBoneWeightError = std::max(error.maxBoneWeightError, fabsf(animationData.aBoneWeights.y - aAnimationData[i].aBoneWeights.y));
+                error.maxBoneWeightError = std::max(error.maxBoneWeightError, fabsf(animationData.aBoneWeights.z - aAnimationData[i].aBoneWeights.z));
+                error.maxBoneWeightError = std::max(error.maxBoneWeightError, fabsf(animationData.aBoneWeights.w - aAnimationData[i].aBoneWeights.w));
+            }
+        }
+
+        return error;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::ReportError
+
+      Summary:  Writes a measured quantization error to the debug output
+
+      Args:     PCSTR pszName
+                  Name of the packed vertices
+                const VertexQuantizationError& error
+                  Error returned by MeasureError
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VertexCompression::ReportError(_In_ PCSTR pszName, _In_ const VertexQuantizationError& error)
+    {
+        CHAR szDebugMessage[512];
+        sprintf_s(szDebugMessage,
+            "Packed %u vertices of %s: texcoord %.6f, normal %.3f deg, tangent %.3f deg, bitangent %.3f deg, bone weight %.4f\n",
+            error.uNumVertices,
+            pszName,
+            error.maxTexCoordError,
+            error.maxNormalAngle,
+            error.maxTangentAngle,
+            error.maxBitangentAngle,
+            error.maxBoneWeightError);
+        OutputDebugStringA(szDebugMessage);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::encodeOctahedral
+
+      Summary:  Projects a direction on the octahedron |x|+|y|+|z| = 1
+                and unfolds the lower half over the diagonals, so the
+                direction is stored in two SNORM16 values
+
+      Args:     const XMFLOAT3& direction
+                  Direction to encode, a zero vector encodes as +z
+
+      Returns:  XMSHORTN2
+                  Encoded direction
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMSHORTN2 VertexCompression::encodeOctahedral(_In_ const XMFLOAT3& direction)
+    {
+        XMSHORTN2 encoded = {};
+
+        const FLOAT length = fabsf(direction.x) + fabsf(direction.y) + fabsf(direction.z);
+        if (length <= 0.0f)
+        {
+            return encoded;
+        }
+
+        FLOAT x = direction.x / length;
+        FLOAT y = direction.y / length;
+        if (direction.z < 0.0f)
+        {
+            const FLOAT foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            y = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldedX;
+        }
+
+        encoded.x = static_cast<INT16>(lroundf(std::clamp(x, -1.0f, 1.0f) * 32767.0f));
+        encoded.y = static_cast<INT16>(lroundf(std::clamp(y, -1.0f, 1.0f) * 32767.0f));
+
+        return encoded;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::decodeOctahedral
+
+      Summary:  Inverse of encodeOctahedral, as in DecodeOctahedral of
+                the shaders
+
+      Args:     FLOAT x
+                  First encoded value in [-1, 1]
+                FLOAT y
+                  Second encoded value in [-1, 1]
+
+      Returns:  XMFLOAT3
+                  Normalized direction
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMFLOAT3 VertexCompression::decodeOctahedral(_In_ FLOAT x, _In_ FLOAT y)
+    {
+        XMFLOAT3 direction(x, y, 1.0f - fabsf(x) - fabsf(y));
+
+        const FLOAT fold = std::max(-direction.z, 0.0f);
+        direction.x += direction.x >= 0.0f ? -fold : fold;
+        direction.y += direction.y >= 0.0f ? -fold : fold;
+
+        XMStoreFloat3(&direction, XMVector3Normalize(XMLoadFloat3(&direction)));
+
+        return direction;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::computeAngle
+
+      Summary:  Returns the angle between a direction and its decoded
+                form
+
+      Args:     const XMFLOAT3& original
+                  Full precision direction, not necessarily normalized
+                const XMFLOAT3& decoded
+                  Decoded direction
+
+      Returns:  FLOAT
+                  Angle in degrees, 0 if the original is a zero vector
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT VertexCompression::computeAngle(_In_ const XMFLOAT3& original, _In_ const XMFLOAT3& decoded)
+    {
+        const XMVECTOR originalVector = XMLoadFloat3(&original);
+        if (XMVectorGetX(XMVector3LengthSq(originalVector)) <= 0.0f)
+        {
+            return 0.0f;
+        }
+
+        const FLOAT cosine = XMVectorGetX(XMVector3Dot(XMVector3Normalize(originalVector), XMVector3Normalize(XMLoadFloat3(&decoded))));
+
+        return XMConvertToDegrees(acosf(std::clamp(cosine, -1.0f, 1.0f)));
+    }
+}
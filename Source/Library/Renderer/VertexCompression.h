@@ -0,0 +1,99 @@
+/*+===================================================================
+  File:      VERTEXCOMPRESSION.H
+
+  Summary:   VertexCompression header file contains declaration of
+             class VertexCompression used to convert vertices between
+             the full precision and the packed vertex formats, and to
+             measure the error of the conversion.
+
+  Classes:  VertexCompression
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VertexQuantizationError
+
+      Summary:  Largest difference between full precision vertices and
+                the same vertices packed and unpacked again. Angles are
+                in degrees.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VertexQuantizationError
+    {
+        FLOAT maxTexCoordError;
+        FLOAT maxNormalAngle;
+        FLOAT maxTangentAngle;
+        FLOAT maxBitangentAngle;
+        FLOAT maxBoneWeightError;
+        UINT uNumVertices;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VertexCompression
+
+      Summary:  Packs vertices for eVertexFormat::PACKED. Positions stay
+                full floats, texture coordinates become half floats,
+                normals and tangents are octahedral encoded in two
+                SNORM16 values, and the bitangent is reduced to the sign
+                of cross(normal, tangent). Bone indices become UINT8 and
+                bone weights UNORM8 that still sum to one. The shaders
+                decode the same encoding.
+
+      Methods:  PackVertex
+                  Packs the position, texture coordinate and normal
+                PackNormalData
+                  Packs the tangent frame
+                PackAnimationData
+                  Packs the bone indices and weights
+                CanPackAnimationData
+                  Returns whether the bone indices fit in UINT8
+                UnpackVertex
+                  Unpacks a PackVertex result
+                UnpackNormalData
+                  Unpacks a PackNormalData result
+                UnpackAnimationData
+                  Unpacks a PackAnimationData result
+                MeasureError
+                  Compares vertices with their packed form
+                ReportError
+                  Writes a measured error to the debug output
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VertexCompression
+    {
+    public:
+        VertexCompression() = delete;
+        VertexCompression(const VertexCompression& other) = delete;
+        VertexCompression(VertexCompression&& other) = delete;
+        VertexCompression& operator=(const VertexCompression& other) = delete;
+        VertexCompression& operator=(VertexCompression&& other) = delete;
+        ~VertexCompression() = delete;
+
+        static PackedVertex PackVertex(_In_ const SimpleVertex& vertex);
+        static PackedNormalData PackNormalData(_In_ const SimpleVertex& vertex, _In_ const NormalData& normalData);
+        static PackedAnimationData PackAnimationData(_In_ const AnimationData& animationData);
+        static BOOL CanPackAnimationData(_In_ const AnimationData& animationData);
+
+        static SimpleVertex UnpackVertex(_In_ const PackedVertex& vertex);
+        static NormalData UnpackNormalData(_In_ const PackedVertex& vertex, _In_ const PackedNormalData& normalData);
+        static AnimationData UnpackAnimationData(_In_ const PackedAnimationData& animationData);
+
+        static VertexQuantizationError MeasureError(
+            _In_reads_(uNumVertices) const SimpleVertex* aVertices,
+            _In_reads_opt_(uNumVertices) const NormalData* aNormalData,
+            _In_reads_opt_(uNumVertices) const AnimationData* aAnimationData,
+            _In_ UINT uNumVertices
+        );
+        static void ReportError(_In_ PCSTR pszName, _In_ const VertexQuantizationError& error);
+
+    private:
+        static XMSHORTN2 encodeOctahedral(_In_ const XMFLOAT3& direction);
+        static XMFLOAT3 decodeOctahedral(_In_ FLOAT x, _In_ FLOAT y);
+        static FLOAT computeAngle(_In_ const XMFLOAT3& original, _In_ const XMFLOAT3& decoded);
+    };
+}
@@ -0,0 +1,337 @@
+#include "Scene/HeightMap.h"
+
+#include <fstream>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::HeightMap
+
+      Summary:  Constructor
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMap::HeightMap()
+        : m_hFile(INVALID_HANDLE_VALUE)
+        , m_hMapping(nullptr)
+        , m_pView(nullptr)
+        , m_uSize(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::~HeightMap
+
+      Summary:  Destructor
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMap::~HeightMap()
+    {
+        Close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::Open
+
+      Summary:  Maps the height map file and checks that it was written
+                by this version, that the palette and the records lie
+                inside the file and that the records cover every column
+                of the map exactly once
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the height map file
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_uSize].
+
+      Returns:  HRESULT
+                  Status code, E_FAIL if the file is not a valid height
+                  map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::Open(_In_ const std::filesystem::path& filePath)
+    {
+        Close();
+
+        m_hFile = CreateFile(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(m_hFile, &fileSize) || static_cast<UINT64>(fileSize.QuadPart) < sizeof(HeightMapHeader))
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        m_hMapping = CreateFileMapping(m_hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_hMapping)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_pView = static_cast<const BYTE*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0u, 0u, 0u));
+        if (!m_pView)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_uSize = static_cast<UINT64>(fileSize.QuadPart);
+
+        const HeightMapHeader& header = GetHeader();
+        if (header.uMagic != MAGIC || header.uVersion != VERSION)
+        {
+            OutputDebugString(L"Height map \"");
+            OutputDebugString(filePath.c_str());
+            OutputDebugString(L"\" was written by another version\n");
+
+            Close();
+            return E_FAIL;
+        }
+
+        const BOOL bIsRunLengthEncoded = (header.uFlags & RUN_LENGTH_ENCODED) != 0u;
+        const UINT64 uRecordSize = bIsRunLengthEncoded ? sizeof(HeightMapRun) : sizeof(HeightMapColumn);
+        const UINT64 uNumColumns = static_cast<UINT64>(header.uWidth) * static_cast<UINT64>(header.uDepth);
+        const UINT64 uRequiredSize = sizeof(HeightMapHeader) + static_cast<UINT64>(header.uNumColors) * sizeof(XMFLOAT3)
+            + static_cast<UINT64>(header.uNumRecords) * uRecordSize;
+
+        BOOL bIsValid = uRequiredSize <= m_uSize;
+        if (bIsValid && bIsRunLengthEncoded)
+        {
+            const HeightMapRun* aRuns = reinterpret_cast<const HeightMapRun*>(getRecords());
+
+            UINT64 uNumRunColumns = 0u;
+            for (UINT i = 0u; i < header.uNumRecords; ++i)
+            {
+                uNumRunColumns += aRuns[i].uNumColumns;
+            }
+            bIsValid = uNumRunColumns == uNumColumns;
+        }
+        else if (bIsValid)
+        {
+            bIsValid = header.uNumRecords == uNumColumns;
+        }
+
+        if (!bIsValid)
+        {
+            OutputDebugString(L"Height map \"");
+            OutputDebugString(filePath.c_str());
+            OutputDebugString(L"\" is truncated\n");
+
+            Close();
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::Close
+
+      Summary:  Unmaps and closes the file. Colors and columns returned
+                before are no longer valid.
+
+      Modifies: [m_hFile, m_hMapping, m_pView, m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMap::Close()
+    {
+        if (m_pView)
+        {
+            UnmapViewOfFile(m_pView);
+            m_pView = nullptr;
+        }
+
+        if (m_hMapping)
+        {
+            CloseHandle(m_hMapping);
+            m_hMapping = nullptr;
+        }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+
+        m_uSize = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetHeader
+
+      Summary:  Returns the header of the open file
+
+      Returns:  const HeightMapHeader&
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const HeightMapHeader& HeightMap::GetHeader() const
+    {
+        assert(m_pView);
+
+        return *reinterpret_cast<const HeightMapHeader*>(m_pView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetColors
+
+      Summary:  Returns the color of every block type of the palette
+
+      Returns:  std::span<const XMFLOAT3>
+                  Colors pointing into the mapped file, empty if the
+                  file is not open
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::span<const XMFLOAT3> HeightMap::GetColors() const
+    {
+        if (!m_pView)
+        {
+            return std::span<const XMFLOAT3>();
+        }
+
+        return std::span<const XMFLOAT3>(reinterpret_cast<const XMFLOAT3*>(m_pView + sizeof(HeightMapHeader)), GetHeader().uNumColors);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetColumns
+
+      Summary:  Returns the column of every position of the map, row by
+                row. The columns of a run length encoded map are decoded
+                into aDecodedColumns, the others point into the mapped
+                file.
+
+      Args:     std::vector<HeightMapColumn>& aDecodedColumns
+                  Holds the decoded columns of a run length encoded map
+
+      Returns:  std::span<const HeightMapColumn>
+                  Width times depth columns, empty if the file is not
+                  open
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::span<const HeightMapColumn> HeightMap::GetColumns(_Inout_ std::vector<HeightMapColumn>& aDecodedColumns) const
+    {
+        if (!m_pView)
+        {
+            return std::span<const HeightMapColumn>();
+        }
+
+        const HeightMapHeader& header = GetHeader();
+        if ((header.uFlags & RUN_LENGTH_ENCODED) == 0u)
+        {
+            return std::span<const HeightMapColumn>(reinterpret_cast<const HeightMapColumn*>(getRecords()), header.uNumRecords);
+        }
+
+        const HeightMapRun* aRuns = reinterpret_cast<const HeightMapRun*>(getRecords());
+
+        aDecodedColumns.resize(static_cast<size_t>(header.uWidth) * static_cast<size_t>(header.uDepth));
+        auto itColumn = aDecodedColumns.begin();
+        for (UINT i = 0u; i < header.uNumRecords; ++i)
+        {
+            itColumn = std::fill_n(itColumn, aRuns[i].uNumColumns, aRuns[i].column);
+        }
+
+        return std::span<const HeightMapColumn>(aDecodedColumns);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::Save
+
+      Summary:  Writes a height map file
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the height map file
+                UINT uWidth
+                  Number of columns along x
+                UINT uHeight
+                  Largest number of voxels in a column
+                UINT uDepth
+                  Number of columns along z
+                const std::vector<XMFLOAT3>& aColors
+                  Color of every block type
+                const std::vector<HeightMapColumn>& aColumns
+                  Width times depth columns, row by row
+                BOOL bRunLengthEncode
+                  Whether equal consecutive columns are stored as runs
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::Save(
+        _In_ const std::filesystem::path& filePath,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ UINT uDepth,
+        _In_ const std::vector<XMFLOAT3>& aColors,
+        _In_ const std::vector<HeightMapColumn>& aColumns,
+        _In_ BOOL bRunLengthEncode
+    )
+    {
+        if (aColumns.size() != static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth))
+        {
+            return E_INVALIDARG;
+        }
+
+        std::vector<HeightMapRun> aRuns;
+        if (bRunLengthEncode)
+        {
+            for (const HeightMapColumn& column : aColumns)
+            {
+                if (!aRuns.empty() && aRuns.back().column.uType == column.uType && aRuns.back().column.uHeight == column.uHeight)
+                {
+                    ++aRuns.back().uNumColumns;
+                }
+                else
+                {
+                    aRuns.push_back({ .column = { .uType = column.uType, .uPadding = 0u, .uHeight = column.uHeight }, .uNumColumns = 1u });
+                }
+            }
+        }
+
+        HeightMapHeader header =
+        {
+            .uMagic = MAGIC,
+            .uVersion = VERSION,
+            .uFlags = bRunLengthEncode ? RUN_LENGTH_ENCODED : 0u,
+            .uWidth = uWidth,
+            .uHeight = uHeight,
+            .uDepth = uDepth,
+            .uNumColors = static_cast<UINT>(aColors.size()),
+            .uNumRecords = static_cast<UINT>(bRunLengthEncode ? aRuns.size() : aColumns.size())
+        };
+
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return E_ACCESSDENIED;
+        }
+
+        file.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const CHAR*>(aColors.data()), static_cast<std::streamsize>(sizeof(XMFLOAT3) * aColors.size()));
+        if (bRunLengthEncode)
+        {
+            file.write(reinterpret_cast<const CHAR*>(aRuns.data()), static_cast<std::streamsize>(sizeof(HeightMapRun) * aRuns.size()));
+        }
+        else
+        {
+            file.write(reinterpret_cast<const CHAR*>(aColumns.data()), static_cast<std::streamsize>(sizeof(HeightMapColumn) * aColumns.size()));
+        }
+
+        file.flush();
+
+        return file.good() ? S_OK : E_FAIL;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::getRecords
+
+      Summary:  Returns the columns or runs following the palette
+
+      Returns:  const BYTE*
+                  Start of the records in the mapped file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BYTE* HeightMap::getRecords() const
+    {
+        return m_pView + sizeof(HeightMapHeader) + static_cast<size_t>(GetHeader().uNumColors) * sizeof(XMFLOAT3);
+    }
+}
@@ -0,0 +1,133 @@
+/*+===================================================================
+  File:      HEIGHTMAP.H
+
+  Summary:   HeightMap header file contains declarations of the binary
+             height map format and of class HeightMap used to read and
+             write it. A height map holds the palette of the block types
+             and the block type and height of every column of a voxel
+             map.
+
+  Classes:  HeightMap
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <span>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   HeightMapColumn
+
+      Summary:  Block type of a column, as an index into the palette,
+                and the number of voxels stacked in it
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapColumn
+    {
+        BYTE uType;
+        BYTE uPadding;
+        WORD uHeight;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   HeightMapRun
+
+      Summary:  uNumColumns consecutive equal columns of a run length
+                encoded height map
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapRun
+    {
+        HeightMapColumn column;
+        UINT uNumColumns;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   HeightMapHeader
+
+      Summary:  Start of a height map file. It is followed by uNumColors
+                XMFLOAT3 colors, then by uNumRecords columns, or runs if
+                the map is run length encoded. Columns are stored row
+                by row, x first.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapHeader
+    {
+        UINT uMagic;
+        UINT uVersion;
+        UINT uFlags;
+        UINT uWidth;
+        UINT uHeight;
+        UINT uDepth;
+        UINT uNumColors;
+        UINT uNumRecords;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HeightMap
+
+      Summary:  Read only view of a height map file mapped in memory.
+                The columns of a map that is not run length encoded are
+                used in place.
+
+      Methods:  Open
+                  Maps a height map file and checks it
+                Close
+                  Unmaps the file
+                GetHeader
+                  Returns the header
+                GetColors
+                  Returns the palette
+                GetColumns
+                  Returns the column of every position of the map
+                Save
+                  Writes a height map file
+                HeightMap
+                  Constructor.
+                ~HeightMap
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class HeightMap
+    {
+    public:
+        static constexpr const UINT MAGIC = 0x50414D48u; // "HMAP"
+        // Increase when the layout of the header or of a record changes
+        static constexpr const UINT VERSION = 1u;
+        static constexpr const UINT RUN_LENGTH_ENCODED = 0x1u;
+
+    public:
+        HeightMap();
+        HeightMap(const HeightMap& other) = delete;
+        HeightMap(HeightMap&& other) = delete;
+        HeightMap& operator=(const HeightMap& other) = delete;
+        HeightMap& operator=(HeightMap&& other) = delete;
+        virtual ~HeightMap();
+
+        HRESULT Open(_In_ const std::filesystem::path& filePath);
+        void Close();
+
+        const HeightMapHeader& GetHeader() const;
+        std::span<const XMFLOAT3> GetColors() const;
+        std::span<const HeightMapColumn> GetColumns(_Inout_ std::vector<HeightMapColumn>& aDecodedColumns) const;
+
+        static HRESULT Save(
+            _In_ const std::filesystem::path& filePath,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ UINT uDepth,
+            _In_ const std::vector<XMFLOAT3>& aColors,
+            _In_ const std::vector<HeightMapColumn>& aColumns,
+            _In_ BOOL bRunLengthEncode
+        );
+
+    private:
+        const BYTE* getRecords() const;
+
+    private:
+        HANDLE m_hFile;
+        HANDLE m_hMapping;
+        const BYTE* m_pView;
+        UINT64 m_uSize;
+    };
+}
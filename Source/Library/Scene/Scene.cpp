@@ -1,6 +1,10 @@
-#include "Scene/Scene.h"
+﻿#include "Scene/Scene.h"
+
+#include <execution>
+#include <numeric>
 
 #include "Shader/SkyMapVertexShader.h"
+#include "Texture/TextureCache.h"
 
 namespace library
 {
@@ -28,138 +32,86 @@ namespace library
         : m_filePath(filePath)
         , m_voxels()
         , m_renderables()
+        , m_models()
+        , m_modelsToUpdate()
+        , m_crowds()
+        , m_instancedModels()
         , m_aPointLights{ nullptr }
         , m_vertexShaders()
         , m_pixelShaders()
         , m_skyBox()
+        , m_aPendingModels()
+        , m_aLoadedModels()
+        , m_loadedModelsMutex()
+        , m_uNumLoadedModels(0u)
+        , m_uNumFailedModels(0u)
+        , m_uNextPendingModel(0u)
+        , m_aLoaderThreads()
     {
-        std::ifstream inputFile;
-        inputFile.open(m_filePath.string());
-
-        std::string trash;
-        UINT aDimension[4] = { 0u, };
-        UINT uDimensionIdx = 0u;
-        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER readingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        HeightMap heightMap;
+        std::vector<XMFLOAT3> aTextColors;
+        std::vector<HeightMapColumn> aColumnStorage;
+        UINT uWidth = 0u;
+        UINT uHeight = 0u;
+        UINT uDepth = 0u;
+        std::span<const XMFLOAT3> aColors;
+        std::span<const HeightMapColumn> aColumns;
+
+        if (m_filePath.extension() == L".txt")
         {
-            inputFile >> aDimension[uDimensionIdx];
-
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else
-            {
-                ++uDimensionIdx;
-            }
+            readTextHeightMap(m_filePath, uWidth, uHeight, uDepth, aTextColors, aColumnStorage);
+            aColors = aTextColors;
+            aColumns = aColumnStorage;
         }
-
-        UINT uColorIdx = 0u;
-        XMFLOAT4 color;
-        while (!inputFile.eof() && uColorIdx < aDimension[3])
+        else if (SUCCEEDED(heightMap.Open(m_filePath)))
         {
-            inputFile >> color.x >> color.y >> color.z;
-
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else
-            {
-                color.w = 1.0f;
-                m_voxels.push_back(std::make_shared<Voxel>(color));
-                ++uColorIdx;
-            }
+            const HeightMapHeader& header = heightMap.GetHeader();
+            uWidth = header.uWidth;
+            uHeight = header.uHeight;
+            uDepth = header.uDepth;
+            aColors = heightMap.GetColors();
+            aColumns = heightMap.GetColumns(aColumnStorage);
         }
 
-        std::vector<std::vector<InstanceData>> aInstanceData;
-        aInstanceData.reserve(m_voxels.size());
-        for (UINT renderableIdx = 0u; renderableIdx < m_voxels.size(); ++renderableIdx)
-        {
-            aInstanceData.push_back(std::vector<InstanceData>());
-            aInstanceData.back().reserve(
-                static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[1]) * static_cast<size_t>(aDimension[2])
-            );
-        }
+        QueryPerformanceCounter(&readingTime);
 
-        UINT uDepthIdx = 0u;
-        UINT uWidthIdx = 0u;
-        CHAR voxelType;
-        FLOAT height;
-        while (!inputFile.eof())
-        {
-            inputFile >> voxelType >> height;
+        initVoxels(uWidth, uHeight, uDepth, aColors, aColumns);
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
-            {
-                for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
-                {
-                    aInstanceData[static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND)].push_back(
-                        InstanceData
-                        {
-                            .Transformation = XMMatrixTranslation(
-                                2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
-                                2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
-                                2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
-                                )
-                        }
-                    );
-                }
-                ++uWidthIdx;
-                if (uWidthIdx >= aDimension[0])
-                {
-                    uWidthIdx -= aDimension[0];
-                    ++uDepthIdx;
-
-                    if (uDepthIdx >= aDimension[2])
-                    {
-                        uDepthIdx -= aDimension[2];
-                    }
-                }
-            }
-        }
+        QueryPerformanceCounter(&endingTime);
 
-        inputFile.close();
-
-        UINT uVoxelIdx = 0u;
-        auto it = m_voxels.begin();
-        while (it != m_voxels.end())
+        UINT64 uNumInstances = 0u;
+        for (const std::shared_ptr<Voxel>& voxel : m_voxels)
         {
-            if (aInstanceData[uVoxelIdx].size() <= 0)
-            {
-                it = m_voxels.erase(it);
-            }
-            else
-            {
-                (*it)->SetInstanceData(std::move(aInstanceData[uVoxelIdx]));
-                ++it;
-            }
-            ++uVoxelIdx;
+            uNumInstances += voxel->GetNumInstances();
         }
+
+        CHAR szDebugMessage[256];
+        sprintf_s(szDebugMessage, "Height map %s: %u x %u columns (%llu bytes) read in %.3f ms, %llu instances (%llu bytes) generated in %.3f ms\n",
+            m_filePath.string().c_str(),
+            uWidth,
+            uDepth,
+            static_cast<UINT64>(aColumns.size_bytes()),
+            static_cast<DOUBLE>(readingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart),
+            uNumInstances,
+            uNumInstances * sizeof(InstanceData),
+            static_cast<DOUBLE>(endingTime.QuadPart - readingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart));
+        OutputDebugStringA(szDebugMessage);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::Initialize
-      Summary:  Initializes the voxels, shaders, renderables, models,
-                and skybox
+      Summary:  Initializes the voxels, shaders, renderables, materials
+                and skybox, and starts loading the models, crowds and
+                instanced models on up to MAX_NUM_LOADER_THREADS loader
+                threads so the rest of the scene can be drawn while they
+                stream in
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
@@ -203,37 +155,66 @@ namespace library
             }
         }
 
-        for (auto it = m_models.begin(); it != m_models.end(); ++it)
+        for (auto it = m_materials.begin(); it != m_materials.end(); ++it)
         {
             HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
             if (FAILED(hr))
             {
                 return hr;
             }
-
-            for (int i = 0; i < it->second->GetNumMaterials(); ++i)
-            {
-                AddMaterial(it->second->GetMaterial(i));
-            }
         }
 
-        for (auto it = m_materials.begin(); it != m_materials.end(); ++it)
+        if (m_skyBox)
         {
-            HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
+            HRESULT hr = m_skyBox->Initialize(pDevice, pImmediateContext);
+
             if (FAILED(hr))
             {
                 return hr;
             }
         }
 
-        if (m_skyBox)
+        m_aPendingModels.clear();
+        for (auto it = m_models.begin(); it != m_models.end(); ++it)
         {
-            HRESULT hr = m_skyBox->Initialize(pDevice, pImmediateContext);
+            m_aPendingModels.push_back({ .pModel = it->second, .pCrowd = nullptr, .pInstancedModel = nullptr, .commandList = nullptr });
+        }
+        for (auto it = m_crowds.begin(); it != m_crowds.end(); ++it)
+        {
+            if (it->second->GetNumInstances() == 0u)
+            {
+                return E_FAIL;
+            }
 
-            if (FAILED(hr))
+            m_aPendingModels.push_back({ .pModel = it->second->GetInstance(0u), .pCrowd = it->second, .pInstancedModel = nullptr, .commandList = nullptr });
+        }
+        for (auto it = m_instancedModels.begin(); it != m_instancedModels.end(); ++it)
+        {
+            if (!it->second->GetModel())
             {
-                return hr;
+                return E_FAIL;
             }
+
+            m_aPendingModels.push_back({ .pModel = it->second->GetModel(), .pCrowd = nullptr, .pInstancedModel = it->second, .commandList = nullptr });
+        }
+
+        const UINT uNumLoaderThreads = std::min({
+            MAX_NUM_LOADER_THREADS,
+            std::max(std::thread::hardware_concurrency(), 1u),
+            static_cast<UINT>(m_aPendingModels.size())
+        });
+
+        ComPtr<ID3D11Device> device(pDevice);
+        m_uNextPendingModel = 0u;
+        m_aLoaderThreads.clear();
+        for (UINT i = 0u; i < uNumLoaderThreads; ++i)
+        {
+            m_aLoaderThreads.emplace_back(
+                [this, device](std::stop_token stopToken)
+                {
+                    loadModels(stopToken, device.Get());
+                }
+            );
         }
 
         return S_OK;
@@ -285,7 +266,7 @@ namespace library
                   Key of the renderable object
                 const std::shared_ptr<Model>& model
                   Shared pointer to the model object
-      Modifies: [m_models].
+      Modifies: [m_models, m_modelsToUpdate].
       Returns:  HRESULT
                   Status code.
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -297,6 +278,53 @@ namespace library
         }
 
         m_models[pszModelName] = pModel;
+        m_modelsToUpdate.push_back(pModel);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::AddCrowd
+      Summary:  Add a crowd of models drawn with instancing
+      Args:     PCWSTR pszCrowdName
+                  Key of the crowd
+                const std::shared_ptr<SkinnedCrowd>& pCrowd
+                  Shared pointer to the crowd
+      Modifies: [m_crowds].
+      Returns:  HRESULT
+                  Status code.
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::AddCrowd(_In_ PCWSTR pszCrowdName, _In_ const std::shared_ptr<SkinnedCrowd>& pCrowd)
+    {
+        if (m_crowds.contains(pszCrowdName))
+        {
+            return E_FAIL;
+        }
+
+        m_crowds[pszCrowdName] = pCrowd;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::AddInstancedModel
+      Summary:  Add a static model drawn at many places with instancing
+      Args:     PCWSTR pszInstancedModelName
+                  Key of the instanced model
+                const std::shared_ptr<InstancedModel>& pInstancedModel
+                  Shared pointer to the instanced model
+      Modifies: [m_instancedModels].
+      Returns:  HRESULT
+                  Status code.
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::AddInstancedModel(_In_ PCWSTR pszInstancedModelName, _In_ const std::shared_ptr<InstancedModel>& pInstancedModel)
+    {
+        if (m_instancedModels.contains(pszInstancedModelName))
+        {
+            return E_FAIL;
+        }
+
+        m_instancedModels[pszInstancedModelName] = pInstancedModel;
 
         return S_OK;
     }
@@ -408,8 +436,10 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::Update
-      Summary:  Update the renderables, models, point lights, skybox
-                each frame
+      Summary:  Update the renderables, models, crowds, point lights,
+                skybox each frame. Models only touch their own animation
+                state, so they are updated in parallel and all of them
+                are done before this returns.
       Args:     FLOAT deltaTime
                   Time difference of a frame
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -420,9 +450,22 @@ namespace library
             it->second->Update(deltaTime);
         }
 
-        for (auto it = m_models.begin(); it != m_models.end(); ++it)
+        std::for_each(std::execution::par, m_modelsToUpdate.begin(), m_modelsToUpdate.end(),
+            [deltaTime](const std::shared_ptr<Model>& pModel)
+            {
+                if (pModel->IsLoaded())
+                {
+                    pModel->Update(deltaTime);
+                }
+            }
+        );
+
+        for (auto it = m_crowds.begin(); it != m_crowds.end(); ++it)
         {
-            it->second->Update(deltaTime);
+            if (it->second->GetInstance(0u)->IsLoaded())
+            {
+                it->second->Update(deltaTime);
+            }
         }
 
         for (UINT lightIdx = 0; lightIdx < NUM_LIGHTS; ++lightIdx)
@@ -433,6 +476,113 @@ namespace library
         m_skyBox->Update(deltaTime);
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::UploadLoadedModels
+      Summary:  Executes the commands recorded while loading the models
+                and crowds the loader threads have finished, adds their
+                materials and marks them loaded so they are drawn from
+                now on. Reports the texture cache once the last model is
+                uploaded. Must be called on the render thread.
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to execute the commands
+      Modifies: [m_aLoadedModels, m_materials, m_uNumLoadedModels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::UploadLoadedModels(_In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        std::vector<PendingModel> aLoadedModels;
+        {
+            std::lock_guard<std::mutex> lock(m_loadedModelsMutex);
+            aLoadedModels.swap(m_aLoadedModels);
+        }
+
+        for (PendingModel& loadedModel : aLoadedModels)
+        {
+            pImmediateContext->ExecuteCommandList(loadedModel.commandList.Get(), TRUE);
+
+            for (UINT i = 0u; i < loadedModel.pModel->GetNumMaterials(); ++i)
+            {
+                AddMaterial(loadedModel.pModel->GetMaterial(i));
+            }
+
+            if (loadedModel.pCrowd)
+            {
+                for (UINT i = 0u; i < loadedModel.pCrowd->GetNumInstances(); ++i)
+                {
+                    loadedModel.pCrowd->GetInstance(i)->SetLoaded(TRUE);
+                }
+            }
+            else
+            {
+                loadedModel.pModel->SetLoaded(TRUE);
+            }
+
+            ++m_uNumLoadedModels;
+        }
+
+        if (!aLoadedModels.empty())
+        {
+            CHAR szDebugMessage[256];
+            sprintf_s(szDebugMessage, "Loaded %u of %u models of %s\n",
+                GetNumLoadedModels(),
+                GetNumModelsToLoad(),
+                m_filePath.string().c_str());
+            OutputDebugStringA(szDebugMessage);
+
+            // Every texture of the scene is loaded once the last model is
+            if (!IsLoading())
+            {
+                TextureCache::Report();
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetNumModelsToLoad
+      Summary:  Returns the number of models and crowds loaded on the
+                loader threads, a crowd counting as one
+      Returns:  UINT
+                  Number of models and crowds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Scene::GetNumModelsToLoad() const
+    {
+        return static_cast<UINT>(m_aPendingModels.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetNumLoadedModels
+      Summary:  Returns the number of models and crowds that are drawn
+      Returns:  UINT
+                  Number of loaded models and crowds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Scene::GetNumLoadedModels() const
+    {
+        return m_uNumLoadedModels.load();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetNumFailedModels
+      Summary:  Returns the number of models and crowds that could not
+                be loaded and are never drawn
+      Returns:  UINT
+                  Number of failed models and crowds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Scene::GetNumFailedModels() const
+    {
+        return m_uNumFailedModels.load();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::IsLoading
+      Summary:  Returns whether some models or crowds are not loaded yet
+      Returns:  BOOL
+                  TRUE while models are still loading or waiting to be
+                  uploaded
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Scene::IsLoading() const
+    {
+        return GetNumLoadedModels() + GetNumFailedModels() < GetNumModelsToLoad();
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::GetVoxels
       Summary:  Returns the vector of voxels
@@ -466,6 +616,28 @@ namespace library
         return m_models;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetCrowds
+      Summary:  Returns the hash map of crowds
+      Returns:  std::unordered_map<std::wstring, std::shared_ptr<SkinnedCrowd>>&
+                  Crowds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::unordered_map<std::wstring, std::shared_ptr<SkinnedCrowd>>& Scene::GetCrowds()
+    {
+        return m_crowds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetInstancedModels
+      Summary:  Returns the hash map of instanced models
+      Returns:  std::unordered_map<std::wstring, std::shared_ptr<InstancedModel>>&
+                  Instanced models
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::unordered_map<std::wstring, std::shared_ptr<InstancedModel>>& Scene::GetInstancedModels()
+    {
+        return m_instancedModels;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::GetPointLight
       Summary:  Returns a point light according to the given index
@@ -633,6 +805,98 @@ namespace library
         return S_OK;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfCrowd
+      Summary:  Sets the vertex shader for a crowd
+      Args:     PCWSTR pszCrowdName
+                  Key of the crowd
+                PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+      Modifies: [m_crowds].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfCrowd(_In_ PCWSTR pszCrowdName, _In_ PCWSTR pszVertexShaderName)
+    {
+        if (!m_crowds.contains(pszCrowdName) || !m_vertexShaders.contains(pszVertexShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_crowds[pszCrowdName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPixelShaderOfCrowd
+      Summary:  Sets the pixel shader for a crowd
+      Args:     PCWSTR pszCrowdName
+                  Key of the crowd
+                PCWSTR pszPixelShaderName
+                  Key of the pixel shader
+      Modifies: [m_crowds].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetPixelShaderOfCrowd(_In_ PCWSTR pszCrowdName, _In_ PCWSTR pszPixelShaderName)
+    {
+        if (!m_crowds.contains(pszCrowdName) || !m_pixelShaders.contains(pszPixelShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_crowds[pszCrowdName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfInstancedModel
+      Summary:  Sets the vertex shader for an instanced model
+      Args:     PCWSTR pszInstancedModelName
+                  Key of the instanced model
+                PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+      Modifies: [m_instancedModels].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfInstancedModel(_In_ PCWSTR pszInstancedModelName, _In_ PCWSTR pszVertexShaderName)
+    {
+        if (!m_instancedModels.contains(pszInstancedModelName) || !m_vertexShaders.contains(pszVertexShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_instancedModels[pszInstancedModelName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPixelShaderOfInstancedModel
+      Summary:  Sets the pixel shader for an instanced model
+      Args:     PCWSTR pszInstancedModelName
+                  Key of the instanced model
+                PCWSTR pszPixelShaderName
+                  Key of the pixel shader
+      Modifies: [m_instancedModels].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetPixelShaderOfInstancedModel(_In_ PCWSTR pszInstancedModelName, _In_ PCWSTR pszPixelShaderName)
+    {
+        if (!m_instancedModels.contains(pszInstancedModelName) || !m_pixelShaders.contains(pszPixelShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_instancedModels[pszInstancedModelName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+
+        return S_OK;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::SetVertexShaderOfVoxel
       Summary:  Sets the vertex shader for the voxels in a scene
@@ -700,6 +964,322 @@ namespace library
         return S_OK;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::loadModels
+      Summary:  Loader thread. Takes the next pending model or crowd
+                until none is left and imports it into its own deferred
+                context, so the importing, texture decoding and resource
+                creation happen on the loader threads, several models at
+                once, and only the commands recorded in the command list
+                run on the render thread. Textures are created with
+                their mips, so a model sharing a texture loaded by
+                another one does not depend on that model's command
+                list.
+      Args:     std::stop_token stopToken
+                  Set when the scene is destroyed
+                ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+      Modifies: [m_aLoadedModels, m_uNumFailedModels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::loadModels(_In_ std::stop_token stopToken, _In_ ID3D11Device* pDevice)
+    {
+        // WIC decodes the textures through COM
+        HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+        for (UINT uPendingModel = m_uNextPendingModel++; uPendingModel < m_aPendingModels.size(); uPendingModel = m_uNextPendingModel++)
+        {
+            if (stopToken.stop_requested())
+            {
+                break;
+            }
+
+            const PendingModel& pendingModel = m_aPendingModels[uPendingModel];
+
+            ComPtr<ID3D11DeviceContext> deferredContext;
+            HRESULT hr = pDevice->CreateDeferredContext(0u, deferredContext.GetAddressOf());
+
+            if (SUCCEEDED(hr))
+            {
+                if (pendingModel.pCrowd)
+                {
+                    hr = pendingModel.pCrowd->Initialize(pDevice, deferredContext.Get());
+                }
+                else if (pendingModel.pInstancedModel)
+                {
+                    hr = pendingModel.pInstancedModel->Initialize(pDevice, deferredContext.Get());
+                }
+                else
+                {
+                    hr = pendingModel.pModel->Initialize(pDevice, deferredContext.Get());
+                }
+            }
+
+            for (UINT i = 0u; SUCCEEDED(hr) && i < pendingModel.pModel->GetNumMaterials(); ++i)
+            {
+                hr = pendingModel.pModel->GetMaterial(i)->Initialize(pDevice, deferredContext.Get());
+            }
+
+            ComPtr<ID3D11CommandList> commandList;
+            if (SUCCEEDED(hr))
+            {
+                hr = deferredContext->FinishCommandList(FALSE, commandList.GetAddressOf());
+            }
+
+            if (FAILED(hr))
+            {
+                CHAR szDebugMessage[256];
+                sprintf_s(szDebugMessage, "Failed to load a model of %s (0x%08X)\n",
+                    m_filePath.string().c_str(),
+                    static_cast<UINT>(hr));
+                OutputDebugStringA(szDebugMessage);
+
+                ++m_uNumFailedModels;
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(m_loadedModelsMutex);
+            m_aLoadedModels.push_back({ .pModel = pendingModel.pModel, .pCrowd = pendingModel.pCrowd, .pInstancedModel = pendingModel.pInstancedModel, .commandList = commandList });
+        }
+
+        if (SUCCEEDED(hrCom))
+        {
+            CoUninitialize();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::readTextHeightMap
+      Summary:  Parses a height map written as text: the width, height
+                and depth of the map and the number of colors, the
+                colors, then the block type character and the relative
+                height of every column, row by row. Unreadable tokens
+                are skipped and missing columns are left empty.
+      Args:     const std::filesystem::path& filePath
+                  Path to the text height map
+                UINT& uOutWidth
+                  Number of columns along x
+                UINT& uOutHeight
+                  Largest number of voxels in a column
+                UINT& uOutDepth
+                  Number of columns along z
+                std::vector<XMFLOAT3>& aOutColors
+                  Color of every block type
+                std::vector<HeightMapColumn>& aOutColumns
+                  Width times depth columns, row by row
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::readTextHeightMap(
+        _In_ const std::filesystem::path& filePath,
+        _Out_ UINT& uOutWidth,
+        _Out_ UINT& uOutHeight,
+        _Out_ UINT& uOutDepth,
+        _Inout_ std::vector<XMFLOAT3>& aOutColors,
+        _Inout_ std::vector<HeightMapColumn>& aOutColumns
+    )
+    {
+        std::ifstream inputFile;
+        inputFile.open(filePath.string());
+
+        std::string trash;
+        UINT aDimension[4] = { 0u, };
+        UINT uDimensionIdx = 0u;
+        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        {
+            inputFile >> aDimension[uDimensionIdx];
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                ++uDimensionIdx;
+            }
+        }
+
+        uOutWidth = aDimension[0];
+        uOutHeight = aDimension[1];
+        uOutDepth = aDimension[2];
+
+        aOutColors.clear();
+        XMFLOAT3 color;
+        while (!inputFile.eof() && aOutColors.size() < aDimension[3])
+        {
+            inputFile >> color.x >> color.y >> color.z;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                aOutColors.push_back(color);
+            }
+        }
+
+        const size_t uNumColumns = static_cast<size_t>(uOutWidth) * static_cast<size_t>(uOutDepth);
+        aOutColumns.assign(uNumColumns, HeightMapColumn{ .uType = 0u, .uPadding = 0u, .uHeight = 0u });
+
+        size_t uColumnIdx = 0u;
+        CHAR voxelType;
+        FLOAT height;
+        while (!inputFile.eof() && uColumnIdx < uNumColumns)
+        {
+            inputFile >> voxelType >> height;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
+            {
+                const FLOAT numVoxels = std::clamp(static_cast<FLOAT>(uOutHeight) * height, 0.0f, static_cast<FLOAT>(USHRT_MAX));
+                aOutColumns[uColumnIdx++] =
+                {
+                    .uType = static_cast<BYTE>(voxelType - static_cast<CHAR>(eBlockType::GRASSLAND)),
+                    .uPadding = 0u,
+                    .uHeight = static_cast<WORD>(numVoxels)
+                };
+            }
+        }
+
+        inputFile.close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::initVoxels
+      Summary:  Creates a voxel for every color of the palette and the
+                instances of its blocks in two passes over the rows of
+                the map, both in parallel. The first counts the blocks
+                of every type in each row, so every instance array is
+                allocated once at its exact size, and the second writes
+                the blocks of each row at its offsets. Voxels without
+                blocks are removed.
+      Args:     UINT uWidth
+                  Number of columns along x
+                UINT uHeight
+                  Largest number of voxels in a column
+                UINT uDepth
+                  Number of columns along z
+                std::span<const XMFLOAT3> aColors
+                  Color of every block type
+                std::span<const HeightMapColumn> aColumns
+                  Width times depth columns, row by row
+      Modifies: [m_voxels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::initVoxels(
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ UINT uDepth,
+        _In_ std::span<const XMFLOAT3> aColors,
+        _In_ std::span<const HeightMapColumn> aColumns
+    )
+    {
+        const size_t uNumTypes = aColors.size();
+        for (const XMFLOAT3& color : aColors)
+        {
+            m_voxels.push_back(std::make_shared<Voxel>(XMFLOAT4(color.x, color.y, color.z, 1.0f)));
+        }
+
+        if (aColumns.size() < static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth))
+        {
+            uDepth = uWidth > 0u ? static_cast<UINT>(aColumns.size() / uWidth) : 0u;
+        }
+
+        std::vector<UINT> aRows(uDepth);
+        std::iota(aRows.begin(), aRows.end(), 0u);
+
+        // Blocks of every type in each row, then the offset of each row in the instance arrays
+        std::vector<size_t> aRowOffsets(static_cast<size_t>(uDepth) * uNumTypes, 0u);
+        std::for_each(std::execution::par, aRows.begin(), aRows.end(),
+            [&](UINT uDepthIdx)
+            {
+                size_t* aCounts = aRowOffsets.data() + static_cast<size_t>(uDepthIdx) * uNumTypes;
+                for (UINT uWidthIdx = 0u; uWidthIdx < uWidth; ++uWidthIdx)
+                {
+                    const HeightMapColumn& column = aColumns[static_cast<size_t>(uDepthIdx) * uWidth + uWidthIdx];
+                    if (column.uType < uNumTypes)
+                    {
+                        aCounts[column.uType] += column.uHeight;
+                    }
+                }
+            }
+        );
+
+        std::vector<std::vector<InstanceData>> aInstanceData(uNumTypes);
+        for (size_t uType = 0u; uType < uNumTypes; ++uType)
+        {
+            size_t uNumInstances = 0u;
+            for (UINT uDepthIdx = 0u; uDepthIdx < uDepth; ++uDepthIdx)
+            {
+                const size_t uCount = aRowOffsets[static_cast<size_t>(uDepthIdx) * uNumTypes + uType];
+                aRowOffsets[static_cast<size_t>(uDepthIdx) * uNumTypes + uType] = uNumInstances;
+                uNumInstances += uCount;
+            }
+            aInstanceData[uType].resize(uNumInstances);
+        }
+
+        std::for_each(std::execution::par, aRows.begin(), aRows.end(),
+            [&](UINT uDepthIdx)
+            {
+                std::vector<size_t> aOffsets(aRowOffsets.begin() + static_cast<ptrdiff_t>(uDepthIdx * uNumTypes),
+                    aRowOffsets.begin() + static_cast<ptrdiff_t>((uDepthIdx + 1u) * uNumTypes));
+                for (UINT uWidthIdx = 0u; uWidthIdx < uWidth; ++uWidthIdx)
+                {
+                    const HeightMapColumn& column = aColumns[static_cast<size_t>(uDepthIdx) * uWidth + uWidthIdx];
+                    if (column.uType >= uNumTypes)
+                    {
+                        continue;
+                    }
+
+                    InstanceData* aInstances = aInstanceData[column.uType].data() + aOffsets[column.uType];
+                    for (UINT heightIdx = 0u; heightIdx < column.uHeight; ++heightIdx)
+                    {
+                        aInstances[heightIdx] =
+                        {
+                            .Transformation = XMMatrixTranslation(
+                                2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(uWidth) / 2.0f),
+                                2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(uHeight)) + (static_cast<FLOAT>(uHeight) * 0.75f),
+                                2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(uDepth) / 2.0f)
+                            )
+                        };
+                    }
+                    aOffsets[column.uType] += column.uHeight;
+                }
+            }
+        );
+
+        UINT uVoxelIdx = 0u;
+        auto it = m_voxels.begin();
+        while (it != m_voxels.end())
+        {
+            if (aInstanceData[uVoxelIdx].empty())
+            {
+                it = m_voxels.erase(it);
+            }
+            else
+            {
+                (*it)->SetInstanceData(std::move(aInstanceData[uVoxelIdx]));
+                ++it;
+            }
+            ++uVoxelIdx;
+        }
+    }
+
     FLOAT Scene::getNoise2(UINT x, UINT y)
     {
         UINT temp = ms_aHashes[y % 256u];
@@ -10,18 +10,29 @@
 
 #include "Common.h"
 
+#include <atomic>
 #include <fstream>
+#include <mutex>
+#include <span>
+#include <thread>
 
 #include "Model/Model.h"
 #include "Light/PointLight.h"
+#include "Renderer/InstancedModel.h"
 #include "Renderer/Skybox.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/SkinnedCrowd.h"
+#include "Scene/HeightMap.h"
 #include "Scene/Voxel.h"
 
 namespace library
 {
     class Scene
     {
+    public:
+        // Models are imported on at most this many threads at once
+        static constexpr const UINT MAX_NUM_LOADER_THREADS = 4u;
+
     public:
         static FLOAT GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth);
 
@@ -38,6 +49,8 @@ namespace library
         HRESULT AddVoxel(_In_ const std::shared_ptr<Voxel>& voxel);
         HRESULT AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable);
         HRESULT AddModel(_In_ PCWSTR pszModelName, _In_ const std::shared_ptr<Model>& pModel);
+        HRESULT AddCrowd(_In_ PCWSTR pszCrowdName, _In_ const std::shared_ptr<SkinnedCrowd>& pCrowd);
+        HRESULT AddInstancedModel(_In_ PCWSTR pszInstancedModelName, _In_ const std::shared_ptr<InstancedModel>& pInstancedModel);
         HRESULT AddPointLight(_In_ size_t index, _In_ const std::shared_ptr<PointLight>& pPointLight);
         HRESULT AddVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ const std::shared_ptr<VertexShader>& vertexShader);
         HRESULT AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader);
@@ -45,10 +58,18 @@ namespace library
         HRESULT AddSkyBox(_In_ const std::shared_ptr<Skybox>& skybox);
 
         void Update(_In_ FLOAT deltaTime);
+        void UploadLoadedModels(_In_ ID3D11DeviceContext* pImmediateContext);
+
+        UINT GetNumModelsToLoad() const;
+        UINT GetNumLoadedModels() const;
+        UINT GetNumFailedModels() const;
+        BOOL IsLoading() const;
 
         std::vector<std::shared_ptr<Voxel>>& GetVoxels();
         std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& GetRenderables();
         std::unordered_map<std::wstring, std::shared_ptr<Model>>& GetModels();
+        std::unordered_map<std::wstring, std::shared_ptr<SkinnedCrowd>>& GetCrowds();
+        std::unordered_map<std::wstring, std::shared_ptr<InstancedModel>>& GetInstancedModels();
         std::shared_ptr<PointLight>& GetPointLight(_In_ size_t index);
         std::unordered_map<std::wstring, std::shared_ptr<VertexShader>>& GetVertexShaders();
         std::unordered_map<std::wstring, std::shared_ptr<PixelShader>>& GetPixelShaders();
@@ -62,6 +83,10 @@ namespace library
         HRESULT SetPixelShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPixelShaderName);
         HRESULT SetVertexShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszVertexShaderName);
         HRESULT SetPixelShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPixelShaderName);
+        HRESULT SetVertexShaderOfCrowd(_In_ PCWSTR pszCrowdName, _In_ PCWSTR pszVertexShaderName);
+        HRESULT SetPixelShaderOfCrowd(_In_ PCWSTR pszCrowdName, _In_ PCWSTR pszPixelShaderName);
+        HRESULT SetVertexShaderOfInstancedModel(_In_ PCWSTR pszInstancedModelName, _In_ PCWSTR pszVertexShaderName);
+        HRESULT SetPixelShaderOfInstancedModel(_In_ PCWSTR pszInstancedModelName, _In_ PCWSTR pszPixelShaderName);
         HRESULT SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName);
         HRESULT SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName);
         HRESULT SetMaterialOfVoxel(_In_ PCWSTR pszMaterialName);
@@ -72,6 +97,40 @@ namespace library
         static FLOAT lerp(FLOAT x, FLOAT y, FLOAT s);
         static FLOAT smoothLerp(FLOAT x, FLOAT y, FLOAT s);
 
+        static void readTextHeightMap(
+            _In_ const std::filesystem::path& filePath,
+            _Out_ UINT& uOutWidth,
+            _Out_ UINT& uOutHeight,
+            _Out_ UINT& uOutDepth,
+            _Inout_ std::vector<XMFLOAT3>& aOutColors,
+            _Inout_ std::vector<HeightMapColumn>& aOutColumns
+        );
+
+        void initVoxels(
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ UINT uDepth,
+            _In_ std::span<const XMFLOAT3> aColors,
+            _In_ std::span<const HeightMapColumn> aColumns
+        );
+        void loadModels(_In_ std::stop_token stopToken, _In_ ID3D11Device* pDevice);
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   PendingModel
+
+          Summary:  Model, crowd or instanced model loaded on a loader
+                    thread, with the commands recorded while loading it
+                    once it is done
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct PendingModel
+        {
+            std::shared_ptr<Model> pModel;
+            std::shared_ptr<SkinnedCrowd> pCrowd;
+            std::shared_ptr<InstancedModel> pInstancedModel;
+            ComPtr<ID3D11CommandList> commandList;
+        };
+
     private:
         static constexpr const UINT ms_aHashes[] =
         {
@@ -94,10 +153,24 @@ namespace library
         std::vector<std::shared_ptr<Voxel>> m_voxels;
         std::unordered_map<std::wstring, std::shared_ptr<Renderable>> m_renderables;
         std::unordered_map<std::wstring, std::shared_ptr<Model>> m_models;
+        std::vector<std::shared_ptr<Model>> m_modelsToUpdate;
+        std::unordered_map<std::wstring, std::shared_ptr<SkinnedCrowd>> m_crowds;
+        std::unordered_map<std::wstring, std::shared_ptr<InstancedModel>> m_instancedModels;
         std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
         std::unordered_map<std::wstring, std::shared_ptr<VertexShader>> m_vertexShaders;
         std::unordered_map<std::wstring, std::shared_ptr<PixelShader>> m_pixelShaders;
         std::unordered_map<std::wstring, std::shared_ptr<Material>> m_materials;
         std::shared_ptr<Skybox> m_skyBox;
+
+        std::vector<PendingModel> m_aPendingModels;
+        std::vector<PendingModel> m_aLoadedModels;
+        std::mutex m_loadedModelsMutex;
+        std::atomic<UINT> m_uNumLoadedModels;
+        std::atomic<UINT> m_uNumFailedModels;
+        std::atomic<UINT> m_uNextPendingModel;
+
+        // Declared last so the loader threads are stopped and joined
+        // before anything they use is destroyed
+        std::vector<std::jthread> m_aLoaderThreads;
     };
 }
\ No newline at end of file
@@ -152,13 +152,13 @@ namespace library
 
       Summary:  Returns the pointer to the indices data
       
-      Returns:  const WORD*
-                  Pointer to the indices data
+      Returns:  const void*
+                  Pointer to the 16-bit indices data
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Voxel::getIndices definition (remove the comment)
     --------------------------------------------------------------------*/
-    const WORD* Voxel::getIndices() const
+    const void* Voxel::getIndices() const
     {
         return INDICES;
     }
@@ -47,7 +47,7 @@ namespace library
 
     protected:
         const SimpleVertex* getVertices() const override;
-        const WORD* getIndices() const override;
+        const void* getIndices() const override;
 
         static constexpr const SimpleVertex VERTICES[] =
         {
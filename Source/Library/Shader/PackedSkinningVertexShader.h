@@ -0,0 +1,33 @@
+/*+===================================================================
+  File:      PACKEDSKINNINGVERTEXSHADER.H
+
+  Summary:   PackedSkinningVertexShader header file contains declarations of
+             PackedSkinningVertexShader class used to draw skinned
+             models whose vertex buffers use eVertexFormat::PACKED.
+
+  Classes: PackedSkinningVertexShader
+
+  2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    class PackedSkinningVertexShader : public VertexShader
+    {
+    public:
+        PackedSkinningVertexShader() = delete;
+        PackedSkinningVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        PackedSkinningVertexShader(const PackedSkinningVertexShader& other) = delete;
+        PackedSkinningVertexShader(PackedSkinningVertexShader&& other) = delete;
+        PackedSkinningVertexShader& operator=(const PackedSkinningVertexShader& other) = delete;
+        PackedSkinningVertexShader& operator=(PackedSkinningVertexShader&& other) = delete;
+        virtual ~PackedSkinningVertexShader() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+/*+===================================================================
+  File:      PACKEDVERTEXSHADER.H
+
+  Summary:   PackedVertexShader header file contains declarations of
+             PackedVertexShader class used to draw renderables whose
+             vertex buffers use eVertexFormat::PACKED.
+
+  Classes: PackedVertexShader
+
+  2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    class PackedVertexShader : public VertexShader
+    {
+    public:
+        PackedVertexShader() = delete;
+        PackedVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        PackedVertexShader(const PackedVertexShader& other) = delete;
+        PackedVertexShader(PackedVertexShader&& other) = delete;
+        PackedVertexShader& operator=(const PackedVertexShader& other) = delete;
+        PackedVertexShader& operator=(PackedVertexShader&& other) = delete;
+        virtual ~PackedVertexShader() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+    };
+}
\ No newline at end of file
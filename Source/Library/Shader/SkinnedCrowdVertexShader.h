@@ -0,0 +1,33 @@
+/*+===================================================================
+  File:      SKINNEDCROWDVERTEXSHADER.H
+
+  Summary:   SkinnedCrowdVertexShader header file contains declarations
+             of SkinnedCrowdVertexShader class used for the lab samples
+             of Game Graphics Programming course.
+
+  Classes: SkinnedCrowdVertexShader
+
+  2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    class SkinnedCrowdVertexShader : public VertexShader
+    {
+    public:
+        SkinnedCrowdVertexShader() = delete;
+        SkinnedCrowdVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        SkinnedCrowdVertexShader(const SkinnedCrowdVertexShader& other) = delete;
+        SkinnedCrowdVertexShader(SkinnedCrowdVertexShader&& other) = delete;
+        SkinnedCrowdVertexShader& operator=(const SkinnedCrowdVertexShader& other) = delete;
+        SkinnedCrowdVertexShader& operator=(SkinnedCrowdVertexShader&& other) = delete;
+        virtual ~SkinnedCrowdVertexShader() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+    };
+}
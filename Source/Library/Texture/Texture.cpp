@@ -6,6 +6,9 @@
 namespace library
 {
     ComPtr<ID3D11SamplerState> Texture::s_samplers[static_cast<size_t>(eTextureSamplerType::COUNT)];
+    std::mutex Texture::s_samplerMutex;
+    std::atomic<UINT> Texture::s_uNumDecodes(0u);
+    std::atomic<UINT> Texture::s_uNumSkippedDecodes(0u);
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::Texture
@@ -17,7 +20,8 @@ namespace library
                 eTextureSamplerType textureSamplerType
                   Texture sampler type of this texture
 
-      Modifies: [m_filePath, m_textureRV, m_textureSamplerType].
+      Modifies: [m_filePath, m_textureRV, m_textureSamplerType,
+                 m_initializeMutex, m_uResidentSize].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Texture::Texture definition (remove the comment)
@@ -25,27 +29,44 @@ namespace library
     Texture::Texture(_In_ const std::filesystem::path& filePath, _In_opt_ eTextureSamplerType textureSamplerType) :
         m_filePath(filePath),
         m_textureRV(),
-        m_textureSamplerType(textureSamplerType)
+        m_textureSamplerType(textureSamplerType),
+        m_initializeMutex(),
+        m_uResidentSize(0u)
     {
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::Initialize
 
-      Summary:  Initializes the texture
+      Summary:  Decodes and uploads the texture. A texture shared by
+                several materials is only decoded by the first call.
+                Given a deferred context, the texture is created with
+                its mips scaled on the CPU, so it is complete once the
+                call returns, whichever command list runs first.
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
 
-      Modifies: [m_textureRV].
+      Modifies: [m_textureRV, m_uResidentSize, s_uNumDecodes,
+                 s_uNumSkippedDecodes].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Texture::Initialize definition (remove the comment)
     --------------------------------------------------------------------*/
     HRESULT Texture::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
+        std::lock_guard<std::mutex> initializeLock(m_initializeMutex);
+
+        if (m_textureRV)
+        {
+            ++s_uNumSkippedDecodes;
+            return S_OK;
+        }
+
+        ++s_uNumDecodes;
+
         HRESULT hr = CreateWICTextureFromFile(
             pDevice,
             pImmediateContext,
@@ -65,11 +86,15 @@ namespace library
             }
         }
 
+        m_uResidentSize = getResidentSize(m_textureRV.Get());
+
 
         // WRAP :  (u,v)  պο ؽó Ÿϸ
         // CLAMP : [0.0, 1.0]   ؽó ǥ  0.0 Ǵ 1.0 ؽó  
         
         // Create the sample state
+        std::lock_guard<std::mutex> lock(s_samplerMutex);
+
         if (!s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)].Get())
         {
             D3D11_SAMPLER_DESC sampDesc =
@@ -141,6 +166,134 @@ M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     {
         return m_textureSamplerType;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetFilePath
+
+      Summary:  Returns the path of the texture file
+
+      Returns:  const std::filesystem::path&
+                  Path of the texture file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::filesystem::path& Texture::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetResidentSize
+
+      Summary:  Returns the video memory taken by the texture and its
+                mip levels
+
+      Returns:  UINT64
+                  Size in bytes, 0 before Initialize
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 Texture::GetResidentSize() const
+    {
+        return m_uResidentSize.load();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetNumDecodes
+
+      Summary:  Returns the number of texture files decoded and uploaded
+                by all textures
+
+      Returns:  UINT
+                  Number of decodes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetNumDecodes()
+    {
+        return s_uNumDecodes.load();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetNumSkippedDecodes
+
+      Summary:  Returns the number of Initialize calls on textures that
+                were already loaded
+
+      Returns:  UINT
+                  Number of decodes skipped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetNumSkippedDecodes()
+    {
+        return s_uNumSkippedDecodes.load();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::getResidentSize
+
+      Summary:  Computes the size of a 2D texture and its mip levels
+                from its description. Block compressed formats take 8
+                or 16 bytes per block of 4x4 texels.
+
+      Args:     ID3D11ShaderResourceView* pTextureRV
+                  View of the texture
+
+      Returns:  UINT64
+                  Size in bytes, 0 if the view is not of a 2D texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 Texture::getResidentSize(_In_ ID3D11ShaderResourceView* pTextureRV)
+    {
+        ComPtr<ID3D11Resource> resource;
+        pTextureRV->GetResource(resource.GetAddressOf());
+
+        ComPtr<ID3D11Texture2D> texture;
+        if (FAILED(resource.As(&texture)))
+        {
+            return 0u;
+        }
+
+        D3D11_TEXTURE2D_DESC desc = {};
+        texture->GetDesc(&desc);
+
+        UINT uBlockSize = 0u;
+        UINT uBytesPerTexel = 4u;
+        switch (desc.Format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            uBlockSize = 8u;
+            break;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC7_UNORM:
+            uBlockSize = 16u;
+            break;
+        case DXGI_FORMAT_R8_UNORM:
+            uBytesPerTexel = 1u;
+            break;
+        case DXGI_FORMAT_R8G8_UNORM:
+            uBytesPerTexel = 2u;
+            break;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            uBytesPerTexel = 8u;
+            break;
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            uBytesPerTexel = 16u;
+            break;
+        default:
+            break;
+        }
+
+        UINT64 uSize = 0u;
+        for (UINT uMip = 0u; uMip < desc.MipLevels; ++uMip)
+        {
+            const UINT64 uWidth = std::max(desc.Width >> uMip, 1u);
+            const UINT64 uHeight = std::max(desc.Height >> uMip, 1u);
+
+            uSize += uBlockSize > 0u ?
+                ((uWidth + 3u) / 4u) * ((uHeight + 3u) / 4u) * uBlockSize :
+                uWidth * uHeight * uBytesPerTexel;
+        }
+
+        return uSize * desc.ArraySize;
+    }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::GetSamplerState
 
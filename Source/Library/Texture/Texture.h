@@ -12,6 +12,9 @@
 
 #include "Common.h"
 
+#include <atomic>
+#include <mutex>
+
 namespace library
 {
     enum class eTextureSamplerType : size_t
@@ -32,18 +35,35 @@ namespace library
         Texture& operator=(Texture&& other) = delete;
         virtual ~Texture() = default;
 
-        // Should be called once to load the texture
+        // Loads the texture on the first call, later calls return at once
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
         ComPtr<ID3D11ShaderResourceView>& GetTextureResourceView();
         eTextureSamplerType GetSamplerType() const;
+        const std::filesystem::path& GetFilePath() const;
+        UINT64 GetResidentSize() const;
+
+        static UINT GetNumDecodes();
+        static UINT GetNumSkippedDecodes();
 
     public:
         static ComPtr<ID3D11SamplerState> s_samplers[static_cast<size_t>(eTextureSamplerType::COUNT)];
 
+    protected:
+        // Textures are also initialized on model loader threads
+        static std::mutex s_samplerMutex;
+        static std::atomic<UINT> s_uNumDecodes;
+        static std::atomic<UINT> s_uNumSkippedDecodes;
+
+    protected:
+        static UINT64 getResidentSize(_In_ ID3D11ShaderResourceView* pTextureRV);
+
     protected:
         std::filesystem::path m_filePath;
         ComPtr<ID3D11ShaderResourceView> m_textureRV;
         eTextureSamplerType m_textureSamplerType;
+        // Shared textures can be initialized by several materials
+        std::mutex m_initializeMutex;
+        std::atomic<UINT64> m_uResidentSize;
     };
 }
\ No newline at end of file
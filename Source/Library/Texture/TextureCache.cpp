@@ -0,0 +1,201 @@
+#include "Texture/TextureCache.h"
+
+#include <cwctype>
+
+namespace library
+{
+    std::unordered_map<std::wstring, TextureCache::Entry> TextureCache::sm_entries;
+    std::mutex TextureCache::sm_mutex;
+    UINT TextureCache::sm_uNumRequests = 0u;
+    UINT TextureCache::sm_uNumHits = 0u;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetTexture
+
+      Summary:  Returns the texture of a file, creating it if no live
+                texture of the same file and sampler type exists. The
+                texture is not initialized; Initialize only decodes it
+                the first time it is called.
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture file
+                eTextureSamplerType textureSamplerType
+                  Sampler type of the texture
+
+      Modifies: [sm_entries, sm_uNumRequests, sm_uNumHits].
+
+      Returns:  std::shared_ptr<Texture>
+                  Shared texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<Texture> TextureCache::GetTexture(_In_ const std::filesystem::path& filePath, _In_ eTextureSamplerType textureSamplerType)
+    {
+        const std::wstring szKey = getKey(filePath, textureSamplerType);
+
+        std::lock_guard<std::mutex> lock(sm_mutex);
+        ++sm_uNumRequests;
+
+        Entry& entry = sm_entries[szKey];
+        std::shared_ptr<Texture> pTexture = entry.pTexture.lock();
+        if (pTexture)
+        {
+            ++entry.uNumRequests;
+            ++sm_uNumHits;
+
+            return pTexture;
+        }
+
+        // The deleter removes the entry once the last reference is dropped
+        pTexture = std::shared_ptr<Texture>(
+            new Texture(filePath, textureSamplerType),
+            [szKey](Texture* pExpiredTexture)
+            {
+                release(szKey, pExpiredTexture);
+            }
+        );
+        entry = { .pTexture = pTexture, .uNumRequests = 1u };
+
+        return pTexture;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetStatistics
+
+      Summary:  Returns the requests served by the cache, the textures
+                it holds and the video memory they take. The saved size
+                counts every extra request of a live texture as one more
+                copy that would have been uploaded without the cache.
+
+      Returns:  TextureCacheStatistics
+                  Statistics of the cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureCacheStatistics TextureCache::GetStatistics()
+    {
+        TextureCacheStatistics statistics =
+        {
+            .uNumRequests = 0u,
+            .uNumHits = 0u,
+            .uNumTextures = 0u,
+            .uResidentSize = 0u,
+            .uSavedSize = 0u,
+            .uNumDecodes = Texture::GetNumDecodes(),
+            .uNumSkippedDecodes = Texture::GetNumSkippedDecodes()
+        };
+
+        // The textures are released after the lock, since releasing the
+        // last reference runs release, which locks sm_mutex again
+        std::vector<std::pair<std::shared_ptr<Texture>, UINT>> aLiveTextures;
+        {
+            std::lock_guard<std::mutex> lock(sm_mutex);
+
+            statistics.uNumRequests = sm_uNumRequests;
+            statistics.uNumHits = sm_uNumHits;
+
+            aLiveTextures.reserve(sm_entries.size());
+            for (const auto& [szKey, entry] : sm_entries)
+            {
+                std::shared_ptr<Texture> pTexture = entry.pTexture.lock();
+                if (pTexture)
+                {
+                    aLiveTextures.emplace_back(std::move(pTexture), entry.uNumRequests);
+                }
+            }
+        }
+
+        for (const auto& [pTexture, uNumRequests] : aLiveTextures)
+        {
+            const UINT64 uResidentSize = pTexture->GetResidentSize();
+
+            ++statistics.uNumTextures;
+            statistics.uResidentSize += uResidentSize;
+            statistics.uSavedSize += uResidentSize * (uNumRequests - 1u);
+        }
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::Report
+
+      Summary:  Writes the statistics of the cache to the debug output
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::Report()
+    {
+        const TextureCacheStatistics statistics = GetStatistics();
+
+        CHAR szDebugMessage[256];
+        sprintf_s(szDebugMessage, "Texture cache: %u textures, %.2f MB resident, %u of %u requests shared, %u decodes, %u decodes skipped, %.2f MB of uploads saved\n",
+            statistics.uNumTextures,
+            static_cast<DOUBLE>(statistics.uResidentSize) / (1024.0 * 1024.0),
+            statistics.uNumHits,
+            statistics.uNumRequests,
+            statistics.uNumDecodes,
+            statistics.uNumSkippedDecodes,
+            static_cast<DOUBLE>(statistics.uSavedSize) / (1024.0 * 1024.0));
+        OutputDebugStringA(szDebugMessage);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::getKey
+
+      Summary:  Returns the key of a texture. The path is made absolute
+                and lexically normal, and lowered since Windows paths
+                are not case sensitive, so different spellings of the
+                same file share a texture.
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture file
+                eTextureSamplerType textureSamplerType
+                  Sampler type of the texture
+
+      Returns:  std::wstring
+                  Key of the texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::wstring TextureCache::getKey(_In_ const std::filesystem::path& filePath, _In_ eTextureSamplerType textureSamplerType)
+    {
+        std::error_code error;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath, error);
+        if (error)
+        {
+            canonicalPath = filePath.lexically_normal();
+        }
+
+        std::wstring szKey = canonicalPath.wstring();
+        std::transform(szKey.begin(), szKey.end(), szKey.begin(),
+            [](WCHAR character)
+            {
+                return static_cast<WCHAR>(std::towlower(character));
+            }
+        );
+
+        return szKey + L'|' + std::to_wstring(static_cast<size_t>(textureSamplerType));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::release
+
+      Summary:  Deleter of the cached textures. Removes the entry of the
+                texture unless a new texture was already created for
+                the key, then destroys the texture outside the lock.
+
+      Args:     const std::wstring& szKey
+                  Key of the texture
+                Texture* pTexture
+                  Texture whose last reference was dropped
+
+      Modifies: [sm_entries].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::release(_In_ const std::wstring& szKey, _In_ Texture* pTexture)
+    {
+        {
+            std::lock_guard<std::mutex> lock(sm_mutex);
+
+            auto iEntry = sm_entries.find(szKey);
+            if (iEntry != sm_entries.end() && iEntry->second.pTexture.expired())
+            {
+                sm_entries.erase(iEntry);
+            }
+        }
+
+        delete pTexture;
+    }
+}
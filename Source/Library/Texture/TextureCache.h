@@ -0,0 +1,94 @@
+/*+===================================================================
+  File:      TEXTURECACHE.H
+
+  Summary:   TextureCache header file contains declaration of class
+             TextureCache used to share the textures loaded from the
+             same file between materials and models.
+
+  Classes:  TextureCache
+
+  2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <mutex>
+
+#include "Texture/Texture.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureCacheStatistics
+
+      Summary:  Textures handed out by the cache and the decodes and
+                video memory sharing them saved. A request served by a
+                texture already in the cache would otherwise have been
+                decoded and uploaded again.
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureCacheStatistics
+    {
+        UINT uNumRequests;
+        UINT uNumHits;
+        UINT uNumTextures;
+        UINT64 uResidentSize;
+        UINT64 uSavedSize;
+        UINT uNumDecodes;
+        UINT uNumSkippedDecodes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureCache
+
+      Summary:  Process wide cache of textures keyed by the canonical
+                path of the file and the sampler type. The cache only
+                keeps weak references, so a texture and its video
+                memory are released when the last material using it
+                is destroyed, and the entry is removed with it.
+
+      Methods:  GetTexture
+                  Returns the shared texture of a file
+                GetStatistics
+                  Returns the requests and savings of the cache
+                Report
+                  Writes the statistics to the debug output
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureCache
+    {
+    public:
+        TextureCache() = delete;
+        TextureCache(const TextureCache& other) = delete;
+        TextureCache(TextureCache&& other) = delete;
+        TextureCache& operator=(const TextureCache& other) = delete;
+        TextureCache& operator=(TextureCache&& other) = delete;
+        ~TextureCache() = delete;
+
+        static std::shared_ptr<Texture> GetTexture(_In_ const std::filesystem::path& filePath, _In_ eTextureSamplerType textureSamplerType);
+        static TextureCacheStatistics GetStatistics();
+        static void Report();
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Entry
+
+          Summary:  Texture of a key and the number of times it was
+                    handed out
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Entry
+        {
+            std::weak_ptr<Texture> pTexture;
+            UINT uNumRequests;
+        };
+
+    private:
+        static std::wstring getKey(_In_ const std::filesystem::path& filePath, _In_ eTextureSamplerType textureSamplerType);
+        static void release(_In_ const std::wstring& szKey, _In_ Texture* pTexture);
+
+    private:
+        static std::unordered_map<std::wstring, Entry> sm_entries;
+        static std::mutex sm_mutex;
+        static UINT sm_uNumRequests;
+        static UINT sm_uNumHits;
+    };
+}
@@ -36,7 +36,9 @@
 #include <wincodec.h>
 #pragma warning(pop)
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "Texture/WICTextureLoader.h"
 
@@ -199,28 +201,33 @@ static WICConvert g_WICConvert[] =
 };
 
 //--------------------------------------------------------------------------------------
-static IWICImagingFactory* _GetWIC()
+static BOOL WINAPI _InitializeWICFactory(PINIT_ONCE, PVOID, PVOID* ifactory)
 {
-    static IWICImagingFactory* s_Factory = nullptr;
-
-    if (s_Factory)
-        return s_Factory;
-
-    HRESULT hr = CoCreateInstance(
+    return SUCCEEDED(CoCreateInstance(
         CLSID_WICImagingFactory,
         nullptr,
         CLSCTX_INPROC_SERVER,
         __uuidof(IWICImagingFactory),
-        (LPVOID*)&s_Factory
-    );
+        ifactory)) ? TRUE : FALSE;
+}
 
-    if (FAILED(hr))
+//---------------------------------------------------------------------------------
+// The factory is created once even when textures are loaded on several threads
+static IWICImagingFactory* _GetWIC()
+{
+    static INIT_ONCE s_initOnce = INIT_ONCE_STATIC_INIT;
+
+    IWICImagingFactory* factory = nullptr;
+    if (!InitOnceExecuteOnce(
+        &s_initOnce,
+        _InitializeWICFactory,
+        nullptr,
+        reinterpret_cast<LPVOID*>(&factory)))
     {
-        s_Factory = nullptr;
         return nullptr;
     }
 
-    return s_Factory;
+    return factory;
 }
 
 //---------------------------------------------------------------------------------
@@ -264,6 +271,52 @@ static size_t _WICBitsPerPixel(REFGUID targetGuid)
     return bpp;
 }
 
+//---------------------------------------------------------------------------------
+// Scales a frame with the Fant filter and converts it to the given format
+static HRESULT _ScaleWIC(_In_ IWICBitmapFrameDecode* frame,
+    _In_ UINT width,
+    _In_ UINT height,
+    _In_ REFGUID convertGUID,
+    _In_ size_t rowPitch,
+    _In_ size_t imageSize,
+    _Out_writes_bytes_(imageSize) uint8_t* pixels)
+{
+    IWICImagingFactory* pWIC = _GetWIC();
+    if (!pWIC)
+        return E_NOINTERFACE;
+
+    ScopedObject<IWICBitmapScaler> scaler;
+    HRESULT hr = pWIC->CreateBitmapScaler(&scaler);
+    if (FAILED(hr))
+        return hr;
+
+    hr = scaler->Initialize(frame, width, height, WICBitmapInterpolationModeFant);
+    if (FAILED(hr))
+        return hr;
+
+    WICPixelFormatGUID pfScaler;
+    hr = scaler->GetPixelFormat(&pfScaler);
+    if (FAILED(hr))
+        return hr;
+
+    if (memcmp(&convertGUID, &pfScaler, sizeof(GUID)) == 0)
+    {
+        // No format conversion needed
+        return scaler->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), pixels);
+    }
+
+    ScopedObject<IWICFormatConverter> FC;
+    hr = pWIC->CreateFormatConverter(&FC);
+    if (FAILED(hr))
+        return hr;
+
+    hr = FC->Initialize(scaler.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom);
+    if (FAILED(hr))
+        return hr;
+
+    return FC->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), pixels);
+}
+
 //---------------------------------------------------------------------------------
 static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
     _In_opt_ ID3D11DeviceContext* d3dContext,
@@ -400,46 +453,9 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
     else if (twidth != width || theight != height)
     {
         // Resize
-        IWICImagingFactory* pWIC = _GetWIC();
-        if (!pWIC)
-            return E_NOINTERFACE;
-
-        ScopedObject<IWICBitmapScaler> scaler;
-        hr = pWIC->CreateBitmapScaler(&scaler);
+        hr = _ScaleWIC(frame, twidth, theight, convertGUID, rowPitch, imageSize, temp.get());
         if (FAILED(hr))
             return hr;
-
-        hr = scaler->Initialize(frame, twidth, theight, WICBitmapInterpolationModeFant);
-        if (FAILED(hr))
-            return hr;
-
-        WICPixelFormatGUID pfScaler;
-        hr = scaler->GetPixelFormat(&pfScaler);
-        if (FAILED(hr))
-            return hr;
-
-        if (memcmp(&convertGUID, &pfScaler, sizeof(GUID)) == 0)
-        {
-            // No format conversion needed
-            hr = scaler->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), temp.get());
-            if (FAILED(hr))
-                return hr;
-        }
-        else
-        {
-            ScopedObject<IWICFormatConverter> FC;
-            hr = pWIC->CreateFormatConverter(&FC);
-            if (FAILED(hr))
-                return hr;
-
-            hr = FC->Initialize(scaler.Get(), convertGUID, WICBitmapDitherTypeErrorDiffusion, 0, 0, WICBitmapPaletteTypeCustom);
-            if (FAILED(hr))
-                return hr;
-
-            hr = FC->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), temp.get());
-            if (FAILED(hr))
-                return hr;
-        }
     }
     else
     {
@@ -464,21 +480,61 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
 
     // See if format is supported for auto-gen mipmaps (varies by feature level)
     bool autogen = false;
+    bool cpumips = false;
     if (d3dContext != 0 && textureView != 0) // Must have context and shader-view to auto generate mipmaps
     {
-        UINT fmtSupport = 0;
-        hr = d3dDevice->CheckFormatSupport(format, &fmtSupport);
-        if (SUCCEEDED(hr) && (fmtSupport & D3D11_FORMAT_SUPPORT_MIP_AUTOGEN))
+        if (d3dContext->GetType() == D3D11_DEVICE_CONTEXT_DEFERRED)
+        {
+            // A texture shared by several loads would only be filled by the command list of the first one,
+            // which may run after the others or not at all, so the mips are scaled here and created with it
+            cpumips = true;
+        }
+        else
         {
-            autogen = true;
+            UINT fmtSupport = 0;
+            hr = d3dDevice->CheckFormatSupport(format, &fmtSupport);
+            if (SUCCEEDED(hr) && (fmtSupport & D3D11_FORMAT_SUPPORT_MIP_AUTOGEN))
+            {
+                autogen = true;
+            }
         }
     }
 
+    UINT mipLevels = 1;
+    if (cpumips)
+    {
+        while ((twidth >> mipLevels) > 0 || (theight >> mipLevels) > 0)
+            ++mipLevels;
+    }
+
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(mipLevels);
+    initData[0].pSysMem = temp.get();
+    initData[0].SysMemPitch = static_cast<UINT>(rowPitch);
+    initData[0].SysMemSlicePitch = static_cast<UINT>(imageSize);
+
+    std::vector<std::unique_ptr<uint8_t[]>> mips(mipLevels);
+    for (UINT level = 1; level < mipLevels; ++level)
+    {
+        const UINT mipWidth = std::max<UINT>(twidth >> level, 1u);
+        const UINT mipHeight = std::max<UINT>(theight >> level, 1u);
+        const size_t mipRowPitch = (mipWidth * bpp + 7) / 8;
+        const size_t mipImageSize = mipRowPitch * mipHeight;
+
+        mips[level].reset(new uint8_t[mipImageSize]);
+        hr = _ScaleWIC(frame, mipWidth, mipHeight, convertGUID, mipRowPitch, mipImageSize, mips[level].get());
+        if (FAILED(hr))
+            return hr;
+
+        initData[level].pSysMem = mips[level].get();
+        initData[level].SysMemPitch = static_cast<UINT>(mipRowPitch);
+        initData[level].SysMemSlicePitch = static_cast<UINT>(mipImageSize);
+    }
+
     // Create texture
     D3D11_TEXTURE2D_DESC desc;
     desc.Width = twidth;
     desc.Height = theight;
-    desc.MipLevels = (autogen) ? 0 : 1;
+    desc.MipLevels = (autogen) ? 0 : mipLevels;
     desc.ArraySize = 1;
     desc.Format = format;
     desc.SampleDesc.Count = 1;
@@ -488,13 +544,8 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
     desc.CPUAccessFlags = 0;
     desc.MiscFlags = (autogen) ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0;
 
-    D3D11_SUBRESOURCE_DATA initData;
-    initData.pSysMem = temp.get();
-    initData.SysMemPitch = static_cast<UINT>(rowPitch);
-    initData.SysMemSlicePitch = static_cast<UINT>(imageSize);
-
     ID3D11Texture2D* tex = nullptr;
-    hr = d3dDevice->CreateTexture2D(&desc, (autogen) ? nullptr : &initData, &tex);
+    hr = d3dDevice->CreateTexture2D(&desc, (autogen) ? nullptr : initData.data(), &tex);
     if (SUCCEEDED(hr) && tex != 0)
     {
         if (textureView != 0)
@@ -503,7 +554,7 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
             memset(&SRVDesc, 0, sizeof(SRVDesc));
             SRVDesc.Format = format;
             SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-            SRVDesc.Texture2D.MipLevels = (autogen) ? -1 : 1;
+            SRVDesc.Texture2D.MipLevels = (autogen) ? -1 : mipLevels;
 
             hr = d3dDevice->CreateShaderResourceView(tex, &SRVDesc, textureView);
             if (FAILED(hr))
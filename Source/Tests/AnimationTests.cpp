@@ -0,0 +1,1054 @@
+#include "Tests.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <execution>
+#include <random>
+#include <thread>
+
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+
+#include "Model/AnimationClip.h"
+#include "Model/Model.h"
+#include "TestUtilities.h"
+
+namespace tests
+{
+    namespace
+    {
+        constexpr const UINT KEY_LOOKUP_NUM_LOOPS = 32u;
+        constexpr const FLOAT KEY_LOOKUP_FRAME_RATE = 60.0f;
+        constexpr const FLOAT DEFAULT_TICKS_PER_SECOND = 25.0f;
+
+        constexpr const UINT BLEND_LAYER_COUNTS[] = { 1u, 2u, 4u, 8u };
+        constexpr const UINT BLEND_NUM_FRAMES = 2048u;
+        constexpr const FLOAT BLEND_DELTA_TIME = 1.0f / 60.0f;
+        // Long enough for the weights to barely change while the layers are timed
+        constexpr const FLOAT BLEND_FADE_DURATION = 1.0e4f;
+        constexpr const FLOAT BLEND_STAGGER_TIME = 0.1f;
+        constexpr const FLOAT MAX_SHARED_POSE_ERROR = 1.0e-3f;
+
+        constexpr const FLOAT MAX_TRANSLATION_ERROR = 1.0e-2f;
+        constexpr const FLOAT MAX_ROTATION_ERROR = 1.0f;
+
+        constexpr const UINT SCALING_INSTANCE_COUNTS[] = { 1u, 16u, 128u, 1024u };
+        constexpr const UINT SCALING_NUM_WARMUP_FRAMES = 5u;
+        constexpr const UINT SCALING_NUM_FRAMES = 60u;
+        constexpr const FLOAT SCALING_DELTA_TIME = 1.0f / 60.0f;
+
+        // Keep the benchmarked lookups and samples from being optimized away
+        volatile UINT g_uKeyIndexSink = 0u;
+        volatile FLOAT g_sampleSink = 0.0f;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ChannelKeyTimes
+
+          Summary:  Times of the position, rotation and scaling keys of
+                    an assimp channel, stored like the tracks of
+                    AnimationClip
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ChannelKeyTimes
+        {
+            std::vector<FLOAT> aPositionTimes;
+            std::vector<FLOAT> aRotationTimes;
+            std::vector<FLOAT> aScalingTimes;
+        };
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetKeyTimes
+
+          Summary:  Copies the times of assimp keys
+
+          Args:     const Key* aKeys
+                      Assimp keys
+                    UINT uNumKeys
+                      Number of keys
+
+          Returns:  std::vector<FLOAT>
+                      Key times in ascending order
+        -----------------------------------------------------------------F-F*/
+        template <class Key>
+        std::vector<FLOAT> GetKeyTimes(_In_reads_(uNumKeys) const Key* aKeys, _In_ UINT uNumKeys)
+        {
+            std::vector<FLOAT> aTimes(uNumKeys);
+            for (UINT i = 0u; i < uNumKeys; ++i)
+            {
+                aTimes[i] = static_cast<FLOAT>(aKeys[i].mTime);
+            }
+
+            return aTimes;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetChannelKeyTimes
+
+          Summary:  Copies the key times of every channel of an animation
+
+          Args:     const aiAnimation* pAnimation
+                      Animation
+
+          Returns:  std::vector<ChannelKeyTimes>
+                      Key times of each channel
+        -----------------------------------------------------------------F-F*/
+        std::vector<ChannelKeyTimes> GetChannelKeyTimes(_In_ const aiAnimation* pAnimation)
+        {
+            std::vector<ChannelKeyTimes> aChannels(pAnimation->mNumChannels);
+            for (UINT uChannel = 0u; uChannel < pAnimation->mNumChannels; ++uChannel)
+            {
+                const aiNodeAnim* pNodeAnim = pAnimation->mChannels[uChannel];
+                aChannels[uChannel].aPositionTimes = GetKeyTimes(pNodeAnim->mPositionKeys, pNodeAnim->mNumPositionKeys);
+                aChannels[uChannel].aRotationTimes = GetKeyTimes(pNodeAnim->mRotationKeys, pNodeAnim->mNumRotationKeys);
+                aChannels[uChannel].aScalingTimes = GetKeyTimes(pNodeAnim->mScalingKeys, pNodeAnim->mNumScalingKeys);
+            }
+
+            return aChannels;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: FindKeyLinear
+
+          Summary:  Finds the key right before the given time by scanning
+                    from the first key, as Model::findPosition,
+                    findRotation and findScaling did before the keys had
+                    cursors
+
+          Args:     FLOAT animationTimeTicks
+                      Time to find
+                    const FLOAT* aTimes
+                      Key times in ascending order
+                    UINT uNumKeys
+                      Number of keys, at least 2
+
+          Returns:  UINT
+                      Index of the key
+        -----------------------------------------------------------------F-F*/
+        UINT FindKeyLinear(_In_ FLOAT animationTimeTicks, _In_reads_(uNumKeys) const FLOAT* aTimes, _In_ UINT uNumKeys)
+        {
+            for (UINT i = 0u; i < uNumKeys - 1u; ++i)
+            {
+                if (animationTimeTicks < aTimes[i + 1u])
+                {
+                    return i;
+                }
+            }
+
+            return uNumKeys - 2u;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: FindKey
+
+          Summary:  Finds the key right before the given time with a
+                    linear scan or with the cursor of the track
+
+          Args:     FLOAT animationTimeTicks
+                      Time to find
+                    const std::vector<FLOAT>& aTimes
+                      Key times in ascending order
+                    BOOL bUseCursor
+                      Whether to search from the cursor
+                    UINT& uCursor
+                      Key index found on the previous call
+
+          Modifies: [uCursor].
+
+          Returns:  UINT
+                      Index of the key, 0 if the track has a single key
+        -----------------------------------------------------------------F-F*/
+        UINT FindKey(_In_ FLOAT animationTimeTicks, _In_ const std::vector<FLOAT>& aTimes, _In_ BOOL bUseCursor, _Inout_ UINT& uCursor)
+        {
+            const UINT uNumKeys = static_cast<UINT>(aTimes.size());
+            if (uNumKeys < 2u)
+            {
+                return 0u;
+            }
+
+            return bUseCursor
+                ? library::AnimationClip::FindKeyIndex(animationTimeTicks, aTimes.data(), uNumKeys, uCursor)
+                : FindKeyLinear(animationTimeTicks, aTimes.data(), uNumKeys);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: FindChannelKeys
+
+          Summary:  Finds the position, rotation and scaling keys of a
+                    channel at the given time
+
+          Args:     const ChannelKeyTimes& channel
+                      Key times of the channel
+                    FLOAT animationTimeTicks
+                      Time to find
+                    BOOL bUseCursors
+                      Whether to search from the cursors
+                    UINT* aCursors
+                      Position, rotation and scaling cursors
+
+          Modifies: [aCursors].
+
+          Returns:  UINT
+                      Sum of the indices of the keys
+        -----------------------------------------------------------------F-F*/
+        UINT FindChannelKeys(_In_ const ChannelKeyTimes& channel, _In_ FLOAT animationTimeTicks, _In_ BOOL bUseCursors, _Inout_updates_(3) UINT* aCursors)
+        {
+            return FindKey(animationTimeTicks, channel.aPositionTimes, bUseCursors, aCursors[0])
+                + FindKey(animationTimeTicks, channel.aRotationTimes, bUseCursors, aCursors[1])
+                + FindKey(animationTimeTicks, channel.aScalingTimes, bUseCursors, aCursors[2]);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: TimeKeyLookups
+
+          Summary:  Finds the keys of every channel at every time, with
+                    linear scans or with one cursor per key track
+
+          Args:     const std::vector<ChannelKeyTimes>& aChannels
+                      Key times of each channel
+                    const std::vector<FLOAT>& aTimes
+                      Times in ticks
+                    BOOL bUseCursors
+                      Whether to search from the cursors
+
+          Returns:  DOUBLE
+                      Time in milliseconds
+        -----------------------------------------------------------------F-F*/
+        DOUBLE TimeKeyLookups(_In_ const std::vector<ChannelKeyTimes>& aChannels, _In_ const std::vector<FLOAT>& aTimes, _In_ BOOL bUseCursors)
+        {
+            std::vector<UINT> aCursors(aChannels.size() * 3u, 0u);
+
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+
+            UINT uSum = 0u;
+            for (FLOAT animationTimeTicks : aTimes)
+            {
+                for (size_t uChannel = 0u; uChannel < aChannels.size(); ++uChannel)
+                {
+                    uSum += FindChannelKeys(aChannels[uChannel], animationTimeTicks, bUseCursors, &aCursors[uChannel * 3u]);
+                }
+            }
+
+            const DOUBLE time = GetElapsedMilliseconds(startingTime);
+            g_uKeyIndexSink = uSum;
+
+            return time;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: CheckKeyLookups
+
+          Summary:  Checks that the cursors find the same key as a linear
+                    scan at every time, whatever key they were left at
+
+          Args:     const std::vector<ChannelKeyTimes>& aChannels
+                      Key times of each channel
+                    const std::vector<FLOAT>& aTimes
+                      Times in ticks
+
+          Returns:  BOOL
+                      TRUE if every key matches
+        -----------------------------------------------------------------F-F*/
+        BOOL CheckKeyLookups(_In_ const std::vector<ChannelKeyTimes>& aChannels, _In_ const std::vector<FLOAT>& aTimes)
+        {
+            std::vector<UINT> aCursors(aChannels.size() * 3u, 0u);
+
+            for (FLOAT animationTimeTicks : aTimes)
+            {
+                for (size_t uChannel = 0u; uChannel < aChannels.size(); ++uChannel)
+                {
+                    const ChannelKeyTimes& channel = aChannels[uChannel];
+                    UINT* aChannelCursors = &aCursors[uChannel * 3u];
+
+                    if (FindKey(animationTimeTicks, channel.aPositionTimes, TRUE, aChannelCursors[0])
+                            != FindKey(animationTimeTicks, channel.aPositionTimes, FALSE, aChannelCursors[0])
+                        || FindKey(animationTimeTicks, channel.aRotationTimes, TRUE, aChannelCursors[1])
+                            != FindKey(animationTimeTicks, channel.aRotationTimes, FALSE, aChannelCursors[1])
+                        || FindKey(animationTimeTicks, channel.aScalingTimes, TRUE, aChannelCursors[2])
+                            != FindKey(animationTimeTicks, channel.aScalingTimes, FALSE, aChannelCursors[2]))
+                    {
+                        return FALSE;
+                    }
+                }
+            }
+
+            return TRUE;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetKeyFactor
+
+          Summary:  Returns how far a time is between two keys
+
+          Args:     FLOAT animationTimeTicks
+                      Sampled time
+                    FLOAT startTime
+                      Time of the first key
+                    FLOAT endTime
+                      Time of the second key
+
+          Returns:  FLOAT
+                      Interpolation factor between 0 and 1
+        -----------------------------------------------------------------F-F*/
+        FLOAT GetKeyFactor(_In_ FLOAT animationTimeTicks, _In_ FLOAT startTime, _In_ FLOAT endTime)
+        {
+            return std::clamp((animationTimeTicks - startTime) / (endTime - startTime), 0.0f, 1.0f);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: SampleVectorKeys
+
+          Summary:  Interpolates assimp vector keys found with a cursor
+
+          Args:     FLOAT animationTimeTicks
+                      Sampled time
+                    const aiVectorKey* aKeys
+                      Assimp keys
+                    const std::vector<FLOAT>& aTimes
+                      Times of the keys
+                    UINT& uCursor
+                      Key index found on the previous call
+
+          Modifies: [uCursor].
+
+          Returns:  XMVECTOR
+                      Interpolated value
+        -----------------------------------------------------------------F-F*/
+        XMVECTOR SampleVectorKeys(_In_ FLOAT animationTimeTicks, _In_ const aiVectorKey* aKeys, _In_ const std::vector<FLOAT>& aTimes, _Inout_ UINT& uCursor)
+        {
+            if (aTimes.size() == 1u)
+            {
+                return XMVectorSet(aKeys[0].mValue.x, aKeys[0].mValue.y, aKeys[0].mValue.z, 0.0f);
+            }
+
+            const UINT uIndex = FindKey(animationTimeTicks, aTimes, TRUE, uCursor);
+            const FLOAT factor = GetKeyFactor(animationTimeTicks, aTimes[uIndex], aTimes[uIndex + 1u]);
+            const aiVector3D& start = aKeys[uIndex].mValue;
+            const aiVector3D& end = aKeys[uIndex + 1u].mValue;
+            const aiVector3D value = start + factor * (end - start);
+
+            return XMVectorSet(value.x, value.y, value.z, 0.0f);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: SampleRotationKeys
+
+          Summary:  Interpolates assimp rotation keys found with a cursor
+
+          Args:     FLOAT animationTimeTicks
+                      Sampled time
+                    const aiQuatKey* aKeys
+                      Assimp keys
+                    const std::vector<FLOAT>& aTimes
+                      Times of the keys
+                    UINT& uCursor
+                      Key index found on the previous call
+
+          Modifies: [uCursor].
+
+          Returns:  XMVECTOR
+                      Interpolated quaternion
+        -----------------------------------------------------------------F-F*/
+        XMVECTOR SampleRotationKeys(_In_ FLOAT animationTimeTicks, _In_ const aiQuatKey* aKeys, _In_ const std::vector<FLOAT>& aTimes, _Inout_ UINT& uCursor)
+        {
+            aiQuaternion value = aKeys[0].mValue;
+            if (aTimes.size() > 1u)
+            {
+                const UINT uIndex = FindKey(animationTimeTicks, aTimes, TRUE, uCursor);
+                const FLOAT factor = GetKeyFactor(animationTimeTicks, aTimes[uIndex], aTimes[uIndex + 1u]);
+                aiQuaternion::Interpolate(value, aKeys[uIndex].mValue, aKeys[uIndex + 1u].mValue, factor);
+                value.Normalize();
+            }
+
+            return XMVectorSet(value.x, value.y, value.z, value.w);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: SampleChannel
+
+          Summary:  Samples an assimp channel the way Model did before
+                    the animations were converted to clips, with one
+                    cursor per key track
+
+          Args:     const aiNodeAnim* pNodeAnim
+                      Sampled channel
+                    const ChannelKeyTimes& channel
+                      Key times of the channel
+                    FLOAT animationTimeTicks
+                      Sampled time
+                    UINT* aCursors
+                      Position, rotation and scaling cursors
+                    XMVECTOR& scale
+                      Sampled scale
+                    XMVECTOR& rotation
+                      Sampled rotation
+                    XMVECTOR& translation
+                      Sampled translation
+
+          Modifies: [aCursors, scale, rotation, translation].
+        -----------------------------------------------------------------F-F*/
+        void SampleChannel(
+            _In_ const aiNodeAnim* pNodeAnim,
+            _In_ const ChannelKeyTimes& channel,
+            _In_ FLOAT animationTimeTicks,
+            _Inout_updates_(3) UINT* aCursors,
+            _Out_ XMVECTOR& scale,
+            _Out_ XMVECTOR& rotation,
+            _Out_ XMVECTOR& translation
+        )
+        {
+            translation = SampleVectorKeys(animationTimeTicks, pNodeAnim->mPositionKeys, channel.aPositionTimes, aCursors[0]);
+            rotation = SampleRotationKeys(animationTimeTicks, pNodeAnim->mRotationKeys, channel.aRotationTimes, aCursors[1]);
+            scale = SampleVectorKeys(animationTimeTicks, pNodeAnim->mScalingKeys, channel.aScalingTimes, aCursors[2]);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: TimeChannelSampling
+
+          Summary:  Samples every assimp channel at every time with one
+                    cursor per key track
+
+          Args:     const aiAnimation* pAnimation
+                      Sampled animation
+                    const std::vector<ChannelKeyTimes>& aChannels
+                      Key times of each channel
+                    const std::vector<FLOAT>& aTimes
+                      Sampled times in ticks
+
+          Returns:  DOUBLE
+                      Time in milliseconds
+        -----------------------------------------------------------------F-F*/
+        DOUBLE TimeChannelSampling(_In_ const aiAnimation* pAnimation, _In_ const std::vector<ChannelKeyTimes>& aChannels, _In_ const std::vector<FLOAT>& aTimes)
+        {
+            std::vector<UINT> aCursors(aChannels.size() * 3u, 0u);
+
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+
+            XMVECTOR sum = XMVectorZero();
+            for (FLOAT animationTimeTicks : aTimes)
+            {
+                for (UINT uChannel = 0u; uChannel < pAnimation->mNumChannels; ++uChannel)
+                {
+                    XMVECTOR scale;
+                    XMVECTOR rotation;
+                    XMVECTOR translation;
+                    SampleChannel(pAnimation->mChannels[uChannel], aChannels[uChannel], animationTimeTicks, &aCursors[uChannel * 3u], scale, rotation, translation);
+                    sum = XMVectorAdd(sum, XMVectorAdd(scale, XMVectorAdd(rotation, translation)));
+                }
+            }
+
+            const DOUBLE time = GetElapsedMilliseconds(startingTime);
+            g_sampleSink = XMVectorGetX(sum);
+
+            return time;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: TimeClipSampling
+
+          Summary:  Samples every joint of a clip at every time through
+                    one key cursor per joint
+
+          Args:     const library::AnimationClip& clip
+                      Sampled clip
+                    UINT uNumJoints
+                      Number of joints of the clip
+                    const std::vector<FLOAT>& aTimes
+                      Sampled times in ticks
+
+          Returns:  DOUBLE
+                      Time in milliseconds
+        -----------------------------------------------------------------F-F*/
+        DOUBLE TimeClipSampling(_In_ const library::AnimationClip& clip, _In_ UINT uNumJoints, _In_ const std::vector<FLOAT>& aTimes)
+        {
+            std::vector<library::AnimationClip::KeyCursor> aCursors(uNumJoints);
+
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+
+            XMVECTOR sum = XMVectorZero();
+            for (FLOAT animationTimeTicks : aTimes)
+            {
+                for (UINT uJoint = 0u; uJoint < uNumJoints; ++uJoint)
+                {
+                    XMVECTOR scale = XMVectorSplatOne();
+                    XMVECTOR rotation = XMQuaternionIdentity();
+                    XMVECTOR translation = XMVectorZero();
+                    clip.Sample(animationTimeTicks, uJoint, aCursors[uJoint], scale, rotation, translation);
+                    sum = XMVectorAdd(sum, XMVectorAdd(scale, XMVectorAdd(rotation, translation)));
+                }
+            }
+
+            const DOUBLE time = GetElapsedMilliseconds(startingTime);
+            g_sampleSink = XMVectorGetX(sum);
+
+            return time;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetFrameTimes
+
+          Summary:  Returns the times of a number of loops of an
+                    animation played at 60 frames per second
+
+          Args:     FLOAT ticksPerSecond
+                      Ticks per second of the animation
+                    FLOAT durationTicks
+                      Duration of the animation in ticks
+
+          Returns:  std::vector<FLOAT>
+                      Times in ticks
+        -----------------------------------------------------------------F-F*/
+        std::vector<FLOAT> GetFrameTimes(_In_ FLOAT ticksPerSecond, _In_ FLOAT durationTicks)
+        {
+            const UINT uNumFramesPerLoop = static_cast<UINT>(durationTicks / ticksPerSecond * KEY_LOOKUP_FRAME_RATE) + 1u;
+
+            std::vector<FLOAT> aTimes(static_cast<size_t>(uNumFramesPerLoop) * KEY_LOOKUP_NUM_LOOPS);
+            for (UINT uFrame = 0u; uFrame < aTimes.size(); ++uFrame)
+            {
+                aTimes[uFrame] = fmodf(static_cast<FLOAT>(uFrame) * ticksPerSecond / KEY_LOOKUP_FRAME_RATE, durationTicks);
+            }
+
+            return aTimes;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: StartLayers
+
+          Summary:  Plays the first animation of a model and cross-fades
+                    it into itself until the model plays the given number
+                    of layers. The fades are long enough for every layer
+                    to keep playing while it is timed.
+
+          Args:     library::Model& model
+                      Animated model
+                    UINT uNumLayers
+                      Number of layers to play
+                    BOOL bStagger
+                      Whether each layer starts at a different time. If
+                      not, every layer plays the same time.
+
+          Modifies: [model].
+        -----------------------------------------------------------------F-F*/
+        void StartLayers(_Inout_ library::Model& model, _In_ UINT uNumLayers, _In_ BOOL bStagger)
+        {
+            model.PlayAnimation(0u, TRUE);
+
+            for (UINT uLayer = 1u; uLayer < uNumLayers; ++uLayer)
+            {
+                if (bStagger)
+                {
+                    model.Update(BLEND_STAGGER_TIME);
+                }
+
+                model.CrossFadeAnimation(0u, BLEND_FADE_DURATION, TRUE);
+            }
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: TimeBlending
+
+          Summary:  Times the updates of a model playing its layers
+
+          Args:     library::Model& model
+                      Animated model
+
+          Modifies: [model].
+
+          Returns:  DOUBLE
+                      Mean time of an update in milliseconds
+        -----------------------------------------------------------------F-F*/
+        DOUBLE TimeBlending(_Inout_ library::Model& model)
+        {
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+
+            for (UINT uFrame = 0u; uFrame < BLEND_NUM_FRAMES; ++uFrame)
+            {
+                model.Update(BLEND_DELTA_TIME);
+            }
+
+            return GetElapsedMilliseconds(startingTime) / static_cast<DOUBLE>(BLEND_NUM_FRAMES);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetLargestDifference
+
+          Summary:  Returns the largest difference between the elements
+                    of two bone palettes
+
+          Args:     const std::vector<XMMATRIX>& aTransforms
+                      First palette
+                    const std::vector<XMMATRIX>& aOtherTransforms
+                      Second palette
+
+          Returns:  FLOAT
+                      Largest difference, infinite if the palettes do not
+                      have the same size
+        -----------------------------------------------------------------F-F*/
+        FLOAT GetLargestDifference(_In_ const std::vector<XMMATRIX>& aTransforms, _In_ const std::vector<XMMATRIX>& aOtherTransforms)
+        {
+            if (aTransforms.size() != aOtherTransforms.size())
+            {
+                return INFINITY;
+            }
+
+            XMVECTOR largestDifference = XMVectorZero();
+            for (size_t i = 0; i < aTransforms.size(); ++i)
+            {
+                for (UINT uRow = 0u; uRow < 4u; ++uRow)
+                {
+                    largestDifference = XMVectorMax(largestDifference, XMVectorAbs(XMVectorSubtract(aTransforms[i].r[uRow], aOtherTransforms[i].r[uRow])));
+                }
+            }
+
+            XMFLOAT4 difference;
+            XMStoreFloat4(&difference, largestDifference);
+
+            return std::max(std::max(difference.x, difference.y), std::max(difference.z, difference.w));
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: CreateAnimatedModels
+
+          Summary:  Creates models of boblampclean.md5mesh playing their
+                    first animation
+
+          Args:     ID3D11Device* pDevice
+                      Device creating the buffers
+                    ID3D11DeviceContext* pImmediateContext
+                      Context of the device
+                    UINT uNumModels
+                      Number of models to create
+                    std::vector<std::shared_ptr<library::Model>>& aOutModels
+                      Created models
+
+          Modifies: [aOutModels].
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT CreateAnimatedModels(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ UINT uNumModels,
+            _Out_ std::vector<std::shared_ptr<library::Model>>& aOutModels
+        )
+        {
+            aOutModels.clear();
+            aOutModels.reserve(uNumModels);
+
+            for (UINT i = 0u; i < uNumModels; ++i)
+            {
+                std::shared_ptr<library::Model> pModel = std::make_shared<library::Model>(L"Content/BobLampClean/boblampclean.md5mesh");
+
+                HRESULT hr = pModel->Initialize(pDevice, pImmediateContext);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                aOutModels.push_back(pModel);
+            }
+
+            return S_OK;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: UpdateModels
+
+          Summary:  Updates the models split in contiguous ranges, one per
+                    thread, and joins the threads before returning
+
+          Args:     const std::vector<std::shared_ptr<library::Model>>& aModels
+                      Updated models
+                    UINT uNumThreads
+                      Number of threads, including the calling one
+                    FLOAT deltaTime
+                      Time since the last update in seconds
+        -----------------------------------------------------------------F-F*/
+        void UpdateModels(_In_ const std::vector<std::shared_ptr<library::Model>>& aModels, _In_ UINT uNumThreads, _In_ FLOAT deltaTime)
+        {
+            auto updateRange = [&aModels, deltaTime](size_t uBegin, size_t uEnd)
+            {
+                for (size_t i = uBegin; i < uEnd; ++i)
+                {
+                    aModels[i]->Update(deltaTime);
+                }
+            };
+
+            std::vector<std::jthread> aThreads;
+            aThreads.reserve(uNumThreads - 1u);
+            for (UINT uThread = 1u; uThread < uNumThreads; ++uThread)
+            {
+                aThreads.emplace_back(updateRange, aModels.size() * uThread / uNumThreads, aModels.size() * (uThread + 1u) / uNumThreads);
+            }
+
+            updateRange(0u, aModels.size() / uNumThreads);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: TimeModelUpdates
+
+          Summary:  Times the updates of the models on a given number of
+                    threads, or through the parallel algorithm used by
+                    Scene::Update if the number is 0
+
+          Args:     const std::vector<std::shared_ptr<library::Model>>& aModels
+                      Updated models
+                    UINT uNumThreads
+                      Number of threads, or 0
+
+          Returns:  DOUBLE
+                      Mean time of a frame in milliseconds
+        -----------------------------------------------------------------F-F*/
+        DOUBLE TimeModelUpdates(_In_ const std::vector<std::shared_ptr<library::Model>>& aModels, _In_ UINT uNumThreads)
+        {
+            LARGE_INTEGER startingTime;
+            for (UINT uFrame = 0u; uFrame < SCALING_NUM_WARMUP_FRAMES + SCALING_NUM_FRAMES; ++uFrame)
+            {
+                if (uFrame == SCALING_NUM_WARMUP_FRAMES)
+                {
+                    QueryPerformanceCounter(&startingTime);
+                }
+
+                if (uNumThreads == 0u)
+                {
+                    std::for_each(std::execution::par, aModels.begin(), aModels.end(),
+                        [](const std::shared_ptr<library::Model>& pModel)
+                        {
+                            pModel->Update(SCALING_DELTA_TIME);
+                        }
+                    );
+                }
+                else
+                {
+                    UpdateModels(aModels, uNumThreads, SCALING_DELTA_TIME);
+                }
+            }
+
+            return GetElapsedMilliseconds(startingTime) / static_cast<DOUBLE>(SCALING_NUM_FRAMES);
+        }
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestAnimationKeyLookup
+
+      Summary:  Microbenchmark of the key lookup of boblampclean.md5anim.
+                The keys of every channel are found at 60 frames per
+                second, in playback order and in random order, once with
+                the linear scans Model used to do and once with the key
+                cursors of AnimationClip::FindKeyIndex, over the same key
+                times. Checks that both find the same keys.
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestAnimationKeyLookup()
+    {
+        Assimp::Importer importer;
+        const aiScene* pScene = importer.ReadFile("Content/BobLampClean/boblampclean.md5mesh", ASSIMP_LOAD_FLAGS);
+        if (!Check(pScene && pScene->mNumAnimations > 0u, "boblampclean.md5mesh loads with its md5anim"))
+        {
+            return E_FAIL;
+        }
+
+        const aiAnimation* pAnimation = pScene->mAnimations[0];
+        const FLOAT ticksPerSecond = pAnimation->mTicksPerSecond != 0.0 ? static_cast<FLOAT>(pAnimation->mTicksPerSecond) : DEFAULT_TICKS_PER_SECOND;
+        const std::vector<ChannelKeyTimes> aChannels = GetChannelKeyTimes(pAnimation);
+
+        const std::vector<FLOAT> aTimes = GetFrameTimes(ticksPerSecond, static_cast<FLOAT>(pAnimation->mDuration));
+        std::vector<FLOAT> aRandomTimes(aTimes);
+        std::shuffle(aRandomTimes.begin(), aRandomTimes.end(), std::mt19937(1u));
+
+        const DOUBLE numLookups = static_cast<DOUBLE>(aTimes.size()) * static_cast<DOUBLE>(aChannels.size()) * 3.0;
+        const DOUBLE linearTime = TimeKeyLookups(aChannels, aTimes, FALSE) * 1.0e6 / numLookups;
+        const DOUBLE cursorTime = TimeKeyLookups(aChannels, aTimes, TRUE) * 1.0e6 / numLookups;
+        const DOUBLE randomLinearTime = TimeKeyLookups(aChannels, aRandomTimes, FALSE) * 1.0e6 / numLookups;
+        const DOUBLE randomCursorTime = TimeKeyLookups(aChannels, aRandomTimes, TRUE) * 1.0e6 / numLookups;
+
+        printf("    %zu channels, %zu frames: linear scan %.1f ns, cursors %.1f ns per key lookup in playback order (%.2fx)\n",
+            aChannels.size(),
+            aTimes.size(),
+            linearTime,
+            cursorTime,
+            linearTime / cursorTime);
+        printf("    random order: linear scan %.1f ns, cursors %.1f ns per key lookup (%.2fx)\n",
+            randomLinearTime,
+            randomCursorTime,
+            randomLinearTime / randomCursorTime);
+
+        BOOL bPassed = Check(CheckKeyLookups(aChannels, aTimes), "the cursors find the keys of a linear scan in playback order");
+        bPassed &= Check(CheckKeyLookups(aChannels, aRandomTimes), "the cursors find the keys of a linear scan in random order");
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestAnimationSampling
+
+      Summary:  Sampling throughput of AnimationClip against the
+                current path. Every bone of boblampclean.md5anim is
+                sampled at 60 frames per second, in playback order and
+                in random order, once from the assimp keys with one
+                cursor per key track, as Model did before the clips, and
+                once from the compressed clip. Checks that the clip
+                stays close to the assimp keys, and that a cursor left
+                at any key samples the same as a new one.
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestAnimationSampling()
+    {
+        Assimp::Importer importer;
+        const aiScene* pScene = importer.ReadFile("Content/BobLampClean/boblampclean.md5mesh", ASSIMP_LOAD_FLAGS);
+        if (!Check(pScene && pScene->mNumAnimations > 0u, "boblampclean.md5mesh loads with its md5anim"))
+        {
+            return E_FAIL;
+        }
+
+        const aiAnimation* pAnimation = pScene->mAnimations[0];
+        const UINT uNumJoints = pAnimation->mNumChannels;
+        const std::vector<ChannelKeyTimes> aChannels = GetChannelKeyTimes(pAnimation);
+
+        // One joint per channel, so joint i samples the track of channel i
+        std::vector<std::string> aJointNames(uNumJoints);
+        for (UINT uChannel = 0u; uChannel < uNumJoints; ++uChannel)
+        {
+            aJointNames[uChannel] = pAnimation->mChannels[uChannel]->mNodeName.C_Str();
+        }
+
+        library::AnimationClip clip;
+        HRESULT hr = clip.Initialize(pAnimation, aJointNames);
+        if (!Check(SUCCEEDED(hr), "the animation converts to a clip"))
+        {
+            return hr;
+        }
+
+        const FLOAT ticksPerSecond = clip.GetTicksPerSecond() != 0.0f ? clip.GetTicksPerSecond() : DEFAULT_TICKS_PER_SECOND;
+        const std::vector<FLOAT> aTimes = GetFrameTimes(ticksPerSecond, clip.GetDurationTicks());
+        std::vector<FLOAT> aRandomTimes(aTimes);
+        std::shuffle(aRandomTimes.begin(), aRandomTimes.end(), std::mt19937(1u));
+
+        const DOUBLE numSamples = static_cast<DOUBLE>(aTimes.size()) * static_cast<DOUBLE>(uNumJoints);
+        const DOUBLE channelTime = TimeChannelSampling(pAnimation, aChannels, aTimes) * 1.0e6 / numSamples;
+        const DOUBLE clipTime = TimeClipSampling(clip, uNumJoints, aTimes) * 1.0e6 / numSamples;
+        const DOUBLE randomChannelTime = TimeChannelSampling(pAnimation, aChannels, aRandomTimes) * 1.0e6 / numSamples;
+        const DOUBLE randomClipTime = TimeClipSampling(clip, uNumJoints, aRandomTimes) * 1.0e6 / numSamples;
+
+        printf("    %u bones, %zu frames: assimp keys %.1f ns, clip %.1f ns per bone sample in playback order (%.2fx)\n",
+            uNumJoints,
+            aTimes.size(),
+            channelTime,
+            clipTime,
+            channelTime / clipTime);
+        printf("    random order: assimp keys %.1f ns, clip %.1f ns per bone sample (%.2fx)\n",
+            randomChannelTime,
+            randomClipTime,
+            randomChannelTime / randomClipTime);
+        printf("    keys: %zu bytes in assimp, %zu bytes in the clip\n", clip.GetSourceSize(), clip.GetCompressedSize());
+
+        FLOAT maxTranslationError = 0.0f;
+        FLOAT maxRotationError = 0.0f;
+        BOOL bCursorsMatch = TRUE;
+        std::vector<UINT> aChannelCursors(aChannels.size() * 3u, 0u);
+        std::vector<library::AnimationClip::KeyCursor> aCursors(uNumJoints);
+        for (FLOAT animationTimeTicks : aRandomTimes)
+        {
+            for (UINT uJoint = 0u; uJoint < uNumJoints; ++uJoint)
+            {
+                XMVECTOR scale;
+                XMVECTOR rotation;
+                XMVECTOR translation;
+                SampleChannel(pAnimation->mChannels[uJoint], aChannels[uJoint], animationTimeTicks, &aChannelCursors[uJoint * 3u], scale, rotation, translation);
+
+                XMVECTOR clipScale = XMVectorSplatOne();
+                XMVECTOR clipRotation = XMQuaternionIdentity();
+                XMVECTOR clipTranslation = XMVectorZero();
+                clip.Sample(animationTimeTicks, uJoint, aCursors[uJoint], clipScale, clipRotation, clipTranslation);
+
+                library::AnimationClip::KeyCursor newCursor;
+                XMVECTOR newScale = XMVectorSplatOne();
+                XMVECTOR newRotation = XMQuaternionIdentity();
+                XMVECTOR newTranslation = XMVectorZero();
+                clip.Sample(animationTimeTicks, uJoint, newCursor, newScale, newRotation, newTranslation);
+
+                bCursorsMatch = bCursorsMatch
+                    && XMVector4Equal(clipScale, newScale)
+                    && XMVector4Equal(clipRotation, newRotation)
+                    && XMVector4Equal(clipTranslation, newTranslation);
+
+                const FLOAT dot = std::min(fabsf(XMVectorGetX(XMQuaternionDot(rotation, clipRotation))), 1.0f);
+                maxRotationError = std::max(maxRotationError, XMConvertToDegrees(2.0f * acosf(dot)));
+                maxTranslationError = std::max(maxTranslationError, XMVectorGetX(XMVector3Length(XMVectorSubtract(translation, clipTranslation))));
+            }
+        }
+
+        printf("    largest error of the clip: %.5f translation, %.3f degrees rotation\n", maxTranslationError, maxRotationError);
+
+        BOOL bPassed = Check(bCursorsMatch, "a cursor left at any key samples the same as a new cursor");
+        bPassed &= Check(maxTranslationError <= MAX_TRANSLATION_ERROR, "the clip translations stay within 0.01 of the assimp keys");
+        bPassed &= Check(maxRotationError <= MAX_ROTATION_ERROR, "the clip rotations stay within 1 degree of the assimp keys");
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestAnimationBlending
+
+      Summary:  Benchmark of the layer blending of a boblampclean model.
+                The model cross-fades its animation into itself until it
+                plays 1, 2, 4 and 8 layers, and the time of an update is
+                printed per blended bone. The layers start at different
+                times, then all at the same time. Checks that layers at
+                different times sample their own pose, that layers at
+                the same time share one, and that blending the shared
+                pose gives the pose of a single layer.
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestAnimationBlending()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a headless device is created"))
+        {
+            return hr;
+        }
+
+        library::Model model(L"Content/BobLampClean/boblampclean.md5mesh");
+        library::Model referenceModel(L"Content/BobLampClean/boblampclean.md5mesh");
+
+        // Only the blending is timed, not the skinning of the vertices
+        model.SetCpuSkinningEnabled(FALSE);
+        referenceModel.SetCpuSkinningEnabled(FALSE);
+
+        hr = model.Initialize(device.Get(), immediateContext.Get());
+        if (SUCCEEDED(hr))
+        {
+            hr = referenceModel.Initialize(device.Get(), immediateContext.Get());
+        }
+        if (!Check(SUCCEEDED(hr) && model.GetNumAnimations() > 0u, "boblampclean.md5mesh loads with its md5anim"))
+        {
+            return FAILED(hr) ? hr : E_FAIL;
+        }
+
+        const UINT uNumJoints = model.GetNumAnimatedNodes(0u) + model.GetNumStaticNodes(0u);
+
+        BOOL bPassed = TRUE;
+        for (UINT uNumLayers : BLEND_LAYER_COUNTS)
+        {
+            StartLayers(model, uNumLayers, TRUE);
+            const DOUBLE time = TimeBlending(model) * 1.0e6 / static_cast<DOUBLE>(uNumJoints);
+            const UINT uNumPoses = model.GetNumSampledPoses();
+
+            StartLayers(model, uNumLayers, FALSE);
+            const DOUBLE sharedTime = TimeBlending(model) * 1.0e6 / static_cast<DOUBLE>(uNumJoints);
+            const UINT uNumSharedPoses = model.GetNumSampledPoses();
+
+            printf("    %u layer%s, %u bones: %.1f ns per blended bone with %u sampled poses, %.1f ns with %u shared pose%s\n",
+                uNumLayers,
+                uNumLayers == 1u ? "" : "s",
+                uNumJoints,
+                time,
+                uNumPoses,
+                sharedTime,
+                uNumSharedPoses,
+                uNumSharedPoses == 1u ? "" : "s");
+
+            bPassed &= Check(uNumPoses == uNumLayers, "layers at different times sample their own pose");
+            bPassed &= Check(uNumSharedPoses == 1u, "layers at the same time share one sampled pose");
+        }
+
+        // The last shared layers and the reference model both played BLEND_NUM_FRAMES from the start
+        referenceModel.PlayAnimation(0u, TRUE);
+        TimeBlending(referenceModel);
+
+        const FLOAT sharedPoseError = GetLargestDifference(model.GetBoneTransforms(), referenceModel.GetBoneTransforms());
+        printf("    largest difference between the shared layers and a single layer: %.6f\n", sharedPoseError);
+        bPassed &= Check(sharedPoseError <= MAX_SHARED_POSE_ERROR, "blending layers that share a pose gives the pose of a single layer");
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestAnimationScaling
+
+      Summary:  Scaling benchmark of the model updates. 1, 16, 128 and
+                1024 animated boblampclean models are updated headless,
+                on 1 to as many threads as the hardware runs and through
+                the parallel algorithm of Scene::Update, and the time of
+                a frame is printed for each. Checks that models updated
+                in parallel end in the same pose as models updated one
+                after another.
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestAnimationScaling()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a headless device is created"))
+        {
+            return hr;
+        }
+
+        std::vector<UINT> aThreadCounts;
+        const UINT uNumHardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        for (UINT uNumThreads = 1u; uNumThreads < uNumHardwareThreads; uNumThreads *= 2u)
+        {
+            aThreadCounts.push_back(uNumThreads);
+        }
+        aThreadCounts.push_back(uNumHardwareThreads);
+
+        for (UINT uNumInstances : SCALING_INSTANCE_COUNTS)
+        {
+            std::vector<std::shared_ptr<library::Model>> aModels;
+            hr = CreateAnimatedModels(device.Get(), immediateContext.Get(), uNumInstances, aModels);
+            if (!Check(SUCCEEDED(hr), "boblampclean.md5mesh loads"))
+            {
+                return hr;
+            }
+
+            printf("    %4u instances, ms per frame:", uNumInstances);
+            for (UINT uNumThreads : aThreadCounts)
+            {
+                printf(" %u thread%s %.3f,", uNumThreads, uNumThreads == 1u ? "" : "s", TimeModelUpdates(aModels, uNumThreads));
+            }
+            printf(" parallel algorithm %.3f\n", TimeModelUpdates(aModels, 0u));
+        }
+
+        std::vector<std::shared_ptr<library::Model>> aSerialModels;
+        std::vector<std::shared_ptr<library::Model>> aParallelModels;
+        hr = CreateAnimatedModels(device.Get(), immediateContext.Get(), SCALING_INSTANCE_COUNTS[1], aSerialModels);
+        if (SUCCEEDED(hr))
+        {
+            hr = CreateAnimatedModels(device.Get(), immediateContext.Get(), SCALING_INSTANCE_COUNTS[1], aParallelModels);
+        }
+        if (!Check(SUCCEEDED(hr), "boblampclean.md5mesh loads"))
+        {
+            return hr;
+        }
+
+        TimeModelUpdates(aSerialModels, 1u);
+        TimeModelUpdates(aParallelModels, 0u);
+
+        BOOL bPosesMatch = TRUE;
+        for (size_t i = 0; i < aSerialModels.size(); ++i)
+        {
+            const std::vector<XMMATRIX>& aSerialTransforms = aSerialModels[i]->GetBoneTransforms();
+            const std::vector<XMMATRIX>& aParallelTransforms = aParallelModels[i]->GetBoneTransforms();
+            bPosesMatch = bPosesMatch
+                && aSerialTransforms.size() == aParallelTransforms.size()
+                && memcmp(aSerialTransforms.data(), aParallelTransforms.data(), aSerialTransforms.size() * sizeof(XMMATRIX)) == 0;
+        }
+
+        return Check(bPosesMatch, "parallel updates give the same poses as serial updates") ? S_OK : E_FAIL;
+    }
+}
@@ -0,0 +1,175 @@
+#include "Tests.h"
+
+#include <cstdio>
+
+#include "Model/Model.h"
+#include "Renderer/RecordingBufferUploader.h"
+#include "Renderer/SkinnedCrowd.h"
+#include "TestUtilities.h"
+
+namespace tests
+{
+    namespace
+    {
+        constexpr const UINT CROWD_NUM_INSTANCES = 8u;
+        constexpr const UINT CROWD_NUM_FRAMES = 3u;
+        constexpr const FLOAT CROWD_DELTA_TIME = 1.0f / 60.0f;
+        constexpr const FLOAT CROWD_SPACING = 50.0f;
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: CheckPaletteWrite
+
+          Summary:  Checks that the recorded palette write holds the
+                    skinning palette of every instance at its offset
+
+          Args:     const library::SkinnedCrowd& crowd
+                      Uploaded crowd
+                    const library::RecordedBufferWrite& write
+                      Recorded palette write
+
+          Returns:  BOOL
+                      TRUE if every palette matches
+        -----------------------------------------------------------------F-F*/
+        BOOL CheckPaletteWrite(_In_ const library::SkinnedCrowd& crowd, _In_ const library::RecordedBufferWrite& write)
+        {
+            const UINT uNumRows = crowd.GetNumPaletteRowsPerInstance();
+            if (!Check(write.aData.size() == sizeof(XMFLOAT4) * uNumRows * crowd.GetNumInstances(), "the palette write holds every row of every instance"))
+            {
+                return FALSE;
+            }
+
+            for (UINT i = 0u; i < crowd.GetNumInstances(); ++i)
+            {
+                const std::vector<XMFLOAT4>& aSkinningPalette = crowd.GetInstance(i)->GetSkinningPalette();
+                if (!Check(memcmp(write.aData.data() + sizeof(XMFLOAT4) * uNumRows * i, aSkinningPalette.data(), sizeof(XMFLOAT4) * uNumRows) == 0,
+                    "the palette of each instance is written at its offset"))
+                {
+                    return FALSE;
+                }
+            }
+
+            return TRUE;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: CheckInstanceWrite
+
+          Summary:  Checks that the recorded instance write holds the
+                    world matrix and palette offset of every instance
+
+          Args:     const library::SkinnedCrowd& crowd
+                      Uploaded crowd
+                    const library::RecordedBufferWrite& write
+                      Recorded instance write
+
+          Returns:  BOOL
+                      TRUE if every instance matches
+        -----------------------------------------------------------------F-F*/
+        BOOL CheckInstanceWrite(_In_ const library::SkinnedCrowd& crowd, _In_ const library::RecordedBufferWrite& write)
+        {
+            if (!Check(write.aData.size() == sizeof(library::CrowdInstanceData) * crowd.GetNumInstances(), "the instance write holds every instance"))
+            {
+                return FALSE;
+            }
+
+            for (UINT i = 0u; i < crowd.GetNumInstances(); ++i)
+            {
+                library::CrowdInstanceData instanceData;
+                memcpy(&instanceData, write.aData.data() + sizeof(library::CrowdInstanceData) * i, sizeof(library::CrowdInstanceData));
+
+                if (!Check(instanceData.PaletteOffset == i * crowd.GetNumPaletteRowsPerInstance(), "the palette offsets follow the instance order"))
+                {
+                    return FALSE;
+                }
+
+                XMFLOAT4X4 written;
+                XMFLOAT4X4 expected;
+                XMStoreFloat4x4(&written, instanceData.Transformation);
+                XMStoreFloat4x4(&expected, crowd.GetInstance(i)->GetWorldMatrix());
+                if (!Check(memcmp(&written, &expected, sizeof(XMFLOAT4X4)) == 0, "the world matrix of each instance is written"))
+                {
+                    return FALSE;
+                }
+            }
+
+            return TRUE;
+        }
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestCrowdPaletteUpload
+
+      Summary:  Uploads a crowd of boblampclean.md5mesh instances for a
+                few frames through a RecordingBufferUploader and checks
+                the packed palettes, the instance data and the upload
+                size accounting without writing the device buffers
+
+      Returns:  HRESULT
+                  S_OK if every check passed
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestCrowdPaletteUpload()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a Direct3D 11 device can be created"))
+        {
+            return hr;
+        }
+
+        library::SkinnedCrowd crowd;
+        for (UINT i = 0u; i < CROWD_NUM_INSTANCES; ++i)
+        {
+            std::shared_ptr<library::Model> pModel = std::make_shared<library::Model>(L"Content/BobLampClean/boblampclean.md5mesh");
+            pModel->Translate(XMVectorSet(CROWD_SPACING * static_cast<FLOAT>(i), 0.0f, 0.0f, 0.0f));
+
+            hr = crowd.AddInstance(pModel);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        hr = crowd.Initialize(device.Get(), immediateContext.Get());
+        if (!Check(SUCCEEDED(hr), "the crowd initializes"))
+        {
+            return hr;
+        }
+
+        const UINT64 uPaletteSize = sizeof(XMFLOAT4) * crowd.GetNumPaletteRowsPerInstance() * crowd.GetNumInstances();
+        const UINT64 uInstanceSize = sizeof(library::CrowdInstanceData) * crowd.GetNumInstances();
+
+        library::RecordingBufferUploader uploader;
+        BOOL bPassed = TRUE;
+        for (UINT uFrame = 1u; uFrame <= CROWD_NUM_FRAMES && bPassed; ++uFrame)
+        {
+            crowd.Update(CROWD_DELTA_TIME);
+
+            uploader.Clear();
+            hr = crowd.Upload(uploader);
+            if (!Check(SUCCEEDED(hr), "the recording upload succeeds"))
+            {
+                return hr;
+            }
+
+            const std::vector<library::RecordedBufferWrite>& aWrites = uploader.GetWrites();
+            if (!Check(aWrites.size() == 2u, "an upload writes the palette buffer and the instance buffer"))
+            {
+                return E_FAIL;
+            }
+
+            bPassed &= Check(aWrites[0].pBuffer != aWrites[1].pBuffer, "the two writes go to different buffers");
+            bPassed &= CheckPaletteWrite(crowd, aWrites[0]);
+            bPassed &= CheckInstanceWrite(crowd, aWrites[1]);
+
+            bPassed &= Check(crowd.GetLastUploadSize() == uPaletteSize + uInstanceSize, "the last upload size is the palette and instance sizes");
+            bPassed &= Check(crowd.GetTotalUploadSize() == (uPaletteSize + uInstanceSize) * uFrame, "the total upload size adds up every frame");
+            bPassed &= Check(crowd.GetNumUploads() == 2u * uFrame, "every upload counts two buffer updates");
+        }
+
+        printf("    %u instances, %u palette rows each: %llu palette bytes + %llu instance bytes per frame\n",
+            crowd.GetNumInstances(), crowd.GetNumPaletteRowsPerInstance(), uPaletteSize, uInstanceSize);
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+}
@@ -0,0 +1,275 @@
+#include "Tests.h"
+
+#include <cstdio>
+
+#include "Model/Model.h"
+#include "Renderer/DataTypes.h"
+#include "Renderer/InstancedModel.h"
+#include "Shader/PixelShader.h"
+#include "Shader/VertexShader.h"
+#include "Texture/Material.h"
+#include "Texture/Texture.h"
+#include "TestUtilities.h"
+
+namespace tests
+{
+    namespace
+    {
+        // 100 x 100 copies, as in the stress scene example of the Game
+        constexpr const UINT STRESS_GRID_SIZE = 100u;
+        constexpr const FLOAT STRESS_GRID_SPACING = 10.0f;
+        constexpr const UINT STRESS_NUM_WARMUP_FRAMES = 3u;
+        constexpr const UINT STRESS_NUM_FRAMES = 20u;
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: SetMeshTextures
+
+          Summary:  Binds the diffuse and normal textures of a mesh as the
+                    Renderer does before drawing it
+
+          Args:     ID3D11DeviceContext* pImmediateContext
+                      Context drawing the mesh
+                    library::Model& model
+                      Model of the mesh
+                    UINT uMeshIndex
+                      Index of the mesh
+        -----------------------------------------------------------------F-F*/
+        void SetMeshTextures(_In_ ID3D11DeviceContext* pImmediateContext, _In_ library::Model& model, _In_ UINT uMeshIndex)
+        {
+            const UINT uMaterialIndex = model.GetMesh(uMeshIndex).uMaterialIndex;
+            if (!model.HasTexture() || !model.GetMaterial(uMaterialIndex)->pDiffuse)
+            {
+                return;
+            }
+
+            const std::shared_ptr<library::Material>& pMaterial = model.GetMaterial(uMaterialIndex);
+            const library::eTextureSamplerType textureSamplerType = pMaterial->pDiffuse->GetSamplerType();
+            pImmediateContext->PSSetShaderResources(0u, 1u, pMaterial->pDiffuse->GetTextureResourceView().GetAddressOf());
+            pImmediateContext->PSSetSamplers(0u, 1u, library::Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+
+            if (pMaterial->pNormal)
+            {
+                pImmediateContext->PSSetShaderResources(1u, 1u, pMaterial->pNormal->GetTextureResourceView().GetAddressOf());
+                pImmediateContext->PSSetSamplers(1u, 1u, library::Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+            }
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: SubmitPerObject
+
+          Summary:  Draws every copy as a separate model, the way the
+                    Renderer draws the models of a scene: a constant
+                    buffer upload per copy and a draw per mesh of each
+                    copy. The copies share one model, so only the
+                    submission differs from a scene of separate models.
+
+          Args:     ID3D11DeviceContext* pImmediateContext
+                      Context drawing the copies
+                    library::Model& model
+                      Drawn model
+                    library::VertexShader& vertexShader
+                      Vertex shader of the model
+                    library::PixelShader& pixelShader
+                      Pixel shader of the model
+                    const std::vector<XMMATRIX>& aTransforms
+                      World matrix of each copy
+
+          Returns:  UINT
+                      Number of draw calls
+        -----------------------------------------------------------------F-F*/
+        UINT SubmitPerObject(
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ library::Model& model,
+            _In_ library::VertexShader& vertexShader,
+            _In_ library::PixelShader& pixelShader,
+            _In_ const std::vector<XMMATRIX>& aTransforms
+        )
+        {
+            UINT uNumDrawCalls = 0u;
+            for (const XMMATRIX& transform : aTransforms)
+            {
+                UINT aStrides[2] = { model.GetVertexStride(), model.GetNormalDataStride() };
+                UINT aOffsets[2] = { 0u, 0u };
+                ID3D11Buffer* aBuffers[2] = { model.GetVertexBuffer().Get(), model.GetNormalBuffer().Get() };
+
+                pImmediateContext->IASetVertexBuffers(0u, 2u, aBuffers, aStrides, aOffsets);
+                pImmediateContext->IASetIndexBuffer(model.GetIndexBuffer().Get(), model.GetIndexFormat(), 0u);
+                pImmediateContext->IASetInputLayout(vertexShader.GetVertexLayout().Get());
+
+                library::CBChangesEveryFrame cbChangesEveryFrame =
+                {
+                    .World = XMMatrixTranspose(model.GetWorldMatrix() * transform),
+                    .OutputColor = model.GetOutputColor(),
+                    .HasNormalMap = model.HasNormalMap()
+                };
+                pImmediateContext->UpdateSubresource(model.GetConstantBuffer().Get(), 0u, nullptr, &cbChangesEveryFrame, 0u, 0u);
+
+                pImmediateContext->VSSetShader(vertexShader.GetVertexShader().Get(), nullptr, 0u);
+                pImmediateContext->VSSetConstantBuffers(2u, 1u, model.GetConstantBuffer().GetAddressOf());
+                pImmediateContext->PSSetShader(pixelShader.GetPixelShader().Get(), nullptr, 0u);
+                pImmediateContext->PSSetConstantBuffers(2u, 1u, model.GetConstantBuffer().GetAddressOf());
+
+                for (UINT i = 0u; i < model.GetNumMeshes(); ++i)
+                {
+                    SetMeshTextures(pImmediateContext, model, i);
+                    pImmediateContext->DrawIndexed(model.GetMesh(i).uNumIndices, model.GetMesh(i).uBaseIndex, model.GetMesh(i).uBaseVertex);
+                    ++uNumDrawCalls;
+                }
+            }
+
+            return uNumDrawCalls;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: SubmitInstanced
+
+          Summary:  Draws every copy of an instanced model the way the
+                    Renderer does: one constant buffer upload and one
+                    instanced draw per mesh
+
+          Args:     ID3D11DeviceContext* pImmediateContext
+                      Context drawing the copies
+                    library::InstancedModel& instancedModel
+                      Drawn instanced model
+
+          Returns:  UINT
+                      Number of draw calls
+        -----------------------------------------------------------------F-F*/
+        UINT SubmitInstanced(_In_ ID3D11DeviceContext* pImmediateContext, _In_ library::InstancedModel& instancedModel)
+        {
+            library::Model& model = *instancedModel.GetModel();
+
+            UINT aStrides[3] = { model.GetVertexStride(), model.GetNormalDataStride(), static_cast<UINT>(sizeof(library::InstanceData)) };
+            UINT aOffsets[3] = { 0u, 0u, 0u };
+            ID3D11Buffer* aBuffers[3] = { model.GetVertexBuffer().Get(), model.GetNormalBuffer().Get(), instancedModel.GetInstanceBuffer().Get() };
+
+            pImmediateContext->IASetVertexBuffers(0u, 3u, aBuffers, aStrides, aOffsets);
+            pImmediateContext->IASetIndexBuffer(model.GetIndexBuffer().Get(), model.GetIndexFormat(), 0u);
+            pImmediateContext->IASetInputLayout(instancedModel.GetVertexLayout().Get());
+
+            library::CBChangesEveryFrame cbChangesEveryFrame =
+            {
+                .World = XMMatrixTranspose(model.GetWorldMatrix()),
+                .OutputColor = model.GetOutputColor(),
+                .HasNormalMap = model.HasNormalMap()
+            };
+            pImmediateContext->UpdateSubresource(model.GetConstantBuffer().Get(), 0u, nullptr, &cbChangesEveryFrame, 0u, 0u);
+
+            pImmediateContext->VSSetShader(instancedModel.GetVertexShader().Get(), nullptr, 0u);
+            pImmediateContext->VSSetConstantBuffers(2u, 1u, model.GetConstantBuffer().GetAddressOf());
+            pImmediateContext->PSSetShader(instancedModel.GetPixelShader().Get(), nullptr, 0u);
+            pImmediateContext->PSSetConstantBuffers(2u, 1u, model.GetConstantBuffer().GetAddressOf());
+
+            UINT uNumDrawCalls = 0u;
+            for (UINT i = 0u; i < model.GetNumMeshes(); ++i)
+            {
+                SetMeshTextures(pImmediateContext, model, i);
+                pImmediateContext->DrawIndexedInstanced(model.GetMesh(i).uNumIndices, instancedModel.GetNumInstances(), model.GetMesh(i).uBaseIndex, model.GetMesh(i).uBaseVertex, 0u);
+                ++uNumDrawCalls;
+            }
+
+            return uNumDrawCalls;
+        }
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestInstancingStress
+
+      Summary:  Submits 10,000 copies of nanosuit.obj on a headless
+                device, first one model at a time and then as one
+                instanced model, and prints the draw calls and CPU
+                submit time per frame of both paths. The frames are
+                flushed outside the timed submission, as the Renderer
+                times it.
+
+      Returns:  HRESULT
+                  S_OK if every check passed
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestInstancingStress()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a Direct3D 11 device can be created"))
+        {
+            return hr;
+        }
+
+        library::VertexShader vertexShader(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
+        std::shared_ptr<library::VertexShader> pInstancedVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhongInstanced", "vs_5_0");
+        std::shared_ptr<library::PixelShader> pPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSPhong", "ps_5_0");
+        for (library::Shader* pShader : std::initializer_list<library::Shader*>{ &vertexShader, pInstancedVertexShader.get(), pPixelShader.get() })
+        {
+            hr = pShader->Initialize(device.Get());
+            if (!Check(SUCCEEDED(hr), "the Phong shaders compile"))
+            {
+                return hr;
+            }
+        }
+
+        std::vector<XMMATRIX> aTransforms;
+        aTransforms.reserve(STRESS_GRID_SIZE * STRESS_GRID_SIZE);
+        for (UINT z = 0u; z < STRESS_GRID_SIZE; ++z)
+        {
+            for (UINT x = 0u; x < STRESS_GRID_SIZE; ++x)
+            {
+                aTransforms.push_back(XMMatrixTranslation(static_cast<FLOAT>(x) * STRESS_GRID_SPACING, 0.0f, static_cast<FLOAT>(z) * STRESS_GRID_SPACING));
+            }
+        }
+
+        library::InstancedModel instancedModel(std::make_shared<library::Model>(L"Content/Nanosuit/nanosuit.obj"));
+        for (const XMMATRIX& transform : aTransforms)
+        {
+            instancedModel.AddInstance(transform);
+        }
+
+        hr = instancedModel.Initialize(device.Get(), immediateContext.Get());
+        if (!Check(SUCCEEDED(hr), "nanosuit.obj loads as an instanced model"))
+        {
+            return hr;
+        }
+
+        library::Model& model = *instancedModel.GetModel();
+        for (UINT i = 0u; i < model.GetNumMaterials(); ++i)
+        {
+            hr = model.GetMaterial(i)->Initialize(device.Get(), immediateContext.Get());
+            if (!Check(SUCCEEDED(hr), "the materials load"))
+            {
+                return hr;
+            }
+        }
+
+        instancedModel.SetVertexShader(pInstancedVertexShader);
+        instancedModel.SetPixelShader(pPixelShader);
+
+        UINT uNumPerObjectDrawCalls = 0u;
+        UINT uNumInstancedDrawCalls = 0u;
+        DOUBLE perObjectSubmitTime = 0.0;
+        DOUBLE instancedSubmitTime = 0.0;
+        for (UINT uFrame = 0u; uFrame < STRESS_NUM_WARMUP_FRAMES + STRESS_NUM_FRAMES; ++uFrame)
+        {
+            const BOOL bIsTimed = uFrame >= STRESS_NUM_WARMUP_FRAMES;
+
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+            uNumPerObjectDrawCalls = SubmitPerObject(immediateContext.Get(), model, vertexShader, *pPixelShader, aTransforms);
+            perObjectSubmitTime += bIsTimed ? GetElapsedMilliseconds(startingTime) : 0.0;
+            immediateContext->Flush();
+
+            QueryPerformanceCounter(&startingTime);
+            uNumInstancedDrawCalls = SubmitInstanced(immediateContext.Get(), instancedModel);
+            instancedSubmitTime += bIsTimed ? GetElapsedMilliseconds(startingTime) : 0.0;
+            immediateContext->Flush();
+        }
+
+        printf("    %u copies of %u meshes\n", instancedModel.GetNumInstances(), model.GetNumMeshes());
+        printf("    per object: %u draw calls, %.3f ms submit per frame\n", uNumPerObjectDrawCalls, perObjectSubmitTime / STRESS_NUM_FRAMES);
+        printf("    instanced:  %u draw calls, %.3f ms submit per frame\n", uNumInstancedDrawCalls, instancedSubmitTime / STRESS_NUM_FRAMES);
+
+        BOOL bPassed = Check(instancedModel.GetNumInstances() == aTransforms.size(), "every copy is in the instance buffer");
+        bPassed &= Check(uNumInstancedDrawCalls == model.GetNumMeshes(), "instancing draws each mesh once");
+        bPassed &= Check(uNumPerObjectDrawCalls == model.GetNumMeshes() * instancedModel.GetNumInstances(), "the per object path draws each mesh of each copy");
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+}
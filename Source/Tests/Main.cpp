@@ -0,0 +1,124 @@
+/*+===================================================================
+  File:      MAIN.CPP
+
+  Summary:   Headless test and benchmark runner of the Library project.
+             It runs every test, or only the ones named on the command
+             line, from the Game directory so the bundled content can
+             be found, and returns the number of tests that failed.
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include <cstdio>
+
+#include "Model/ImportProfiler.h"
+
+#include "Tests.h"
+#include "TestUtilities.h"
+
+/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+  Struct:   TestCase
+
+  Summary:  Name of a test and the function running it
+S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+struct TestCase
+{
+    PCSTR pszName;
+    HRESULT (*pfnRun)();
+};
+
+constexpr const TestCase TEST_CASES[] =
+{
+    { "AnimationKeyLookup", tests::TestAnimationKeyLookup },
+    { "AnimationSampling", tests::TestAnimationSampling },
+    { "AnimationBlending", tests::TestAnimationBlending },
+    { "AnimationScaling", tests::TestAnimationScaling },
+    { "SkinnedVertexCache", tests::TestSkinnedVertexCache },
+    { "CrowdPaletteUpload", tests::TestCrowdPaletteUpload },
+    { "CookedModelLoad", tests::TestCookedModelLoad },
+    { "WideIndexImport", tests::TestWideIndexImport },
+    { "LodSelection", tests::TestLodSelection },
+    { "MeshletCulling", tests::TestMeshletCulling },
+    { "ParallelImport", tests::TestParallelImport },
+    { "InstancingStress", tests::TestInstancingStress },
+    { "TangentFrames", tests::TestTangentFrames },
+    { "ConcurrentLoad", tests::TestConcurrentLoad },
+    { "HeightMapLoad", tests::TestHeightMapLoad },
+};
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Entry point to the program. Runs the tests named on the
+            command line, or every test if none is named.
+
+  Args:     INT argc
+              Number of command-line arguments
+            PSTR* argv
+              Command-line arguments. "--content <directory>" sets the
+              directory the content paths are relative to, the other
+              arguments name the tests to run.
+
+  Returns:  INT
+              Number of tests that failed
+-----------------------------------------------------------------F-F*/
+INT main(_In_ INT argc, _In_reads_(argc) PSTR* argv)
+{
+    std::vector<PCSTR> aTestNames;
+    for (INT i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--content") == 0 && i + 1 < argc)
+        {
+            if (!SetCurrentDirectoryA(argv[++i]))
+            {
+                printf("Cannot open the content directory %s\n", argv[i]);
+                return -1;
+            }
+            continue;
+        }
+
+        aTestNames.push_back(argv[i]);
+    }
+
+    // WIC decodes the textures of the models through COM
+    HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+    // The import reports would otherwise be timed with the benchmarks
+    library::ImportProfiler::SetVerbosity(library::eImportVerbosity::SILENT);
+
+    INT iNumFailedTests = 0;
+    for (const TestCase& testCase : TEST_CASES)
+    {
+        if (!aTestNames.empty() && std::none_of(aTestNames.begin(), aTestNames.end(),
+            [&testCase](PCSTR pszName)
+            {
+                return _stricmp(pszName, testCase.pszName) == 0;
+            }
+        ))
+        {
+            continue;
+        }
+
+        printf("%s\n", testCase.pszName);
+
+        LARGE_INTEGER startingTime;
+        QueryPerformanceCounter(&startingTime);
+
+        HRESULT hr = testCase.pfnRun();
+
+        printf("%s %s (%.1f ms)\n", SUCCEEDED(hr) ? "passed" : "FAILED", testCase.pszName, tests::GetElapsedMilliseconds(startingTime));
+        if (FAILED(hr))
+        {
+            ++iNumFailedTests;
+        }
+    }
+
+    if (SUCCEEDED(hrCom))
+    {
+        CoUninitialize();
+    }
+
+    return iNumFailedTests;
+}
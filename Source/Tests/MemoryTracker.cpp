@@ -0,0 +1,163 @@
+#include "MemoryTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace tests
+{
+    namespace
+    {
+        // Keeps the memory after the header aligned like the one malloc returns
+        constexpr const SIZE_T ALLOCATION_HEADER_SIZE = 16u;
+
+        std::atomic<SIZE_T> g_uAllocatedBytes = 0u;
+        std::atomic<SIZE_T> g_uPeakAllocatedBytes = 0u;
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: TrackedAllocate
+
+          Summary:  Allocates a block with its size stored in front of it
+                    and raises the peak if needed
+
+          Args:     SIZE_T uSize
+                      Number of bytes requested
+
+          Returns:  void*
+                      Allocated memory, nullptr if the heap is full
+        -----------------------------------------------------------------F-F*/
+        void* TrackedAllocate(_In_ SIZE_T uSize)
+        {
+            BYTE* pBlock = static_cast<BYTE*>(malloc(uSize + ALLOCATION_HEADER_SIZE));
+            if (!pBlock)
+            {
+                return nullptr;
+            }
+
+            *reinterpret_cast<SIZE_T*>(pBlock) = uSize;
+
+            const SIZE_T uAllocatedBytes = g_uAllocatedBytes.fetch_add(uSize) + uSize;
+            SIZE_T uPeakAllocatedBytes = g_uPeakAllocatedBytes.load();
+            while (uAllocatedBytes > uPeakAllocatedBytes && !g_uPeakAllocatedBytes.compare_exchange_weak(uPeakAllocatedBytes, uAllocatedBytes))
+            {
+            }
+
+            return pBlock + ALLOCATION_HEADER_SIZE;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: TrackedFree
+
+          Summary:  Frees a block allocated by TrackedAllocate
+
+          Args:     void* pMemory
+                      Memory returned by TrackedAllocate, or nullptr
+        -----------------------------------------------------------------F-F*/
+        void TrackedFree(_In_opt_ void* pMemory)
+        {
+            if (!pMemory)
+            {
+                return;
+            }
+
+            BYTE* pBlock = static_cast<BYTE*>(pMemory) - ALLOCATION_HEADER_SIZE;
+            g_uAllocatedBytes -= *reinterpret_cast<SIZE_T*>(pBlock);
+            free(pBlock);
+        }
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: GetAllocatedBytes
+
+      Summary:  Returns the bytes allocated through operator new and not
+                freed yet
+
+      Returns:  SIZE_T
+                  Allocated bytes
+    -----------------------------------------------------------------F-F*/
+    SIZE_T GetAllocatedBytes()
+    {
+        return g_uAllocatedBytes.load();
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: GetPeakAllocatedBytes
+
+      Summary:  Returns the most bytes allocated at the same time since
+                the last ResetPeakAllocatedBytes
+
+      Returns:  SIZE_T
+                  Peak allocated bytes
+    -----------------------------------------------------------------F-F*/
+    SIZE_T GetPeakAllocatedBytes()
+    {
+        return g_uPeakAllocatedBytes.load();
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: ResetPeakAllocatedBytes
+
+      Summary:  Lowers the peak to the bytes allocated now
+    -----------------------------------------------------------------F-F*/
+    void ResetPeakAllocatedBytes()
+    {
+        g_uPeakAllocatedBytes = g_uAllocatedBytes.load();
+    }
+}
+
+// Every allocation of the program, the Library included, goes through these
+void* operator new(size_t uSize)
+{
+    void* pMemory = tests::TrackedAllocate(uSize);
+    if (!pMemory)
+    {
+        throw std::bad_alloc();
+    }
+
+    return pMemory;
+}
+
+void* operator new[](size_t uSize)
+{
+    return operator new(uSize);
+}
+
+void* operator new(size_t uSize, const std::nothrow_t&) noexcept
+{
+    return tests::TrackedAllocate(uSize);
+}
+
+void* operator new[](size_t uSize, const std::nothrow_t&) noexcept
+{
+    return tests::TrackedAllocate(uSize);
+}
+
+void operator delete(void* pMemory) noexcept
+{
+    tests::TrackedFree(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept
+{
+    tests::TrackedFree(pMemory);
+}
+
+void operator delete(void* pMemory, size_t) noexcept
+{
+    tests::TrackedFree(pMemory);
+}
+
+void operator delete[](void* pMemory, size_t) noexcept
+{
+    tests::TrackedFree(pMemory);
+}
+
+void operator delete(void* pMemory, const std::nothrow_t&) noexcept
+{
+    tests::TrackedFree(pMemory);
+}
+
+void operator delete[](void* pMemory, const std::nothrow_t&) noexcept
+{
+    tests::TrackedFree(pMemory);
+}
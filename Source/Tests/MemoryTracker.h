@@ -0,0 +1,22 @@
+/*+===================================================================
+  File:      MEMORYTRACKER.H
+
+  Summary:   MemoryTracker header file contains declarations of the
+             functions reporting the heap memory allocated through the
+             global operator new of the Tests project.
+
+  Functions: GetAllocatedBytes, GetPeakAllocatedBytes,
+             ResetPeakAllocatedBytes
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace tests
+{
+    SIZE_T GetAllocatedBytes();
+    SIZE_T GetPeakAllocatedBytes();
+    void ResetPeakAllocatedBytes();
+}
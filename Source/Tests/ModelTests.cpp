@@ -0,0 +1,808 @@
+#include "Tests.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "Model/CookedModel.h"
+#include "Model/MeshletCuller.h"
+#include "Model/Model.h"
+#include "Renderer/Renderer.h"
+#include "TestUtilities.h"
+
+namespace tests
+{
+    namespace
+    {
+        constexpr PCWSTR COOKED_LOAD_MODELS[] =
+        {
+            L"Content/Nanosuit/nanosuit.obj",
+            L"Content/BobLampClean/boblampclean.md5mesh",
+        };
+
+        // 300 x 300 vertices cannot be addressed by 16-bit indices
+        constexpr const UINT LARGE_GRID_SIZE = 300u;
+        constexpr const UINT SMALL_GRID_SIZE = 100u;
+
+        constexpr const UINT VIEW_WIDTH = 800u;
+        constexpr const UINT VIEW_HEIGHT = 600u;
+        // Same as the projection of the Renderer
+        constexpr const FLOAT VIEW_FIELD_OF_VIEW = XM_PIDIV4;
+        constexpr const FLOAT VIEW_NEAR_Z = 0.01f;
+        constexpr const FLOAT VIEW_FAR_Z = 1000.0f;
+
+        constexpr const UINT LOD_PATH_NUM_FRAMES = 64u;
+        constexpr const FLOAT LOD_PATH_START_DISTANCE = 0.5f;
+        constexpr const FLOAT LOD_PATH_END_DISTANCE = 200.0f;
+        constexpr const UINT LOD_PATH_REPORT_INTERVAL = 8u;
+
+        constexpr const UINT CULL_ORBIT_NUM_FRAMES = 360u;
+        constexpr const FLOAT CULL_ORBIT_DISTANCE = 2.5f;
+
+        constexpr const FLOAT PARALLEL_IMPORT_POSE_TIME = 0.5f;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ModelLoad
+
+          Summary:  Time of a model load and the size of the loaded model
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ModelLoad
+        {
+            DOUBLE time;
+            UINT uNumMeshes;
+            UINT uNumVertices;
+            UINT uNumIndices;
+        };
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: LoadModel
+
+          Summary:  Times the initialization of a model, then releases
+                    it so the next load does not reuse its asset
+
+          Args:     ID3D11Device* pDevice
+                      Device creating the buffers
+                    ID3D11DeviceContext* pImmediateContext
+                      Context of the device
+                    const std::filesystem::path& filePath
+                      Path to the model file
+                    ModelLoad& outLoad
+                      Time of the load and size of the model
+
+          Modifies: [outLoad].
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT LoadModel(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::filesystem::path& filePath,
+            _Out_ ModelLoad& outLoad
+        )
+        {
+            library::Model model(filePath);
+
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+
+            HRESULT hr = model.Initialize(pDevice, pImmediateContext);
+
+            outLoad =
+            {
+                .time = GetElapsedMilliseconds(startingTime),
+                .uNumMeshes = model.GetNumMeshes(),
+                .uNumVertices = model.GetNumVertices(),
+                .uNumIndices = model.GetNumIndices()
+            };
+
+            return hr;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: WriteGridObj
+
+          Summary:  Writes a flat square grid to a Wavefront OBJ file
+
+          Args:     const std::filesystem::path& filePath
+                      Path of the file to write
+                    UINT uGridSize
+                      Number of vertices along each side
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT WriteGridObj(_In_ const std::filesystem::path& filePath, _In_ UINT uGridSize)
+        {
+            std::ofstream file(filePath, std::ios::trunc);
+            if (!file)
+            {
+                return E_FAIL;
+            }
+
+            const FLOAT invSize = 1.0f / static_cast<FLOAT>(uGridSize - 1u);
+            for (UINT z = 0u; z < uGridSize; ++z)
+            {
+                for (UINT x = 0u; x < uGridSize; ++x)
+                {
+                    file << "v " << static_cast<FLOAT>(x) << " 0 " << static_cast<FLOAT>(z) << '\n';
+                    file << "vt " << static_cast<FLOAT>(x) * invSize << ' ' << static_cast<FLOAT>(z) * invSize << '\n';
+                }
+            }
+
+            file << "vn 0 1 0\n";
+
+            // OBJ indices start at 1
+            for (UINT z = 0u; z < uGridSize - 1u; ++z)
+            {
+                for (UINT x = 0u; x < uGridSize - 1u; ++x)
+                {
+                    const UINT a = z * uGridSize + x + 1u;
+                    const UINT b = a + 1u;
+                    const UINT c = a + uGridSize;
+                    const UINT d = c + 1u;
+
+                    file << "f " << a << '/' << a << "/1 " << c << '/' << c << "/1 " << b << '/' << b << "/1\n";
+                    file << "f " << b << '/' << b << "/1 " << c << '/' << c << "/1 " << d << '/' << d << "/1\n";
+                }
+            }
+
+            return file ? S_OK : E_FAIL;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: CheckGridModel
+
+          Summary:  Checks the vertex and index counts and the index
+                    format of an imported grid
+
+          Args:     const library::Model& model
+                      Imported grid
+                    UINT uGridSize
+                      Number of vertices along each side
+                    DXGI_FORMAT expectedIndexFormat
+                      Index format the grid needs
+
+          Returns:  BOOL
+                      TRUE if every check passed
+        -----------------------------------------------------------------F-F*/
+        BOOL CheckGridModel(_In_ const library::Model& model, _In_ UINT uGridSize, _In_ DXGI_FORMAT expectedIndexFormat)
+        {
+            const UINT uNumTriangles = (uGridSize - 1u) * (uGridSize - 1u) * 2u;
+
+            BOOL bPassed = Check(model.GetIndexFormat() == expectedIndexFormat, "the index format is the narrowest one addressing every vertex");
+            bPassed &= Check(model.GetNumVertices() == uGridSize * uGridSize, "every grid vertex is imported");
+            bPassed &= Check(model.GetNumMeshes() == 1u, "the grid is one mesh");
+            if (model.GetNumMeshes() == 1u)
+            {
+                bPassed &= Check(model.GetMesh(0u).uNumIndices == uNumTriangles * 3u, "every grid triangle is imported");
+            }
+
+            return bPassed;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: ImportGrid
+
+          Summary:  Writes a grid, imports it twice, once from the OBJ
+                    file and once from the cooked file written by the
+                    first import, and checks both
+
+          Args:     ID3D11Device* pDevice
+                      Device creating the buffers
+                    ID3D11DeviceContext* pImmediateContext
+                      Context of the device
+                    UINT uGridSize
+                      Number of vertices along each side
+                    DXGI_FORMAT expectedIndexFormat
+                      Index format the grid needs
+
+          Returns:  HRESULT
+                      S_OK if every check passed
+        -----------------------------------------------------------------F-F*/
+        HRESULT ImportGrid(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uGridSize, _In_ DXGI_FORMAT expectedIndexFormat)
+        {
+            const std::filesystem::path filePath = std::filesystem::temp_directory_path() / (L"Grid" + std::to_wstring(uGridSize) + L".obj");
+            const std::filesystem::path cookedFilePath = library::CookedModel::GetCookedFilePath(filePath);
+
+            HRESULT hr = WriteGridObj(filePath, uGridSize);
+            if (!Check(SUCCEEDED(hr), "the grid file can be written"))
+            {
+                return hr;
+            }
+
+            std::error_code error;
+            std::filesystem::remove(cookedFilePath, error);
+
+            BOOL bPassed = TRUE;
+            for (PCSTR pszSource : { "OBJ", "cooked" })
+            {
+                LARGE_INTEGER startingTime;
+                QueryPerformanceCounter(&startingTime);
+
+                // The first model is released before the second one is created, so the second one reads the cooked file
+                library::Model model(filePath);
+                hr = model.Initialize(pDevice, pImmediateContext);
+                if (!Check(SUCCEEDED(hr), "the grid imports"))
+                {
+                    break;
+                }
+
+                printf("    %u vertices from the %s file: %s indices, %.1f ms\n", model.GetNumVertices(), pszSource,
+                    model.GetIndexFormat() == DXGI_FORMAT_R32_UINT ? "32-bit" : "16-bit", GetElapsedMilliseconds(startingTime));
+
+                bPassed &= CheckGridModel(model, uGridSize, expectedIndexFormat);
+            }
+
+            std::filesystem::remove(filePath, error);
+            std::filesystem::remove(cookedFilePath, error);
+
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            return bPassed ? S_OK : E_FAIL;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: LoadNanosuit
+
+          Summary:  Imports nanosuit.obj from the file instead of its
+                    cooked file, so the import statistics are measured
+
+          Args:     ID3D11Device* pDevice
+                      Device creating the buffers
+                    ID3D11DeviceContext* pImmediateContext
+                      Context of the device
+                    std::shared_ptr<library::Model>& pOutModel
+                      Imported model
+
+          Modifies: [pOutModel].
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT LoadNanosuit(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _Out_ std::shared_ptr<library::Model>& pOutModel)
+        {
+            const std::filesystem::path filePath = L"Content/Nanosuit/nanosuit.obj";
+
+            std::error_code error;
+            std::filesystem::remove(library::CookedModel::GetCookedFilePath(filePath), error);
+
+            pOutModel = std::make_shared<library::Model>(filePath);
+
+            return pOutModel->Initialize(pDevice, pImmediateContext);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: ImportModel
+
+          Summary:  Removes the cooked file of a model and imports it
+                    through assimp
+
+          Args:     ID3D11Device* pDevice
+                      Device creating the buffers
+                    ID3D11DeviceContext* pImmediateContext
+                      Context of the device
+                    const std::filesystem::path& filePath
+                      Path to the model file
+                    std::shared_ptr<library::Model>& pOutModel
+                      Imported model
+                    DOUBLE& outTime
+                      Time of the initialization in milliseconds
+
+          Modifies: [pOutModel, outTime].
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT ImportModel(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::filesystem::path& filePath,
+            _Out_ std::shared_ptr<library::Model>& pOutModel,
+            _Out_ DOUBLE& outTime
+        )
+        {
+            std::error_code error;
+            std::filesystem::remove(library::CookedModel::GetCookedFilePath(filePath), error);
+
+            pOutModel = std::make_shared<library::Model>(filePath);
+
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+
+            HRESULT hr = pOutModel->Initialize(pDevice, pImmediateContext);
+
+            outTime = GetElapsedMilliseconds(startingTime);
+
+            return hr;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetSkinnedPositions
+
+          Summary:  Returns the positions skinned on the CPU by a model
+
+          Args:     const library::Model& model
+                      Updated model
+
+          Returns:  std::vector<XMFLOAT3>
+                      Skinned position of every vertex
+        -----------------------------------------------------------------F-F*/
+        std::vector<XMFLOAT3> GetSkinnedPositions(_In_ const library::Model& model)
+        {
+            const library::SkinnedVertexCache& cache = model.GetSkinnedVertexCache();
+
+            std::vector<XMFLOAT3> aPositions(cache.GetNumVertices());
+            for (UINT i = 0u; i < cache.GetNumVertices(); ++i)
+            {
+                XMStoreFloat3(&aPositions[i], cache.GetPosition(i));
+            }
+
+            return aPositions;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetModelBounds
+
+          Summary:  Returns a sphere bounding every mesh of a model
+
+          Args:     const library::Model& model
+                      Model with at least one mesh
+
+          Returns:  BoundingSphere
+                      Model space bounds
+        -----------------------------------------------------------------F-F*/
+        BoundingSphere GetModelBounds(_In_ const library::Model& model)
+        {
+            BoundingSphere bounds = model.GetMesh(0u).bounds;
+            for (UINT i = 1u; i < model.GetNumMeshes(); ++i)
+            {
+                BoundingSphere::CreateMerged(bounds, bounds, model.GetMesh(i).bounds);
+            }
+
+            return bounds;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetProjectionScale
+
+          Summary:  Returns the pixels covered by one unit at a distance
+                    of one unit, as the Renderer computes it
+
+          Returns:  FLOAT
+                      Projection scale
+        -----------------------------------------------------------------F-F*/
+        FLOAT GetProjectionScale()
+        {
+            const XMMATRIX projection = XMMatrixPerspectiveFovLH(VIEW_FIELD_OF_VIEW, static_cast<FLOAT>(VIEW_WIDTH) / static_cast<FLOAT>(VIEW_HEIGHT), VIEW_NEAR_Z, VIEW_FAR_Z);
+
+            return XMVectorGetY(projection.r[1]) * static_cast<FLOAT>(VIEW_HEIGHT) * 0.5f;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetLodPathDistance
+
+          Summary:  Returns the distance of the camera from the center of
+                    the model at a frame of the scripted path, which
+                    moves away geometrically so every detail level is
+                    crossed
+
+          Args:     UINT uFrame
+                      Frame of the path
+                    FLOAT radius
+                      Radius of the model bounds
+
+          Returns:  FLOAT
+                      Distance from the center
+        -----------------------------------------------------------------F-F*/
+        FLOAT GetLodPathDistance(_In_ UINT uFrame, _In_ FLOAT radius)
+        {
+            const FLOAT t = static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(LOD_PATH_NUM_FRAMES - 1u);
+
+            return radius * LOD_PATH_START_DISTANCE * powf(LOD_PATH_END_DISTANCE / LOD_PATH_START_DISTANCE, t);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: CullModel
+
+          Summary:  Culls the meshlets of every mesh of a model as the
+                    Renderer does for a camera
+
+          Args:     const library::Model& model
+                      Culled model
+                    FXMVECTOR eyePosition
+                      Position of the camera
+                    FXMVECTOR focusPosition
+                      Point the camera looks at
+                    library::MeshletCullingStatistics& statistics
+                      Statistics the work is added to
+
+          Modifies: [statistics].
+
+          Returns:  BOOL
+                      TRUE if the index ranges of every mesh hold exactly
+                      the triangles counted as visible
+        -----------------------------------------------------------------F-F*/
+        BOOL CullModel(_In_ const library::Model& model, _In_ FXMVECTOR eyePosition, _In_ FXMVECTOR focusPosition, _Inout_ library::MeshletCullingStatistics& statistics)
+        {
+            const XMMATRIX view = XMMatrixLookAtLH(eyePosition, focusPosition, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            const XMMATRIX projection = XMMatrixPerspectiveFovLH(VIEW_FIELD_OF_VIEW, static_cast<FLOAT>(VIEW_WIDTH) / static_cast<FLOAT>(VIEW_HEIGHT), VIEW_NEAR_Z, VIEW_FAR_Z);
+            const XMMATRIX viewProjection = view * projection;
+
+            std::vector<library::Meshlet> aRanges;
+            BOOL bRangesMatch = TRUE;
+            for (UINT i = 0u; i < model.GetNumMeshes(); ++i)
+            {
+                const UINT uNumVisibleTriangles = statistics.uNumVisibleTriangles;
+                if (!model.CullMeshlets(i, eyePosition, viewProjection, aRanges, statistics))
+                {
+                    continue;
+                }
+
+                UINT uNumRangeIndices = 0u;
+                for (const library::Meshlet& range : aRanges)
+                {
+                    uNumRangeIndices += range.uNumIndices;
+                }
+
+                bRangesMatch &= uNumRangeIndices == (statistics.uNumVisibleTriangles - uNumVisibleTriangles) * 3u;
+            }
+
+            return bRangesMatch;
+        }
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestCookedModelLoad
+
+      Summary:  Load-time benchmark of the bundled models. Each model is
+                loaded cold through assimp with its cooked file removed,
+                which writes the cooked file, then loaded again from the
+                cooked file. Checks that the cooked file is written and
+                that both loads give the same meshes, vertices and
+                indices.
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestCookedModelLoad()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a headless device is created"))
+        {
+            return hr;
+        }
+
+        BOOL bPassed = TRUE;
+        for (PCWSTR pszFilePath : COOKED_LOAD_MODELS)
+        {
+            const std::filesystem::path filePath = pszFilePath;
+            const std::filesystem::path cookedFilePath = library::CookedModel::GetCookedFilePath(filePath);
+
+            std::error_code error;
+            std::filesystem::remove(cookedFilePath, error);
+
+            ModelLoad assimpLoad;
+            hr = LoadModel(device.Get(), immediateContext.Get(), filePath, assimpLoad);
+            if (!Check(SUCCEEDED(hr), "the model loads through assimp"))
+            {
+                return hr;
+            }
+
+            bPassed &= Check(std::filesystem::exists(cookedFilePath, error), "loading through assimp writes the cooked file");
+
+            ModelLoad cookedLoad;
+            hr = LoadModel(device.Get(), immediateContext.Get(), filePath, cookedLoad);
+            if (!Check(SUCCEEDED(hr), "the model loads from the cooked file"))
+            {
+                return hr;
+            }
+
+            printf("    %s: assimp %.1f ms, cooked %.1f ms (%.2fx), %u meshes, %u vertices, %u indices\n",
+                filePath.filename().string().c_str(),
+                assimpLoad.time,
+                cookedLoad.time,
+                assimpLoad.time / cookedLoad.time,
+                cookedLoad.uNumMeshes,
+                cookedLoad.uNumVertices,
+                cookedLoad.uNumIndices);
+
+            bPassed &= Check(cookedLoad.uNumMeshes == assimpLoad.uNumMeshes, "the cooked file has the meshes of the assimp import");
+            bPassed &= Check(cookedLoad.uNumVertices == assimpLoad.uNumVertices, "the cooked file has the vertices of the assimp import");
+            bPassed &= Check(cookedLoad.uNumIndices == assimpLoad.uNumIndices, "the cooked file has the indices of the assimp import");
+        }
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestWideIndexImport
+
+      Summary:  Imports a grid with more vertices than 16-bit indices can
+                address and checks that it keeps 32-bit indices, while a
+                smaller grid is compacted to 16-bit indices
+
+      Returns:  HRESULT
+                  S_OK if every check passed
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestWideIndexImport()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a Direct3D 11 device can be created"))
+        {
+            return hr;
+        }
+
+        HRESULT hrLarge = ImportGrid(device.Get(), immediateContext.Get(), LARGE_GRID_SIZE, DXGI_FORMAT_R32_UINT);
+        HRESULT hrSmall = ImportGrid(device.Get(), immediateContext.Get(), SMALL_GRID_SIZE, DXGI_FORMAT_R16_UINT);
+
+        return FAILED(hrLarge) ? hrLarge : hrSmall;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestLodSelection
+
+      Summary:  Moves a camera away from nanosuit.obj along a scripted
+                path and selects the detail level of every mesh each
+                frame as the Renderer does. Prints the detail levels
+                built on import and the triangles drawn along the path,
+                and checks that a mesh around the camera is drawn in
+                full and that the meshes only get coarser as the camera
+                moves away.
+
+      Returns:  HRESULT
+                  S_OK if every check passed
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestLodSelection()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a Direct3D 11 device can be created"))
+        {
+            return hr;
+        }
+
+        std::shared_ptr<library::Model> pModel;
+        hr = LoadNanosuit(device.Get(), immediateContext.Get(), pModel);
+        if (!Check(SUCCEEDED(hr), "nanosuit.obj loads"))
+        {
+            return hr;
+        }
+
+        const std::vector<library::LodStatistics>& aLodStatistics = pModel->GetLodStatistics();
+        for (size_t i = 0u; i < aLodStatistics.size(); ++i)
+        {
+            printf("    LOD %zu: %u triangles, error %.4f, %.2f ms\n", i, aLodStatistics[i].uNumTriangles, aLodStatistics[i].maxError, aLodStatistics[i].generationTime);
+        }
+
+        const UINT uNumMeshes = pModel->GetNumMeshes();
+        const BoundingSphere bounds = GetModelBounds(*pModel);
+        const XMVECTOR center = XMLoadFloat3(&bounds.Center);
+        const FLOAT projectionScale = GetProjectionScale();
+
+        BOOL bPassed = Check(aLodStatistics.size() > 1u, "coarser detail levels are built");
+        std::vector<UINT> aPreviousLods(uNumMeshes, 0u);
+        DOUBLE selectionTime = 0.0;
+        UINT uNumNearTriangles = 0u;
+        UINT uNumCoarserMeshes = 0u;
+
+        for (UINT uFrame = 0u; uFrame < LOD_PATH_NUM_FRAMES; ++uFrame)
+        {
+            const FLOAT distance = GetLodPathDistance(uFrame, bounds.Radius);
+            const XMVECTOR eyePosition = XMVectorAdd(center, XMVectorSet(0.0f, 0.0f, -distance, 0.0f));
+
+            std::vector<UINT> aLods(uNumMeshes);
+
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+
+            for (UINT i = 0u; i < uNumMeshes; ++i)
+            {
+                aLods[i] = pModel->SelectLod(i, eyePosition, projectionScale, library::Renderer::DEFAULT_MAX_LOD_PIXEL_ERROR);
+            }
+
+            selectionTime += GetElapsedMilliseconds(startingTime);
+
+            UINT uNumTriangles = 0u;
+            UINT uNumFullTriangles = 0u;
+            for (UINT i = 0u; i < uNumMeshes; ++i)
+            {
+                const auto& mesh = pModel->GetMesh(i);
+                uNumTriangles += (mesh.uNumLods > 0u ? mesh.aLods[aLods[i]].uNumIndices : mesh.uNumIndices) / 3u;
+                uNumFullTriangles += mesh.uNumIndices / 3u;
+
+                bPassed &= Check(aLods[i] >= aPreviousLods[i], "a mesh never gets finer while the camera moves away");
+                bPassed &= Check(mesh.bounds.Contains(eyePosition) != CONTAINS || aLods[i] == 0u, "a mesh is drawn in full when the camera is inside its bounds");
+                bPassed &= Check(aLods[i] < std::max(mesh.uNumLods, 1u), "the selected level exists");
+            }
+
+            if (uFrame == 0u)
+            {
+                uNumNearTriangles = uNumTriangles;
+            }
+
+            if (uFrame == LOD_PATH_NUM_FRAMES - 1u)
+            {
+                bPassed &= Check(uNumTriangles <= uNumNearTriangles, "the far end of the path draws no more triangles than the near end");
+                uNumCoarserMeshes = static_cast<UINT>(std::count_if(aLods.begin(), aLods.end(), [](UINT uLod) { return uLod > 0u; }));
+            }
+
+            if (uFrame % LOD_PATH_REPORT_INTERVAL == 0u || uFrame == LOD_PATH_NUM_FRAMES - 1u)
+            {
+                printf("    distance %8.2f: %u of %u triangles\n", distance, uNumTriangles, uNumFullTriangles);
+            }
+
+            aPreviousLods = std::move(aLods);
+        }
+
+        bPassed &= Check(uNumCoarserMeshes > 0u, "distant meshes use a coarser level");
+
+        printf("    selection: %.4f ms per frame for %u meshes\n", selectionTime / LOD_PATH_NUM_FRAMES, uNumMeshes);
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestMeshletCulling
+
+      Summary:  Orbits a camera around nanosuit.obj and culls its
+                meshlets every frame. Prints the fraction of triangles
+                culled and the culling time per frame, and checks the
+                culled ranges and that nothing is kept when the camera
+                looks away from the model.
+
+      Returns:  HRESULT
+                  S_OK if every check passed
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestMeshletCulling()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a Direct3D 11 device can be created"))
+        {
+            return hr;
+        }
+
+        std::shared_ptr<library::Model> pModel;
+        hr = LoadNanosuit(device.Get(), immediateContext.Get(), pModel);
+        if (!Check(SUCCEEDED(hr), "nanosuit.obj loads"))
+        {
+            return hr;
+        }
+
+        const BoundingSphere bounds = GetModelBounds(*pModel);
+        const XMVECTOR center = XMLoadFloat3(&bounds.Center);
+
+        library::MeshletCullingStatistics statistics = {};
+        BOOL bPassed = TRUE;
+        for (UINT uFrame = 0u; uFrame < CULL_ORBIT_NUM_FRAMES; ++uFrame)
+        {
+            const FLOAT angle = XM_2PI * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(CULL_ORBIT_NUM_FRAMES);
+            const FLOAT distance = bounds.Radius * CULL_ORBIT_DISTANCE;
+            const XMVECTOR eyePosition = XMVectorAdd(center, XMVectorSet(distance * sinf(angle), 0.0f, -distance * cosf(angle), 0.0f));
+
+            bPassed &= Check(CullModel(*pModel, eyePosition, center, statistics), "the visible ranges hold the visible triangles");
+        }
+
+        bPassed &= Check(statistics.uNumMeshlets > 0u, "the meshes are split into meshlets");
+        bPassed &= Check(statistics.uNumVisibleTriangles <= statistics.uNumTriangles, "culling never adds triangles");
+        bPassed &= Check(statistics.uNumVisibleTriangles < statistics.uNumTriangles, "back facing meshlets are culled along the orbit");
+
+        if (statistics.uNumTriangles > 0u)
+        {
+            printf("    %u meshlets, %.1f%% of %u triangles culled, %.1f ranges, %.4f ms per frame\n",
+                statistics.uNumMeshlets / CULL_ORBIT_NUM_FRAMES,
+                100.0 * (1.0 - static_cast<DOUBLE>(statistics.uNumVisibleTriangles) / static_cast<DOUBLE>(statistics.uNumTriangles)),
+                statistics.uNumTriangles / CULL_ORBIT_NUM_FRAMES,
+                static_cast<DOUBLE>(statistics.uNumRanges) / CULL_ORBIT_NUM_FRAMES,
+                statistics.cullingTime / CULL_ORBIT_NUM_FRAMES);
+        }
+
+        // A camera in front of the model looking away from it sees none of it
+        library::MeshletCullingStatistics awayStatistics = {};
+        const XMVECTOR awayEyePosition = XMVectorAdd(center, XMVectorSet(0.0f, 0.0f, -bounds.Radius * CULL_ORBIT_DISTANCE, 0.0f));
+        CullModel(*pModel, awayEyePosition, XMVectorAdd(awayEyePosition, XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f)), awayStatistics);
+        bPassed &= Check(awayStatistics.uNumVisibleTriangles == 0u, "meshlets behind the camera are culled");
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestParallelImport
+
+      Summary:  Imports nanosuit.obj with its cooked file removed and the
+                import limited to one thread, then to every thread count
+                up to the number of hardware threads, and prints the
+                import time of each. boblampclean is imported with every
+                thread count too, and checks that its bone ids and
+                skinned positions match the single threaded import.
+
+      Returns:  HRESULT
+                  S_OK if every check passed
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestParallelImport()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a Direct3D 11 device can be created"))
+        {
+            return hr;
+        }
+
+        const UINT uMaxNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+        DOUBLE singleThreadTime = 0.0;
+        std::unordered_map<std::string, UINT> referenceBoneIds;
+        std::vector<XMFLOAT3> aReferencePositions;
+        BOOL bPassed = TRUE;
+        for (UINT uNumThreads = 1u; uNumThreads <= uMaxNumThreads && SUCCEEDED(hr); ++uNumThreads)
+        {
+            library::Model::SetNumImportThreads(uNumThreads);
+
+            // Each model is released at the end of the iteration, so the next one is imported again
+            std::shared_ptr<library::Model> pNanosuit;
+            DOUBLE time = 0.0;
+            hr = ImportModel(device.Get(), immediateContext.Get(), L"Content/Nanosuit/nanosuit.obj", pNanosuit, time);
+            if (!Check(SUCCEEDED(hr), "nanosuit.obj imports"))
+            {
+                break;
+            }
+
+            std::shared_ptr<library::Model> pBobLamp;
+            DOUBLE bobLampTime = 0.0;
+            hr = ImportModel(device.Get(), immediateContext.Get(), L"Content/BobLampClean/boblampclean.md5mesh", pBobLamp, bobLampTime);
+            if (!Check(SUCCEEDED(hr), "boblampclean.md5mesh imports"))
+            {
+                break;
+            }
+
+            pBobLamp->Update(PARALLEL_IMPORT_POSE_TIME);
+            std::vector<XMFLOAT3> aPositions = GetSkinnedPositions(*pBobLamp);
+
+            if (uNumThreads == 1u)
+            {
+                singleThreadTime = time;
+                referenceBoneIds = pBobLamp->GetBoneNameToIndexMap();
+                aReferencePositions = std::move(aPositions);
+            }
+            else
+            {
+                bPassed &= Check(pBobLamp->GetBoneNameToIndexMap() == referenceBoneIds, "the bone ids do not depend on the number of threads");
+                bPassed &= Check(
+                    aPositions.size() == aReferencePositions.size() &&
+                    std::equal(aPositions.begin(), aPositions.end(), aReferencePositions.begin(),
+                        [](const XMFLOAT3& position, const XMFLOAT3& referencePosition)
+                        {
+                            return position.x == referencePosition.x && position.y == referencePosition.y && position.z == referencePosition.z;
+                        }
+                    ),
+                    "the skinned positions do not depend on the number of threads"
+                );
+            }
+
+            printf("    %2u threads: nanosuit %.1f ms (%.2fx), boblampclean %.1f ms\n", uNumThreads, time, singleThreadTime / time, bobLampTime);
+        }
+
+        library::Model::SetNumImportThreads(0u);
+
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        bPassed &= Check(!referenceBoneIds.empty(), "boblampclean.md5mesh has bones");
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+}
@@ -0,0 +1,682 @@
+#include "Tests.h"
+
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+#include "Model/CookedModel.h"
+#include "Model/Model.h"
+#include "Scene/HeightMap.h"
+#include "Scene/Scene.h"
+#include "Scene/Voxel.h"
+#include "Texture/Texture.h"
+#include "MemoryTracker.h"
+#include "TestUtilities.h"
+
+namespace tests
+{
+    namespace
+    {
+        constexpr const PCWSTR BUNDLED_MODEL_PATHS[] =
+        {
+            L"Content/BobLampClean/boblampclean.md5mesh",
+            L"Content/Nanosuit/nanosuit.obj",
+            L"Content/cyborg/cyborg.obj",
+        };
+        constexpr const DWORD LOAD_POLL_INTERVAL = 1u;
+
+        constexpr const PCWSTR SHARED_TEXTURE_SOURCE_PATH = L"Content/Cube/diffuse.png";
+        constexpr const PCWSTR SHARED_TEXTURE_FILE_NAME = L"ConcurrentLoadShared.png";
+        constexpr const PCWSTR SHARED_TEXTURE_MATERIAL_FILE_NAME = L"ConcurrentLoadShared.mtl";
+        constexpr const PCWSTR SHARED_TEXTURE_MODEL_FILE_NAMES[] =
+        {
+            L"ConcurrentLoadSharedFirst.obj",
+            L"ConcurrentLoadSharedSecond.obj",
+        };
+
+        constexpr const UINT HEIGHT_MAP_SIZE = 1024u;
+        // One block per column keeps the instances of the voxels small next to the columns
+        constexpr const UINT HEIGHT_MAP_HEIGHT = 1u;
+        // The text loader reads a block type as one character, and the character of BARE ends a text stream on Windows
+        constexpr const UINT HEIGHT_MAP_NUM_TYPES = static_cast<UINT>(library::eBlockType::BARE) - static_cast<UINT>(library::eBlockType::GRASSLAND);
+        constexpr const FLOAT HEIGHT_MAP_FREQUENCY = 0.02f;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   HeightMapLoad
+
+          Summary:  Time, peak heap memory and voxels of a scene built
+                    from a height map file
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct HeightMapLoad
+        {
+            DOUBLE loadTime;
+            SIZE_T uPeakAllocatedBytes;
+            std::vector<UINT> aNumVoxelInstances;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ModelGeometry
+
+          Summary:  Sizes of the geometry of a loaded model
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ModelGeometry
+        {
+            UINT uNumVertices;
+            UINT uNumIndices;
+            UINT uNumMeshes;
+            UINT uNumMaterials;
+        };
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetModelGeometry
+
+          Summary:  Returns the sizes of the geometry of a model
+
+          Args:     const library::Model& model
+                      Loaded model
+
+          Returns:  ModelGeometry
+                      Sizes of the geometry
+        -----------------------------------------------------------------F-F*/
+        ModelGeometry GetModelGeometry(_In_ const library::Model& model)
+        {
+            return ModelGeometry
+            {
+                .uNumVertices = model.GetNumVertices(),
+                .uNumIndices = model.GetNumIndices(),
+                .uNumMeshes = model.GetNumMeshes(),
+                .uNumMaterials = model.GetNumMaterials()
+            };
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: RemoveCookedFiles
+
+          Summary:  Removes the cooked files of the bundled models so they
+                    are imported from their source files
+        -----------------------------------------------------------------F-F*/
+        void RemoveCookedFiles()
+        {
+            for (PCWSTR pszFilePath : BUNDLED_MODEL_PATHS)
+            {
+                std::error_code error;
+                std::filesystem::remove(library::CookedModel::GetCookedFilePath(pszFilePath), error);
+            }
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: WriteSharedTextureModels
+
+          Summary:  Copies a bundled texture to a directory and writes
+                    two Wavefront OBJ files of one triangle whose
+                    material uses that texture, so the models are
+                    imported separately but share the texture
+
+          Args:     const std::filesystem::path& directory
+                      Directory of the files
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT WriteSharedTextureModels(_In_ const std::filesystem::path& directory)
+        {
+            std::error_code error;
+            std::filesystem::copy_file(SHARED_TEXTURE_SOURCE_PATH, directory / SHARED_TEXTURE_FILE_NAME, std::filesystem::copy_options::overwrite_existing, error);
+            if (error)
+            {
+                return E_FAIL;
+            }
+
+            std::ofstream materialFile(directory / SHARED_TEXTURE_MATERIAL_FILE_NAME, std::ios::trunc);
+            materialFile << "newmtl Shared\n";
+            materialFile << "map_Kd " << std::filesystem::path(SHARED_TEXTURE_FILE_NAME).string() << '\n';
+            if (!materialFile)
+            {
+                return E_FAIL;
+            }
+
+            for (PCWSTR pszFileName : SHARED_TEXTURE_MODEL_FILE_NAMES)
+            {
+                std::ofstream modelFile(directory / pszFileName, std::ios::trunc);
+                modelFile << "mtllib " << std::filesystem::path(SHARED_TEXTURE_MATERIAL_FILE_NAME).string() << '\n';
+                modelFile << "v 0 0 0\nv 1 0 0\nv 0 0 1\n";
+                modelFile << "vt 0 0\nvt 1 0\nvt 0 1\n";
+                modelFile << "vn 0 1 0\n";
+                modelFile << "usemtl Shared\n";
+                modelFile << "f 1/1/1 3/3/1 2/2/1\n";
+                if (!modelFile)
+                {
+                    return E_FAIL;
+                }
+            }
+
+            return S_OK;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: RemoveSharedTextureModels
+
+          Summary:  Removes the files written by WriteSharedTextureModels
+                    and the cooked files of the models
+
+          Args:     const std::filesystem::path& directory
+                      Directory of the files
+        -----------------------------------------------------------------F-F*/
+        void RemoveSharedTextureModels(_In_ const std::filesystem::path& directory)
+        {
+            std::error_code error;
+            for (PCWSTR pszFileName : SHARED_TEXTURE_MODEL_FILE_NAMES)
+            {
+                std::filesystem::remove(directory / pszFileName, error);
+                std::filesystem::remove(library::CookedModel::GetCookedFilePath(directory / pszFileName), error);
+            }
+            std::filesystem::remove(directory / SHARED_TEXTURE_MATERIAL_FILE_NAME, error);
+            std::filesystem::remove(directory / SHARED_TEXTURE_FILE_NAME, error);
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: LoadIntoDeferredContext
+
+          Summary:  Initializes a model and its materials into a deferred
+                    context of its own, as the loader threads of a scene
+                    do, and returns the recorded commands without
+                    executing them
+
+          Args:     ID3D11Device* pDevice
+                      Device creating the resources
+                    library::Model& model
+                      Model to initialize
+                    ComPtr<ID3D11CommandList>& outCommandList
+                      Recorded commands
+
+          Modifies: [model, outCommandList].
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT LoadIntoDeferredContext(_In_ ID3D11Device* pDevice, _Inout_ library::Model& model, _Out_ ComPtr<ID3D11CommandList>& outCommandList)
+        {
+            // WIC decodes the textures through COM
+            HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+            ComPtr<ID3D11DeviceContext> deferredContext;
+            HRESULT hr = pDevice->CreateDeferredContext(0u, deferredContext.GetAddressOf());
+            if (SUCCEEDED(hr))
+            {
+                hr = model.Initialize(pDevice, deferredContext.Get());
+            }
+
+            for (UINT i = 0u; SUCCEEDED(hr) && i < model.GetNumMaterials(); ++i)
+            {
+                hr = model.GetMaterial(i)->Initialize(pDevice, deferredContext.Get());
+            }
+
+            if (SUCCEEDED(hr))
+            {
+                hr = deferredContext->FinishCommandList(FALSE, outCommandList.ReleaseAndGetAddressOf());
+            }
+
+            if (SUCCEEDED(hrCom))
+            {
+                CoUninitialize();
+            }
+
+            return hr;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetDiffuseTexture
+
+          Summary:  Returns the diffuse texture of the first material of
+                    a model that has one
+
+          Args:     const library::Model& model
+                      Loaded model
+
+          Returns:  std::shared_ptr<library::Texture>
+                      Diffuse texture, nullptr if no material has one
+        -----------------------------------------------------------------F-F*/
+        std::shared_ptr<library::Texture> GetDiffuseTexture(_In_ const library::Model& model)
+        {
+            for (UINT i = 0u; i < model.GetNumMaterials(); ++i)
+            {
+                if (model.GetMaterial(i)->pDiffuse)
+                {
+                    return model.GetMaterial(i)->pDiffuse;
+                }
+            }
+
+            return nullptr;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: ReadTexels
+
+          Summary:  Copies the first mip level of a texture of four bytes
+                    per texel to a staging texture and reads it back
+
+          Args:     ID3D11Device* pDevice
+                      Device creating the staging texture
+                    ID3D11DeviceContext* pImmediateContext
+                      Context copying and mapping the texture
+                    library::Texture& texture
+                      Texture to read
+                    std::vector<BYTE>& aOutTexels
+                      Texels of the first mip level, row by row
+                    UINT& uOutNumMips
+                      Number of mip levels of the texture
+
+          Modifies: [aOutTexels, uOutNumMips].
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT ReadTexels(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ library::Texture& texture,
+            _Out_ std::vector<BYTE>& aOutTexels,
+            _Out_ UINT& uOutNumMips
+        )
+        {
+            aOutTexels.clear();
+            uOutNumMips = 0u;
+
+            ComPtr<ID3D11Resource> resource;
+            texture.GetTextureResourceView()->GetResource(resource.GetAddressOf());
+
+            ComPtr<ID3D11Texture2D> texture2D;
+            HRESULT hr = resource.As(&texture2D);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            D3D11_TEXTURE2D_DESC desc = {};
+            texture2D->GetDesc(&desc);
+            uOutNumMips = desc.MipLevels;
+
+            D3D11_TEXTURE2D_DESC stagingDesc =
+            {
+                .Width = desc.Width,
+                .Height = desc.Height,
+                .MipLevels = 1u,
+                .ArraySize = 1u,
+                .Format = desc.Format,
+                .SampleDesc = {.Count = 1u, .Quality = 0u },
+                .Usage = D3D11_USAGE_STAGING,
+                .BindFlags = 0u,
+                .CPUAccessFlags = D3D11_CPU_ACCESS_READ,
+                .MiscFlags = 0u
+            };
+
+            ComPtr<ID3D11Texture2D> stagingTexture;
+            hr = pDevice->CreateTexture2D(&stagingDesc, nullptr, stagingTexture.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            pImmediateContext->CopySubresourceRegion(stagingTexture.Get(), 0u, 0u, 0u, 0u, texture2D.Get(), 0u, nullptr);
+
+            D3D11_MAPPED_SUBRESOURCE mappedResource = {};
+            hr = pImmediateContext->Map(stagingTexture.Get(), 0u, D3D11_MAP_READ, 0u, &mappedResource);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            const UINT uRowSize = desc.Width * 4u;
+            aOutTexels.resize(static_cast<size_t>(uRowSize) * desc.Height);
+            for (UINT uRow = 0u; uRow < desc.Height; ++uRow)
+            {
+                memcpy(aOutTexels.data() + static_cast<size_t>(uRow) * uRowSize, static_cast<const BYTE*>(mappedResource.pData) + static_cast<size_t>(uRow) * mappedResource.RowPitch, uRowSize);
+            }
+
+            pImmediateContext->Unmap(stagingTexture.Get(), 0u);
+
+            return S_OK;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GenerateHeightMap
+
+          Summary:  Generates a palette and a map of one block high
+                    columns whose types follow Perlin noise, so the map
+                    has runs of equal columns like a terrain
+
+          Args:     std::vector<XMFLOAT3>& aOutColors
+                      Color of every block type
+                    std::vector<library::HeightMapColumn>& aOutColumns
+                      Columns of the map, row by row
+
+          Modifies: [aOutColors, aOutColumns].
+        -----------------------------------------------------------------F-F*/
+        void GenerateHeightMap(_Out_ std::vector<XMFLOAT3>& aOutColors, _Out_ std::vector<library::HeightMapColumn>& aOutColumns)
+        {
+            aOutColors.clear();
+            for (UINT i = 0u; i < HEIGHT_MAP_NUM_TYPES; ++i)
+            {
+                const FLOAT intensity = static_cast<FLOAT>(i + 1u) / static_cast<FLOAT>(HEIGHT_MAP_NUM_TYPES);
+                aOutColors.push_back(XMFLOAT3(intensity, intensity, intensity));
+            }
+
+            aOutColumns.clear();
+            aOutColumns.reserve(static_cast<size_t>(HEIGHT_MAP_SIZE) * HEIGHT_MAP_SIZE);
+            for (UINT z = 0u; z < HEIGHT_MAP_SIZE; ++z)
+            {
+                for (UINT x = 0u; x < HEIGHT_MAP_SIZE; ++x)
+                {
+                    const FLOAT noise = library::Scene::GetPerlin2d(static_cast<FLOAT>(x), static_cast<FLOAT>(z), HEIGHT_MAP_FREQUENCY, 4u);
+                    const UINT uType = std::min(static_cast<UINT>(std::max(noise, 0.0f) * HEIGHT_MAP_NUM_TYPES), HEIGHT_MAP_NUM_TYPES - 1u);
+
+                    aOutColumns.push_back(
+                        library::HeightMapColumn
+                        {
+                            .uType = static_cast<BYTE>(uType),
+                            .uPadding = 0u,
+                            .uHeight = static_cast<WORD>(HEIGHT_MAP_HEIGHT)
+                        }
+                    );
+                }
+            }
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: SaveTextHeightMap
+
+          Summary:  Writes a height map in the text format of
+                    HeightMap.txt: the dimensions and the number
+                    of colors, the colors, then the block type character
+                    and the relative height of every column
+
+          Args:     const std::filesystem::path& filePath
+                      Path of the file to write
+                    const std::vector<XMFLOAT3>& aColors
+                      Color of every block type
+                    const std::vector<library::HeightMapColumn>& aColumns
+                      Columns of the map, row by row
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT SaveTextHeightMap(
+            _In_ const std::filesystem::path& filePath,
+            _In_ const std::vector<XMFLOAT3>& aColors,
+            _In_ const std::vector<library::HeightMapColumn>& aColumns
+        )
+        {
+            std::ofstream file(filePath, std::ios::trunc);
+            if (!file)
+            {
+                return E_FAIL;
+            }
+
+            file << HEIGHT_MAP_SIZE << ' ' << HEIGHT_MAP_HEIGHT << ' ' << HEIGHT_MAP_SIZE << ' ' << aColors.size() << '\n';
+            for (const XMFLOAT3& color : aColors)
+            {
+                file << color.x << ' ' << color.y << ' ' << color.z << '\n';
+            }
+
+            for (const library::HeightMapColumn& column : aColumns)
+            {
+                file << static_cast<CHAR>(static_cast<CHAR>(library::eBlockType::GRASSLAND) + column.uType) << ' '
+                    << static_cast<FLOAT>(column.uHeight) / static_cast<FLOAT>(HEIGHT_MAP_HEIGHT) << '\n';
+            }
+
+            return file ? S_OK : E_FAIL;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: LoadHeightMap
+
+          Summary:  Builds a scene from a height map file and measures
+                    the time and the peak heap memory
+
+          Args:     const std::filesystem::path& filePath
+                      Height map file, text if its extension is .txt
+
+          Returns:  HeightMapLoad
+                      Measurements and voxels of the scene
+        -----------------------------------------------------------------F-F*/
+        HeightMapLoad LoadHeightMap(_In_ const std::filesystem::path& filePath)
+        {
+            HeightMapLoad load =
+            {
+                .loadTime = 0.0,
+                .uPeakAllocatedBytes = 0u,
+                .aNumVoxelInstances = std::vector<UINT>()
+            };
+
+            const SIZE_T uAllocatedBytes = GetAllocatedBytes();
+            ResetPeakAllocatedBytes();
+
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+            {
+                library::Scene scene(filePath);
+                load.loadTime = GetElapsedMilliseconds(startingTime);
+                load.uPeakAllocatedBytes = GetPeakAllocatedBytes() - uAllocatedBytes;
+
+                for (const std::shared_ptr<library::Voxel>& voxel : scene.GetVoxels())
+                {
+                    load.aNumVoxelInstances.push_back(voxel->GetNumInstances());
+                }
+            }
+
+            return load;
+        }
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestConcurrentLoad
+
+      Summary:  Imports the three bundled models one after the other,
+                then imports them again at the same time on the loader
+                threads of a scene, and checks that both loads give the
+                same geometry. Prints the time of both loads. Then loads
+                two models sharing a texture at the same time without
+                executing their command lists, and checks that the
+                texture holds the texels and mips of the file anyway.
+
+      Returns:  HRESULT
+                  S_OK if every check passed
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestConcurrentLoad()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a Direct3D 11 device can be created"))
+        {
+            return hr;
+        }
+
+        RemoveCookedFiles();
+
+        // The models are released before the concurrent load so it does not share their assets
+        std::vector<ModelGeometry> aExpectedGeometry;
+        LARGE_INTEGER startingTime;
+        QueryPerformanceCounter(&startingTime);
+        for (PCWSTR pszFilePath : BUNDLED_MODEL_PATHS)
+        {
+            library::Model model(pszFilePath);
+            hr = model.Initialize(device.Get(), immediateContext.Get());
+            if (!Check(SUCCEEDED(hr), "every bundled model loads on its own"))
+            {
+                return hr;
+            }
+
+            aExpectedGeometry.push_back(GetModelGeometry(model));
+        }
+        const DOUBLE sequentialTime = GetElapsedMilliseconds(startingTime);
+
+        RemoveCookedFiles();
+
+        // A scene without a height map only loads its models
+        library::Scene scene(std::filesystem::temp_directory_path() / L"ConcurrentLoad.txt");
+        std::vector<std::shared_ptr<library::Model>> aModels;
+        for (PCWSTR pszFilePath : BUNDLED_MODEL_PATHS)
+        {
+            aModels.push_back(std::make_shared<library::Model>(pszFilePath));
+            hr = scene.AddModel(pszFilePath, aModels.back());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        QueryPerformanceCounter(&startingTime);
+        hr = scene.Initialize(device.Get(), immediateContext.Get());
+        if (!Check(SUCCEEDED(hr), "the scene starts loading"))
+        {
+            return hr;
+        }
+
+        while (scene.IsLoading())
+        {
+            scene.UploadLoadedModels(immediateContext.Get());
+            std::this_thread::sleep_for(std::chrono::milliseconds(LOAD_POLL_INTERVAL));
+        }
+        scene.UploadLoadedModels(immediateContext.Get());
+        const DOUBLE concurrentTime = GetElapsedMilliseconds(startingTime);
+
+        printf("    %zu models: %.1f ms one after the other, %.1f ms at the same time\n", aModels.size(), sequentialTime, concurrentTime);
+
+        BOOL bPassed = Check(scene.GetNumFailedModels() == 0u, "no model fails to load");
+        bPassed &= Check(scene.GetNumLoadedModels() == aModels.size(), "every model is loaded");
+        for (size_t i = 0u; i < aModels.size(); ++i)
+        {
+            const ModelGeometry geometry = GetModelGeometry(*aModels[i]);
+            const ModelGeometry& expectedGeometry = aExpectedGeometry[i];
+
+            printf("    %ls: %u vertices, %u indices, %u meshes, %u materials\n", BUNDLED_MODEL_PATHS[i],
+                geometry.uNumVertices, geometry.uNumIndices, geometry.uNumMeshes, geometry.uNumMaterials);
+
+            bPassed &= Check(aModels[i]->IsLoaded(), "every model is marked as loaded");
+            bPassed &= Check(geometry.uNumVertices > 0u && geometry.uNumIndices > 0u && geometry.uNumMeshes > 0u, "every model has geometry");
+            bPassed &= Check(geometry.uNumVertices == expectedGeometry.uNumVertices
+                && geometry.uNumIndices == expectedGeometry.uNumIndices
+                && geometry.uNumMeshes == expectedGeometry.uNumMeshes
+                && geometry.uNumMaterials == expectedGeometry.uNumMaterials,
+                "a model loaded concurrently matches the same model loaded on its own");
+            bPassed &= Check(std::filesystem::exists(library::CookedModel::GetCookedFilePath(BUNDLED_MODEL_PATHS[i])), "every model writes its cooked file");
+        }
+
+        // Two models sharing a texture are loaded at the same time and neither command list is executed,
+        // as if the load that decoded the texture had failed or its commands had not run yet
+        const std::filesystem::path directory = std::filesystem::temp_directory_path();
+        RemoveSharedTextureModels(directory);
+        hr = WriteSharedTextureModels(directory);
+        if (!Check(SUCCEEDED(hr), "the models sharing a texture can be written"))
+        {
+            return hr;
+        }
+
+        library::Model firstModel(directory / SHARED_TEXTURE_MODEL_FILE_NAMES[0]);
+        library::Model secondModel(directory / SHARED_TEXTURE_MODEL_FILE_NAMES[1]);
+        ComPtr<ID3D11CommandList> firstCommandList;
+        ComPtr<ID3D11CommandList> secondCommandList;
+        HRESULT hrFirst = E_FAIL;
+        HRESULT hrSecond = E_FAIL;
+        {
+            std::jthread firstLoader([&]() { hrFirst = LoadIntoDeferredContext(device.Get(), firstModel, firstCommandList); });
+            std::jthread secondLoader([&]() { hrSecond = LoadIntoDeferredContext(device.Get(), secondModel, secondCommandList); });
+        }
+        bPassed &= Check(SUCCEEDED(hrFirst) && SUCCEEDED(hrSecond), "both models sharing a texture load");
+
+        const std::shared_ptr<library::Texture> pSharedTexture = GetDiffuseTexture(firstModel);
+        bPassed &= Check(pSharedTexture && pSharedTexture == GetDiffuseTexture(secondModel), "both models use one texture");
+
+        library::Texture referenceTexture(SHARED_TEXTURE_SOURCE_PATH);
+        hr = referenceTexture.Initialize(device.Get(), immediateContext.Get());
+        if (SUCCEEDED(hr) && pSharedTexture)
+        {
+            std::vector<BYTE> aSharedTexels;
+            std::vector<BYTE> aReferenceTexels;
+            UINT uNumSharedMips = 0u;
+            UINT uNumReferenceMips = 0u;
+            hr = ReadTexels(device.Get(), immediateContext.Get(), *pSharedTexture, aSharedTexels, uNumSharedMips);
+            if (SUCCEEDED(hr))
+            {
+                hr = ReadTexels(device.Get(), immediateContext.Get(), referenceTexture, aReferenceTexels, uNumReferenceMips);
+            }
+
+            bPassed &= Check(SUCCEEDED(hr) && !aSharedTexels.empty() && aSharedTexels == aReferenceTexels, "the shared texture holds its texels without any command list");
+            bPassed &= Check(uNumSharedMips == uNumReferenceMips, "the shared texture has its mips without any command list");
+        }
+        bPassed &= Check(SUCCEEDED(hr), "the shared texture can be read back");
+
+        RemoveSharedTextureModels(directory);
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestHeightMapLoad
+
+      Summary:  Writes a 1024 x 1024 height map as text, as a binary
+                map and as a run length encoded binary map, builds a
+                scene from each one and prints the load time and the
+                peak heap memory of each format. Checks that every
+                format gives the same voxels and that the binary map,
+                read in place, needs less memory than the text map.
+
+      Returns:  HRESULT
+                  S_OK if every check passed
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestHeightMapLoad()
+    {
+        std::vector<XMFLOAT3> aColors;
+        std::vector<library::HeightMapColumn> aColumns;
+        GenerateHeightMap(aColors, aColumns);
+
+        const std::filesystem::path directory = std::filesystem::temp_directory_path();
+        const std::filesystem::path textFilePath = directory / L"HeightMapLoad.txt";
+        const std::filesystem::path binaryFilePath = directory / L"HeightMapLoad.hmap";
+        const std::filesystem::path encodedFilePath = directory / L"HeightMapLoadEncoded.hmap";
+
+        HRESULT hr = SaveTextHeightMap(textFilePath, aColors, aColumns);
+        if (SUCCEEDED(hr))
+        {
+            hr = library::HeightMap::Save(binaryFilePath, HEIGHT_MAP_SIZE, HEIGHT_MAP_HEIGHT, HEIGHT_MAP_SIZE, aColors, aColumns, FALSE);
+        }
+        if (SUCCEEDED(hr))
+        {
+            hr = library::HeightMap::Save(encodedFilePath, HEIGHT_MAP_SIZE, HEIGHT_MAP_HEIGHT, HEIGHT_MAP_SIZE, aColors, aColumns, TRUE);
+        }
+        if (!Check(SUCCEEDED(hr), "the height map files can be written"))
+        {
+            return hr;
+        }
+
+        const std::filesystem::path aFilePaths[] = { textFilePath, binaryFilePath, encodedFilePath };
+        const PCSTR aszFormats[] = { "text", "binary", "encoded binary" };
+        std::vector<HeightMapLoad> aLoads;
+        for (size_t i = 0u; i < ARRAYSIZE(aFilePaths); ++i)
+        {
+            aLoads.push_back(LoadHeightMap(aFilePaths[i]));
+
+            std::error_code error;
+            const UINT64 uFileSize = std::filesystem::file_size(aFilePaths[i], error);
+
+            // The binary maps are mapped in memory, which the peak heap memory does not count
+            printf("    %-14s: %8llu byte file, %8.1f ms, %9zu peak heap bytes\n", aszFormats[i], uFileSize, aLoads[i].loadTime, aLoads[i].uPeakAllocatedBytes);
+        }
+
+        for (const std::filesystem::path& filePath : aFilePaths)
+        {
+            std::error_code error;
+            std::filesystem::remove(filePath, error);
+        }
+
+        const UINT64 uNumInstances = std::accumulate(aLoads[0].aNumVoxelInstances.begin(), aLoads[0].aNumVoxelInstances.end(), 0ull);
+        BOOL bPassed = Check(uNumInstances == static_cast<UINT64>(HEIGHT_MAP_SIZE) * HEIGHT_MAP_SIZE * HEIGHT_MAP_HEIGHT, "the text map gives a block for every column");
+        bPassed &= Check(aLoads[1].aNumVoxelInstances == aLoads[0].aNumVoxelInstances, "the binary map gives the voxels of the text map");
+        bPassed &= Check(aLoads[2].aNumVoxelInstances == aLoads[0].aNumVoxelInstances, "the encoded binary map gives the voxels of the text map");
+        bPassed &= Check(aLoads[1].uPeakAllocatedBytes < aLoads[0].uPeakAllocatedBytes, "the binary map needs less heap memory than the text map");
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+}
@@ -0,0 +1,260 @@
+#include "Tests.h"
+
+#include <cstdio>
+
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+
+#include "Model/Model.h"
+#include "Model/SkinnedVertexCache.h"
+#include "TestUtilities.h"
+
+namespace tests
+{
+    namespace
+    {
+        constexpr const UINT SKINNING_NUM_FRAMES = 256u;
+        constexpr const FLOAT SKINNING_POSE_TIME = 0.5f;
+        constexpr const FLOAT MAX_SKINNING_ERROR = 1.0e-3f;
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: CreateSkinningStreams
+
+          Summary:  Builds the skinning streams of every mesh of a scene,
+                    with the bone indices of the palette of a model
+                    loaded from the same file
+
+          Args:     const aiScene* pScene
+                      Imported scene
+                    const std::unordered_map<std::string, UINT>& boneNameToIndexMap
+                      Palette index of each bone
+                    std::shared_ptr<library::SkinningStreams>& pOutStreams
+                      Created streams
+
+          Modifies: [pOutStreams].
+
+          Returns:  HRESULT
+                      Status code
+        -----------------------------------------------------------------F-F*/
+        HRESULT CreateSkinningStreams(
+            _In_ const aiScene* pScene,
+            _In_ const std::unordered_map<std::string, UINT>& boneNameToIndexMap,
+            _Out_ std::shared_ptr<library::SkinningStreams>& pOutStreams
+        )
+        {
+            std::vector<library::SimpleVertex> aVertices;
+            std::vector<library::NormalData> aNormalData;
+            std::vector<library::AnimationData> aAnimationData;
+
+            for (UINT uMesh = 0u; uMesh < pScene->mNumMeshes; ++uMesh)
+            {
+                const aiMesh* pMesh = pScene->mMeshes[uMesh];
+                const size_t uBaseVertex = aVertices.size();
+
+                for (UINT i = 0u; i < pMesh->mNumVertices; ++i)
+                {
+                    const aiVector3D& position = pMesh->mVertices[i];
+                    const aiVector3D& normal = pMesh->mNormals[i];
+                    const aiVector3D texCoord = pMesh->HasTextureCoords(0u) ? pMesh->mTextureCoords[0][i] : aiVector3D(0.0f);
+                    const aiVector3D tangent = pMesh->HasTangentsAndBitangents() ? pMesh->mTangents[i] : aiVector3D(1.0f, 0.0f, 0.0f);
+                    const aiVector3D bitangent = pMesh->HasTangentsAndBitangents() ? pMesh->mBitangents[i] : aiVector3D(0.0f, 1.0f, 0.0f);
+
+                    aVertices.push_back({
+                        .Position = XMFLOAT3(position.x, position.y, position.z),
+                        .TexCoord = XMFLOAT2(texCoord.x, texCoord.y),
+                        .Normal = XMFLOAT3(normal.x, normal.y, normal.z)
+                    });
+                    aNormalData.push_back({
+                        .Tangent = XMFLOAT3(tangent.x, tangent.y, tangent.z),
+                        .Bitangent = XMFLOAT3(bitangent.x, bitangent.y, bitangent.z)
+                    });
+                    aAnimationData.push_back({
+                        .aBoneIndices = XMUINT4(0u, 0u, 0u, 0u),
+                        .aBoneWeights = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f)
+                    });
+                }
+
+                for (UINT uBone = 0u; uBone < pMesh->mNumBones; ++uBone)
+                {
+                    const aiBone* pBone = pMesh->mBones[uBone];
+                    const auto it = boneNameToIndexMap.find(pBone->mName.C_Str());
+                    if (it == boneNameToIndexMap.end())
+                    {
+                        return E_FAIL;
+                    }
+
+                    for (UINT uWeight = 0u; uWeight < pBone->mNumWeights; ++uWeight)
+                    {
+                        library::AnimationData& animationData = aAnimationData[uBaseVertex + pBone->mWeights[uWeight].mVertexId];
+                        UINT* aBoneIndices = &animationData.aBoneIndices.x;
+                        FLOAT* aBoneWeights = &animationData.aBoneWeights.x;
+
+                        // Influences past the fourth are dropped, as Model does
+                        for (UINT uInfluence = 0u; uInfluence < library::SkinningStreams::NUM_INFLUENCES; ++uInfluence)
+                        {
+                            if (aBoneWeights[uInfluence] == 0.0f)
+                            {
+                                aBoneIndices[uInfluence] = it->second;
+                                aBoneWeights[uInfluence] = pBone->mWeights[uWeight].mWeight;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            pOutStreams = std::make_shared<library::SkinningStreams>();
+
+            return pOutStreams->Initialize(aVertices.data(), aNormalData.data(), aAnimationData.data(), static_cast<UINT>(aVertices.size()));
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: TimeSkinning
+
+          Summary:  Skins the vertices of a cache on the calling thread
+                    a number of times, with or without AVX2
+
+          Args:     library::SkinnedVertexCache& cache
+                      Cache to skin
+                    const std::vector<XMMATRIX>& aBoneTransforms
+                      Bone palette
+                    BOOL bUseAvx2
+                      Whether to skin with AVX2
+
+          Modifies: [cache].
+
+          Returns:  DOUBLE
+                      Number of vertices skinned per second
+        -----------------------------------------------------------------F-F*/
+        DOUBLE TimeSkinning(_Inout_ library::SkinnedVertexCache& cache, _In_ const std::vector<XMMATRIX>& aBoneTransforms, _In_ BOOL bUseAvx2)
+        {
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+
+            for (UINT uFrame = 0u; uFrame < SKINNING_NUM_FRAMES; ++uFrame)
+            {
+                if (bUseAvx2)
+                {
+                    cache.Update(aBoneTransforms);
+                }
+                else
+                {
+                    cache.UpdateScalar(aBoneTransforms);
+                }
+            }
+
+            const DOUBLE time = GetElapsedMilliseconds(startingTime);
+
+            return static_cast<DOUBLE>(cache.GetNumVertices()) * static_cast<DOUBLE>(SKINNING_NUM_FRAMES) * 1.0e3 / time;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GetLargestSkinningDifference
+
+          Summary:  Returns the largest difference between the skinned
+                    positions, normals and tangents of two caches
+
+          Args:     const library::SkinnedVertexCache& cache
+                      First cache
+                    const library::SkinnedVertexCache& otherCache
+                      Second cache, skinned from the same streams
+
+          Returns:  FLOAT
+                      Largest difference of a component
+        -----------------------------------------------------------------F-F*/
+        FLOAT GetLargestSkinningDifference(_In_ const library::SkinnedVertexCache& cache, _In_ const library::SkinnedVertexCache& otherCache)
+        {
+            XMVECTOR largestDifference = XMVectorZero();
+            for (UINT i = 0u; i < cache.GetNumVertices(); ++i)
+            {
+                largestDifference = XMVectorMax(largestDifference, XMVectorAbs(XMVectorSubtract(cache.GetPosition(i), otherCache.GetPosition(i))));
+                largestDifference = XMVectorMax(largestDifference, XMVectorAbs(XMVectorSubtract(cache.GetNormal(i), otherCache.GetNormal(i))));
+                largestDifference = XMVectorMax(largestDifference, XMVectorAbs(XMVectorSubtract(cache.GetTangent(i), otherCache.GetTangent(i))));
+            }
+
+            XMFLOAT3 difference;
+            XMStoreFloat3(&difference, largestDifference);
+
+            return std::max(difference.x, std::max(difference.y, difference.z));
+        }
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestSkinnedVertexCache
+
+      Summary:  Benchmark of the CPU skinning of boblampclean. The same
+                pose is skinned on one thread through the AVX2 path and
+                through the DirectXMath path, and the throughput of each
+                is printed in vertices per second per core. Checks that
+                both paths give the same positions, normals and
+                tangents within a tolerance.
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestSkinnedVertexCache()
+    {
+        ComPtr<ID3D11Device> device;
+        ComPtr<ID3D11DeviceContext> immediateContext;
+        HRESULT hr = CreateHeadlessDevice(device, immediateContext);
+        if (!Check(SUCCEEDED(hr), "a headless device is created"))
+        {
+            return hr;
+        }
+
+        library::Model model(L"Content/BobLampClean/boblampclean.md5mesh");
+        hr = model.Initialize(device.Get(), immediateContext.Get());
+        if (!Check(SUCCEEDED(hr) && model.GetNumAnimations() > 0u, "boblampclean.md5mesh loads with its md5anim"))
+        {
+            return FAILED(hr) ? hr : E_FAIL;
+        }
+
+        model.Update(SKINNING_POSE_TIME);
+        const std::vector<XMMATRIX> aBoneTransforms = model.GetBoneTransforms();
+
+        Assimp::Importer importer;
+        const aiScene* pScene = importer.ReadFile("Content/BobLampClean/boblampclean.md5mesh", ASSIMP_LOAD_FLAGS);
+        if (!Check(pScene != nullptr, "boblampclean.md5mesh imports through assimp"))
+        {
+            return E_FAIL;
+        }
+
+        std::shared_ptr<library::SkinningStreams> pStreams;
+        hr = CreateSkinningStreams(pScene, model.GetBoneNameToIndexMap(), pStreams);
+        if (!Check(SUCCEEDED(hr), "the skinning streams are built with the bones of the model"))
+        {
+            return hr;
+        }
+
+        library::SkinnedVertexCache avx2Cache;
+        library::SkinnedVertexCache scalarCache;
+        avx2Cache.Initialize(pStreams);
+        scalarCache.Initialize(pStreams);
+
+        const DOUBLE scalarRate = TimeSkinning(scalarCache, aBoneTransforms, FALSE);
+        BOOL bPassed = Check(scalarCache.IsValid(), "the DirectXMath path skins the vertices");
+
+        if (!library::SkinnedVertexCache::HasAvx2())
+        {
+            printf("    %u vertices: DirectXMath %.2f M vertices/s/core, AVX2 is not supported\n", scalarCache.GetNumVertices(), scalarRate * 1.0e-6);
+
+            return bPassed ? S_OK : E_FAIL;
+        }
+
+        const DOUBLE avx2Rate = TimeSkinning(avx2Cache, aBoneTransforms, TRUE);
+        const FLOAT difference = GetLargestSkinningDifference(avx2Cache, scalarCache);
+
+        printf("    %u vertices: DirectXMath %.2f M, AVX2 %.2f M vertices/s/core (%.2fx)\n",
+            scalarCache.GetNumVertices(),
+            scalarRate * 1.0e-6,
+            avx2Rate * 1.0e-6,
+            avx2Rate / scalarRate);
+        printf("    largest difference between the paths: %.6f\n", difference);
+
+        bPassed &= Check(avx2Cache.IsValid(), "the AVX2 path skins the vertices");
+        bPassed &= Check(difference <= MAX_SKINNING_ERROR, "the AVX2 and DirectXMath paths agree within 0.001");
+
+        return bPassed ? S_OK : E_FAIL;
+    }
+}
@@ -0,0 +1,275 @@
+#include "Tests.h"
+
+#include <cstdio>
+
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/TangentFrameGenerator.h"
+#include "TestUtilities.h"
+
+namespace tests
+{
+    namespace
+    {
+        constexpr const PCSTR TANGENT_MODEL_PATHS[] =
+        {
+            "Content/Nanosuit/nanosuit.obj",
+            "Content/cyborg/cyborg.obj",
+        };
+        constexpr const UINT TANGENT_NUM_LOOPS = 8u;
+        // Sanity bounds, the two methods weight the faces differently
+        constexpr const FLOAT MAX_MEAN_TANGENT_ANGLE = 15.0f;
+        constexpr const FLOAT MAX_FLIPPED_VERTEX_FRACTION = 0.05f;
+        constexpr const FLOAT MAX_FRAME_ERROR = 1.0e-3f;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   TangentMesh
+
+          Summary:  Vertices and indices of an imported mesh, with the
+                    tangent frames Assimp computed for it
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct TangentMesh
+        {
+            std::vector<library::SimpleVertex> aVertices;
+            std::vector<UINT> aIndices;
+            std::vector<library::NormalData> aReferenceNormalData;
+        };
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: ReadTangentMeshes
+
+          Summary:  Copies the meshes of an Assimp scene as the Model
+                    imports them
+
+          Args:     const aiScene* pScene
+                      Scene imported with aiProcess_CalcTangentSpace
+                    std::vector<TangentMesh>& aOutMeshes
+                      Meshes of the scene
+
+          Modifies: [aOutMeshes].
+        -----------------------------------------------------------------F-F*/
+        void ReadTangentMeshes(_In_ const aiScene* pScene, _Out_ std::vector<TangentMesh>& aOutMeshes)
+        {
+            aOutMeshes.clear();
+            aOutMeshes.resize(pScene->mNumMeshes);
+
+            const aiVector3D zero3d(0.0f, 0.0f, 0.0f);
+            for (UINT i = 0u; i < pScene->mNumMeshes; ++i)
+            {
+                const aiMesh* pMesh = pScene->mMeshes[i];
+                TangentMesh& mesh = aOutMeshes[i];
+
+                mesh.aVertices.resize(pMesh->mNumVertices);
+                mesh.aReferenceNormalData.resize(pMesh->mNumVertices);
+                for (UINT j = 0u; j < pMesh->mNumVertices; ++j)
+                {
+                    const aiVector3D& position = pMesh->mVertices[j];
+                    const aiVector3D& normal = pMesh->mNormals[j];
+                    const aiVector3D& texCoord = pMesh->HasTextureCoords(0u) ? pMesh->mTextureCoords[0][j] : zero3d;
+                    const aiVector3D& tangent = pMesh->HasTangentsAndBitangents() ? pMesh->mTangents[j] : zero3d;
+                    const aiVector3D& bitangent = pMesh->HasTangentsAndBitangents() ? pMesh->mBitangents[j] : zero3d;
+
+                    mesh.aVertices[j] =
+                    {
+                        .Position = XMFLOAT3(position.x, position.y, position.z),
+                        .TexCoord = XMFLOAT2(texCoord.x, texCoord.y),
+                        .Normal = XMFLOAT3(normal.x, normal.y, normal.z)
+                    };
+                    mesh.aReferenceNormalData[j] =
+                    {
+                        .Tangent = XMFLOAT3(tangent.x, tangent.y, tangent.z),
+                        .Bitangent = XMFLOAT3(bitangent.x, bitangent.y, bitangent.z)
+                    };
+                }
+
+                mesh.aIndices.reserve(static_cast<size_t>(pMesh->mNumFaces) * 3u);
+                for (UINT j = 0u; j < pMesh->mNumFaces; ++j)
+                {
+                    const aiFace& face = pMesh->mFaces[j];
+                    mesh.aIndices.insert(mesh.aIndices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+                }
+            }
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: GenerateTangentFrames
+
+          Summary:  Generates the tangent frames of every mesh
+
+          Args:     const std::vector<TangentMesh>& aMeshes
+                      Meshes to generate
+                    std::vector<std::vector<library::NormalData>>& aOutNormalData
+                      Tangent frames of each mesh
+
+          Modifies: [aOutNormalData].
+        -----------------------------------------------------------------F-F*/
+        void GenerateTangentFrames(_In_ const std::vector<TangentMesh>& aMeshes, _Out_ std::vector<std::vector<library::NormalData>>& aOutNormalData)
+        {
+            aOutNormalData.resize(aMeshes.size());
+            for (size_t i = 0u; i < aMeshes.size(); ++i)
+            {
+                aOutNormalData[i].resize(aMeshes[i].aVertices.size());
+                library::TangentFrameGenerator::Generate(
+                    aMeshes[i].aVertices.data(),
+                    static_cast<UINT>(aMeshes[i].aVertices.size()),
+                    aMeshes[i].aIndices.data(),
+                    DXGI_FORMAT_R32_UINT,
+                    static_cast<UINT>(aMeshes[i].aIndices.size()),
+                    aOutNormalData[i].data()
+                );
+            }
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: IsOrthonormalFrame
+
+          Summary:  Returns whether a tangent frame is made of unit
+                    vectors orthogonal to each other and to the normal
+
+          Args:     const library::SimpleVertex& vertex
+                      Vertex with the normal
+                    const library::NormalData& normalData
+                      Tangent frame of the vertex
+
+          Returns:  BOOL
+                      TRUE if the frame is orthonormal
+        -----------------------------------------------------------------F-F*/
+        BOOL IsOrthonormalFrame(_In_ const library::SimpleVertex& vertex, _In_ const library::NormalData& normalData)
+        {
+            const XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&vertex.Normal));
+            const XMVECTOR tangent = XMLoadFloat3(&normalData.Tangent);
+            const XMVECTOR bitangent = XMLoadFloat3(&normalData.Bitangent);
+
+            return fabsf(XMVectorGetX(XMVector3Length(tangent)) - 1.0f) < MAX_FRAME_ERROR
+                && fabsf(XMVectorGetX(XMVector3Length(bitangent)) - 1.0f) < MAX_FRAME_ERROR
+                && fabsf(XMVectorGetX(XMVector3Dot(tangent, normal))) < MAX_FRAME_ERROR
+                && fabsf(XMVectorGetX(XMVector3Dot(bitangent, normal))) < MAX_FRAME_ERROR
+                && fabsf(XMVectorGetX(XMVector3Dot(tangent, bitangent))) < MAX_FRAME_ERROR;
+        }
+
+        /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+          Function: TestTangentModel
+
+          Summary:  Times and checks the tangent frames of one model
+
+          Args:     PCSTR pszFilePath
+                      Path of the model
+
+          Returns:  HRESULT
+                      S_OK if every check passed
+        -----------------------------------------------------------------F-F*/
+        HRESULT TestTangentModel(_In_ PCSTR pszFilePath)
+        {
+            printf("    %s\n", pszFilePath);
+
+            // Assimp computes the reference frames as part of the import the Model uses
+            Assimp::Importer importer;
+            const aiScene* pScene = importer.ReadFile(pszFilePath, ASSIMP_LOAD_FLAGS);
+            if (!Check(pScene != nullptr, "the model imports"))
+            {
+                return E_FAIL;
+            }
+
+            std::vector<TangentMesh> aMeshes;
+            ReadTangentMeshes(pScene, aMeshes);
+
+            // Assimp timed on its own, on a copy of the scene imported without tangents
+            Assimp::Importer timedImporter;
+            if (!Check(timedImporter.ReadFile(pszFilePath, ASSIMP_LOAD_FLAGS & ~aiProcess_CalcTangentSpace) != nullptr, "the model imports without tangents"))
+            {
+                return E_FAIL;
+            }
+
+            LARGE_INTEGER startingTime;
+            QueryPerformanceCounter(&startingTime);
+            timedImporter.ApplyPostProcessing(aiProcess_CalcTangentSpace);
+            const DOUBLE assimpTime = GetElapsedMilliseconds(startingTime);
+
+            std::vector<std::vector<library::NormalData>> aNormalData;
+            GenerateTangentFrames(aMeshes, aNormalData);
+
+            QueryPerformanceCounter(&startingTime);
+            for (UINT uLoop = 0u; uLoop < TANGENT_NUM_LOOPS; ++uLoop)
+            {
+                std::vector<std::vector<library::NormalData>> aTimedNormalData;
+                GenerateTangentFrames(aMeshes, aTimedNormalData);
+            }
+            const DOUBLE generatorTime = GetElapsedMilliseconds(startingTime) / TANGENT_NUM_LOOPS;
+
+            std::vector<std::vector<library::NormalData>> aRepeatedNormalData;
+            GenerateTangentFrames(aMeshes, aRepeatedNormalData);
+
+            BOOL bPassed = TRUE;
+            UINT uNumVertices = 0u;
+            UINT uNumComparedVertices = 0u;
+            UINT uNumFlippedVertices = 0u;
+            DOUBLE angleSum = 0.0;
+            FLOAT maxAngle = 0.0f;
+            for (size_t i = 0u; i < aMeshes.size(); ++i)
+            {
+                const TangentMesh& mesh = aMeshes[i];
+                const UINT uNumMeshVertices = static_cast<UINT>(mesh.aVertices.size());
+
+                const library::TangentFrameError error = library::TangentFrameGenerator::Compare(mesh.aReferenceNormalData.data(), aNormalData[i].data(), uNumMeshVertices);
+                uNumVertices += uNumMeshVertices;
+                uNumComparedVertices += error.uNumVertices;
+                uNumFlippedVertices += error.uNumFlippedVertices;
+                angleSum += static_cast<DOUBLE>(error.meanTangentAngle) * error.uNumVertices;
+                maxAngle = std::max(maxAngle, error.maxTangentAngle);
+
+                bPassed &= Check(memcmp(aNormalData[i].data(), aRepeatedNormalData[i].data(), sizeof(library::NormalData) * uNumMeshVertices) == 0,
+                    "the tangent frames are the same on every run");
+
+                for (UINT j = 0u; j < uNumMeshVertices; ++j)
+                {
+                    if (XMVectorGetX(XMVector3LengthSq(XMLoadFloat3(&mesh.aVertices[j].Normal))) > 0.0f && !IsOrthonormalFrame(mesh.aVertices[j], aNormalData[i][j]))
+                    {
+                        bPassed &= Check(FALSE, "every tangent frame is orthonormal");
+                        break;
+                    }
+                }
+            }
+
+            const FLOAT meanAngle = uNumComparedVertices > 0u ? static_cast<FLOAT>(angleSum / uNumComparedVertices) : 0.0f;
+            printf("    %u vertices: generator %.3f ms, Assimp %.3f ms\n", uNumVertices, generatorTime, assimpTime);
+            printf("    against Assimp: %u vertices compared, tangent angle mean %.2f max %.2f degrees, %u flipped\n",
+                uNumComparedVertices, meanAngle, maxAngle, uNumFlippedVertices);
+
+            bPassed &= Check(uNumComparedVertices > 0u, "Assimp computes reference tangents");
+            bPassed &= Check(meanAngle <= MAX_MEAN_TANGENT_ANGLE, "the tangents stay close to Assimp on average");
+            bPassed &= Check(static_cast<FLOAT>(uNumFlippedVertices) <= MAX_FLIPPED_VERTEX_FRACTION * static_cast<FLOAT>(uNumComparedVertices), "the handedness agrees with Assimp");
+
+            return bPassed ? S_OK : E_FAIL;
+        }
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: TestTangentFrames
+
+      Summary:  Generates the tangent frames of the bundled static
+                models, prints the time against Assimp's
+                aiProcess_CalcTangentSpace and how far the frames are
+                from Assimp's, and checks that the frames are
+                orthonormal and the same on every run
+
+      Returns:  HRESULT
+                  S_OK if every check passed
+    -----------------------------------------------------------------F-F*/
+    HRESULT TestTangentFrames()
+    {
+        HRESULT hr = S_OK;
+        for (PCSTR pszFilePath : TANGENT_MODEL_PATHS)
+        {
+            HRESULT hrModel = TestTangentModel(pszFilePath);
+            if (FAILED(hrModel))
+            {
+                hr = hrModel;
+            }
+        }
+
+        return hr;
+    }
+}
@@ -0,0 +1,102 @@
+#include "TestUtilities.h"
+
+#include <cstdio>
+
+namespace tests
+{
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: Check
+
+      Summary:  Prints the description of a check that failed
+
+      Args:     BOOL bCondition
+                  Result of the check
+                PCSTR pszDescription
+                  What the check expects
+
+      Returns:  BOOL
+                  bCondition
+    -----------------------------------------------------------------F-F*/
+    BOOL Check(_In_ BOOL bCondition, _In_ PCSTR pszDescription)
+    {
+        if (!bCondition)
+        {
+            printf("    check failed: %s\n", pszDescription);
+        }
+
+        return bCondition;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: CreateHeadlessDevice
+
+      Summary:  Creates a device without a window or swap chain, on the
+                hardware if there is one and on WARP otherwise
+
+      Args:     ComPtr<ID3D11Device>& device
+                  Created device
+                ComPtr<ID3D11DeviceContext>& immediateContext
+                  Immediate context of the device
+
+      Modifies: [device, immediateContext].
+
+      Returns:  HRESULT
+                  Status code
+    -----------------------------------------------------------------F-F*/
+    HRESULT CreateHeadlessDevice(_Out_ ComPtr<ID3D11Device>& device, _Out_ ComPtr<ID3D11DeviceContext>& immediateContext)
+    {
+        D3D_DRIVER_TYPE driverTypes[] =
+        {
+            D3D_DRIVER_TYPE_HARDWARE,
+            D3D_DRIVER_TYPE_WARP,
+        };
+
+        D3D_FEATURE_LEVEL featureLevels[] =
+        {
+            D3D_FEATURE_LEVEL_11_1,
+            D3D_FEATURE_LEVEL_11_0,
+        };
+
+        HRESULT hr = E_FAIL;
+        for (D3D_DRIVER_TYPE driverType : driverTypes)
+        {
+            hr = D3D11CreateDevice(nullptr, driverType, nullptr, 0u, featureLevels, ARRAYSIZE(featureLevels),
+                D3D11_SDK_VERSION, device.ReleaseAndGetAddressOf(), nullptr, immediateContext.ReleaseAndGetAddressOf());
+
+            if (hr == E_INVALIDARG)
+            {
+                // DirectX 11.0 platforms will not recognize D3D_FEATURE_LEVEL_11_1 so we need to retry without it
+                hr = D3D11CreateDevice(nullptr, driverType, nullptr, 0u, &featureLevels[1], ARRAYSIZE(featureLevels) - 1u,
+                    D3D11_SDK_VERSION, device.ReleaseAndGetAddressOf(), nullptr, immediateContext.ReleaseAndGetAddressOf());
+            }
+
+            if (SUCCEEDED(hr))
+            {
+                break;
+            }
+        }
+
+        return hr;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+      Function: GetElapsedMilliseconds
+
+      Summary:  Returns the time since a performance counter value
+
+      Args:     const LARGE_INTEGER& startingTime
+                  Value of QueryPerformanceCounter at the start
+
+      Returns:  DOUBLE
+                  Elapsed time in milliseconds
+    -----------------------------------------------------------------F-F*/
+    DOUBLE GetElapsedMilliseconds(_In_ const LARGE_INTEGER& startingTime)
+    {
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&endingTime);
+
+        return static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart);
+    }
+}
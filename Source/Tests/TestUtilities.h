@@ -0,0 +1,21 @@
+/*+===================================================================
+  File:      TESTUTILITIES.H
+
+  Summary:   TestUtilities header file contains declarations of the
+             functions shared by the headless tests and benchmarks of
+             the Library project.
+
+  Functions: Check, CreateHeadlessDevice, GetElapsedMilliseconds
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace tests
+{
+    BOOL Check(_In_ BOOL bCondition, _In_ PCSTR pszDescription);
+    HRESULT CreateHeadlessDevice(_Out_ ComPtr<ID3D11Device>& device, _Out_ ComPtr<ID3D11DeviceContext>& immediateContext);
+    DOUBLE GetElapsedMilliseconds(_In_ const LARGE_INTEGER& startingTime);
+}
@@ -0,0 +1,41 @@
+/*+===================================================================
+  File:      TESTS.H
+
+  Summary:   Tests header file contains declarations of the headless
+             tests and benchmarks run by the Tests project. Each one
+             prints its measurements and returns S_OK if every check
+             passed.
+
+  Functions: TestAnimationKeyLookup, TestAnimationSampling,
+             TestAnimationBlending, TestAnimationScaling,
+             TestSkinnedVertexCache, TestCrowdPaletteUpload,
+             TestCookedModelLoad, TestWideIndexImport,
+             TestLodSelection, TestMeshletCulling,
+             TestParallelImport, TestInstancingStress,
+             TestTangentFrames, TestConcurrentLoad,
+             TestHeightMapLoad
+
+  ?2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace tests
+{
+    HRESULT TestAnimationKeyLookup();
+    HRESULT TestAnimationSampling();
+    HRESULT TestAnimationBlending();
+    HRESULT TestAnimationScaling();
+    HRESULT TestSkinnedVertexCache();
+    HRESULT TestCrowdPaletteUpload();
+    HRESULT TestCookedModelLoad();
+    HRESULT TestWideIndexImport();
+    HRESULT TestLodSelection();
+    HRESULT TestMeshletCulling();
+    HRESULT TestParallelImport();
+    HRESULT TestInstancingStress();
+    HRESULT TestTangentFrames();
+    HRESULT TestConcurrentLoad();
+    HRESULT TestHeightMapLoad();
+}